@@ -0,0 +1,166 @@
+#include "harness.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <reloco/allocator.hpp>
+#include <reloco/heap_profiler.hpp>
+#include <reloco/stack_allocator.hpp>
+#include <reloco/statistics_allocator.hpp>
+#include <reloco/stl_bridge_allocator.hpp>
+#include <vector>
+
+using reloco::bench::do_not_optimize;
+using reloco::bench::state;
+
+namespace {
+
+/// Blocks held at once, so frees do not just hand back the last block
+constexpr std::size_t batch = 64;
+
+/**
+ * Allocates ``batch`` blocks of ``s.arg()`` bytes and frees them again.
+ */
+void churn(state &s, reloco::fallible_allocator &alloc) {
+  const auto size = static_cast<std::size_t>(s.arg());
+  void *blocks[batch];
+  while (s.keep_running()) {
+    for (auto &b : blocks)
+      b = alloc.allocate(size, alignof(std::max_align_t)).value().ptr;
+    do_not_optimize(blocks);
+    for (auto *b : blocks)
+      alloc.deallocate(b, size);
+  }
+  s.set_items_processed(s.iterations() * batch);
+}
+
+void bm_alloc_malloc(state &s) {
+  const auto size = static_cast<std::size_t>(s.arg());
+  void *blocks[batch];
+  while (s.keep_running()) {
+    for (auto &b : blocks)
+      b = std::malloc(size);
+    do_not_optimize(blocks);
+    for (auto *b : blocks)
+      std::free(b);
+  }
+  s.set_items_processed(s.iterations() * batch);
+}
+RELOCO_BENCHMARK(bm_alloc_malloc, 16, 256, 4096);
+
+void bm_alloc_operator_new(state &s) {
+  const auto size = static_cast<std::size_t>(s.arg());
+  void *blocks[batch];
+  while (s.keep_running()) {
+    for (auto &b : blocks)
+      b = ::operator new(size);
+    do_not_optimize(blocks);
+    for (auto *b : blocks)
+      ::operator delete(b, size);
+  }
+  s.set_items_processed(s.iterations() * batch);
+}
+RELOCO_BENCHMARK(bm_alloc_operator_new, 16, 256, 4096);
+
+void bm_alloc_core(state &s) { churn(s, reloco::get_default_allocator()); }
+RELOCO_BENCHMARK(bm_alloc_core, 16, 256, 4096);
+
+void bm_alloc_statistics(state &s) {
+  reloco::statistics_allocator stats(reloco::get_default_allocator());
+  churn(s, stats);
+}
+RELOCO_BENCHMARK(bm_alloc_statistics, 16, 256, 4096);
+
+/**
+ * Sampling at the default 512 KiB interval; nearly every call takes the
+ * unsampled path.
+ */
+void bm_alloc_heap_profiler(state &s) {
+  reloco::heap_profiler profiler(reloco::get_default_allocator());
+  if (!profiler.try_start())
+    s.skip("heap profiler unavailable");
+  churn(s, profiler);
+}
+RELOCO_BENCHMARK(bm_alloc_heap_profiler, 16, 256, 4096);
+
+void bm_alloc_stack(state &s) {
+  const auto size = static_cast<std::size_t>(s.arg());
+  const std::size_t capacity = batch * (size + alignof(std::max_align_t));
+  const auto storage = std::make_unique<std::byte[]>(capacity);
+  reloco::stack_allocator arena(storage.get(), capacity);
+  void *blocks[batch];
+  while (s.keep_running()) {
+    for (auto &b : blocks)
+      b = arena.allocate(size, alignof(std::max_align_t)).value().ptr;
+    do_not_optimize(blocks);
+    arena.reset();
+  }
+  s.set_items_processed(s.iterations() * batch);
+}
+RELOCO_BENCHMARK(bm_alloc_stack, 16, 256, 4096);
+
+#ifndef _WIN32
+void bm_alloc_mmap(state &s) {
+  reloco::mmap_allocator alloc;
+  churn(s, alloc);
+}
+RELOCO_BENCHMARK(bm_alloc_mmap, 1 << 16, 1 << 20);
+#endif
+
+/**
+ * Zeroed memory from calloc against allocate() followed by memset.
+ */
+void bm_alloc_zeroed_core(state &s) {
+  const auto size = static_cast<std::size_t>(s.arg());
+  auto &alloc = reloco::get_default_allocator();
+  while (s.keep_running()) {
+    auto block = alloc.allocate_zeroed(size, alignof(std::max_align_t));
+    do_not_optimize(block);
+    alloc.deallocate(block.value().ptr, size);
+  }
+  s.set_bytes_processed(s.iterations() * size);
+}
+RELOCO_BENCHMARK(bm_alloc_zeroed_core, 4096, 1 << 20, 1 << 24);
+
+void bm_alloc_then_memset_core(state &s) {
+  const std::size_t size = static_cast<std::uint32_t>(s.arg());
+  auto &alloc = reloco::get_default_allocator();
+  while (s.keep_running()) {
+    void *ptr = alloc.allocate(size, alignof(std::max_align_t)).value().ptr;
+    std::memset(ptr, 0, size);
+    do_not_optimize(ptr);
+    alloc.deallocate(ptr, size);
+  }
+  s.set_bytes_processed(s.iterations() * size);
+}
+RELOCO_BENCHMARK(bm_alloc_then_memset_core, 4096, 1 << 20, 1 << 24);
+
+/**
+ * The cost of routing std::vector through a fallible_allocator.
+ */
+void bm_alloc_stl_bridge_vector(state &s) {
+  const auto n = static_cast<int>(s.arg());
+  const reloco::stl_bridge_allocator<int> bridge;
+  while (s.keep_running()) {
+    std::vector<int, reloco::stl_bridge_allocator<int>> v(bridge);
+    for (int i = 0; i < n; ++i)
+      v.push_back(i);
+    do_not_optimize(v.data());
+  }
+  s.set_items_processed(s.iterations() * n);
+}
+RELOCO_BENCHMARK(bm_alloc_stl_bridge_vector, 1 << 10, 1 << 16);
+
+void bm_alloc_std_allocator_vector(state &s) {
+  const auto n = static_cast<int>(s.arg());
+  while (s.keep_running()) {
+    std::vector<int> v;
+    for (int i = 0; i < n; ++i)
+      v.push_back(i);
+    do_not_optimize(v.data());
+  }
+  s.set_items_processed(s.iterations() * n);
+}
+RELOCO_BENCHMARK(bm_alloc_std_allocator_vector, 1 << 10, 1 << 16);
+
+} // namespace
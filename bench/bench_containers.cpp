@@ -0,0 +1,434 @@
+#include "harness.hpp"
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <reloco/flat_set.hpp>
+#include <reloco/function.hpp>
+#include <reloco/shared_ptr.hpp>
+#include <reloco/string.hpp>
+#include <reloco/vector.hpp>
+#include <set>
+#include <string>
+#include <vector>
+
+using reloco::bench::do_not_optimize;
+using reloco::bench::state;
+
+namespace {
+
+/// Long enough to live on the heap in both string types
+constexpr std::string_view long_text = "a string that does not fit any SSO";
+
+std::vector<std::int32_t> random_keys(const std::size_t n,
+                                      const std::uint64_t seed = 0x5eed) {
+  reloco::bench::input_rng rng(seed);
+  std::vector<std::int32_t> keys(n);
+  for (auto &k : keys)
+    k = static_cast<std::int32_t>(rng.next() >> 33);
+  return keys;
+}
+
+// vector
+
+void bm_vector_push_back_reloco(state &s) {
+  const auto n = static_cast<int>(s.arg());
+  while (s.keep_running()) {
+    reloco::vector<int> v;
+    for (int i = 0; i < n; ++i)
+      do_not_optimize(v.try_push_back(static_cast<int>(i)));
+    do_not_optimize(v.begin());
+  }
+  s.set_items_processed(s.iterations() * n);
+}
+RELOCO_BENCHMARK(bm_vector_push_back_reloco, 1 << 10, 1 << 16);
+
+void bm_vector_push_back_std(state &s) {
+  const auto n = static_cast<int>(s.arg());
+  while (s.keep_running()) {
+    std::vector<int> v;
+    for (int i = 0; i < n; ++i)
+      v.push_back(i);
+    do_not_optimize(v.data());
+  }
+  s.set_items_processed(s.iterations() * n);
+}
+RELOCO_BENCHMARK(bm_vector_push_back_std, 1 << 10, 1 << 16);
+
+/**
+ * Growing a full vector of heap strings: reloco relocates them with one
+ * memcpy, std::vector move-constructs and destroys each one.
+ */
+void bm_vector_reserve_strings_reloco(state &s) {
+  const auto n = static_cast<std::size_t>(s.arg());
+  while (s.keep_running()) {
+    s.pause_timing();
+    reloco::vector<reloco::string> v;
+    do_not_optimize(v.try_reserve(n));
+    for (std::size_t i = 0; i < n; ++i)
+      do_not_optimize(
+          v.try_push_back(reloco::string::try_create(long_text).value()));
+    s.resume_timing();
+    do_not_optimize(v.try_reserve(2 * n));
+    s.pause_timing();
+    v.clear();
+    s.resume_timing();
+  }
+  s.set_items_processed(s.iterations() * n);
+}
+RELOCO_BENCHMARK(bm_vector_reserve_strings_reloco, 1 << 10, 1 << 16);
+
+void bm_vector_reserve_strings_std(state &s) {
+  const auto n = static_cast<std::size_t>(s.arg());
+  while (s.keep_running()) {
+    s.pause_timing();
+    std::vector<std::string> v;
+    v.reserve(n);
+    for (std::size_t i = 0; i < n; ++i)
+      v.emplace_back(long_text);
+    s.resume_timing();
+    v.reserve(2 * n);
+    s.pause_timing();
+    v.clear();
+    s.resume_timing();
+  }
+  s.set_items_processed(s.iterations() * n);
+}
+RELOCO_BENCHMARK(bm_vector_reserve_strings_std, 1 << 10, 1 << 16);
+
+void bm_vector_clone_reloco(state &s) {
+  const auto n = static_cast<int>(s.arg());
+  reloco::vector<int> v;
+  for (int i = 0; i < n; ++i)
+    do_not_optimize(v.try_push_back(static_cast<int>(i)));
+  while (s.keep_running()) {
+    auto clone = v.try_clone();
+    do_not_optimize(clone);
+  }
+  s.set_bytes_processed(s.iterations() * n * sizeof(int));
+}
+RELOCO_BENCHMARK(bm_vector_clone_reloco, 1 << 10, 1 << 20);
+
+void bm_vector_clone_std(state &s) {
+  const auto n = static_cast<int>(s.arg());
+  std::vector<int> v(n);
+  while (s.keep_running()) {
+    std::vector<int> copy = v;
+    do_not_optimize(copy.data());
+  }
+  s.set_bytes_processed(s.iterations() * n * sizeof(int));
+}
+RELOCO_BENCHMARK(bm_vector_clone_std, 1 << 10, 1 << 20);
+
+// basic_string
+
+void bm_string_append_reloco(state &s) {
+  const auto pieces = s.arg();
+  while (s.keep_running()) {
+    reloco::string str;
+    for (std::int64_t i = 0; i < pieces; ++i)
+      do_not_optimize(str.try_append(reloco::string_view("0123456789abcdef")));
+    do_not_optimize(str.size());
+  }
+  s.set_bytes_processed(s.iterations() * pieces * 16);
+}
+RELOCO_BENCHMARK(bm_string_append_reloco, 4, 1024);
+
+void bm_string_append_std(state &s) {
+  const auto pieces = s.arg();
+  while (s.keep_running()) {
+    std::string str;
+    for (std::int64_t i = 0; i < pieces; ++i)
+      str.append("0123456789abcdef");
+    do_not_optimize(str.data());
+  }
+  s.set_bytes_processed(s.iterations() * pieces * 16);
+}
+RELOCO_BENCHMARK(bm_string_append_std, 4, 1024);
+
+void bm_string_clone_reloco(state &s) {
+  const auto str = reloco::string::try_create(long_text).value();
+  while (s.keep_running()) {
+    auto clone = str.try_clone();
+    do_not_optimize(clone);
+  }
+  s.set_items_processed(s.iterations());
+}
+RELOCO_BENCHMARK(bm_string_clone_reloco);
+
+void bm_string_clone_std(state &s) {
+  const std::string str(long_text);
+  while (s.keep_running()) {
+    std::string copy = str;
+    do_not_optimize(copy.data());
+  }
+  s.set_items_processed(s.iterations());
+}
+RELOCO_BENCHMARK(bm_string_clone_std);
+
+// flat_set against std::set and the <algorithm> set operations
+
+void bm_flat_set_insert_reloco(state &s) {
+  const auto keys = random_keys(static_cast<std::size_t>(s.arg()));
+  while (s.keep_running()) {
+    auto set = reloco::flat_set<std::int32_t>::try_create().value();
+    for (const auto k : keys)
+      do_not_optimize(set.try_insert(std::int32_t{k}));
+    do_not_optimize(set.size());
+  }
+  s.set_items_processed(s.iterations() * keys.size());
+}
+RELOCO_BENCHMARK(bm_flat_set_insert_reloco, 1 << 8, 1 << 12);
+
+void bm_flat_set_insert_std_set(state &s) {
+  const auto keys = random_keys(static_cast<std::size_t>(s.arg()));
+  while (s.keep_running()) {
+    std::set<std::int32_t> set;
+    for (const auto k : keys)
+      set.insert(k);
+    do_not_optimize(set.size());
+  }
+  s.set_items_processed(s.iterations() * keys.size());
+}
+RELOCO_BENCHMARK(bm_flat_set_insert_std_set, 1 << 8, 1 << 12);
+
+void bm_flat_set_contains_reloco(state &s) {
+  const auto keys = random_keys(static_cast<std::size_t>(s.arg()));
+  auto set = reloco::flat_set<std::int32_t>::try_create().value();
+  for (const auto k : keys)
+    do_not_optimize(set.try_insert(std::int32_t{k}));
+  const auto probes = random_keys(1024, 7);
+  while (s.keep_running())
+    for (const auto k : probes)
+      do_not_optimize(set.contains(k));
+  s.set_items_processed(s.iterations() * probes.size());
+}
+RELOCO_BENCHMARK(bm_flat_set_contains_reloco, 1 << 8, 1 << 16);
+
+void bm_flat_set_contains_std_set(state &s) {
+  const auto keys = random_keys(static_cast<std::size_t>(s.arg()));
+  const std::set<std::int32_t> set(keys.begin(), keys.end());
+  const auto probes = random_keys(1024, 7);
+  while (s.keep_running())
+    for (const auto k : probes)
+      do_not_optimize(set.count(k));
+  s.set_items_processed(s.iterations() * probes.size());
+}
+RELOCO_BENCHMARK(bm_flat_set_contains_std_set, 1 << 8, 1 << 16);
+
+/**
+ * Set operation inputs: ``a`` holds n even numbers, ``b`` holds n / skew
+ * multiples of three spread over the same range, so they half-overlap.
+ */
+struct set_inputs {
+  std::vector<std::int32_t> a;
+  std::vector<std::int32_t> b;
+
+  set_inputs(const std::size_t n, const std::size_t skew) {
+    for (std::size_t i = 0; i < n; ++i)
+      a.push_back(static_cast<std::int32_t>(2 * i));
+    const std::size_t m = std::max<std::size_t>(1, n / skew);
+    for (std::size_t i = 0; i < m; ++i)
+      b.push_back(static_cast<std::int32_t>(3 * i * skew));
+  }
+
+  static reloco::flat_set<std::int32_t>
+  to_flat_set(const std::vector<std::int32_t> &sorted) {
+    auto set = reloco::flat_set<std::int32_t>::try_create().value();
+    for (const auto v : sorted)
+      do_not_optimize(set.try_insert(std::int32_t{v}));
+    return set;
+  }
+};
+
+constexpr std::int64_t set_op_n = 1 << 16;
+
+/// The argument is the size ratio of the two inputs
+void bm_flat_set_intersection_reloco(state &s) {
+  const set_inputs in(set_op_n, static_cast<std::size_t>(s.arg()));
+  const auto a = set_inputs::to_flat_set(in.a);
+  const auto b = set_inputs::to_flat_set(in.b);
+  while (s.keep_running()) {
+    auto out = a.try_set_intersection(b);
+    do_not_optimize(out);
+  }
+  s.set_items_processed(s.iterations() * (in.a.size() + in.b.size()));
+}
+RELOCO_BENCHMARK(bm_flat_set_intersection_reloco, 1, 64);
+
+void bm_flat_set_intersection_std(state &s) {
+  const set_inputs in(set_op_n, static_cast<std::size_t>(s.arg()));
+  std::vector<std::int32_t> out;
+  while (s.keep_running()) {
+    out.clear();
+    std::set_intersection(in.a.begin(), in.a.end(), in.b.begin(), in.b.end(),
+                          std::back_inserter(out));
+    do_not_optimize(out.data());
+  }
+  s.set_items_processed(s.iterations() * (in.a.size() + in.b.size()));
+}
+RELOCO_BENCHMARK(bm_flat_set_intersection_std, 1, 64);
+
+void bm_flat_set_union_reloco(state &s) {
+  const set_inputs in(set_op_n, static_cast<std::size_t>(s.arg()));
+  const auto a = set_inputs::to_flat_set(in.a);
+  const auto b = set_inputs::to_flat_set(in.b);
+  while (s.keep_running()) {
+    auto out = a.try_set_union(b);
+    do_not_optimize(out);
+  }
+  s.set_items_processed(s.iterations() * (in.a.size() + in.b.size()));
+}
+RELOCO_BENCHMARK(bm_flat_set_union_reloco, 1, 64);
+
+void bm_flat_set_union_std(state &s) {
+  const set_inputs in(set_op_n, static_cast<std::size_t>(s.arg()));
+  std::vector<std::int32_t> out;
+  while (s.keep_running()) {
+    out.clear();
+    std::set_union(in.a.begin(), in.a.end(), in.b.begin(), in.b.end(),
+                   std::back_inserter(out));
+    do_not_optimize(out.data());
+  }
+  s.set_items_processed(s.iterations() * (in.a.size() + in.b.size()));
+}
+RELOCO_BENCHMARK(bm_flat_set_union_std, 1, 64);
+
+void bm_flat_set_difference_reloco(state &s) {
+  const set_inputs in(set_op_n, static_cast<std::size_t>(s.arg()));
+  const auto a = set_inputs::to_flat_set(in.a);
+  const auto b = set_inputs::to_flat_set(in.b);
+  while (s.keep_running()) {
+    auto out = a.try_set_difference(b);
+    do_not_optimize(out);
+  }
+  s.set_items_processed(s.iterations() * (in.a.size() + in.b.size()));
+}
+RELOCO_BENCHMARK(bm_flat_set_difference_reloco, 1, 64);
+
+void bm_flat_set_difference_std(state &s) {
+  const set_inputs in(set_op_n, static_cast<std::size_t>(s.arg()));
+  std::vector<std::int32_t> out;
+  while (s.keep_running()) {
+    out.clear();
+    std::set_difference(in.a.begin(), in.a.end(), in.b.begin(), in.b.end(),
+                        std::back_inserter(out));
+    do_not_optimize(out.data());
+  }
+  s.set_items_processed(s.iterations() * (in.a.size() + in.b.size()));
+}
+RELOCO_BENCHMARK(bm_flat_set_difference_std, 1, 64);
+
+// function
+
+struct big_capture {
+  std::int64_t values[8]; // past the inline buffer of both function types
+  std::int64_t operator()(std::int64_t x) const noexcept {
+    return x + values[x & 7];
+  }
+};
+
+/// 0 captures one word (stored inline), 1 a 64-byte object (heap)
+void bm_function_create_reloco(state &s) {
+  const std::int64_t bias = s.arg();
+  while (s.keep_running()) {
+    if (s.arg() == 0) {
+      auto f = reloco::function<std::int64_t(std::int64_t)>::try_create(
+          [bias](std::int64_t x) noexcept { return x + bias; });
+      do_not_optimize(f);
+    } else {
+      auto f = reloco::function<std::int64_t(std::int64_t)>::try_create(
+          big_capture{});
+      do_not_optimize(f);
+    }
+  }
+  s.set_items_processed(s.iterations());
+}
+RELOCO_BENCHMARK(bm_function_create_reloco, 0, 1);
+
+void bm_function_create_std(state &s) {
+  const std::int64_t bias = s.arg();
+  while (s.keep_running()) {
+    if (s.arg() == 0) {
+      std::function<std::int64_t(std::int64_t)> f =
+          [bias](std::int64_t x) noexcept { return x + bias; };
+      do_not_optimize(f);
+    } else {
+      std::function<std::int64_t(std::int64_t)> f = big_capture{};
+      do_not_optimize(f);
+    }
+  }
+  s.set_items_processed(s.iterations());
+}
+RELOCO_BENCHMARK(bm_function_create_std, 0, 1);
+
+void bm_function_call_reloco(state &s) {
+  const std::int64_t bias = 3;
+  const auto f = reloco::function<std::int64_t(std::int64_t)>::try_create(
+                     [bias](std::int64_t x) noexcept { return x + bias; })
+                     .value();
+  std::int64_t acc = 0;
+  while (s.keep_running()) {
+    do_not_optimize(f);
+    acc = f(std::int64_t{acc});
+  }
+  do_not_optimize(acc);
+  s.set_items_processed(s.iterations());
+}
+RELOCO_BENCHMARK(bm_function_call_reloco);
+
+void bm_function_call_std(state &s) {
+  const std::int64_t bias = 3;
+  const std::function<std::int64_t(std::int64_t)> f =
+      [bias](std::int64_t x) noexcept { return x + bias; };
+  std::int64_t acc = 0;
+  while (s.keep_running()) {
+    do_not_optimize(f);
+    acc = f(acc);
+  }
+  do_not_optimize(acc);
+  s.set_items_processed(s.iterations());
+}
+RELOCO_BENCHMARK(bm_function_call_std);
+
+// shared_ptr
+
+void bm_shared_ptr_make_reloco(state &s) {
+  while (s.keep_running()) {
+    auto p = reloco::try_make_shared<std::int64_t>(42);
+    do_not_optimize(p);
+  }
+  s.set_items_processed(s.iterations());
+}
+RELOCO_BENCHMARK(bm_shared_ptr_make_reloco);
+
+void bm_shared_ptr_make_std(state &s) {
+  while (s.keep_running()) {
+    auto p = std::make_shared<std::int64_t>(42);
+    do_not_optimize(p);
+  }
+  s.set_items_processed(s.iterations());
+}
+RELOCO_BENCHMARK(bm_shared_ptr_make_std);
+
+void bm_shared_ptr_copy_reloco(state &s) {
+  const auto p = reloco::try_make_shared<std::int64_t>(42).value();
+  while (s.keep_running()) {
+    reloco::shared_ptr<std::int64_t> copy = p;
+    do_not_optimize(copy);
+  }
+  s.set_items_processed(s.iterations());
+}
+RELOCO_BENCHMARK(bm_shared_ptr_copy_reloco);
+
+void bm_shared_ptr_copy_std(state &s) {
+  const auto p = std::make_shared<std::int64_t>(42);
+  while (s.keep_running()) {
+    std::shared_ptr<std::int64_t> copy = p;
+    do_not_optimize(copy);
+  }
+  s.set_items_processed(s.iterations());
+}
+RELOCO_BENCHMARK(bm_shared_ptr_copy_std);
+
+} // namespace
@@ -0,0 +1,407 @@
+#include "harness.hpp"
+#include <algorithm>
+#include <mutex>
+#include <reloco/collection_view.hpp>
+#include <reloco/core.hpp>
+#include <reloco/mutex.hpp>
+#include <reloco/radix_sort.hpp>
+#include <reloco/simd.hpp>
+#include <reloco/spinlock.hpp>
+#include <reloco/thread_pool.hpp>
+#include <reloco/vector.hpp>
+#include <thread>
+#include <vector>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define RELOCO_BENCH_NOINLINE __attribute__((noinline))
+#elif defined(_MSC_VER)
+#define RELOCO_BENCH_NOINLINE __declspec(noinline)
+#else
+#define RELOCO_BENCH_NOINLINE
+#endif
+
+using reloco::bench::do_not_optimize;
+using reloco::bench::state;
+
+namespace {
+
+// result<T> layout: a pointer has a niche and travels in one register, an
+// integer of the same size needs the separate has-value flag.
+
+static_assert(sizeof(reloco::result<const int *>) == sizeof(const int *));
+static_assert(sizeof(reloco::result<std::uintptr_t>) >
+              sizeof(std::uintptr_t));
+
+int niche_storage[64];
+
+RELOCO_BENCH_NOINLINE reloco::result<const int *>
+lookup_niche(const std::size_t i) noexcept {
+  if (i >= 64)
+    return RELOCO_ERROR(reloco::error::out_of_range);
+  return niche_storage + i;
+}
+
+RELOCO_BENCH_NOINLINE reloco::result<std::uintptr_t>
+lookup_tagged(const std::size_t i) noexcept {
+  if (i >= 64)
+    return RELOCO_ERROR(reloco::error::out_of_range);
+  return reinterpret_cast<std::uintptr_t>(niche_storage + i);
+}
+
+void bm_result_niche_pointer(state &s) {
+  std::uintptr_t acc = 0;
+  while (s.keep_running())
+    for (std::size_t i = 0; i < 64; ++i)
+      acc += reinterpret_cast<std::uintptr_t>(*lookup_niche(i));
+  do_not_optimize(acc);
+  s.set_items_processed(s.iterations() * 64);
+}
+RELOCO_BENCHMARK(bm_result_niche_pointer);
+
+void bm_result_tagged_integer(state &s) {
+  std::uintptr_t acc = 0;
+  while (s.keep_running())
+    for (std::size_t i = 0; i < 64; ++i)
+      acc += *lookup_tagged(i);
+  do_not_optimize(acc);
+  s.set_items_processed(s.iterations() * 64);
+}
+RELOCO_BENCHMARK(bm_result_tagged_integer);
+
+// Error propagation through three calls: RELOCO_TRY_ASSIGN against the
+// hand-written check it replaced. Neither path ever fails here.
+
+RELOCO_BENCH_NOINLINE reloco::result<int> parse_digit(const char c) noexcept {
+  if (c < '0' || c > '9')
+    return RELOCO_ERROR(reloco::error::invalid_argument);
+  return c - '0';
+}
+
+RELOCO_BENCH_NOINLINE reloco::result<int>
+parse_pair_macro(const char *text) noexcept {
+  RELOCO_TRY_ASSIGN(const int high, parse_digit(text[0]));
+  RELOCO_TRY_ASSIGN(const int low, parse_digit(text[1]));
+  return high * 10 + low;
+}
+
+RELOCO_BENCH_NOINLINE reloco::result<int>
+parse_pair_manual(const char *text) noexcept {
+  auto high = parse_digit(text[0]);
+  if (!high)
+    return reloco::unexpected(high.error());
+  auto low = parse_digit(text[1]);
+  if (!low)
+    return reloco::unexpected(low.error());
+  return *high * 10 + *low;
+}
+
+void bm_try_macro(state &s) {
+  const char text[] = "42";
+  int acc = 0;
+  while (s.keep_running()) {
+    do_not_optimize(text);
+    acc += parse_pair_macro(text).value();
+  }
+  do_not_optimize(acc);
+  s.set_items_processed(s.iterations());
+}
+RELOCO_BENCHMARK(bm_try_macro);
+
+void bm_try_manual(state &s) {
+  const char text[] = "42";
+  int acc = 0;
+  while (s.keep_running()) {
+    do_not_optimize(text);
+    acc += parse_pair_manual(text).value();
+  }
+  do_not_optimize(acc);
+  s.set_items_processed(s.iterations());
+}
+RELOCO_BENCHMARK(bm_try_manual);
+
+// any_view: element-wise virtual access against chunked iteration
+
+reloco::vector<int> iota_vector(const std::size_t n) {
+  reloco::vector<int> v;
+  for (std::size_t i = 0; i < n; ++i)
+    do_not_optimize(v.try_push_back(static_cast<int>(i & 0xff)));
+  return v;
+}
+
+using int_view =
+    reloco::collection_view<reloco::vector<int>, reloco::policy::non_owner>;
+
+void bm_any_view_sum_elements(state &s) {
+  auto v = iota_vector(static_cast<std::size_t>(s.arg()));
+  auto view = reloco::any_view<int>::try_create(
+                  int_view(&v), reloco::get_default_allocator())
+                  .value();
+  while (s.keep_running()) {
+    long long sum = 0;
+    for (std::size_t i = 0; i < view.size(); ++i)
+      sum += view.try_at(i).value().get();
+    do_not_optimize(sum);
+  }
+  s.set_items_processed(s.iterations() * v.size());
+}
+RELOCO_BENCHMARK(bm_any_view_sum_elements, 1 << 16);
+
+void bm_any_view_sum_chunks(state &s) {
+  auto v = iota_vector(static_cast<std::size_t>(s.arg()));
+  auto view = reloco::any_view<int>::try_create(
+                  int_view(&v), reloco::get_default_allocator())
+                  .value();
+  while (s.keep_running()) {
+    long long sum = 0;
+    view.for_each_chunk([&](reloco::span<const int> chunk) noexcept {
+      for (const int x : chunk)
+        sum += x;
+    });
+    do_not_optimize(sum);
+  }
+  s.set_items_processed(s.iterations() * v.size());
+}
+RELOCO_BENCHMARK(bm_any_view_sum_chunks, 1 << 16);
+
+void bm_any_view_sum_vector(state &s) {
+  const auto v = iota_vector(static_cast<std::size_t>(s.arg()));
+  while (s.keep_running()) {
+    long long sum = 0;
+    for (const int x : v)
+      sum += x;
+    do_not_optimize(sum);
+  }
+  s.set_items_processed(s.iterations() * v.size());
+}
+RELOCO_BENCHMARK(bm_any_view_sum_vector, 1 << 16);
+
+// simd kernels, one run per instruction set; the argument is the
+// reloco::simd::isa level (0 scalar, 1 SSE2, 2 AVX2, 3 AVX-512)
+
+constexpr std::size_t simd_n = 1 << 16;
+
+/**
+ * Pins the kernels to the level given as argument for one benchmark run.
+ */
+class scoped_isa {
+  reloco::simd::isa m_previous = reloco::simd::active_isa();
+  bool m_ok;
+
+public:
+  explicit scoped_isa(state &s)
+      : m_ok(reloco::simd::try_select_isa(
+                 static_cast<reloco::simd::isa>(s.arg()))
+                 .has_value()) {
+    if (!m_ok)
+      s.skip("instruction set not supported");
+  }
+  ~scoped_isa() { std::ignore = reloco::simd::try_select_isa(m_previous); }
+};
+
+std::vector<float> simd_floats() {
+  reloco::bench::input_rng rng;
+  std::vector<float> v(simd_n);
+  for (auto &x : v)
+    x = static_cast<float>(rng.next() % 10000) / 100.0f;
+  return v;
+}
+
+std::vector<std::int32_t> simd_ints() {
+  reloco::bench::input_rng rng;
+  std::vector<std::int32_t> v(simd_n);
+  for (auto &x : v)
+    x = static_cast<std::int32_t>(rng.next() % 1000);
+  return v;
+}
+
+void bm_simd_sum_f32(state &s) {
+  const scoped_isa isa(s);
+  const auto v = simd_floats();
+  const reloco::span<const float> data(v.data(), v.size());
+  while (s.keep_running())
+    do_not_optimize(reloco::simd::sum(data));
+  s.set_bytes_processed(s.iterations() * simd_n * sizeof(float));
+}
+RELOCO_BENCHMARK(bm_simd_sum_f32, 0, 1, 2, 3);
+
+void bm_simd_minmax_f32(state &s) {
+  const scoped_isa isa(s);
+  const auto v = simd_floats();
+  const reloco::span<const float> data(v.data(), v.size());
+  while (s.keep_running())
+    do_not_optimize(reloco::simd::try_minmax(data));
+  s.set_bytes_processed(s.iterations() * simd_n * sizeof(float));
+}
+RELOCO_BENCHMARK(bm_simd_minmax_f32, 0, 1, 2, 3);
+
+void bm_simd_find_i32(state &s) {
+  const scoped_isa isa(s);
+  const auto v = simd_ints(); // values below 1000, so the search scans all
+  const reloco::span<const std::int32_t> data(v.data(), v.size());
+  while (s.keep_running())
+    do_not_optimize(reloco::simd::find(data, 5000));
+  s.set_bytes_processed(s.iterations() * simd_n * sizeof(std::int32_t));
+}
+RELOCO_BENCHMARK(bm_simd_find_i32, 0, 1, 2, 3);
+
+void bm_simd_count_i32(state &s) {
+  const scoped_isa isa(s);
+  const auto v = simd_ints();
+  const reloco::span<const std::int32_t> data(v.data(), v.size());
+  while (s.keep_running())
+    do_not_optimize(reloco::simd::count(data, 7));
+  s.set_bytes_processed(s.iterations() * simd_n * sizeof(std::int32_t));
+}
+RELOCO_BENCHMARK(bm_simd_count_i32, 0, 1, 2, 3);
+
+void bm_simd_dot_f32(state &s) {
+  const scoped_isa isa(s);
+  const auto a = simd_floats();
+  const auto b = simd_floats();
+  const reloco::span<const float> lhs(a.data(), a.size());
+  const reloco::span<const float> rhs(b.data(), b.size());
+  while (s.keep_running())
+    do_not_optimize(reloco::simd::try_dot(lhs, rhs));
+  s.set_bytes_processed(s.iterations() * 2 * simd_n * sizeof(float));
+}
+RELOCO_BENCHMARK(bm_simd_dot_f32, 0, 1, 2, 3);
+
+void bm_simd_clamp_i32(state &s) {
+  const scoped_isa isa(s);
+  auto v = simd_ints();
+  const reloco::span<std::int32_t> data(v.data(), v.size());
+  // Clamping is branch-free, so later passes over clamped data cost the same
+  while (s.keep_running()) {
+    std::ignore = reloco::simd::try_clamp<std::int32_t>(data, 100, 900);
+    do_not_optimize(v.data());
+  }
+  s.set_bytes_processed(s.iterations() * simd_n * sizeof(std::int32_t));
+}
+RELOCO_BENCHMARK(bm_simd_clamp_i32, 0, 1, 2, 3);
+
+void bm_simd_gather_f32(state &s) {
+  const scoped_isa isa(s);
+  const auto source = simd_floats();
+  reloco::bench::input_rng rng;
+  std::vector<std::uint32_t> indices(simd_n);
+  for (auto &i : indices)
+    i = static_cast<std::uint32_t>(rng.next() % simd_n);
+  std::vector<float> out(simd_n);
+  const reloco::span<const float> from(source.data(), source.size());
+  const reloco::span<const std::uint32_t> at(indices.data(), indices.size());
+  const reloco::span<float> into(out.data(), out.size());
+  while (s.keep_running()) {
+    std::ignore = reloco::simd::try_gather(from, at, into);
+    do_not_optimize(out.data());
+  }
+  s.set_items_processed(s.iterations() * simd_n);
+}
+RELOCO_BENCHMARK(bm_simd_gather_f32, 0, 1, 2, 3);
+
+// Sorting 32-bit keys; the argument is the element count
+
+std::vector<std::uint32_t> sort_input(const std::size_t n) {
+  reloco::bench::input_rng rng;
+  std::vector<std::uint32_t> v(n);
+  for (auto &x : v)
+    x = static_cast<std::uint32_t>(rng.next());
+  return v;
+}
+
+template <typename Sort> void run_sort(state &s, Sort &&sort) {
+  const auto input = sort_input(static_cast<std::size_t>(s.arg()));
+  std::vector<std::uint32_t> work(input.size());
+  while (s.keep_running()) {
+    s.pause_timing();
+    std::copy(input.begin(), input.end(), work.begin());
+    s.resume_timing();
+    sort(work);
+    do_not_optimize(work.data());
+  }
+  s.set_items_processed(s.iterations() * input.size());
+}
+
+void bm_sort_radix(state &s) {
+  run_sort(s, [](std::vector<std::uint32_t> &v) {
+    do_not_optimize(reloco::try_radix_sort(
+        reloco::span<std::uint32_t>(v.data(), v.size())));
+  });
+}
+RELOCO_BENCHMARK(bm_sort_radix, 1 << 10, 1 << 20, 1 << 24);
+
+void bm_sort_radix_parallel(state &s) {
+  reloco::thread_pool pool;
+  if (!pool.try_start(std::thread::hardware_concurrency()))
+    s.skip("cannot start worker threads");
+  run_sort(s, [&](std::vector<std::uint32_t> &v) {
+    do_not_optimize(reloco::try_parallel_radix_sort(
+        pool, reloco::span<std::uint32_t>(v.data(), v.size())));
+  });
+}
+RELOCO_BENCHMARK(bm_sort_radix_parallel, 1 << 20, 1 << 24);
+
+void bm_sort_std(state &s) {
+  run_sort(s, [](std::vector<std::uint32_t> &v) {
+    std::sort(v.begin(), v.end());
+  });
+}
+RELOCO_BENCHMARK(bm_sort_std, 1 << 10, 1 << 20, 1 << 24);
+
+// Locks under contention; the argument is the thread count and every
+// thread takes the lock lock_rounds times per iteration
+
+constexpr int lock_rounds = 10000;
+
+template <typename Lock, typename Unlock>
+void contend(state &s, Lock &&lock, Unlock &&unlock) {
+  const auto threads = static_cast<int>(s.arg());
+  std::uint64_t shared_counter = 0;
+  while (s.keep_running()) {
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+      workers.emplace_back([&] {
+        for (int i = 0; i < lock_rounds; ++i) {
+          lock();
+          ++shared_counter;
+          unlock();
+        }
+      });
+    for (auto &w : workers)
+      w.join();
+  }
+  do_not_optimize(shared_counter);
+  s.set_items_processed(s.iterations() * threads * lock_rounds);
+}
+
+void bm_lock_mcs(state &s) {
+  reloco::mcs_lock lock;
+  contend(
+      s, [&] { std::ignore = lock.lock(); },
+      [&] { std::ignore = lock.unlock(); });
+}
+RELOCO_BENCHMARK(bm_lock_mcs, 1, 2, 4, 8);
+
+void bm_lock_ticket(state &s) {
+  reloco::ticket_lock lock;
+  contend(
+      s, [&] { std::ignore = lock.lock(); },
+      [&] { std::ignore = lock.unlock(); });
+}
+RELOCO_BENCHMARK(bm_lock_ticket, 1, 2, 4, 8);
+
+void bm_lock_reloco_mutex(state &s) {
+  reloco::mutex lock;
+  contend(
+      s, [&] { std::ignore = lock.lock(); },
+      [&] { std::ignore = lock.unlock(); });
+}
+RELOCO_BENCHMARK(bm_lock_reloco_mutex, 1, 2, 4, 8);
+
+void bm_lock_std_mutex(state &s) {
+  std::mutex lock;
+  contend(
+      s, [&] { lock.lock(); }, [&] { lock.unlock(); });
+}
+RELOCO_BENCHMARK(bm_lock_std_mutex, 1, 2, 4, 8);
+
+} // namespace
@@ -0,0 +1,275 @@
+#ifndef _WIN32
+#include "harness.hpp"
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <reloco/file_io.hpp>
+#include <reloco/io_uring.hpp>
+#include <reloco/mapped_file.hpp>
+#include <reloco/serialization.hpp>
+#include <reloco/simd.hpp>
+#include <reloco/string.hpp>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using reloco::bench::do_not_optimize;
+using reloco::bench::state;
+
+namespace {
+
+/**
+ * @brief A file of ``mib`` MiB of ``key,value`` lines, created on first
+ * use and removed at exit. Reads come from the page cache, so these
+ * benchmarks measure per-byte and per-call overhead rather than the disk.
+ */
+class record_file {
+  std::string m_path;
+
+public:
+  explicit record_file(const std::size_t mib) {
+    char name[] = "/tmp/reloco_bench_XXXXXX";
+    const int fd = ::mkstemp(name);
+    if (fd < 0)
+      std::abort();
+    ::close(fd);
+    m_path = name;
+
+    std::ofstream out(m_path, std::ios::binary);
+    reloco::bench::input_rng rng;
+    const std::size_t target = mib << 20;
+    std::size_t written = 0;
+    char line[64];
+    for (std::uint64_t key = 0; written < target; ++key) {
+      const int n =
+          std::snprintf(line, sizeof(line), "%llu,%llu\n",
+                        static_cast<unsigned long long>(key),
+                        static_cast<unsigned long long>(rng.next() % 1000000));
+      out.write(line, n);
+      written += static_cast<std::size_t>(n);
+    }
+  }
+  ~record_file() { ::unlink(m_path.c_str()); }
+
+  record_file(const record_file &) = delete;
+  record_file &operator=(const record_file &) = delete;
+
+  const char *path() const { return m_path.c_str(); }
+
+  static const record_file &of_size(const std::size_t mib) {
+    static std::map<std::size_t, std::unique_ptr<record_file>> files;
+    auto &file = files[mib];
+    if (!file)
+      file = std::make_unique<record_file>(mib);
+    return *file;
+  }
+};
+
+std::size_t count_newlines(const reloco::span<const std::byte> bytes) {
+  if (bytes.empty())
+    return 0;
+  const reloco::span<const std::uint8_t> octets(
+      reinterpret_cast<const std::uint8_t *>(bytes.unsafe_data()),
+      bytes.size());
+  return reloco::simd::count(octets, std::uint8_t{'\n'});
+}
+
+// Scanning a whole file; the argument is its size in MiB
+
+void bm_scan_mapped_file(state &s) {
+  const auto &file = record_file::of_size(static_cast<std::size_t>(s.arg()));
+  reloco::mapped_file_options opts;
+  opts.hint = reloco::usage_hint::sequential;
+  std::size_t bytes = 0;
+  while (s.keep_running()) {
+    auto map = reloco::mapped_file::try_open(file.path(), opts).value();
+    do_not_optimize(count_newlines(map.bytes()));
+    bytes += map.size();
+  }
+  s.set_bytes_processed(bytes);
+}
+RELOCO_BENCHMARK(bm_scan_mapped_file, 64);
+
+void bm_scan_file_reader(state &s) {
+  const auto &file = record_file::of_size(static_cast<std::size_t>(s.arg()));
+  std::size_t bytes = 0;
+  while (s.keep_running()) {
+    auto reader = reloco::file_reader::try_open(file.path()).value();
+    while (reader.try_fill().value() != 0) {
+      const auto chunk = reader.buffered();
+      do_not_optimize(count_newlines(chunk));
+      bytes += chunk.size();
+      reader.consume(chunk.size());
+    }
+  }
+  s.set_bytes_processed(bytes);
+}
+RELOCO_BENCHMARK(bm_scan_file_reader, 64);
+
+void bm_scan_read_syscall(state &s) {
+  const auto &file = record_file::of_size(static_cast<std::size_t>(s.arg()));
+  std::vector<std::byte> buffer(1 << 16);
+  std::size_t bytes = 0;
+  while (s.keep_running()) {
+    const int fd = ::open(file.path(), O_RDONLY);
+    ssize_t n;
+    while ((n = ::read(fd, buffer.data(), buffer.size())) > 0) {
+      do_not_optimize(count_newlines(reloco::span<const std::byte>(
+          buffer.data(), static_cast<std::size_t>(n))));
+      bytes += static_cast<std::size_t>(n);
+    }
+    ::close(fd);
+  }
+  s.set_bytes_processed(bytes);
+}
+RELOCO_BENCHMARK(bm_scan_read_syscall, 64);
+
+// Parsing the key,value records line by line
+
+std::uint64_t parse_value(std::string_view line) {
+  const auto comma = line.find(',');
+  std::uint64_t value = 0;
+  if (comma != std::string_view::npos)
+    std::from_chars(line.data() + comma + 1, line.data() + line.size(),
+                    value);
+  return value;
+}
+
+void bm_parse_records_file_reader(state &s) {
+  const auto &file = record_file::of_size(static_cast<std::size_t>(s.arg()));
+  std::size_t bytes = 0;
+  while (s.keep_running()) {
+    auto reader = reloco::file_reader::try_open(file.path()).value();
+    std::uint64_t sum = 0;
+    for (auto line = reader.try_read_line(); line;
+         line = reader.try_read_line()) {
+      sum += parse_value(*line);
+      bytes += line->size() + 1;
+    }
+    do_not_optimize(sum);
+  }
+  s.set_bytes_processed(bytes);
+}
+RELOCO_BENCHMARK(bm_parse_records_file_reader, 16);
+
+void bm_parse_records_ifstream(state &s) {
+  const auto &file = record_file::of_size(static_cast<std::size_t>(s.arg()));
+  std::size_t bytes = 0;
+  while (s.keep_running()) {
+    std::ifstream in(file.path(), std::ios::binary);
+    std::string line;
+    std::uint64_t sum = 0;
+    while (std::getline(in, line)) {
+      sum += parse_value(line);
+      bytes += line.size() + 1;
+    }
+    do_not_optimize(sum);
+  }
+  s.set_bytes_processed(bytes);
+}
+RELOCO_BENCHMARK(bm_parse_records_ifstream, 16);
+
+// Serialization round trip; the argument is the number of strings
+
+void bm_serialization_round_trip(state &s) {
+  reloco::vector<reloco::string> names;
+  for (std::int64_t i = 0; i < s.arg(); ++i) {
+    auto name = reloco::string::try_create("record-").value();
+    do_not_optimize(name.try_append(std::to_string(i).c_str()));
+    do_not_optimize(names.try_push_back(std::move(name)));
+  }
+  reloco::vector<std::byte> bytes;
+  std::size_t processed = 0;
+  while (s.keep_running()) {
+    bytes.clear();
+    do_not_optimize(reloco::try_serialize(names, bytes));
+    const reloco::span<const std::byte> input(bytes.begin(), bytes.size());
+    auto view = reloco::try_deserialize<decltype(names)>(input).value();
+    std::size_t total = 0;
+    do_not_optimize(view.try_for_each([&](reloco::string_view name) noexcept {
+      total += name.size();
+    }));
+    do_not_optimize(total);
+    processed += bytes.size();
+  }
+  s.set_bytes_processed(processed);
+}
+RELOCO_BENCHMARK(bm_serialization_round_trip, 16, 4096);
+
+// Random 4 KiB reads; the argument is the number kept in flight
+
+constexpr std::size_t random_reads = 1024;
+constexpr std::size_t read_size = 4096;
+
+void random_reads_on(state &s, const bool force_fallback) {
+  const auto &file = record_file::of_size(64);
+  const int fd = ::open(file.path(), O_RDONLY);
+  const std::size_t depth = static_cast<std::size_t>(s.arg());
+  reloco::io_ring ring;
+  reloco::io_ring_options opts;
+  opts.queue_depth = static_cast<std::uint32_t>(depth);
+  opts.force_fallback = force_fallback;
+  if (!ring.try_init(opts)) {
+    s.skip("io_ring unavailable");
+  } else if (!force_fallback &&
+             ring.backend() != reloco::io_backend::io_uring) {
+    s.skip("kernel lacks io_uring");
+  }
+
+  // Buffers are reused round-robin; their contents are never looked at
+  std::vector<std::byte> buffers(depth * read_size);
+  std::vector<std::uint64_t> offsets(random_reads);
+  reloco::bench::input_rng rng;
+  for (auto &offset : offsets)
+    offset = rng.next() % ((64u << 20) / read_size) * read_size;
+
+  while (s.keep_running()) {
+    std::size_t issued = 0;
+    while (issued < random_reads) {
+      std::byte *into = buffers.data() + issued % depth * read_size;
+      auto queued = ring.try_read(
+          fd, reloco::span<std::byte>(into, read_size), offsets[issued],
+          [](reloco::result<std::size_t> n) { do_not_optimize(n); });
+      if (queued) {
+        ++issued;
+        continue;
+      }
+      do_not_optimize(ring.try_wait(1));
+    }
+    do_not_optimize(ring.try_wait(ring.in_flight()));
+  }
+  ::close(fd);
+  s.set_items_processed(s.iterations() * random_reads);
+}
+
+void bm_random_read_io_uring(state &s) { random_reads_on(s, false); }
+RELOCO_BENCHMARK(bm_random_read_io_uring, 1, 8, 64);
+
+void bm_random_read_thread_pool(state &s) { random_reads_on(s, true); }
+RELOCO_BENCHMARK(bm_random_read_thread_pool, 1, 8, 64);
+
+void bm_random_read_pread(state &s) {
+  const auto &file = record_file::of_size(64);
+  const int fd = ::open(file.path(), O_RDONLY);
+  std::vector<std::byte> buffer(read_size);
+  reloco::bench::input_rng rng;
+  std::vector<std::uint64_t> offsets(random_reads);
+  for (auto &offset : offsets)
+    offset = rng.next() % ((64u << 20) / read_size) * read_size;
+
+  while (s.keep_running())
+    for (const auto offset : offsets)
+      do_not_optimize(::pread(fd, buffer.data(), read_size,
+                              static_cast<off_t>(offset)));
+  ::close(fd);
+  s.set_items_processed(s.iterations() * random_reads);
+}
+RELOCO_BENCHMARK(bm_random_read_pread);
+
+} // namespace
+
+#endif
@@ -0,0 +1,87 @@
+#include "harness.hpp"
+#include <map>
+#include <memory>
+#include <reloco/map.hpp>
+#include <reloco/stack_allocator.hpp>
+#include <vector>
+
+using reloco::bench::do_not_optimize;
+using reloco::bench::state;
+
+namespace {
+
+std::vector<std::int64_t> random_keys(const std::size_t n) {
+  reloco::bench::input_rng rng;
+  std::vector<std::int64_t> keys(n);
+  for (auto &k : keys)
+    k = static_cast<std::int64_t>(rng.next() >> 1);
+  return keys;
+}
+
+void bm_map_insert_reloco(state &s) {
+  const auto keys = random_keys(static_cast<std::size_t>(s.arg()));
+  while (s.keep_running()) {
+    reloco::map<std::int64_t, std::int64_t> m;
+    for (const auto k : keys)
+      do_not_optimize(m.try_insert(k, k));
+    do_not_optimize(m.size());
+  }
+  s.set_items_processed(s.iterations() * keys.size());
+}
+RELOCO_BENCHMARK(bm_map_insert_reloco, 1 << 8, 1 << 16);
+
+/**
+ * Nodes from an arena: teardown skips the per-node frees entirely.
+ */
+void bm_map_insert_reloco_arena(state &s) {
+  const auto keys = random_keys(static_cast<std::size_t>(s.arg()));
+  const std::size_t arena_size = keys.size() * 128;
+  const auto arena = std::make_unique<std::byte[]>(arena_size);
+  while (s.keep_running()) {
+    reloco::stack_allocator alloc(arena.get(), arena_size);
+    reloco::map<std::int64_t, std::int64_t> m(alloc);
+    for (const auto k : keys)
+      do_not_optimize(m.try_insert(k, k));
+    do_not_optimize(m.size());
+  }
+  s.set_items_processed(s.iterations() * keys.size());
+}
+RELOCO_BENCHMARK(bm_map_insert_reloco_arena, 1 << 8, 1 << 16);
+
+void bm_map_insert_std(state &s) {
+  const auto keys = random_keys(static_cast<std::size_t>(s.arg()));
+  while (s.keep_running()) {
+    std::map<std::int64_t, std::int64_t> m;
+    for (const auto k : keys)
+      m.emplace(k, k);
+    do_not_optimize(m.size());
+  }
+  s.set_items_processed(s.iterations() * keys.size());
+}
+RELOCO_BENCHMARK(bm_map_insert_std, 1 << 8, 1 << 16);
+
+void bm_map_find_reloco(state &s) {
+  const auto keys = random_keys(static_cast<std::size_t>(s.arg()));
+  reloco::map<std::int64_t, std::int64_t> m;
+  for (const auto k : keys)
+    do_not_optimize(m.try_insert(k, k));
+  while (s.keep_running())
+    for (const auto k : keys)
+      do_not_optimize(m.contains(k));
+  s.set_items_processed(s.iterations() * keys.size());
+}
+RELOCO_BENCHMARK(bm_map_find_reloco, 1 << 8, 1 << 16);
+
+void bm_map_find_std(state &s) {
+  const auto keys = random_keys(static_cast<std::size_t>(s.arg()));
+  std::map<std::int64_t, std::int64_t> m;
+  for (const auto k : keys)
+    m.emplace(k, k);
+  while (s.keep_running())
+    for (const auto k : keys)
+      do_not_optimize(m.count(k));
+  s.set_items_processed(s.iterations() * keys.size());
+}
+RELOCO_BENCHMARK(bm_map_find_std, 1 << 8, 1 << 16);
+
+} // namespace
@@ -0,0 +1,196 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+namespace reloco::bench {
+
+/**
+ * @brief Timing state handed to a benchmark body. It mirrors the parts of
+ * Google Benchmark's ``benchmark::State`` the suite needs, so bodies port
+ * between the two with little more than renaming.
+ *
+ * @code
+ * void bm_sum(reloco::bench::state &s) {
+ *   const auto data = make_input(s.arg());
+ *   while (s.keep_running())
+ *     reloco::bench::do_not_optimize(sum(data));
+ *   s.set_items_processed(s.iterations() * s.arg());
+ * }
+ * RELOCO_BENCHMARK(bm_sum, 1 << 10, 1 << 20);
+ * @endcode
+ */
+class state {
+  using clock = std::chrono::steady_clock;
+
+  std::uint64_t m_iterations;
+  std::uint64_t m_remaining = 0;
+  std::int64_t m_arg;
+  bool m_started = false;
+  bool m_running = false;
+  clock::time_point m_start;
+  clock::duration m_elapsed{};
+  std::clock_t m_cpu_start = 0;
+  std::clock_t m_cpu_elapsed = 0;
+  std::uint64_t m_items = 0;
+  std::uint64_t m_bytes = 0;
+  std::string m_skip_reason;
+
+  bool start_or_finish() noexcept {
+    if (!m_started && m_skip_reason.empty() && m_iterations != 0) {
+      m_started = true;
+      m_remaining = m_iterations - 1;
+      resume_timing();
+      return true;
+    }
+    if (m_running)
+      pause_timing();
+    return false;
+  }
+
+public:
+  state(const std::uint64_t iterations, const std::int64_t arg) noexcept
+      : m_iterations(iterations), m_arg(arg) {}
+
+  state(const state &) = delete;
+  state &operator=(const state &) = delete;
+
+  /**
+   * @brief Loop condition of the timed region: true exactly
+   * ``iterations()`` times. The clock starts on the first call and stops
+   * when it returns false.
+   */
+  bool keep_running() noexcept {
+    if (m_remaining != 0) [[likely]] {
+      --m_remaining;
+      return true;
+    }
+    return start_or_finish();
+  }
+
+  /**
+   * @brief Excludes per-iteration setup, such as refilling an input that
+   * the body sorts in place, from the measurement.
+   */
+  void pause_timing() noexcept {
+    m_elapsed += clock::now() - m_start;
+    m_cpu_elapsed += std::clock() - m_cpu_start;
+    m_running = false;
+  }
+
+  void resume_timing() noexcept {
+    m_running = true;
+    m_cpu_start = std::clock();
+    m_start = clock::now();
+  }
+
+  /**
+   * @brief Marks the benchmark as not applicable here, e.g. an instruction
+   * set the CPU lacks. The loop is then never entered.
+   */
+  void skip(std::string reason) { m_skip_reason = std::move(reason); }
+
+  void set_items_processed(const std::uint64_t items) noexcept {
+    m_items = items;
+  }
+  void set_bytes_processed(const std::uint64_t bytes) noexcept {
+    m_bytes = bytes;
+  }
+
+  [[nodiscard]] std::int64_t arg() const noexcept { return m_arg; }
+  [[nodiscard]] std::uint64_t iterations() const noexcept {
+    return m_iterations;
+  }
+  [[nodiscard]] std::uint64_t items_processed() const noexcept {
+    return m_items;
+  }
+  [[nodiscard]] std::uint64_t bytes_processed() const noexcept {
+    return m_bytes;
+  }
+  [[nodiscard]] bool started() const noexcept { return m_started; }
+  [[nodiscard]] const std::string &skip_reason() const noexcept {
+    return m_skip_reason;
+  }
+
+  [[nodiscard]] double real_seconds() const noexcept {
+    return std::chrono::duration<double>(m_elapsed).count();
+  }
+  /// Process CPU time, so it counts every thread the body runs
+  [[nodiscard]] double cpu_seconds() const noexcept {
+    return static_cast<double>(m_cpu_elapsed) / CLOCKS_PER_SEC;
+  }
+};
+
+/**
+ * @brief Keeps ``value`` from being optimized away without adding a store.
+ */
+template <typename T> inline void do_not_optimize(const T &value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  const volatile auto *sink = &value;
+  (void)*sink;
+#endif
+}
+
+/**
+ * @brief Forces pending writes to memory to be considered observable.
+ */
+inline void clobber_memory() noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : : "memory");
+#endif
+}
+
+/**
+ * @brief Deterministic input generator (splitmix64), so every run and
+ * every commit measures the same data.
+ */
+class input_rng {
+  std::uint64_t m_state;
+
+public:
+  explicit input_rng(const std::uint64_t seed = 0x5eed) noexcept
+      : m_state(seed) {}
+
+  std::uint64_t next() noexcept {
+    std::uint64_t z = (m_state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+  }
+};
+
+using benchmark_fn = void (*)(state &);
+
+struct registration {
+  const char *name;
+  benchmark_fn fn;
+  /// One run per argument; none means a single run with ``arg() == 0``
+  std::vector<std::int64_t> args;
+};
+
+inline std::vector<registration> &registry() {
+  static std::vector<registration> benchmarks;
+  return benchmarks;
+}
+
+inline bool register_benchmark(const char *name, const benchmark_fn fn,
+                               std::initializer_list<std::int64_t> args) {
+  registry().push_back({name, fn, args});
+  return true;
+}
+
+} // namespace reloco::bench
+
+/**
+ * @def RELOCO_BENCHMARK
+ * @brief Registers ``fn`` to run once for each of the optional arguments,
+ * reported as ``fn/arg``.
+ */
+#define RELOCO_BENCHMARK(fn, ...)                                              \
+  [[maybe_unused]] static const bool reloco_bench_registered_##fn =            \
+      ::reloco::bench::register_benchmark(#fn, fn, {__VA_ARGS__})
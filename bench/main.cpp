@@ -0,0 +1,265 @@
+#include "harness.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <reloco/simd.hpp>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct options {
+  std::string filter;
+  double min_time = 0.5;
+  int repetitions = 1;
+  std::string json_path;
+  bool list = false;
+};
+
+struct run_report {
+  std::string name;
+  std::uint64_t iterations = 0;
+  double real_ns = 0; ///< Per iteration
+  double cpu_ns = 0;  ///< Per iteration
+  double items_per_second = 0;
+  double bytes_per_second = 0;
+  std::string skip_reason;
+};
+
+constexpr std::uint64_t max_iterations = 1'000'000'000;
+
+void print_usage(const char *argv0) {
+  std::cerr
+      << "usage: " << argv0 << " [options]\n"
+      << "  --filter=TEXT      run benchmarks whose name contains TEXT\n"
+      << "  --min-time=SEC     time each benchmark for at least SEC (0.5)\n"
+      << "  --repetitions=N    report N runs of each benchmark (1)\n"
+      << "  --json=PATH        also write results as JSON, '-' for stdout\n"
+      << "  --list             print the benchmark names and exit\n";
+}
+
+bool parse_options(int argc, char **argv, options &opts) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg = argv[i];
+    const auto value_of = [&](std::string_view flag) -> const char * {
+      if (arg.size() > flag.size() && arg.substr(0, flag.size()) == flag &&
+          arg[flag.size()] == '=')
+        return argv[i] + flag.size() + 1;
+      return nullptr;
+    };
+    if (const char *v = value_of("--filter")) {
+      opts.filter = v;
+    } else if (const char *v = value_of("--min-time")) {
+      opts.min_time = std::strtod(v, nullptr);
+    } else if (const char *v = value_of("--repetitions")) {
+      opts.repetitions = std::max(1, std::atoi(v));
+    } else if (const char *v = value_of("--json")) {
+      opts.json_path = v;
+    } else if (arg == "--list") {
+      opts.list = true;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::string run_name(const reloco::bench::registration &reg,
+                     const std::int64_t arg) {
+  std::string name = reg.name;
+  if (!reg.args.empty()) {
+    name += '/';
+    name += std::to_string(arg);
+  }
+  return name;
+}
+
+/**
+ * @brief Grows the iteration count until one run lasts ``min_time``, like
+ * Google Benchmark does, and reports that run.
+ */
+run_report measure(const reloco::bench::registration &reg,
+                   const std::int64_t arg, const double min_time,
+                   std::uint64_t &iterations) {
+  run_report report;
+  report.name = run_name(reg, arg);
+  while (true) {
+    reloco::bench::state s(iterations, arg);
+    reg.fn(s);
+    if (!s.skip_reason().empty()) {
+      report.skip_reason = s.skip_reason();
+      return report;
+    }
+    if (!s.started()) {
+      report.skip_reason = "body never called keep_running()";
+      return report;
+    }
+    const double seconds = s.real_seconds();
+    if (seconds >= min_time || iterations >= max_iterations) {
+      const auto n = static_cast<double>(iterations);
+      report.iterations = iterations;
+      report.real_ns = seconds * 1e9 / n;
+      report.cpu_ns = s.cpu_seconds() * 1e9 / n;
+      if (seconds > 0) {
+        report.items_per_second =
+            static_cast<double>(s.items_processed()) / seconds;
+        report.bytes_per_second =
+            static_cast<double>(s.bytes_processed()) / seconds;
+      }
+      return report;
+    }
+    // Aim 40% past the target; runs too short to trust grow tenfold
+    double factor = seconds / min_time > 0.1 ? min_time * 1.4 / seconds : 10;
+    factor = std::clamp(factor, 2.0, 100.0);
+    iterations = std::min<std::uint64_t>(
+        max_iterations,
+        static_cast<std::uint64_t>(static_cast<double>(iterations) * factor));
+  }
+}
+
+std::string json_escape(std::string_view text) {
+  std::string out;
+  for (const char c : text) {
+    if (c == '"' || c == '\\')
+      out += '\\';
+    if (static_cast<unsigned char>(c) < 0x20)
+      out += ' ';
+    else
+      out += c;
+  }
+  return out;
+}
+
+const char *isa_name(const reloco::simd::isa level) {
+  switch (level) {
+  case reloco::simd::isa::sse2:
+    return "sse2";
+  case reloco::simd::isa::avx2:
+    return "avx2";
+  case reloco::simd::isa::avx512:
+    return "avx512";
+  default:
+    return "scalar";
+  }
+}
+
+/**
+ * @brief Google Benchmark's JSON layout, so its tools/compare.py can diff
+ * two runs of reloco_bench.
+ */
+void write_json(std::ostream &out, const char *argv0,
+                const std::vector<run_report> &reports) {
+  char date[64];
+  const std::time_t now = std::time(nullptr);
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z",
+                std::localtime(&now));
+
+  out << "{\n  \"context\": {\n"
+      << "    \"date\": \"" << date << "\",\n"
+      << "    \"executable\": \"" << json_escape(argv0) << "\",\n"
+      << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+#ifdef NDEBUG
+      << "    \"library_build_type\": \"release\",\n"
+#else
+      << "    \"library_build_type\": \"debug\",\n"
+#endif
+      << "    \"simd_isa\": \"" << isa_name(reloco::simd::best_isa())
+      << "\"\n  },\n  \"benchmarks\": [";
+  bool first = true;
+  for (const auto &r : reports) {
+    if (!r.skip_reason.empty())
+      continue;
+    out << (first ? "\n" : ",\n") << "    {\n"
+        << "      \"name\": \"" << json_escape(r.name) << "\",\n"
+        << "      \"run_name\": \"" << json_escape(r.name) << "\",\n"
+        << "      \"run_type\": \"iteration\",\n"
+        << "      \"iterations\": " << r.iterations << ",\n"
+        << "      \"real_time\": " << r.real_ns << ",\n"
+        << "      \"cpu_time\": " << r.cpu_ns << ",\n"
+        << "      \"time_unit\": \"ns\"";
+    if (r.items_per_second > 0)
+      out << ",\n      \"items_per_second\": " << r.items_per_second;
+    if (r.bytes_per_second > 0)
+      out << ",\n      \"bytes_per_second\": " << r.bytes_per_second;
+    out << "\n    }";
+    first = false;
+  }
+  out << "\n  ]\n}\n";
+}
+
+void print_row(const run_report &r) {
+  if (!r.skip_reason.empty()) {
+    std::printf("%-48s skipped: %s\n", r.name.c_str(), r.skip_reason.c_str());
+    return;
+  }
+  std::printf("%-48s %12.1f ns %12.1f ns %12llu", r.name.c_str(), r.real_ns,
+              r.cpu_ns, static_cast<unsigned long long>(r.iterations));
+  if (r.bytes_per_second > 0)
+    std::printf("  %9.2f MiB/s", r.bytes_per_second / (1 << 20));
+  else if (r.items_per_second > 0)
+    std::printf("  %9.3f M items/s", r.items_per_second / 1e6);
+  std::printf("\n");
+  std::fflush(stdout);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  options opts;
+  if (!parse_options(argc, argv, opts)) {
+    print_usage(argv[0]);
+    return 2;
+  }
+
+  auto &benchmarks = reloco::bench::registry();
+  std::sort(benchmarks.begin(), benchmarks.end(),
+            [](const auto &a, const auto &b) {
+              return std::strcmp(a.name, b.name) < 0;
+            });
+
+  const bool console = opts.json_path != "-";
+  if (console && !opts.list)
+    std::printf("%-48s %15s %15s %12s\n", "benchmark", "time", "cpu",
+                "iterations");
+
+  std::vector<run_report> reports;
+  for (const auto &reg : benchmarks) {
+    std::vector<std::int64_t> args = reg.args;
+    if (args.empty())
+      args.push_back(0);
+    for (const std::int64_t arg : args) {
+      if (run_name(reg, arg).find(opts.filter) == std::string::npos)
+        continue;
+      if (opts.list) {
+        std::printf("%s\n", run_name(reg, arg).c_str());
+        continue;
+      }
+      std::uint64_t iterations = 1;
+      for (int rep = 0; rep < opts.repetitions; ++rep) {
+        reports.push_back(measure(reg, arg, opts.min_time, iterations));
+        if (console)
+          print_row(reports.back());
+        if (!reports.back().skip_reason.empty())
+          break;
+      }
+    }
+  }
+
+  if (opts.json_path == "-") {
+    write_json(std::cout, argv[0], reports);
+  } else if (!opts.json_path.empty()) {
+    std::ofstream file(opts.json_path);
+    if (!file) {
+      std::cerr << "cannot write " << opts.json_path << "\n";
+      return 1;
+    }
+    write_json(file, argv[0], reports);
+  }
+  return 0;
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include <atomic>
 #if defined(_WIN32)
 #include <reloco/win_allocator.hpp>
 #else
@@ -13,9 +14,72 @@ using core_allocator = win_allocator;
 using core_allocator = posix_allocator;
 #endif
 
-inline core_allocator &get_default_allocator() noexcept {
+namespace detail {
+
+inline std::atomic<fallible_allocator *> &
+installed_default_allocator() noexcept {
+  static std::atomic<fallible_allocator *> installed{nullptr};
+  return installed;
+}
+
+} // namespace detail
+
+/**
+ * @brief The platform allocator, which the default allocator is unless
+ * another one has been installed.
+ */
+inline core_allocator &get_core_allocator() noexcept {
   static core_allocator instance;
   return instance;
 }
 
+/**
+ * @brief The allocator used wherever none is passed explicitly.
+ */
+inline fallible_allocator &get_default_allocator() noexcept {
+  if (auto *installed = detail::installed_default_allocator().load(
+          std::memory_order_acquire)) [[unlikely]]
+    return *installed;
+  return get_core_allocator();
+}
+
+/**
+ * @brief Installs ``alloc`` as the default allocator and returns the one it
+ * replaces, typically so a decorator can forward to it.
+ * Objects keep the allocator they were created with, so blocks are always
+ * returned to the allocator they came from; ``alloc`` has to outlive every
+ * object that picked it up as the default.
+ */
+inline fallible_allocator &
+set_default_allocator(fallible_allocator &alloc) noexcept {
+  auto *previous = detail::installed_default_allocator().exchange(
+      &alloc, std::memory_order_acq_rel);
+  return previous ? *previous : get_core_allocator();
+}
+
+/**
+ * @brief Installs a default allocator for the lifetime of the guard and
+ * puts the previous one back afterwards.
+ */
+class scoped_default_allocator {
+public:
+  explicit scoped_default_allocator(fallible_allocator &alloc) noexcept
+      : m_previous(&set_default_allocator(alloc)) {}
+  ~scoped_default_allocator() noexcept { set_default_allocator(*m_previous); }
+
+  scoped_default_allocator(const scoped_default_allocator &) = delete;
+  scoped_default_allocator &
+  operator=(const scoped_default_allocator &) = delete;
+
+  /**
+   * @brief The default allocator from before this guard.
+   */
+  [[nodiscard]] fallible_allocator &previous() const noexcept {
+    return *m_previous;
+  }
+
+private:
+  fallible_allocator *m_previous;
+};
+
 } // namespace reloco
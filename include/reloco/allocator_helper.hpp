@@ -3,7 +3,9 @@
 #include <reloco/assert.hpp>
 #include <reloco/construction_helpers.hpp>
 #include <reloco/core.hpp>
+#include <reloco/error_origin.hpp>
 #include <reloco/rvalue_safety.hpp>
+#include <utility>
 
 #if defined(_MSC_VER)
 #include <intsafe.h>
@@ -122,7 +124,7 @@ public:
   [[nodiscard]] result<std::reference_wrapper<T>>
   at(size_t index) const & noexcept {
     if (index >= m_count)
-      return unexpected(error::out_of_bounds);
+      return RELOCO_ERROR(error::out_of_bounds);
     return std::ref(m_ptr[index]);
   }
 
@@ -191,16 +193,29 @@ public:
   /**
    * @brief Allocates an array of T with overflow-safe size calculation.
    * Returns a fallible_array_ptr for RAII safety.
+   *
+   * Value-initialized arrays of zero-initializable types come straight from
+   * ``allocate_zeroed()``, no element is constructed one by one.
    */
   template <typename T, typename... Args>
   [[nodiscard]] result<fallible_array_ptr<T>>
   allocate_array(size_t count, Args &&...args) const noexcept {
     if (count == 0)
-      return unexpected(error::invalid_argument);
+      return RELOCO_ERROR(error::invalid_argument);
 
     std::size_t total_bytes;
     if (detail::check_mul(count, sizeof(T), &total_bytes)) {
-      return unexpected(error::integer_overflow);
+      return RELOCO_ERROR(error::integer_overflow);
+    }
+
+    if constexpr (sizeof...(Args) == 0 && is_zero_initializable<T>::value &&
+                  !has_try_construct<T> && !has_try_allocate<T> &&
+                  !has_try_create<T>) {
+      auto block_res = m_alloc->allocate_zeroed(total_bytes, alignof(T));
+      if (!block_res)
+        return unexpected(block_res.error());
+      return fallible_array_ptr<T>(static_cast<T *>(block_res->ptr), count,
+                                   m_alloc);
     }
 
     auto block_res = m_alloc->allocate(total_bytes, alignof(T));
@@ -1,5 +1,6 @@
 #pragma once
 #include <array>
+#include <reloco/error_origin.hpp>
 #include <reloco/rvalue_safety.hpp>
 #include <reloco/span.hpp>
 #include <utility>
@@ -19,7 +20,7 @@ template <typename T, std::size_t N> struct array {
   [[nodiscard]] constexpr result<std::reference_wrapper<T>>
   try_at(size_type index) & noexcept {
     if (index >= N) [[unlikely]] {
-      return unexpected(error::out_of_bounds);
+      return RELOCO_ERROR(error::out_of_bounds);
     }
     return std::ref(data_[index]);
   }
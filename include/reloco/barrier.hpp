@@ -0,0 +1,114 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <reloco/core.hpp>
+#include <reloco/futex.hpp>
+#include <type_traits>
+
+namespace reloco {
+
+namespace detail {
+struct barrier_noop_completion {
+  void operator()() const noexcept {}
+};
+} // namespace detail
+
+/**
+ * @brief Reusable phase barrier.
+ * The last thread to arrive runs the completion function and bumps the phase
+ * word. Waiters sleep on the phase word and are only woken through a syscall
+ * when at least one of them actually blocked.
+ */
+template <typename CompletionFunction = detail::barrier_noop_completion>
+class barrier {
+  static_assert(std::is_nothrow_invocable_v<CompletionFunction &>,
+                "Barrier completion function must be noexcept invocable");
+
+public:
+  class [[nodiscard]] arrival_token {
+    friend class barrier;
+    explicit arrival_token(std::uint32_t phase) noexcept : m_phase(phase) {}
+    std::uint32_t m_phase;
+  };
+
+  static constexpr std::uint32_t max() noexcept {
+    return std::numeric_limits<std::uint32_t>::max();
+  }
+
+  constexpr explicit barrier(std::uint32_t expected,
+                             CompletionFunction f = CompletionFunction()) noexcept
+      : m_completion(std::move(f)), m_expected(expected), m_remaining(expected),
+        m_phase(0) {}
+
+  barrier(const barrier &) = delete;
+  barrier &operator=(const barrier &) = delete;
+
+  arrival_token arrive() & noexcept {
+    const std::uint32_t phase = m_phase.load(std::memory_order_acquire);
+    if (m_remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      complete_phase();
+    return arrival_token(phase);
+  }
+
+  result<void> wait(arrival_token &&token) const & noexcept {
+    if (m_phase.load(std::memory_order_acquire) != token.m_phase)
+      return {};
+
+    m_waiters.fetch_add(1, std::memory_order_seq_cst);
+    while (m_phase.load(std::memory_order_seq_cst) == token.m_phase) {
+      std::ignore = futex_wait(m_phase, token.m_phase);
+    }
+    m_waiters.fetch_sub(1, std::memory_order_relaxed);
+    return {};
+  }
+
+  template <typename Clock, typename Duration>
+  result<void>
+  wait_until(arrival_token &&token,
+             const std::chrono::time_point<Clock, Duration> &deadline) const & noexcept {
+    if (m_phase.load(std::memory_order_acquire) != token.m_phase)
+      return {};
+
+    m_waiters.fetch_add(1, std::memory_order_seq_cst);
+    result<void> res;
+    while (m_phase.load(std::memory_order_seq_cst) == token.m_phase) {
+      res = futex_wait_until(m_phase, token.m_phase, deadline);
+      if (!res) {
+        if (m_phase.load(std::memory_order_acquire) != token.m_phase)
+          res = {};
+        break;
+      }
+    }
+    m_waiters.fetch_sub(1, std::memory_order_relaxed);
+    return res;
+  }
+
+  result<void> arrive_and_wait() & noexcept { return wait(arrive()); }
+
+  /**
+   * @brief Arrives and removes the caller from every subsequent phase.
+   */
+  void arrive_and_drop() & noexcept {
+    m_expected.fetch_sub(1, std::memory_order_relaxed);
+    std::ignore = arrive();
+  }
+
+private:
+  void complete_phase() noexcept {
+    m_completion();
+    m_remaining.store(m_expected.load(std::memory_order_relaxed),
+                      std::memory_order_relaxed);
+    m_phase.fetch_add(1, std::memory_order_seq_cst);
+    if (m_waiters.load(std::memory_order_seq_cst) != 0) [[unlikely]]
+      futex_wake_all(m_phase);
+  }
+
+  [[no_unique_address]] CompletionFunction m_completion;
+  std::atomic<std::uint32_t> m_expected;
+  std::atomic<std::uint32_t> m_remaining;
+  mutable futex_word m_phase;
+  mutable std::atomic<std::uint32_t> m_waiters{0};
+};
+
+} // namespace reloco
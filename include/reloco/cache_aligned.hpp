@@ -0,0 +1,81 @@
+#pragma once
+#include <cstddef>
+#include <reloco/config.hpp>
+#include <type_traits>
+#include <utility>
+
+namespace reloco {
+
+namespace detail {
+
+constexpr std::size_t round_up_to_cache_line(std::size_t bytes) noexcept {
+  return (bytes + cache_line_size - 1) / cache_line_size * cache_line_size;
+}
+
+template <std::size_t N> struct cache_line_padding {
+  std::byte bytes[N];
+};
+
+template <> struct cache_line_padding<0> {};
+
+} // namespace detail
+
+/**
+ * @brief Stores ``T`` at the start of its own cache line(s).
+ * Alignment and size are multiples of ``cache_line_size``, so no other
+ * object shares a line with the value. Allocations of this type must honor
+ * the over-alignment (every reloco allocator does).
+ */
+template <typename T> struct alignas(cache_line_size) cache_aligned {
+  T value;
+
+  constexpr cache_aligned() noexcept(
+      std::is_nothrow_default_constructible_v<T>) = default;
+
+  template <typename... Args>
+    requires std::is_constructible_v<T, Args...>
+  constexpr explicit cache_aligned(std::in_place_t, Args &&...args) noexcept(
+      std::is_nothrow_constructible_v<T, Args...>)
+      : value(std::forward<Args>(args)...) {}
+
+  constexpr T &get() & noexcept { return value; }
+  constexpr const T &get() const & noexcept { return value; }
+  constexpr T &operator*() & noexcept { return value; }
+  constexpr const T &operator*() const & noexcept { return value; }
+  constexpr T *operator->() noexcept { return &value; }
+  constexpr const T *operator->() const noexcept { return &value; }
+};
+
+/**
+ * @brief ``T`` followed by padding up to a whole number of cache lines.
+ * Unlike cache_aligned it does not raise the alignment, so it fits storage
+ * that only guarantees ``alignof(T)``; neighbouring elements of an array of
+ * padded values never share a line as long as the array itself starts on a
+ * line boundary.
+ */
+template <typename T> struct padded {
+  T value;
+
+  constexpr padded() noexcept(std::is_nothrow_default_constructible_v<T>) =
+      default;
+
+  template <typename... Args>
+    requires std::is_constructible_v<T, Args...>
+  constexpr explicit padded(std::in_place_t, Args &&...args) noexcept(
+      std::is_nothrow_constructible_v<T, Args...>)
+      : value(std::forward<Args>(args)...) {}
+
+  constexpr T &get() & noexcept { return value; }
+  constexpr const T &get() const & noexcept { return value; }
+  constexpr T &operator*() & noexcept { return value; }
+  constexpr const T &operator*() const & noexcept { return value; }
+  constexpr T *operator->() noexcept { return &value; }
+  constexpr const T *operator->() const noexcept { return &value; }
+
+private:
+  [[no_unique_address]] detail::cache_line_padding<
+      detail::round_up_to_cache_line(sizeof(T)) - sizeof(T)>
+      m_padding;
+};
+
+} // namespace reloco
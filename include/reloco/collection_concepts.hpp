@@ -2,6 +2,7 @@
 #include <memory>
 #include <reloco/concepts.hpp>
 #include <reloco/core.hpp>
+#include <reloco/span.hpp>
 #include <utility>
 
 namespace reloco {
@@ -43,4 +44,15 @@ concept is_mutable_fallible_collection_view =
       { v.clear() } -> std::same_as<void>;
     };
 
+/**
+ * @brief Containers storing their elements in several contiguous segments.
+ * ``for_each_chunk`` calls the callback once per non-empty segment, in order.
+ * Containers without it are treated as one contiguous block.
+ */
+template <typename T, typename Element>
+concept has_for_each_chunk =
+    requires(const T &v, void (*fn)(span<const Element>)) {
+      v.for_each_chunk(fn);
+    };
+
 } // namespace reloco
@@ -1,7 +1,10 @@
 #pragma once
 #include <reloco/collection_concepts.hpp>
+#include <algorithm>
 #include <reloco/core.hpp>
+#include <reloco/error_origin.hpp>
 #include <reloco/ownership_policy.hpp>
+#include <reloco/span.hpp>
 
 namespace reloco {
 
@@ -50,6 +53,48 @@ public:
     return Policy<Container>::get(m_storage).unsafe_data();
   }
 
+  /**
+   * @brief Calls ``fn(span<const value_type>)`` for each contiguous run of
+   * elements, in order. Contiguous containers yield a single span.
+   */
+  template <typename F> void for_each_chunk(F &&fn) const noexcept {
+    const auto &container = Policy<Container>::get(m_storage);
+    if constexpr (has_for_each_chunk<Container, value_type>) {
+      container.for_each_chunk(fn);
+    } else if (!container.empty()) {
+      fn(span<const value_type>(container.unsafe_data(), container.size()));
+    }
+  }
+
+  /**
+   * @brief Copies the elements starting at ``offset`` into ``out``.
+   * @return Number of elements copied, at most ``out.size()``.
+   */
+  result<size_t> try_copy_to(span<value_type> out,
+                             size_t offset = 0) const noexcept
+    requires std::is_copy_assignable_v<value_type>
+  {
+    if (offset > size())
+      return RELOCO_ERROR(error::out_of_range);
+
+    size_t skip = offset;
+    size_t copied = 0;
+    for_each_chunk([&](span<const value_type> chunk) noexcept {
+      if (skip >= chunk.size()) {
+        skip -= chunk.size();
+        return;
+      }
+      const size_t count = std::min(chunk.size() - skip, out.size() - copied);
+      if (count == 0)
+        return;
+      std::copy_n(chunk.unsafe_data() + skip, count,
+                  out.unsafe_data() + copied);
+      copied += count;
+      skip = 0;
+    });
+    return copied;
+  }
+
   template <typename C = Container>
     requires has_try_clone<C>
   auto try_clone() const
@@ -124,12 +169,39 @@ public:
   using Base::unsafe_data;
 };
 
+namespace detail {
+
+// Inline context buffer of any_view: a pointer, a shared_ptr or a vector
+// stored by value all fit
+inline constexpr size_t any_view_inline_size = 4 * sizeof(void *);
+inline constexpr size_t any_view_inline_align = alignof(std::max_align_t);
+
+template <typename ViewType>
+inline constexpr bool any_view_fits_inline =
+    sizeof(ViewType) <= any_view_inline_size &&
+    alignof(ViewType) <= any_view_inline_align &&
+    std::is_nothrow_move_constructible_v<ViewType>;
+
+} // namespace detail
+
 template <typename Element> struct any_view_vtable {
+  using chunk_callback = void (*)(void *, span<const Element>) noexcept;
+
+  size_t context_size;
+  size_t context_align;
+  // Context lives in any_view's inline buffer rather than on the heap
+  bool stored_inline;
+
   size_t (*size)(const void *) noexcept;
   result<std::reference_wrapper<const Element>> (*try_at)(const void *,
                                                           size_t) noexcept;
-  void (*destroy)(void *, fallible_allocator &alloc) noexcept;
-  result<void *> (*try_clone)(const void *, fallible_allocator &alloc) noexcept;
+  void (*for_each_chunk)(const void *, void *fn_ctx,
+                         chunk_callback fn) noexcept;
+  result<size_t> (*try_copy_to)(const void *, span<Element>, size_t) noexcept;
+  void (*destroy)(void *) noexcept;
+  // Move-constructs the context at ``to`` and destroys it at ``from``
+  void (*relocate)(void *from, void *to) noexcept;
+  result<void> (*try_clone_at)(const void *, void *storage) noexcept;
 };
 
 namespace detail {
@@ -140,6 +212,10 @@ struct any_view_vtable_factory {
   using ViewType = collection_view<Container, Policy>;
 
   static constexpr any_view_vtable<Element> instance = {
+      .context_size = sizeof(ViewType),
+      .context_align = alignof(ViewType),
+      .stored_inline = any_view_fits_inline<ViewType>,
+
       .size = [](const void *ctx) noexcept -> size_t {
         return static_cast<const ViewType *>(ctx)->size();
       },
@@ -149,92 +225,161 @@ struct any_view_vtable_factory {
         return static_cast<const ViewType *>(ctx)->try_at(i);
       },
 
+      .for_each_chunk =
+          [](const void *ctx, void *fn_ctx,
+             typename any_view_vtable<Element>::chunk_callback fn) noexcept {
+            static_cast<const ViewType *>(ctx)->for_each_chunk(
+                [&](span<const Element> chunk) noexcept { fn(fn_ctx, chunk); });
+          },
+
+      .try_copy_to = [](const void *ctx, span<Element> out,
+                        size_t offset) noexcept -> result<size_t> {
+        if constexpr (std::is_copy_assignable_v<Element>) {
+          return static_cast<const ViewType *>(ctx)->try_copy_to(out, offset);
+        } else {
+          return RELOCO_ERROR(error::unsupported_operation);
+        }
+      },
+
       .destroy =
-          [](void *ctx, fallible_allocator &alloc) noexcept {
-            static_cast<ViewType *>(ctx)->~ViewType();
-            alloc.deallocate(ctx, sizeof(ViewType));
+          [](void *ctx) noexcept { static_cast<ViewType *>(ctx)->~ViewType(); },
+
+      .relocate =
+          [](void *from, void *to) noexcept {
+            auto *source = static_cast<ViewType *>(from);
+            new (to) ViewType(std::move(*source));
+            source->~ViewType();
           },
 
-      .try_clone = [](const void *ctx,
-                      fallible_allocator &alloc) noexcept -> result<void *> {
+      .try_clone_at = [](const void *ctx,
+                         void *storage) noexcept -> result<void> {
         if constexpr (has_try_clone<ViewType>) {
-          auto res = alloc.allocate(sizeof(ViewType), alignof(ViewType));
-          if (!res)
-            return unexpected(error::allocation_failed);
-          auto cloned = static_cast<const ViewType *>(ctx)->try_clone();
-          if (!cloned.has_value()) {
-            alloc.deallocate(res->ptr, res->size);
-            return unexpected(cloned.error());
-          }
-          return new (res->ptr) ViewType(std::move(cloned.value()));
+          RELOCO_TRY_ASSIGN(auto cloned,
+                            static_cast<const ViewType *>(ctx)->try_clone());
+          new (storage) ViewType(std::move(cloned));
+          return {};
         } else {
-          return unexpected(error::unsupported_operation);
+          return RELOCO_ERROR(error::unsupported_operation);
         }
       }};
 };
 
 } // namespace detail
 
+/**
+ * @brief Type-erased, read-only view over any fallible collection.
+ * Erased views small enough for the inline buffer (non-owning pointers,
+ * shared owners, containers moved in by value) are stored in place, so
+ * creating them never allocates. Larger ones are placed on ``alloc``.
+ */
 template <typename Element> class any_view {
-  void *m_ctx;
-  const any_view_vtable<Element> *m_vtable;
+  alignas(detail::any_view_inline_align) std::byte
+      m_inline[detail::any_view_inline_size];
+  void *m_ctx = nullptr;
+  const any_view_vtable<Element> *m_vtable = nullptr;
   fallible_allocator *m_alloc;
 
-  any_view(void *ctx, const any_view_vtable<Element> *vt,
-           fallible_allocator *alloc)
-      : m_ctx(ctx), m_vtable(vt), m_alloc(alloc) {}
+  any_view(const any_view_vtable<Element> *vt,
+           fallible_allocator *alloc) noexcept
+      : m_vtable(vt), m_alloc(alloc) {}
+
+  void reset() noexcept {
+    if (!m_ctx)
+      return;
+    m_vtable->destroy(m_ctx);
+    if (!m_vtable->stored_inline)
+      m_alloc->deallocate(m_ctx, m_vtable->context_size);
+    m_ctx = nullptr;
+  }
+
+  void steal(any_view &other) noexcept {
+    m_vtable = other.m_vtable;
+    m_alloc = other.m_alloc;
+    if (other.m_ctx && m_vtable->stored_inline) {
+      m_vtable->relocate(other.m_ctx, m_inline);
+      m_ctx = m_inline;
+    } else {
+      m_ctx = other.m_ctx;
+    }
+    other.m_ctx = nullptr;
+    other.m_vtable = nullptr;
+  }
 
 public:
+  /**
+   * @brief Erases a view that fits the inline buffer; never allocates.
+   */
   template <typename Container, template <typename> typename Policy>
-    requires is_fallible_collection_view<Container, Element>
-  static result<any_view> try_create(collection_view<Container, Policy> &&view,
-                                     fallible_allocator &alloc) {
+    requires is_fallible_collection_view<Container, Element> &&
+             detail::any_view_fits_inline<collection_view<Container, Policy>>
+  static any_view create(collection_view<Container, Policy> &&view,
+                         fallible_allocator &alloc =
+                             get_default_allocator()) noexcept {
     using ViewType = collection_view<Container, Policy>;
 
-    // Fallible allocation of the erased context
-    auto ctx_res = alloc.allocate(sizeof(ViewType), alignof(ViewType));
-    if (!ctx_res)
-      return unexpected(error::allocation_failed);
-
-    new (ctx_res->ptr) ViewType(std::move(view));
-
-    return any_view(
-        ctx_res->ptr,
+    any_view erased(
         &detail::any_view_vtable_factory<Container, Policy, Element>::instance,
         &alloc);
+    erased.m_ctx = new (erased.m_inline) ViewType(std::move(view));
+    return erased;
   }
 
-  ~any_view() {
-    if (m_ctx)
-      m_vtable->destroy(m_ctx, *m_alloc);
+  template <typename Container, template <typename> typename Policy>
+    requires is_fallible_collection_view<Container, Element>
+  static result<any_view> try_create(collection_view<Container, Policy> &&view,
+                                     fallible_allocator &alloc) {
+    using ViewType = collection_view<Container, Policy>;
+
+    if constexpr (detail::any_view_fits_inline<ViewType>) {
+      return create(std::move(view), alloc);
+    } else {
+      // Fallible allocation of the erased context
+      auto ctx_res = alloc.allocate(sizeof(ViewType), alignof(ViewType));
+      if (!ctx_res)
+        return RELOCO_ALLOC_ERROR(error::allocation_failed, alloc);
+
+      any_view erased(
+          &detail::any_view_vtable_factory<Container, Policy,
+                                           Element>::instance,
+          &alloc);
+      erased.m_ctx = new (ctx_res->ptr) ViewType(std::move(view));
+      return erased;
+    }
   }
 
+  ~any_view() { reset(); }
+
   result<any_view> try_clone() const {
     if (!m_ctx || !m_vtable)
-      return unexpected(error::not_initialized);
+      return RELOCO_ERROR(error::not_initialized);
+
+    any_view copy(m_vtable, m_alloc);
+    void *storage = copy.m_inline;
+    if (!m_vtable->stored_inline) {
+      RELOCO_TRY_ASSIGN(mem_block block,
+                        m_alloc->allocate(m_vtable->context_size,
+                                          m_vtable->context_align));
+      storage = block.ptr;
+    }
 
-    auto res = m_vtable->try_clone(m_ctx, *m_alloc);
-    if (!res)
+    auto res = m_vtable->try_clone_at(m_ctx, storage);
+    if (!res) [[unlikely]] {
+      if (!m_vtable->stored_inline)
+        m_alloc->deallocate(storage, m_vtable->context_size);
       return unexpected(res.error());
-
-    return any_view(*res, m_vtable, m_alloc);
+    }
+    copy.m_ctx = storage;
+    return copy;
   }
 
-  any_view(any_view &&other) noexcept
-      : m_ctx(other.m_ctx), m_vtable(other.m_vtable), m_alloc(other.m_alloc) {
-    other.m_ctx = nullptr;
-    other.m_vtable = nullptr;
+  any_view(any_view &&other) noexcept : m_alloc(other.m_alloc) {
+    steal(other);
   }
 
   any_view &operator=(any_view &&other) noexcept {
     if (this != &other) {
-      if (m_ctx)
-        m_vtable->destroy(m_ctx, *m_alloc);
-      m_ctx = other.m_ctx;
-      m_vtable = other.m_vtable;
-      m_alloc = other.m_alloc;
-      other.m_ctx = nullptr;
-      other.m_vtable = nullptr;
+      reset();
+      steal(other);
     }
     return *this;
   }
@@ -248,7 +393,7 @@ public:
   result<std::reference_wrapper<const Element>>
   try_at(size_t i) const noexcept {
     if (!m_ctx)
-      return unexpected(error::not_initialized);
+      return RELOCO_ERROR(error::not_initialized);
     return m_vtable->try_at(m_ctx, i);
   }
 
@@ -257,6 +402,34 @@ public:
     RELOCO_ASSERT(result.has_value(), "Could not obtain element reference");
     return *result;
   }
+
+  /**
+   * @brief Calls ``fn(span<const Element>)`` for each contiguous run of
+   * elements. One indirect call per chunk instead of one per element, and the
+   * loop over a chunk can be vectorized.
+   */
+  template <typename F> void for_each_chunk(F &&fn) const noexcept {
+    if (!m_ctx)
+      return;
+    using Fn = std::remove_reference_t<F>;
+    m_vtable->for_each_chunk(
+        m_ctx, const_cast<void *>(static_cast<const void *>(&fn)),
+        [](void *f, span<const Element> chunk) noexcept {
+          (*static_cast<Fn *>(f))(chunk);
+        });
+  }
+
+  /**
+   * @brief Copies the elements starting at ``offset`` into ``out``.
+   * @return Number of elements copied, ``unsupported_operation`` for elements
+   * that cannot be copied.
+   */
+  result<size_t> try_copy_to(span<Element> out,
+                             size_t offset = 0) const noexcept {
+    if (!m_ctx)
+      return RELOCO_ERROR(error::not_initialized);
+    return m_vtable->try_copy_to(m_ctx, out, offset);
+  }
 };
 
 } // namespace reloco
\ No newline at end of file
@@ -1 +1,57 @@
 #pragma once
+#include <cstddef>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/**
+ * @def RELOCO_CACHE_LINE_SIZE
+ * @brief Granularity used to keep independently written data apart.
+ * Override on the command line for targets with larger lines (e.g. 128 on
+ * Apple M-series or POWER).
+ */
+#if !defined(RELOCO_CACHE_LINE_SIZE)
+#define RELOCO_CACHE_LINE_SIZE 64
+#endif
+
+/**
+ * @def RELOCO_COLD
+ * @brief Marks a function as rarely called and keeps it out of line, so the
+ * paths that reach it are laid out away from the hot code.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define RELOCO_COLD __attribute__((cold, noinline))
+#elif defined(_MSC_VER)
+#define RELOCO_COLD __declspec(noinline)
+#else
+#define RELOCO_COLD
+#endif
+
+#define RELOCO_CONCAT_IMPL(a, b) a##b
+#define RELOCO_CONCAT(a, b) RELOCO_CONCAT_IMPL(a, b)
+
+namespace reloco {
+
+inline constexpr std::size_t cache_line_size = RELOCO_CACHE_LINE_SIZE;
+
+namespace detail {
+
+/**
+ * @brief Tells the CPU we are in a spin-wait loop.
+ */
+inline void cpu_relax() noexcept {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  _mm_pause();
+#elif defined(_MSC_VER) && defined(_M_ARM64)
+  __yield();
+#elif defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+  asm volatile("yield" ::: "memory");
+#endif
+}
+
+} // namespace detail
+
+} // namespace reloco
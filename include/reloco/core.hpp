@@ -1,5 +1,10 @@
 #pragma once
+#include <bit>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <reloco/config.hpp>
 #include <reloco/expected.hpp>
 #include <system_error>
 
@@ -25,16 +30,155 @@ enum class error : int {
   not_initialized,
   container_empty,
   not_found,
-  integer_overflow
+  integer_overflow,
+  invalid_format,
+  io_failed,
+  end_of_file
 };
 
 template <typename T> using result = expected<T, error>;
 
+namespace detail {
+
+/**
+ * @brief Failure exit of RELOCO_TRY/RELOCO_TRY_ASSIGN.
+ * Being cold and out of line, it makes the compiler treat every branch that
+ * reaches it as unlikely and move that code away from the success path.
+ */
+template <typename E>
+RELOCO_COLD constexpr unexpected<E> propagate_error(E e) noexcept {
+  return unexpected<E>(std::move(e));
+}
+
+} // namespace detail
+
+/**
+ * @def RELOCO_TRY
+ * @brief Evaluates ``expr`` (an ``expected``) and returns its error from the
+ * enclosing function if it holds one.
+ *
+ * @code
+ * RELOCO_TRY(vec.try_reserve(n));
+ * @endcode
+ */
+#define RELOCO_TRY(expr)                                                       \
+  RELOCO_TRY_IMPL(RELOCO_CONCAT(reloco_try_, __COUNTER__), expr)
+
+#define RELOCO_TRY_IMPL(tmp, expr)                                             \
+  do {                                                                         \
+    auto &&tmp = (expr);                                                       \
+    if (!tmp) [[unlikely]]                                                     \
+      return ::reloco::detail::propagate_error(std::move(tmp).error());        \
+  } while (0)
+
+/**
+ * @def RELOCO_TRY_ASSIGN
+ * @brief Like RELOCO_TRY, but on success moves the value into ``lhs``, which
+ * may be a declaration.
+ *
+ * @code
+ * RELOCO_TRY_ASSIGN(mem_block block, alloc.allocate(size, align));
+ * @endcode
+ */
+#define RELOCO_TRY_ASSIGN(lhs, expr)                                           \
+  RELOCO_TRY_ASSIGN_IMPL(RELOCO_CONCAT(reloco_try_, __COUNTER__), lhs, expr)
+
+#define RELOCO_TRY_ASSIGN_IMPL(tmp, lhs, expr)                                 \
+  auto &&tmp = (expr);                                                         \
+  if (!tmp) [[unlikely]]                                                       \
+    return ::reloco::detail::propagate_error(std::move(tmp).error());          \
+  lhs = std::move(tmp).value()
+
 struct [[nodiscard]] mem_block {
   void *ptr;
   std::size_t size;
 };
 
+namespace detail {
+
+/**
+ * Nothing is ever mapped in the first page on supported platforms, so
+ * pointer-sized values in [1, niche_address_limit) can carry an error code
+ * while null stays a valid value.
+ */
+inline constexpr std::uintptr_t niche_address_limit = 4096;
+
+constexpr bool is_niche_address(std::uintptr_t bits) noexcept {
+  return bits - 1 < niche_address_limit - 1;
+}
+
+} // namespace detail
+
+template <> struct expected_niche<void, error> {
+  static constexpr bool available = true;
+  // Every error enumerator is non-zero
+  static constexpr error no_error = error{};
+};
+
+template <typename P> struct expected_niche<P *, error> {
+  static constexpr bool available = true;
+
+  static constexpr bool holds_error(P *const &v) noexcept {
+    // Errors cannot be encoded during constant evaluation
+    if (std::is_constant_evaluated())
+      return false;
+    return detail::is_niche_address(reinterpret_cast<std::uintptr_t>(v));
+  }
+
+  static P *encode(error e) noexcept {
+    return reinterpret_cast<P *>(static_cast<std::uintptr_t>(e));
+  }
+
+  static error decode(P *const &v) noexcept {
+    return static_cast<error>(reinterpret_cast<std::uintptr_t>(v));
+  }
+};
+
+template <typename U> struct expected_niche<std::reference_wrapper<U>, error> {
+  using wrapper = std::reference_wrapper<U>;
+  static_assert(sizeof(wrapper) == sizeof(std::uintptr_t),
+                "reference_wrapper is expected to hold a single pointer");
+
+  static constexpr bool available = true;
+
+  static constexpr bool holds_error(const wrapper &v) noexcept {
+    if (std::is_constant_evaluated())
+      return false;
+    return detail::is_niche_address(std::bit_cast<std::uintptr_t>(v));
+  }
+
+  static wrapper encode(error e) noexcept {
+    return std::bit_cast<wrapper>(static_cast<std::uintptr_t>(e));
+  }
+
+  static error decode(const wrapper &v) noexcept {
+    return static_cast<error>(std::bit_cast<std::uintptr_t>(v));
+  }
+};
+
+/**
+ * No allocation can span half of the address space, so the top bit of
+ * ``size`` marks an error and the low bits carry its code.
+ */
+template <> struct expected_niche<mem_block, error> {
+  static constexpr std::size_t error_bit = std::size_t{1}
+                                           << (sizeof(std::size_t) * 8 - 1);
+
+  static constexpr bool available = true;
+
+  static constexpr bool holds_error(const mem_block &b) noexcept {
+    return (b.size & error_bit) != 0;
+  }
+
+  static constexpr mem_block encode(error e) noexcept {
+    return mem_block{nullptr, error_bit | static_cast<std::size_t>(e)};
+  }
+
+  static constexpr error decode(const mem_block &b) noexcept {
+    return static_cast<error>(b.size & ~error_bit);
+  }
+};
+
 enum class usage_hint : int {
   normal,     // Default behavior
   sequential, // Expecting to read from start to finish (e.g., big data
@@ -65,13 +209,53 @@ public:
 
   virtual void deallocate(void *ptr, std::size_t bytes) noexcept = 0;
 
+  /**
+   * @brief Like allocate(), but the returned memory reads as zero.
+   * Allocators that can obtain zero pages from the system (calloc, fresh
+   * mappings) override this to skip the memset, so untouched pages of a
+   * large zeroed block are never faulted in.
+   */
+  [[nodiscard]] virtual result<mem_block>
+  allocate_zeroed(std::size_t bytes, std::size_t alignment) noexcept {
+    auto res = allocate(bytes, alignment);
+    if (res && res->size != 0)
+      std::memset(res->ptr, 0, res->size);
+    return res;
+  }
+
   virtual void advise(void *ptr, std::size_t bytes, usage_hint hint) noexcept {}
+
+  /**
+   * @brief True when deallocate() never releases anything, because memory is
+   * reclaimed all at once (e.g. an arena reset). Containers then skip
+   * per-element deallocation, and destruction of trivially destructible
+   * elements, when tearing down.
+   */
+  [[nodiscard]] virtual bool frees_are_noops() const noexcept { return false; }
+
+  /**
+   * @brief Short static name identifying the allocator in diagnostics.
+   */
+  [[nodiscard]] virtual const char *tag() const noexcept {
+    return "allocator";
+  }
 };
 
 // By default, only trivially copyable types are bitwise relocatable.
-// However, users can specialize this for types like std::unique_ptr.
+// However, users can specialize this for types like std::unique_ptr, or use
+// RELOCO_RELOCATABLE_AGGREGATE from relocation.hpp for aggregates.
 template <typename T> struct is_relocatable : std::is_trivially_copyable<T> {};
 
+// Types that may be created in memory from allocate_zeroed() without running a
+// constructor, because their value-initialized state is all zero bytes. Null
+// member pointers are not zero on common ABIs; specialize this to false for
+// classes holding one.
+template <typename T>
+struct is_zero_initializable
+    : std::bool_constant<std::is_trivially_default_constructible_v<T> &&
+                         std::is_trivially_destructible_v<T> &&
+                         !std::is_member_pointer_v<T>> {};
+
 template <typename T> struct is_result : std::false_type {};
 
 template <typename T> struct is_result<result<T>> : std::true_type {};
@@ -0,0 +1,122 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <reloco/config.hpp>
+#include <reloco/core.hpp>
+
+namespace reloco {
+
+/**
+ * @brief Where the library first produced an error.
+ */
+struct error_origin {
+  const char *file = nullptr;
+  std::uint32_t line = 0;
+  error code{};
+  // fallible_allocator::tag() of the allocator that failed, if any
+  const char *allocator_tag = nullptr;
+};
+
+namespace detail {
+
+struct error_origin_ring {
+  static constexpr std::size_t capacity = 32;
+
+  error_origin entries[capacity];
+  std::uint64_t recorded = 0;
+};
+
+inline error_origin_ring &local_error_origins() noexcept {
+  static thread_local error_origin_ring ring;
+  return ring;
+}
+
+inline std::atomic<bool> &error_origins_switch() noexcept {
+  static std::atomic<bool> enabled{false};
+  return enabled;
+}
+
+RELOCO_COLD inline void
+record_error_origin(error e, const char *file, std::uint32_t line,
+                    const fallible_allocator *alloc) noexcept {
+  auto &ring = local_error_origins();
+  ring.entries[ring.recorded++ % error_origin_ring::capacity] =
+      error_origin{file, line, e, alloc ? alloc->tag() : nullptr};
+}
+
+/**
+ * @brief Creates the ``unexpected`` for a new library error.
+ * Only ever reached on failure paths; being cold, it also tells the
+ * compiler so. While recording is disabled it costs one relaxed load.
+ */
+RELOCO_COLD constexpr unexpected<error>
+make_error(error e, const char *file, std::uint32_t line,
+           const fallible_allocator *alloc = nullptr) noexcept {
+#if !defined(RELOCO_DISABLE_ERROR_ORIGIN)
+  if (!std::is_constant_evaluated() &&
+      error_origins_switch().load(std::memory_order_relaxed))
+    record_error_origin(e, file, line, alloc);
+#endif
+  return unexpected<error>(e);
+}
+
+} // namespace detail
+
+/**
+ * @brief Starts or stops recording error origins, for all threads.
+ * Off by default. Each thread keeps the last
+ * ``detail::error_origin_ring::capacity`` origins it produced. Building
+ * with ``RELOCO_DISABLE_ERROR_ORIGIN`` removes recording entirely.
+ */
+inline void enable_error_origins(bool enabled = true) noexcept {
+  detail::error_origins_switch().store(enabled, std::memory_order_relaxed);
+}
+
+[[nodiscard]] inline bool error_origins_enabled() noexcept {
+  return detail::error_origins_switch().load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief The most recent origin recorded on the calling thread, or null.
+ */
+[[nodiscard]] inline const error_origin *last_error_origin() noexcept {
+  const auto &ring = detail::local_error_origins();
+  if (ring.recorded == 0)
+    return nullptr;
+  return &ring.entries[(ring.recorded - 1) %
+                       detail::error_origin_ring::capacity];
+}
+
+/**
+ * @brief Visits the origins recorded on the calling thread, newest first.
+ */
+template <typename F> void for_each_error_origin(F &&f) noexcept {
+  const auto &ring = detail::local_error_origins();
+  const std::uint64_t count =
+      ring.recorded < detail::error_origin_ring::capacity
+          ? ring.recorded
+          : detail::error_origin_ring::capacity;
+  for (std::uint64_t i = 1; i <= count; ++i)
+    f(ring.entries[(ring.recorded - i) % detail::error_origin_ring::capacity]);
+}
+
+inline void clear_error_origins() noexcept {
+  detail::local_error_origins().recorded = 0;
+}
+
+} // namespace reloco
+
+/**
+ * @def RELOCO_ERROR
+ * @brief ``unexpected(e)`` that remembers where it was created.
+ */
+#define RELOCO_ERROR(e) ::reloco::detail::make_error((e), __FILE__, __LINE__)
+
+/**
+ * @def RELOCO_ALLOC_ERROR
+ * @brief RELOCO_ERROR for failures of the allocator ``alloc`` (a reference),
+ * which also records the allocator's tag.
+ */
+#define RELOCO_ALLOC_ERROR(e, alloc)                                           \
+  ::reloco::detail::make_error((e), __FILE__, __LINE__, &(alloc))
@@ -0,0 +1,102 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <reloco/core.hpp>
+#include <reloco/futex.hpp>
+
+namespace reloco {
+
+/**
+ * @brief Lets consumers of a lock-free structure block without a mutex.
+ *
+ * Consumer protocol:
+ * @code
+ * while (true) {
+ *   if (auto item = queue.try_pop()) return item;
+ *   auto key = ec.prepare_wait();
+ *   if (auto item = queue.try_pop()) { ec.cancel_wait(); return item; }
+ *   std::ignore = ec.wait(key);
+ * }
+ * @endcode
+ * Producers publish first and call ``notify_one()``/``notify_all()`` after.
+ * Notifications are a fence plus a load when no consumer is preparing to
+ * wait.
+ */
+class eventcount {
+public:
+  class [[nodiscard]] key {
+    friend class eventcount;
+    explicit key(std::uint32_t epoch) noexcept : m_epoch(epoch) {}
+    std::uint32_t m_epoch;
+  };
+
+  constexpr eventcount() noexcept = default;
+
+  eventcount(const eventcount &) = delete;
+  eventcount &operator=(const eventcount &) = delete;
+
+  key prepare_wait() & noexcept {
+    m_waiters.fetch_add(1, std::memory_order_seq_cst);
+    return key(m_epoch.load(std::memory_order_seq_cst));
+  }
+
+  void cancel_wait() & noexcept {
+    m_waiters.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  result<void> wait(key k) & noexcept {
+    while (m_epoch.load(std::memory_order_acquire) == k.m_epoch) {
+      std::ignore = futex_wait(m_epoch, k.m_epoch);
+    }
+    m_waiters.fetch_sub(1, std::memory_order_relaxed);
+    return {};
+  }
+
+  template <typename Clock, typename Duration>
+  result<void>
+  wait_until(key k,
+             const std::chrono::time_point<Clock, Duration> &deadline) & noexcept {
+    result<void> res;
+    while (m_epoch.load(std::memory_order_acquire) == k.m_epoch) {
+      res = futex_wait_until(m_epoch, k.m_epoch, deadline);
+      if (!res) {
+        if (m_epoch.load(std::memory_order_acquire) != k.m_epoch)
+          res = {};
+        break;
+      }
+    }
+    m_waiters.fetch_sub(1, std::memory_order_relaxed);
+    return res;
+  }
+
+  template <typename Rep, typename Period>
+  result<void>
+  wait_for(key k, const std::chrono::duration<Rep, Period> &timeout) & noexcept {
+    return wait_until(k, std::chrono::steady_clock::now() + timeout);
+  }
+
+  void notify_one() & noexcept { notify(false); }
+
+  void notify_all() & noexcept { notify(true); }
+
+private:
+  void notify(bool all) noexcept {
+    // Orders the producer's publication before the waiter count check,
+    // pairing with the seq_cst increment in prepare_wait()
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_waiters.load(std::memory_order_relaxed) == 0) [[likely]]
+      return;
+
+    m_epoch.fetch_add(1, std::memory_order_release);
+    if (all)
+      futex_wake_all(m_epoch);
+    else
+      futex_wake_one(m_epoch);
+  }
+
+  futex_word m_epoch{0};
+  std::atomic<std::uint32_t> m_waiters{0};
+};
+
+} // namespace reloco
@@ -18,6 +18,29 @@ template <typename E> unexpected(E) -> unexpected<E>;
 
 struct expected_tag_t {};
 
+/**
+ * @brief Opt-in to store ``expected<T, E>`` without a separate discriminator.
+ *
+ * For a non-void ``T`` a specialization reserves representations of ``T``
+ * that no valid value ever uses and provides:
+ * - ``static bool holds_error(const T &)``
+ * - ``static T encode(E)``
+ * - ``static E decode(const T &)``
+ *
+ * For ``T = void`` it names the value of ``E`` that means success:
+ * - ``static constexpr E no_error``
+ *
+ * The resulting ``expected`` is exactly as large as ``T`` (or ``E``), is
+ * trivially copyable whenever ``T`` is, and therefore travels in registers.
+ * ``error()`` returns by value because the error is decoded on access.
+ */
+template <typename T, typename E> struct expected_niche {
+  static constexpr bool available = false;
+};
+
+template <typename T, typename E>
+concept has_expected_niche = expected_niche<T, E>::available;
+
 template <typename T, typename E>
 class [[nodiscard]] expected : expected_tag_t {
   static_assert(std::is_nothrow_move_constructible_v<T>,
@@ -73,7 +96,12 @@ public:
   constexpr expected(const unexpected<E> &err) noexcept
       : m_error(err.value()), m_has_value(false) {}
 
-  ~expected() noexcept {
+  constexpr ~expected() noexcept
+    requires(std::is_trivially_destructible_v<T> &&
+             std::is_trivially_destructible_v<E>)
+  = default;
+
+  constexpr ~expected() noexcept {
     if (m_has_value)
       m_value.~T();
     else
@@ -160,6 +188,159 @@ public:
   }
 };
 
+template <typename T, typename E>
+  requires(!std::is_void_v<T> && has_expected_niche<T, E>)
+class [[nodiscard]] expected<T, E> : expected_tag_t {
+  using niche = expected_niche<T, E>;
+
+  static_assert(std::is_trivially_copyable_v<T>,
+                "Niche storage requires a trivially copyable T");
+
+  // Either a value or an error encoded by the niche
+  T m_value;
+
+public:
+  using value_type = T;
+  using error_type = E;
+
+  template <typename U = T>
+    requires std::is_nothrow_default_constructible_v<U>
+  constexpr expected() noexcept : m_value() {}
+
+  // The assertions double as optimizer hints in release builds: a freshly
+  // stored value is known not to be an error.
+  constexpr expected(T &&val) noexcept : m_value(std::move(val)) {
+    RELOCO_DEBUG_ASSERT(!niche::holds_error(m_value),
+                        "Value collides with the error niche");
+  }
+
+  template <typename U>
+    requires std::is_constructible_v<T, U &&>
+  constexpr expected(U &&val) noexcept : m_value(std::forward<U>(val)) {
+    RELOCO_DEBUG_ASSERT(!niche::holds_error(m_value),
+                        "Value collides with the error niche");
+  }
+
+  template <typename U, typename G>
+    requires std::is_nothrow_constructible_v<T, U &&> &&
+             std::is_nothrow_constructible_v<E, G &&>
+  constexpr expected(expected<U, G> &&other) noexcept
+      : m_value(other.has_value() ? T(std::move(other.value()))
+                                  : niche::encode(E(std::move(other).error()))) {
+  }
+
+  template <typename G>
+    requires std::is_constructible_v<E, G &&>
+  constexpr expected(unexpected<G> &&err) noexcept
+      : m_value(niche::encode(E(std::move(err.value())))) {}
+
+  constexpr expected(unexpected<E> &&err) noexcept
+      : m_value(niche::encode(err.value())) {}
+  constexpr expected(const unexpected<E> &err) noexcept
+      : m_value(niche::encode(err.value())) {}
+
+  constexpr bool has_value() const noexcept {
+    return !niche::holds_error(m_value);
+  }
+  constexpr explicit operator bool() const noexcept { return has_value(); }
+
+  constexpr T &value() & noexcept {
+    RELOCO_ASSERT(has_value() && "Result does not contain a value");
+    return m_value;
+  }
+
+  constexpr T &&value() && noexcept {
+    RELOCO_ASSERT(has_value() && "Result does not contain a value");
+    return std::move(m_value);
+  }
+
+  constexpr const T &value() const & noexcept {
+    RELOCO_ASSERT(has_value() && "Result does not contain a value");
+    return m_value;
+  }
+
+  constexpr const T &&value() const && noexcept {
+    RELOCO_ASSERT(has_value() && "Result does not contain a value");
+    return std::move(m_value);
+  }
+
+  constexpr E error() const noexcept {
+    RELOCO_ASSERT(!has_value() && "Result does not contain an error");
+    return niche::decode(m_value);
+  }
+
+  template <typename F> auto transform(F &&f) const noexcept {
+    using NewValue = decltype(f(value()));
+    if (has_value())
+      return expected<NewValue, E>(f(value()));
+    return expected<NewValue, E>(unexpected(error()));
+  }
+
+  template <typename F> auto and_then(F &&f) const noexcept {
+    if (has_value())
+      return f(value());
+    return decltype(f(value()))(unexpected(error()));
+  }
+
+  constexpr T value_or(T &&fallback) const noexcept {
+    return has_value() ? m_value : std::move(fallback);
+  }
+
+  constexpr T *operator->() noexcept { return &value(); }
+  constexpr const T *operator->() const noexcept { return &value(); }
+
+  constexpr T &operator*() & noexcept { return value(); }
+  constexpr const T &operator*() const & noexcept { return value(); }
+  constexpr T &&operator*() && noexcept { return std::move(value()); }
+
+  constexpr bool operator==(const expected &other) const noexcept {
+    if (has_value() != other.has_value())
+      return false;
+    if (has_value())
+      return m_value == other.m_value;
+    return error() == other.error();
+  }
+
+  constexpr bool operator!=(const expected &other) const noexcept {
+    return !(*this == other);
+  }
+};
+
+template <typename E>
+  requires has_expected_niche<void, E>
+class [[nodiscard]] expected<void, E> {
+  static constexpr E no_error = expected_niche<void, E>::no_error;
+
+  E m_error = no_error;
+
+public:
+  constexpr expected() noexcept = default;
+  constexpr expected(unexpected<E> &&err) noexcept : m_error(err.value()) {
+    RELOCO_DEBUG_ASSERT(m_error != no_error &&
+                        "The success value cannot be used as an error");
+  }
+
+  constexpr bool has_value() const noexcept { return m_error == no_error; }
+  constexpr explicit operator bool() const noexcept { return has_value(); }
+
+  void value() const noexcept {
+    RELOCO_ASSERT(has_value() && "Result contains an error");
+  }
+
+  constexpr E error() const noexcept {
+    RELOCO_ASSERT(!has_value() && "Result does not contain an error");
+    return m_error;
+  }
+
+  constexpr bool operator==(const expected &other) const noexcept {
+    return m_error == other.m_error;
+  }
+
+  constexpr bool operator!=(const expected &other) const noexcept {
+    return !(*this == other);
+  }
+};
+
 template <typename E> class [[nodiscard]] expected<void, E> {
   union {
     E m_error;
@@ -2,6 +2,7 @@
 #include <reloco/assert.hpp>
 #include <reloco/concepts.hpp>
 #include <reloco/core.hpp>
+#include <reloco/error_origin.hpp>
 
 namespace reloco {
 
@@ -139,14 +140,14 @@ public:
 
   [[nodiscard]] result<T *> try_get() noexcept {
     if (!m_initialized) [[unlikely]] {
-      return unexpected(error::not_initialized);
+      return RELOCO_ERROR(error::not_initialized);
     }
     return &m_storage;
   }
 
   [[nodiscard]] result<const T *> try_get() const noexcept {
     if (!m_initialized) [[unlikely]] {
-      return unexpected(error::not_initialized);
+      return RELOCO_ERROR(error::not_initialized);
     }
     return &m_storage;
   }
@@ -222,7 +223,7 @@ public:
 
   [[nodiscard]] result<T *> try_get() const & noexcept {
     if (!m_ptr) [[unlikely]] {
-      return unexpected(error::not_initialized);
+      return RELOCO_ERROR(error::not_initialized);
     }
     return m_ptr;
   }
@@ -341,14 +342,14 @@ public:
 
   [[nodiscard]] result<T *> try_get() & noexcept {
     if (!m_initialized) [[unlikely]] {
-      return unexpected(error::not_initialized);
+      return RELOCO_ERROR(error::not_initialized);
     }
     return reinterpret_cast<T *>(&m_storage);
   }
 
   [[nodiscard]] result<const T *> try_get() const & noexcept {
     if (!m_initialized) [[unlikely]] {
-      return unexpected(error::not_initialized);
+      return RELOCO_ERROR(error::not_initialized);
     }
     return reinterpret_cast<const T *>(&m_storage);
   }
@@ -2,6 +2,7 @@
 #include <atomic>
 #include <reloco/concepts.hpp>
 #include <reloco/fallible_constructed.hpp>
+#include <reloco/once.hpp>
 
 namespace reloco {
 
@@ -70,4 +71,28 @@ public:
   }
 };
 
+/**
+ * Thread-safe singleton that needs no external lock. After the first
+ * successful ``instance()`` every call is a single acquire load. Threads
+ * racing the initialization park on a futex until it finishes. A failed
+ * ``try_init`` is not sticky, the next ``instance()`` call retries it.
+ */
+template <is_fallible_initializable T> class concurrent_fallible_singleton {
+public:
+  static result<T *> instance() noexcept {
+    auto res = m_once.try_call([] { return m_storage.try_init(); });
+    if (!res) [[unlikely]]
+      return unexpected(res.error());
+    return m_storage.get();
+  }
+
+  [[nodiscard]] static bool is_initialized() noexcept {
+    return m_once.is_done();
+  }
+
+private:
+  static inline once_flag m_once;
+  static inline static_fallible_constructed<T> m_storage;
+};
+
 } // namespace reloco
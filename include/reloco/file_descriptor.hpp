@@ -0,0 +1,104 @@
+#pragma once
+#include <cerrno>
+#include <fcntl.h>
+#include <reloco/core.hpp>
+#include <reloco/error_origin.hpp>
+#include <sys/types.h>
+#include <unistd.h>
+
+namespace reloco {
+
+namespace detail {
+
+/**
+ * @brief Maps the errno of a failed file system call onto reloco::error.
+ */
+inline error error_from_errno(const int errno_value) noexcept {
+  switch (errno_value) {
+  case ENOENT:
+  case ENOTDIR:
+    return error::not_found;
+  case EEXIST:
+    return error::already_exists;
+  case ENOMEM:
+    return error::allocation_failed;
+  case EINVAL:
+  case EBADF:
+  case EISDIR:
+  case ENAMETOOLONG:
+    return error::invalid_argument;
+  case EAGAIN:
+  case EBUSY:
+  case EINTR:
+    return error::try_again;
+  case EOVERFLOW:
+  case EFBIG:
+    return error::integer_overflow;
+  case ENOSYS:
+  case EOPNOTSUPP:
+    return error::unsupported_operation;
+  default:
+    return error::io_failed;
+  }
+}
+
+} // namespace detail
+
+/**
+ * @brief Owning POSIX file descriptor, closed on destruction.
+ */
+class unique_fd {
+  int m_fd = -1;
+
+public:
+  unique_fd() noexcept = default;
+  explicit unique_fd(const int fd) noexcept : m_fd(fd) {}
+
+  unique_fd(const unique_fd &) = delete;
+  unique_fd &operator=(const unique_fd &) = delete;
+
+  unique_fd(unique_fd &&other) noexcept : m_fd(other.release()) {}
+  unique_fd &operator=(unique_fd &&other) noexcept {
+    if (this != &other)
+      reset(other.release());
+    return *this;
+  }
+
+  ~unique_fd() { reset(); }
+
+  /**
+   * @brief open(2) with ``O_CLOEXEC`` added, retried on EINTR.
+   */
+  static result<unique_fd> try_open(const char *path, const int flags,
+                                    const mode_t mode = 0644) noexcept {
+    int fd;
+    do {
+      fd = ::open(path, flags | O_CLOEXEC, mode);
+    } while (fd < 0 && errno == EINTR);
+    if (fd < 0)
+      return RELOCO_ERROR(detail::error_from_errno(errno));
+    return unique_fd(fd);
+  }
+
+  [[nodiscard]] int get() const noexcept { return m_fd; }
+  [[nodiscard]] bool valid() const noexcept { return m_fd >= 0; }
+  explicit operator bool() const noexcept { return valid(); }
+
+  /**
+   * @brief Gives up ownership without closing.
+   */
+  [[nodiscard]] int release() noexcept {
+    const int fd = m_fd;
+    m_fd = -1;
+    return fd;
+  }
+
+  void reset(const int fd = -1) noexcept {
+    // The descriptor is gone even if close reports an error, so no retry
+    if (m_fd >= 0)
+      ::close(m_fd);
+    m_fd = fd;
+  }
+};
+
+} // namespace reloco
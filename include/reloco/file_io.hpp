@@ -0,0 +1,553 @@
+#pragma once
+#include <climits>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <reloco/allocator.hpp>
+#include <reloco/assert.hpp>
+#include <reloco/core.hpp>
+#include <reloco/error_origin.hpp>
+#include <reloco/file_descriptor.hpp>
+#include <reloco/span.hpp>
+#include <reloco/string_view.hpp>
+#include <sys/uio.h>
+#include <tuple>
+#include <unistd.h>
+
+namespace reloco {
+
+/**
+ * @brief Buffer alignment and granularity used for ``O_DIRECT`` I/O.
+ * A page satisfies the logical block size of every common device.
+ */
+inline constexpr std::size_t direct_io_alignment = 4096;
+
+struct file_io_options {
+  /// Initial buffer size; the reader grows it for lines and records that
+  /// do not fit
+  std::size_t buffer_size = 64 * 1024;
+  /// Open with ``O_DIRECT``, bypassing the page cache. Buffers are then
+  /// aligned to, and sized in multiples of, direct_io_alignment
+  bool direct = false;
+  /// Writer only: append instead of truncating
+  bool append = false;
+};
+
+namespace detail {
+
+#ifdef IOV_MAX
+inline constexpr std::size_t max_iovecs = IOV_MAX;
+#else
+inline constexpr std::size_t max_iovecs = 16;
+#endif
+
+inline result<int> try_direct_flag(const bool direct) noexcept {
+  if (!direct)
+    return 0;
+#ifdef O_DIRECT
+  return O_DIRECT;
+#else
+  return RELOCO_ERROR(error::unsupported_operation);
+#endif
+}
+
+/**
+ * @brief Buffer owned by a file_reader or file_writer.
+ */
+class io_buffer {
+  fallible_allocator *m_alloc;
+  std::byte *m_data = nullptr;
+  std::size_t m_capacity = 0;
+  std::size_t m_alignment = 1;
+
+public:
+  explicit io_buffer(fallible_allocator &alloc) noexcept : m_alloc(&alloc) {}
+
+  io_buffer(const io_buffer &) = delete;
+  io_buffer &operator=(const io_buffer &) = delete;
+
+  io_buffer(io_buffer &&other) noexcept
+      : m_alloc(other.m_alloc), m_data(other.m_data),
+        m_capacity(other.m_capacity), m_alignment(other.m_alignment) {
+    other.m_data = nullptr;
+    other.m_capacity = 0;
+  }
+
+  ~io_buffer() {
+    if (m_data)
+      m_alloc->deallocate(m_data, m_capacity);
+  }
+
+  result<void> try_allocate(std::size_t capacity,
+                            const std::size_t alignment) noexcept {
+    capacity = (capacity + alignment - 1) & ~(alignment - 1);
+    if (capacity == 0)
+      capacity = alignment;
+    auto block = m_alloc->allocate(capacity, alignment);
+    if (!block)
+      return RELOCO_ALLOC_ERROR(error::allocation_failed, *m_alloc);
+    m_data = static_cast<std::byte *>(block->ptr);
+    m_capacity = capacity;
+    m_alignment = alignment;
+    return {};
+  }
+
+  /**
+   * @brief Doubles the capacity, keeping the contents.
+   */
+  result<void> try_grow() noexcept {
+    if (m_capacity > SIZE_MAX / 2)
+      return RELOCO_ERROR(error::integer_overflow);
+    auto block = m_alloc->reallocate(m_data, m_capacity, m_capacity * 2,
+                                     m_alignment);
+    if (!block)
+      return RELOCO_ALLOC_ERROR(error::allocation_failed, *m_alloc);
+    m_data = static_cast<std::byte *>(block->ptr);
+    m_capacity *= 2;
+    return {};
+  }
+
+  std::byte *data() const noexcept { return m_data; }
+  std::size_t capacity() const noexcept { return m_capacity; }
+  std::size_t alignment() const noexcept { return m_alignment; }
+};
+
+inline result<std::size_t> try_read_some(const int fd, std::byte *out,
+                                         const std::size_t count) noexcept {
+  ssize_t n;
+  do {
+    n = ::read(fd, out, count);
+  } while (n < 0 && errno == EINTR);
+  if (n < 0)
+    return RELOCO_ERROR(error_from_errno(errno));
+  return static_cast<std::size_t>(n);
+}
+
+/**
+ * @brief writev() until every byte of ``iov`` is written, in batches of at
+ * most max_iovecs. ``iov`` is consumed in place. ``written`` counts the
+ * bytes that reached the file, also when an error stops it partway.
+ */
+inline result<void> try_write_fully(const int fd, iovec *iov,
+                                    std::size_t count,
+                                    std::size_t &written_total) noexcept {
+  while (count > 0) {
+    const std::size_t batch = count < max_iovecs ? count : max_iovecs;
+    ssize_t n;
+    do {
+      n = ::writev(fd, iov, static_cast<int>(batch));
+    } while (n < 0 && errno == EINTR);
+    if (n < 0)
+      return RELOCO_ERROR(error_from_errno(errno));
+
+    auto written = static_cast<std::size_t>(n);
+    written_total += written;
+    while (count > 0 && written >= iov->iov_len) {
+      written -= iov->iov_len;
+      ++iov;
+      --count;
+    }
+    if (count > 0) {
+      iov->iov_base = static_cast<std::byte *>(iov->iov_base) + written;
+      iov->iov_len -= written;
+    }
+  }
+  return {};
+}
+
+} // namespace detail
+
+/**
+ * @brief Buffered reader over a file descriptor.
+ * Besides copying out with try_read_into(), callers can parse in place:
+ * try_read_line() and try_read_exact() return views of the internal buffer
+ * that stay valid until the next call on the reader.
+ */
+class file_reader {
+  unique_fd m_fd;
+  detail::io_buffer m_buffer;
+  std::size_t m_begin = 0;
+  std::size_t m_end = 0;
+  bool m_direct = false;
+  bool m_eof = false;
+
+  file_reader(unique_fd fd, fallible_allocator &alloc) noexcept
+      : m_fd(std::move(fd)), m_buffer(alloc) {}
+
+public:
+  file_reader(file_reader &&) noexcept = default;
+
+  static result<file_reader>
+  try_open(const char *path, const file_io_options &opts = {},
+           fallible_allocator &alloc = get_default_allocator()) noexcept {
+    RELOCO_TRY_ASSIGN(const int direct, detail::try_direct_flag(opts.direct));
+    RELOCO_TRY_ASSIGN(unique_fd fd,
+                      unique_fd::try_open(path, O_RDONLY | direct));
+    return try_adopt(std::move(fd), opts, alloc);
+  }
+
+  /**
+   * @brief Reads from an already open ``fd``. ``opts.direct`` only aligns
+   * the buffer here; the descriptor must have been opened with O_DIRECT.
+   */
+  static result<file_reader>
+  try_adopt(unique_fd fd, const file_io_options &opts = {},
+            fallible_allocator &alloc = get_default_allocator()) noexcept {
+    file_reader reader(std::move(fd), alloc);
+    reader.m_direct = opts.direct;
+    RELOCO_TRY(reader.m_buffer.try_allocate(
+        opts.buffer_size, opts.direct ? direct_io_alignment : 1));
+    return reader;
+  }
+
+  /**
+   * @brief Bytes read from the file but not consumed yet.
+   */
+  [[nodiscard]] span<const std::byte> buffered() const & noexcept {
+    return span<const std::byte>(m_buffer.data() + m_begin, m_end - m_begin);
+  }
+
+  void consume(const std::size_t count) noexcept {
+    RELOCO_DEBUG_ASSERT(count <= m_end - m_begin, "consumed past buffer");
+    m_begin += count;
+  }
+
+  [[nodiscard]] bool at_eof() const noexcept {
+    return m_eof && m_begin == m_end;
+  }
+
+  /**
+   * @brief Reads more of the file behind the buffered bytes, growing the
+   * buffer if it is full.
+   * @return The number of bytes added, 0 at end of file.
+   */
+  result<std::size_t> try_fill() noexcept {
+    if (m_eof)
+      return std::size_t{0};
+    compact();
+    if (m_end == m_buffer.capacity())
+      RELOCO_TRY(m_buffer.try_grow());
+
+    const std::size_t room = m_buffer.capacity() - m_end;
+    RELOCO_TRY_ASSIGN(const std::size_t n,
+                      detail::try_read_some(m_fd.get(),
+                                            m_buffer.data() + m_end, room));
+    m_end += n;
+    // A short direct read means end of file; reading on from the unaligned
+    // offset it leaves would fail
+    m_eof = n == 0 || (m_direct && n < room);
+    return n;
+  }
+
+  /**
+   * @brief Copies up to ``out.size()`` bytes into ``out``. Large requests
+   * bypass the buffer unless the file was opened for direct I/O.
+   * @return The number of bytes copied; less than requested only at end of
+   * file.
+   */
+  result<std::size_t> try_read_into(span<std::byte> out) noexcept {
+    std::byte *dest = out.empty() ? nullptr : out.unsafe_data();
+    const std::size_t wanted = out.size();
+    std::size_t copied = 0;
+    while (copied < wanted) {
+      if (m_begin == m_end) {
+        if (!m_direct && wanted - copied >= m_buffer.capacity()) {
+          RELOCO_TRY_ASSIGN(const std::size_t n,
+                            detail::try_read_some(m_fd.get(), dest + copied,
+                                                  wanted - copied));
+          if (n == 0) {
+            m_eof = true;
+            break;
+          }
+          copied += n;
+          continue;
+        }
+        RELOCO_TRY_ASSIGN(const std::size_t n, try_fill());
+        if (n == 0)
+          break;
+      }
+      const std::size_t available = m_end - m_begin;
+      const std::size_t chunk =
+          available < wanted - copied ? available : wanted - copied;
+      std::memcpy(dest + copied, m_buffer.data() + m_begin, chunk);
+      m_begin += chunk;
+      copied += chunk;
+    }
+    return copied;
+  }
+
+  /**
+   * @brief Borrows the next ``count`` bytes, e.g. a fixed-size record.
+   * @return end_of_file if the file is exhausted, invalid_format if it ends
+   * partway through the record.
+   */
+  result<span<const std::byte>>
+  try_read_exact(const std::size_t count) noexcept {
+    while (m_end - m_begin < count) {
+      RELOCO_TRY_ASSIGN(const std::size_t n, try_fill());
+      if (n == 0)
+        return RELOCO_ERROR(m_begin == m_end ? error::end_of_file
+                                             : error::invalid_format);
+    }
+    const std::byte *first = m_buffer.data() + m_begin;
+    m_begin += count;
+    return span<const std::byte>(first, count);
+  }
+
+  /**
+   * @brief Borrows the next line, without its ``delimiter``. The last line
+   * need not end in one.
+   * @return end_of_file once every line has been returned.
+   */
+  result<string_view> try_read_line(const char delimiter = '\n') noexcept {
+    std::size_t scanned = 0;
+    for (;;) {
+      const char *first =
+          reinterpret_cast<const char *>(m_buffer.data() + m_begin);
+      const std::size_t available = m_end - m_begin;
+      if (const void *hit = std::memchr(first + scanned, delimiter,
+                                        available - scanned)) {
+        const auto length =
+            static_cast<std::size_t>(static_cast<const char *>(hit) - first);
+        m_begin += length + 1;
+        return string_view(first, length);
+      }
+      scanned = available;
+
+      RELOCO_TRY_ASSIGN(const std::size_t n, try_fill());
+      if (n == 0) {
+        if (m_begin == m_end)
+          return RELOCO_ERROR(error::end_of_file);
+        first = reinterpret_cast<const char *>(m_buffer.data() + m_begin);
+        const std::size_t length = m_end - m_begin;
+        m_begin = m_end;
+        return string_view(first, length);
+      }
+    }
+  }
+
+private:
+  /**
+   * @brief Moves the unconsumed bytes to the front, leaving the next read
+   * aligned for direct I/O.
+   */
+  void compact() noexcept {
+    const std::size_t pending = m_end - m_begin;
+    const std::size_t align = m_buffer.alignment();
+    const std::size_t start = ((pending + align - 1) & ~(align - 1)) - pending;
+    if (start == m_begin)
+      return;
+    if (pending > 0)
+      std::memmove(m_buffer.data() + start, m_buffer.data() + m_begin,
+                   pending);
+    m_begin = start;
+    m_end = start + pending;
+  }
+};
+
+/**
+ * @brief Buffered writer over a file descriptor.
+ * Writes that do not fit the buffer go out together with it in one writev().
+ * The destructor flushes on a best-effort basis; call try_close() to see
+ * errors.
+ *
+ * After a failed write, the buffer holds exactly the bytes that did not
+ * reach the file, so a retry or flush never repeats any. Bytes passed to
+ * the failing call itself may have been written in part.
+ */
+class file_writer {
+  unique_fd m_fd;
+  detail::io_buffer m_buffer;
+  std::size_t m_size = 0;
+  bool m_direct = false;
+
+  file_writer(unique_fd fd, fallible_allocator &alloc) noexcept
+      : m_fd(std::move(fd)), m_buffer(alloc) {}
+
+public:
+  file_writer(file_writer &&) noexcept = default;
+
+  ~file_writer() {
+    if (m_fd)
+      std::ignore = try_close();
+  }
+
+  /**
+   * @brief Creates or truncates ``path`` (or appends to it, with
+   * ``opts.append``).
+   */
+  static result<file_writer>
+  try_open(const char *path, const file_io_options &opts = {},
+           fallible_allocator &alloc = get_default_allocator()) noexcept {
+    RELOCO_TRY_ASSIGN(const int direct, detail::try_direct_flag(opts.direct));
+    const int mode = opts.append ? O_APPEND : O_TRUNC;
+    RELOCO_TRY_ASSIGN(unique_fd fd,
+                      unique_fd::try_open(path, O_WRONLY | O_CREAT | mode |
+                                                    direct));
+    return try_adopt(std::move(fd), opts, alloc);
+  }
+
+  /**
+   * @brief Writes to an already open ``fd``. ``opts.direct`` only aligns
+   * the buffer here; the descriptor must have been opened with O_DIRECT.
+   */
+  static result<file_writer>
+  try_adopt(unique_fd fd, const file_io_options &opts = {},
+            fallible_allocator &alloc = get_default_allocator()) noexcept {
+    file_writer writer(std::move(fd), alloc);
+    writer.m_direct = opts.direct;
+    RELOCO_TRY(writer.m_buffer.try_allocate(
+        opts.buffer_size, opts.direct ? direct_io_alignment : 1));
+    return writer;
+  }
+
+  result<void> try_write(span<const std::byte> bytes) noexcept {
+    const std::size_t count = bytes.size();
+    if (count == 0)
+      return {};
+    const std::byte *source = bytes.unsafe_data();
+    if (count <= m_buffer.capacity() - m_size) {
+      std::memcpy(m_buffer.data() + m_size, source, count);
+      m_size += count;
+      return {};
+    }
+    if (!m_direct) {
+      iovec iov[2] = {{m_buffer.data(), m_size},
+                      {const_cast<std::byte *>(source), count}};
+      std::size_t written = 0;
+      auto res = detail::try_write_fully(m_fd.get(), iov, 2, written);
+      discard_written(written);
+      return res;
+    }
+
+    // Direct I/O can only go out in whole aligned buffers
+    std::size_t done = 0;
+    while (done < count) {
+      const std::size_t room = m_buffer.capacity() - m_size;
+      const std::size_t chunk = room < count - done ? room : count - done;
+      std::memcpy(m_buffer.data() + m_size, source + done, chunk);
+      m_size += chunk;
+      done += chunk;
+      if (m_size == m_buffer.capacity())
+        RELOCO_TRY(try_flush());
+    }
+    return {};
+  }
+
+  result<void> try_write(const string_view text) noexcept {
+    if (text.empty())
+      return {};
+    return try_write(span<const std::byte>(
+        reinterpret_cast<const std::byte *>(text.data()), text.size()));
+  }
+
+  /**
+   * @brief Writes the buffered bytes and then every piece of ``pieces``,
+   * in order, with as few writev() calls as possible. Not available for
+   * direct I/O, whose writes must be aligned.
+   */
+  result<void>
+  try_write_batch(span<const span<const std::byte>> pieces) noexcept {
+    if (m_direct)
+      return RELOCO_ERROR(error::unsupported_operation);
+    std::size_t done = 0;
+    const std::size_t count = pieces.size();
+    const span<const std::byte> *first =
+        count == 0 ? nullptr : pieces.unsafe_data();
+    iovec iov[detail::max_iovecs < 64 ? detail::max_iovecs : 64];
+    std::size_t used = 0;
+    if (m_size > 0)
+      iov[used++] = {m_buffer.data(), m_size};
+    while (done < count || used > 0) {
+      while (done < count && used < std::size(iov)) {
+        const span<const std::byte> piece = first[done++];
+        if (!piece.empty())
+          iov[used++] = {const_cast<std::byte *>(piece.unsafe_data()),
+                         piece.size()};
+      }
+      if (used == 0)
+        break;
+      std::size_t written = 0;
+      auto res = detail::try_write_fully(m_fd.get(), iov, used, written);
+      discard_written(written);
+      if (!res)
+        return res;
+      used = 0;
+    }
+    return {};
+  }
+
+  /**
+   * @brief Borrows at least ``count`` writable bytes at the end of the
+   * buffer, flushing first if needed, to format output in place. Nothing is
+   * written until commit().
+   */
+  result<span<std::byte>> try_prepare(const std::size_t count) noexcept {
+    if (count > m_buffer.capacity() - m_size) {
+      RELOCO_TRY(try_flush());
+      while (count > m_buffer.capacity() - m_size)
+        RELOCO_TRY(m_buffer.try_grow());
+    }
+    return span<std::byte>(m_buffer.data() + m_size,
+                           m_buffer.capacity() - m_size);
+  }
+
+  void commit(const std::size_t count) noexcept {
+    RELOCO_DEBUG_ASSERT(count <= m_buffer.capacity() - m_size,
+                        "committed past prepared space");
+    m_size += count;
+  }
+
+  /**
+   * @brief Writes out the buffer. With direct I/O a trailing partial block
+   * stays buffered until try_close().
+   */
+  result<void> try_flush() noexcept {
+    std::size_t count = m_size;
+    if (m_direct)
+      count &= ~(direct_io_alignment - 1);
+    if (count == 0)
+      return {};
+    iovec iov{m_buffer.data(), count};
+    std::size_t written = 0;
+    auto res = detail::try_write_fully(m_fd.get(), &iov, 1, written);
+    discard_written(written);
+    return res;
+  }
+
+  /**
+   * @brief Flushes everything and closes the file. The file is closed even
+   * if the flush fails.
+   */
+  result<void> try_close() noexcept {
+    auto res = try_flush();
+    if (res && m_size > 0) {
+      // The unaligned tail of a direct write goes through the page cache
+      const int flags = ::fcntl(m_fd.get(), F_GETFL);
+#ifdef O_DIRECT
+      if (flags >= 0)
+        ::fcntl(m_fd.get(), F_SETFL, flags & ~O_DIRECT);
+#endif
+      iovec iov{m_buffer.data(), m_size};
+      std::size_t written = 0;
+      res = detail::try_write_fully(m_fd.get(), &iov, 1, written);
+      discard_written(written);
+    }
+    m_fd.reset();
+    return res;
+  }
+
+private:
+  /**
+   * @brief Drops the front of the buffer once ``written`` bytes of a write
+   * that started with it reached the file, so that a retry after an error
+   * does not write them twice.
+   */
+  void discard_written(const std::size_t written) noexcept {
+    const std::size_t count = written < m_size ? written : m_size;
+    std::memmove(m_buffer.data(), m_buffer.data() + count, m_size - count);
+    m_size -= count;
+  }
+};
+
+} // namespace reloco
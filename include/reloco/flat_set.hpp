@@ -1,12 +1,248 @@
 #pragma once
 #include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <functional>
 #include <iterator>
 #include <reloco/collection_view.hpp>
+#include <reloco/error_origin.hpp>
 #include <reloco/rvalue_safety.hpp>
+#include <reloco/span.hpp>
 #include <reloco/vector.hpp>
 
 namespace reloco {
 
+namespace detail {
+
+// Size ratio from which galloping through the larger input beats a merge
+inline constexpr std::size_t set_gallop_ratio = 32;
+
+/**
+ * First index in ``[lo, n)`` whose element is not less than ``key``, found by
+ * probing 1, 2, 4, ... elements ahead of ``lo`` and then bisecting.
+ */
+template <typename T, typename Compare>
+std::size_t gallop_lower_bound(const T *data, std::size_t lo, std::size_t n,
+                               const T &key, const Compare &comp) noexcept {
+  std::size_t step = 1;
+  std::size_t hi = lo;
+  while (hi < n && comp(data[hi], key)) {
+    lo = hi + 1;
+    hi += step;
+    step *= 2;
+  }
+  hi = std::min(hi, n);
+  return static_cast<std::size_t>(
+      std::lower_bound(data + lo, data + hi, key, comp) - data);
+}
+
+template <typename T>
+result<void> append_run(vector<T> &out, const T *first,
+                        std::size_t count) noexcept {
+  return out.try_append(span<const T>(first, count));
+}
+
+template <typename T, typename Compare>
+constexpr bool is_plain_less = std::same_as<Compare, std::less<T>> ||
+                               std::same_as<Compare, std::less<>>;
+
+#if defined(__GNUC__) || defined(__clang__)
+template <typename T>
+concept block_intersectable = std::integral<T> && sizeof(T) == 4;
+
+/**
+ * Intersects four keys of ``a`` with four keys of ``b`` per step: each key
+ * of the ``b`` block is broadcast and compared with the whole ``a`` block.
+ * Advances ``i`` and ``j`` to where the scalar merge has to continue.
+ */
+template <block_intersectable T>
+result<void> intersect_blocks(const T *a, std::size_t na, const T *b,
+                              std::size_t nb, std::size_t &i, std::size_t &j,
+                              vector<T> &out) noexcept {
+  typedef T block
+      __attribute__((vector_size(16), aligned(alignof(T)), may_alias));
+  constexpr std::size_t lanes = 4;
+
+  while (i + lanes <= na && j + lanes <= nb) {
+    const block &va = *reinterpret_cast<const block *>(a + i);
+    const auto match =
+        (va == (block{} + b[j])) | (va == (block{} + b[j + 1])) |
+        (va == (block{} + b[j + 2])) | (va == (block{} + b[j + 3]));
+    if (match[0] | match[1] | match[2] | match[3]) {
+      for (std::size_t k = 0; k < lanes; ++k)
+        if (match[k])
+          RELOCO_TRY(append_run(out, a + i + k, 1));
+    }
+    const T a_last = a[i + lanes - 1];
+    const T b_last = b[j + lanes - 1];
+    i += a_last <= b_last ? lanes : 0;
+    j += b_last <= a_last ? lanes : 0;
+  }
+  return {};
+}
+#endif
+
+/**
+ * Appends the elements of ``a`` that are also in ``b``. Both inputs must be
+ * sorted by ``comp`` and free of duplicates, as in flat_set.
+ */
+template <typename T, typename Compare>
+result<void> set_intersection_into(span<const T> a, span<const T> b,
+                                   vector<T> &out,
+                                   const Compare &comp) noexcept {
+  const std::size_t na = a.size();
+  const std::size_t nb = b.size();
+  if (na == 0 || nb == 0)
+    return {};
+  const T *pa = a.unsafe_data();
+  const T *pb = b.unsafe_data();
+
+  if (na <= nb / set_gallop_ratio) {
+    std::size_t cur = 0;
+    for (std::size_t i = 0; i < na && cur < nb; ++i) {
+      cur = gallop_lower_bound(pb, cur, nb, pa[i], comp);
+      if (cur < nb && !comp(pa[i], pb[cur]))
+        RELOCO_TRY(append_run(out, pa + i, 1));
+    }
+    return {};
+  }
+  if (nb <= na / set_gallop_ratio) {
+    std::size_t cur = 0;
+    for (std::size_t j = 0; j < nb && cur < na; ++j) {
+      cur = gallop_lower_bound(pa, cur, na, pb[j], comp);
+      if (cur < na && !comp(pb[j], pa[cur]))
+        RELOCO_TRY(append_run(out, pa + cur, 1));
+    }
+    return {};
+  }
+
+  std::size_t i = 0;
+  std::size_t j = 0;
+#if defined(__GNUC__) || defined(__clang__)
+  if constexpr (block_intersectable<T> && is_plain_less<T, Compare>)
+    RELOCO_TRY(intersect_blocks(pa, na, pb, nb, i, j, out));
+#endif
+  while (i < na && j < nb) {
+    if (comp(pa[i], pb[j])) {
+      ++i;
+    } else if (comp(pb[j], pa[i])) {
+      ++j;
+    } else {
+      RELOCO_TRY(append_run(out, pa + i, 1));
+      ++i;
+      ++j;
+    }
+  }
+  return {};
+}
+
+/**
+ * Appends every element of ``a`` or ``b``, taking it from ``a`` when both
+ * hold it. Runs from one input are copied in bulk.
+ */
+template <typename T, typename Compare>
+result<void> set_union_into(span<const T> a, span<const T> b, vector<T> &out,
+                            const Compare &comp) noexcept {
+  const std::size_t na = a.size();
+  const std::size_t nb = b.size();
+  const T *pa = na ? a.unsafe_data() : nullptr;
+  const T *pb = nb ? b.unsafe_data() : nullptr;
+
+  std::size_t i = 0;
+  std::size_t j = 0;
+  if (na <= nb / set_gallop_ratio) {
+    for (; i < na; ++i) {
+      const std::size_t pos = gallop_lower_bound(pb, j, nb, pa[i], comp);
+      RELOCO_TRY(append_run(out, pb + j, pos - j));
+      RELOCO_TRY(append_run(out, pa + i, 1));
+      j = pos < nb && !comp(pa[i], pb[pos]) ? pos + 1 : pos;
+    }
+  } else if (nb <= na / set_gallop_ratio) {
+    for (; j < nb; ++j) {
+      std::size_t pos = gallop_lower_bound(pa, i, na, pb[j], comp);
+      const bool shared = pos < na && !comp(pb[j], pa[pos]);
+      pos += shared;
+      RELOCO_TRY(append_run(out, pa + i, pos - i));
+      if (!shared)
+        RELOCO_TRY(append_run(out, pb + j, 1));
+      i = pos;
+    }
+  } else {
+    while (i < na && j < nb) {
+      const std::size_t run_a = i;
+      while (i < na && comp(pa[i], pb[j]))
+        ++i;
+      RELOCO_TRY(append_run(out, pa + run_a, i - run_a));
+      if (i == na)
+        break;
+      const std::size_t run_b = j;
+      while (j < nb && comp(pb[j], pa[i]))
+        ++j;
+      RELOCO_TRY(append_run(out, pb + run_b, j - run_b));
+      if (j < nb && !comp(pa[i], pb[j])) {
+        RELOCO_TRY(append_run(out, pa + i, 1));
+        ++i;
+        ++j;
+      }
+    }
+  }
+  RELOCO_TRY(append_run(out, pa + i, na - i));
+  return append_run(out, pb + j, nb - j);
+}
+
+/**
+ * Appends the elements of ``a`` that are not in ``b``.
+ */
+template <typename T, typename Compare>
+result<void> set_difference_into(span<const T> a, span<const T> b,
+                                 vector<T> &out,
+                                 const Compare &comp) noexcept {
+  const std::size_t na = a.size();
+  const std::size_t nb = b.size();
+  if (na == 0)
+    return {};
+  const T *pa = a.unsafe_data();
+  const T *pb = nb ? b.unsafe_data() : nullptr;
+
+  std::size_t i = 0;
+  std::size_t j = 0;
+  if (na <= nb / set_gallop_ratio) {
+    for (; i < na; ++i) {
+      j = gallop_lower_bound(pb, j, nb, pa[i], comp);
+      if (j == nb || comp(pa[i], pb[j]))
+        RELOCO_TRY(append_run(out, pa + i, 1));
+    }
+    return {};
+  }
+  if (nb <= na / set_gallop_ratio) {
+    for (; j < nb; ++j) {
+      std::size_t pos = gallop_lower_bound(pa, i, na, pb[j], comp);
+      RELOCO_TRY(append_run(out, pa + i, pos - i));
+      if (pos < na && !comp(pb[j], pa[pos]))
+        ++pos;
+      i = pos;
+    }
+  } else {
+    while (i < na && j < nb) {
+      const std::size_t run_a = i;
+      while (i < na && comp(pa[i], pb[j]))
+        ++i;
+      RELOCO_TRY(append_run(out, pa + run_a, i - run_a));
+      if (i == na)
+        break;
+      while (j < nb && comp(pb[j], pa[i]))
+        ++j;
+      if (j < nb && !comp(pa[i], pb[j])) {
+        ++i;
+        ++j;
+      }
+    }
+  }
+  return append_run(out, pa + i, na - i);
+}
+
+} // namespace detail
+
 template <typename T, typename Compare = std::less<T>> class flat_set {
   vector<T> m_data;
   Compare m_comp;
@@ -16,10 +252,9 @@ public:
 
   static result<flat_set> try_allocate(fallible_allocator &alloc,
                                        size_t initial_capacity = 0) {
-    auto vec_res = vector<T>::try_allocate(alloc, initial_capacity);
-    if (!vec_res)
-      return unexpected(vec_res.error());
-    return flat_set(std::move(*vec_res));
+    RELOCO_TRY_ASSIGN(vector<T> data,
+                      vector<T>::try_allocate(alloc, initial_capacity));
+    return flat_set(std::move(data));
   }
 
   static result<flat_set> try_create(size_t initial_capacity = 0) {
@@ -27,12 +262,23 @@ public:
   }
 
   size_t size() const noexcept { return m_data.size(); }
+  [[nodiscard]] bool empty() const noexcept { return m_data.empty(); }
   void clear() noexcept { m_data.clear(); }
 
+  const T *begin() const & noexcept { return m_data.begin(); }
+  const T *end() const & noexcept { return m_data.end(); }
+
+  /**
+   * @brief The elements in ascending order.
+   */
+  [[nodiscard]] span<const T> as_span() const & noexcept {
+    return span<const T>(m_data.begin(), m_data.size());
+  }
+
   result<T *> try_insert(T &&value) & noexcept {
     auto it = find_pos(value);
     if (it != m_data.end() && !m_comp(value, *it)) {
-      return unexpected(error::already_exists);
+      return RELOCO_ERROR(error::already_exists);
     }
     const auto index = std::distance(std::as_const(m_data).begin(), it);
     RELOCO_ASSERT(index >= 0);
@@ -51,38 +297,164 @@ public:
     if (it != m_data.end() && !m_comp(value, *it)) {
       return std::cref(*it);
     }
-    return unexpected(error::not_found);
+    return RELOCO_ERROR(error::not_found);
   }
 
   /**
    * Construct non-owning view of this flat map
    */
-  result<any_view<T>> as_view() & noexcept { return m_data.as_view(); }
+  any_view<T> as_view() & noexcept { return m_data.as_view(); }
 
   /**
    * @brief Performs a deep copy of the set using a specific allocator.
    */
   result<flat_set> try_clone(fallible_allocator &alloc) const noexcept {
-    flat_set result;
-
-    auto cloned_data = m_data.try_clone(alloc);
-    if (!cloned_data)
-      return unexpected(cloned_data.error());
-
-    result.m_data = std::move(*cloned_data);
-    return result;
+    RELOCO_TRY_ASSIGN(vector<T> data, m_data.try_clone(alloc));
+    return flat_set(std::move(data), m_comp);
   }
 
   result<flat_set> try_clone() const noexcept {
     return try_clone(*m_data.get_allocator());
   }
 
+  /**
+   * @brief Elements present in both sets, allocated from ``alloc``.
+   * Skewed sizes gallop through the larger set; 32-bit integer keys under
+   * the default ordering are matched four at a time. The result is sized
+   * with one reserve of the smaller input's size.
+   */
+  result<flat_set>
+  try_set_intersection(const flat_set &other,
+                       fallible_allocator &alloc) const & noexcept {
+    const std::size_t bound = std::min(size(), other.size());
+    RELOCO_TRY_ASSIGN(vector<T> out, vector<T>::try_allocate(alloc, bound));
+    RELOCO_TRY(detail::set_intersection_into(as_span(), other.as_span(), out,
+                                             m_comp));
+    return flat_set(std::move(out), m_comp);
+  }
+
+  result<flat_set>
+  try_set_intersection(const flat_set &other) const & noexcept {
+    return try_set_intersection(other, *m_data.get_allocator());
+  }
+
+  /**
+   * @brief Elements present in either set, allocated from ``alloc`` with one
+   * reserve of both sizes combined. Runs and skewed inputs copy in bulk.
+   */
+  result<flat_set> try_set_union(const flat_set &other,
+                                 fallible_allocator &alloc) const & noexcept {
+    if (other.size() > SIZE_MAX / sizeof(T) - size())
+      return RELOCO_ERROR(error::integer_overflow);
+    RELOCO_TRY_ASSIGN(vector<T> out,
+                      vector<T>::try_allocate(alloc, size() + other.size()));
+    RELOCO_TRY(
+        detail::set_union_into(as_span(), other.as_span(), out, m_comp));
+    return flat_set(std::move(out), m_comp);
+  }
+
+  result<flat_set> try_set_union(const flat_set &other) const & noexcept {
+    return try_set_union(other, *m_data.get_allocator());
+  }
+
+  /**
+   * @brief Elements of this set missing from ``other``, allocated from
+   * ``alloc`` with one reserve of this set's size.
+   */
+  result<flat_set>
+  try_set_difference(const flat_set &other,
+                     fallible_allocator &alloc) const & noexcept {
+    RELOCO_TRY_ASSIGN(vector<T> out, vector<T>::try_allocate(alloc, size()));
+    RELOCO_TRY(detail::set_difference_into(as_span(), other.as_span(), out,
+                                           m_comp));
+    return flat_set(std::move(out), m_comp);
+  }
+
+  result<flat_set> try_set_difference(const flat_set &other) const & noexcept {
+    return try_set_difference(other, *m_data.get_allocator());
+  }
+
 private:
   template <typename Key> auto find_pos(const Key &value) const noexcept {
     return std::lower_bound(m_data.begin(), m_data.end(), value, m_comp);
   }
 
   flat_set(vector<T> &&vec) noexcept : m_data(std::move(vec)) {}
+  flat_set(vector<T> &&vec, const Compare &comp) noexcept
+      : m_data(std::move(vec)), m_comp(comp) {}
 };
 
+/**
+ * @brief Set operations on sorted, duplicate-free spans, appending to
+ * ``out`` after reserving for the largest possible result once.
+ */
+template <typename T, typename Compare = std::less<T>>
+result<void> try_set_intersection(span<const T> a, span<const T> b,
+                                  vector<T> &out,
+                                  const Compare &comp = {}) noexcept {
+  RELOCO_TRY(out.try_reserve(out.size() + std::min(a.size(), b.size())));
+  return detail::set_intersection_into(a, b, out, comp);
+}
+
+template <typename T, typename Compare = std::less<T>>
+result<void> try_set_union(span<const T> a, span<const T> b, vector<T> &out,
+                           const Compare &comp = {}) noexcept {
+  if (b.size() > SIZE_MAX / sizeof(T) - a.size() - out.size())
+    return RELOCO_ERROR(error::integer_overflow);
+  RELOCO_TRY(out.try_reserve(out.size() + a.size() + b.size()));
+  return detail::set_union_into(a, b, out, comp);
+}
+
+template <typename T, typename Compare = std::less<T>>
+result<void> try_set_difference(span<const T> a, span<const T> b,
+                                vector<T> &out,
+                                const Compare &comp = {}) noexcept {
+  RELOCO_TRY(out.try_reserve(out.size() + a.size()));
+  return detail::set_difference_into(a, b, out, comp);
+}
+
+template <typename T, typename Compare>
+result<flat_set<T, Compare>>
+try_set_intersection(const flat_set<T, Compare> &a,
+                     const flat_set<T, Compare> &b) noexcept {
+  return a.try_set_intersection(b);
+}
+
+template <typename T, typename Compare>
+result<flat_set<T, Compare>>
+try_set_intersection(const flat_set<T, Compare> &a,
+                     const flat_set<T, Compare> &b,
+                     fallible_allocator &alloc) noexcept {
+  return a.try_set_intersection(b, alloc);
+}
+
+template <typename T, typename Compare>
+result<flat_set<T, Compare>>
+try_set_union(const flat_set<T, Compare> &a,
+              const flat_set<T, Compare> &b) noexcept {
+  return a.try_set_union(b);
+}
+
+template <typename T, typename Compare>
+result<flat_set<T, Compare>> try_set_union(const flat_set<T, Compare> &a,
+                                           const flat_set<T, Compare> &b,
+                                           fallible_allocator &alloc) noexcept {
+  return a.try_set_union(b, alloc);
+}
+
+template <typename T, typename Compare>
+result<flat_set<T, Compare>>
+try_set_difference(const flat_set<T, Compare> &a,
+                   const flat_set<T, Compare> &b) noexcept {
+  return a.try_set_difference(b);
+}
+
+template <typename T, typename Compare>
+result<flat_set<T, Compare>>
+try_set_difference(const flat_set<T, Compare> &a,
+                   const flat_set<T, Compare> &b,
+                   fallible_allocator &alloc) noexcept {
+  return a.try_set_difference(b, alloc);
+}
+
 } // namespace reloco
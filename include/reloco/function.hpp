@@ -1,6 +1,7 @@
 #pragma once
 #include <functional>
 #include <reloco/allocator.hpp>
+#include <reloco/error_origin.hpp>
 
 namespace reloco {
 
@@ -31,7 +32,7 @@ public:
       // Requires heap allocation
       auto res = alloc.allocate(sizeof(DecayedF), alignof(DecayedF));
       if (!res)
-        return unexpected(error::allocation_failed);
+        return RELOCO_ALLOC_ERROR(error::allocation_failed, alloc);
 
       new (res->ptr) DecayedF(std::forward<F>(func));
 
@@ -62,9 +63,9 @@ public:
 
     if (!m_vtable) [[unlikely]] {
       if constexpr (is_result_v<ReturnType>) {
-        return ReturnType(unexpected(error::container_empty));
+        return ReturnType(RELOCO_ERROR(error::container_empty));
       } else {
-        return result<ReturnType>(unexpected(error::container_empty));
+        return result<ReturnType>(RELOCO_ERROR(error::container_empty));
       }
     }
 
@@ -112,7 +113,7 @@ public:
 
   result<function> try_clone() const noexcept {
     if (!m_vtable || !m_vtable->try_clone) {
-      return unexpected(error::unsupported_operation);
+      return RELOCO_ERROR(error::unsupported_operation);
     }
 
     // Attempt the fallible allocation part
@@ -124,7 +125,7 @@ public:
     cloned.m_alloc = m_alloc;
     cloned.m_vtable = m_vtable;
 
-    if (res.value() == (void *)0x1) {
+    if (res.value() == nullptr) {
       RELOCO_ASSERT(m_vtable->copy_soo != nullptr, "Internal logic error");
       m_vtable->copy_soo(&m_storage, &cloned.m_storage);
     } else {
@@ -172,7 +173,7 @@ private:
         .move_and_destroy =
             [](storage *src, storage *dest) { dest->func_ptr = src->func_ptr; },
         .try_clone = [](const auto *, fallible_allocator &) -> result<void *> {
-          return (void *)0x1; // Raw pointers don't need allocation
+          return nullptr; // Raw pointers don't need allocation
         },
         .copy_soo =
             [](const storage *src, storage *dest) {
@@ -203,11 +204,11 @@ private:
         .try_clone = [](const auto *s, fallible_allocator &) -> result<void *> {
           if constexpr (std::is_nothrow_copy_constructible_v<F>) {
 
-            // No allocation needed for SOO, but we return a "fake" pointer
-            // to signal that the data is ready for the SOO buffer
-            return (void *)0x1;
+            // No allocation needed for SOO, a null pointer signals that the
+            // data goes into the SOO buffer
+            return nullptr;
           } else {
-            return unexpected(error::unsupported_operation);
+            return RELOCO_ERROR(error::unsupported_operation);
           }
         },
         .copy_soo =
@@ -248,7 +249,7 @@ private:
               return unexpected(res.error());
             return new (res->ptr) F(original);
           } else {
-            return unexpected(error::unsupported_operation);
+            return RELOCO_ERROR(error::unsupported_operation);
           }
         },
         .copy_soo = nullptr,
@@ -0,0 +1,150 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <reloco/core.hpp>
+#include <reloco/error_origin.hpp>
+
+#if defined(_WIN32)
+#include <windows.h>
+#if defined(_MSC_VER)
+#pragma comment(lib, "Synchronization.lib")
+#endif
+#elif defined(__linux__)
+#include <cerrno>
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#else
+#include <thread>
+#endif
+
+namespace reloco {
+
+/**
+ * @brief 32-bit word the futex primitives block on.
+ * Every primitive built on top of the futex helpers keeps its whole state (or
+ * at least the part waiters sleep on) in one of these, so the kernel can check
+ * the expected value atomically with putting the thread to sleep.
+ */
+using futex_word = std::atomic<std::uint32_t>;
+
+static_assert(sizeof(futex_word) == sizeof(std::uint32_t),
+              "futex_word must be layout compatible with a 32-bit integer");
+
+namespace detail {
+
+#if defined(__linux__)
+inline result<void> futex_wait_raw(futex_word &word, std::uint32_t expected,
+                                   const timespec *rel_timeout) noexcept {
+  const long rc =
+      ::syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&word),
+                FUTEX_WAIT_PRIVATE, expected, rel_timeout, nullptr, 0);
+  if (rc == 0)
+    return {};
+  if (errno == ETIMEDOUT)
+    return RELOCO_ERROR(error::timed_out);
+  // EAGAIN (value already changed) and EINTR are spurious wakeups; callers
+  // always re-check their predicate.
+  return {};
+}
+
+inline void futex_wake_raw(futex_word &word, int count) noexcept {
+  ::syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&word),
+            FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+}
+#endif
+
+} // namespace detail
+
+/**
+ * @brief Blocks the calling thread while ``word`` holds ``expected``.
+ * Spurious wakeups are allowed, callers must re-check their condition.
+ */
+inline result<void> futex_wait(futex_word &word,
+                               std::uint32_t expected) noexcept {
+#if defined(_WIN32)
+  WaitOnAddress(&word, &expected, sizeof(expected), INFINITE);
+  return {};
+#elif defined(__linux__)
+  return detail::futex_wait_raw(word, expected, nullptr);
+#else
+  word.wait(expected, std::memory_order_relaxed);
+  return {};
+#endif
+}
+
+/**
+ * @brief Timed variant of futex_wait.
+ * @return error::timed_out once ``deadline`` has passed, success on wakeup
+ * (spurious or not).
+ */
+template <typename Clock, typename Duration>
+result<void>
+futex_wait_until(futex_word &word, std::uint32_t expected,
+                 const std::chrono::time_point<Clock, Duration> &deadline) noexcept {
+  const auto now = Clock::now();
+  if (now >= deadline)
+    return RELOCO_ERROR(error::timed_out);
+
+  const auto remaining =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now);
+#if defined(_WIN32)
+  const auto ms =
+      std::chrono::ceil<std::chrono::milliseconds>(remaining).count();
+  if (!WaitOnAddress(&word, &expected, sizeof(expected),
+                     static_cast<DWORD>(ms))) {
+    if (GetLastError() == ERROR_TIMEOUT)
+      return RELOCO_ERROR(error::timed_out);
+  }
+  return {};
+#elif defined(__linux__)
+  const auto secs = std::chrono::duration_cast<std::chrono::seconds>(remaining);
+  timespec ts{static_cast<time_t>(secs.count()),
+              static_cast<long>((remaining - secs).count())};
+  return detail::futex_wait_raw(word, expected, &ts);
+#else
+  // No timed wait on address available, fall back to polling.
+  if (word.load(std::memory_order_relaxed) == expected)
+    std::this_thread::yield();
+  return {};
+#endif
+}
+
+template <typename Rep, typename Period>
+result<void>
+futex_wait_for(futex_word &word, std::uint32_t expected,
+               const std::chrono::duration<Rep, Period> &timeout) noexcept {
+  return futex_wait_until(word, expected,
+                          std::chrono::steady_clock::now() + timeout);
+}
+
+/**
+ * @brief Wakes at most one thread blocked on ``word``.
+ */
+inline void futex_wake_one(futex_word &word) noexcept {
+#if defined(_WIN32)
+  WakeByAddressSingle(&word);
+#elif defined(__linux__)
+  detail::futex_wake_raw(word, 1);
+#else
+  word.notify_one();
+#endif
+}
+
+/**
+ * @brief Wakes every thread blocked on ``word``.
+ */
+inline void futex_wake_all(futex_word &word) noexcept {
+#if defined(_WIN32)
+  WakeByAddressAll(&word);
+#elif defined(__linux__)
+  detail::futex_wake_raw(word, INT_MAX);
+#else
+  word.notify_all();
+#endif
+}
+
+} // namespace reloco
@@ -0,0 +1,519 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <reloco/allocator.hpp>
+#include <reloco/config.hpp>
+#include <reloco/mutex.hpp>
+#include <reloco/string.hpp>
+#include <reloco/thread_specific.hpp>
+#include <reloco/vector.hpp>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#if __has_include(<execinfo.h>)
+#include <execinfo.h>
+#endif
+#if __has_include(<cxxabi.h>)
+#include <cxxabi.h>
+#endif
+#endif
+
+#if defined(__linux__)
+#include <reloco/file_io.hpp>
+#endif
+
+namespace reloco {
+
+/**
+ * @brief One sampled allocation that has not been freed yet.
+ */
+struct heap_sample {
+  static constexpr std::uint32_t max_depth = 32;
+
+  std::size_t size = 0;
+  // Mean bytes between samples when this one was taken
+  std::size_t interval = 0;
+  std::uint32_t depth = 0;
+  // Return addresses, innermost first
+  void *frames[max_depth] = {};
+
+  /**
+   * @brief How many allocations of this size the sample stands for.
+   * A block of ``size`` bytes is sampled with probability
+   * 1 - exp(-size / interval), so each sample counts for its inverse.
+   */
+  [[nodiscard]] double estimated_count() const noexcept {
+    if (size == 0 || interval == 0)
+      return 1.0;
+    return 1.0 / -std::expm1(-static_cast<double>(size) /
+                             static_cast<double>(interval));
+  }
+
+  [[nodiscard]] double estimated_bytes() const noexcept {
+    return estimated_count() * static_cast<double>(size);
+  }
+};
+
+struct heap_profiler_options {
+  // Mean number of bytes allocated between two samples
+  std::size_t sample_interval = 512 * 1024;
+  // Sampled blocks tracked at once; samples past this are dropped
+  std::size_t max_live_samples = 1024;
+};
+
+namespace detail {
+
+/**
+ * @brief Fills ``frames`` with the calling thread's return addresses,
+ * starting at this function's caller. Kept out of line so that frame is
+ * always there to be skipped.
+ */
+RELOCO_COLD inline std::uint32_t
+capture_stack(void **frames, std::uint32_t capacity) noexcept {
+#if defined(_WIN32)
+  return ::RtlCaptureStackBackTrace(1, capacity, frames, nullptr);
+#elif __has_include(<execinfo.h>)
+  void *raw[heap_sample::max_depth + 1];
+  capacity = std::min(capacity, heap_sample::max_depth);
+  const int n = ::backtrace(raw, static_cast<int>(capacity + 1));
+  if (n <= 1)
+    return 0;
+  std::copy(raw + 1, raw + n, frames);
+  return static_cast<std::uint32_t>(n - 1);
+#else
+  return 0;
+#endif
+}
+
+inline result<void> try_append_number(string &out, std::uint64_t value,
+                                      int base = 10) noexcept {
+  char digits[24];
+  const auto end = std::to_chars(digits, digits + sizeof(digits), value, base);
+  return out.try_append(
+      string_view(digits, static_cast<std::size_t>(end.ptr - digits)));
+}
+
+inline result<void> try_append_address(string &out,
+                                       const void *frame) noexcept {
+  RELOCO_TRY(out.try_append("0x"));
+  return try_append_number(out, reinterpret_cast<std::uintptr_t>(frame), 16);
+}
+
+/**
+ * @brief Appends the demangled name of the function holding ``frame``, or
+ * its address when the symbol is not exported (link with -rdynamic to
+ * export them).
+ */
+inline result<void> try_append_frame_name(string &out,
+                                          const void *frame) noexcept {
+#if !defined(_WIN32)
+  Dl_info info;
+  if (::dladdr(frame, &info) != 0 && info.dli_sname) {
+#if __has_include(<cxxabi.h>)
+    int status = 0;
+    if (char *demangled =
+            abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status)) {
+      auto res = out.try_append(demangled);
+      std::free(demangled);
+      return res;
+    }
+#endif
+    return out.try_append(info.dli_sname);
+  }
+#endif
+  return try_append_address(out, frame);
+}
+
+} // namespace detail
+
+/**
+ * @brief Forwards to an upstream allocator and samples what passes through,
+ * keeping the stack of every sampled block until it is freed.
+ *
+ * Allocations are sampled as a Poisson process over bytes, like tcmalloc:
+ * each thread counts down an exponentially distributed number of bytes and
+ * samples the allocation that crosses zero. An unsampled allocation costs a
+ * thread-local subtraction; an unsampled free costs one load while nothing
+ * is sampled and a short probe of the sample table otherwise. Bookkeeping
+ * memory comes from the upstream allocator, so installing the profiler
+ * with set_default_allocator() never makes it sample itself.
+ *
+ * Stacks are raw return addresses; the writers symbolize them with dladdr()
+ * where available. A failed reallocate() loses the sample of its block.
+ */
+class heap_profiler final : public fallible_allocator {
+  struct thread_state {
+    std::int64_t countdown = 0;
+    // Zero until the thread's first allocation seeds it
+    std::uint64_t rng = 0;
+  };
+
+  // Frames of the profiler itself at the top of every captured stack
+  static constexpr std::uint32_t internal_frames = 2;
+
+public:
+  explicit heap_profiler(fallible_allocator &upstream) noexcept
+      : m_upstream(&upstream), m_threads(upstream) {}
+
+  heap_profiler(const heap_profiler &) = delete;
+  heap_profiler &operator=(const heap_profiler &) = delete;
+
+  ~heap_profiler() noexcept {
+    if (m_keys) {
+      m_upstream->deallocate(m_keys, m_slots * sizeof(std::atomic<void *>));
+      m_upstream->deallocate(m_samples, m_slots * sizeof(heap_sample));
+    }
+  }
+
+  /**
+   * @brief Starts sampling. The first call sizes the sample table; later
+   * calls only change the interval.
+   */
+  [[nodiscard]] result<void>
+  try_start(const heap_profiler_options &opts = {}) noexcept {
+    if (opts.sample_interval == 0 || opts.max_live_samples == 0)
+      return RELOCO_ERROR(error::invalid_argument);
+
+    std::unique_lock<mutex> lock(m_mutex);
+    if (!m_keys) {
+      if (opts.max_live_samples > (SIZE_MAX / sizeof(heap_sample)) / 4)
+        return RELOCO_ERROR(error::integer_overflow);
+      // At most half full, so probe sequences stay short
+      const std::size_t slots = std::bit_ceil(opts.max_live_samples * 2);
+      RELOCO_TRY_ASSIGN(
+          const mem_block keys,
+          m_upstream->allocate(slots * sizeof(std::atomic<void *>),
+                               alignof(std::atomic<void *>)));
+      auto samples = m_upstream->allocate(slots * sizeof(heap_sample),
+                                          alignof(heap_sample));
+      if (!samples) {
+        m_upstream->deallocate(keys.ptr, keys.size);
+        return unexpected(samples.error());
+      }
+
+      m_keys = static_cast<std::atomic<void *> *>(keys.ptr);
+      m_samples = static_cast<heap_sample *>(samples->ptr);
+      for (std::size_t i = 0; i < slots; ++i) {
+        new (m_keys + i) std::atomic<void *>(nullptr);
+        new (m_samples + i) heap_sample();
+      }
+      m_slots = slots;
+      m_shift = 64 - static_cast<unsigned>(std::countr_zero(slots));
+      m_max_live = opts.max_live_samples;
+    }
+    m_interval.store(opts.sample_interval, std::memory_order_relaxed);
+    return {};
+  }
+
+  /**
+   * @brief Stops taking new samples. Blocks sampled so far stay tracked
+   * until they are freed.
+   */
+  void stop() noexcept { m_interval.store(0, std::memory_order_relaxed); }
+
+  [[nodiscard]] bool sampling() const noexcept {
+    return m_interval.load(std::memory_order_relaxed) != 0;
+  }
+
+  [[nodiscard]] result<mem_block>
+  allocate(std::size_t bytes, std::size_t alignment) noexcept override {
+    auto res = m_upstream->allocate(bytes, alignment);
+    if (res)
+      maybe_sample(res->ptr, bytes);
+    return res;
+  }
+
+  [[nodiscard]] result<mem_block>
+  allocate_zeroed(std::size_t bytes, std::size_t alignment) noexcept override {
+    auto res = m_upstream->allocate_zeroed(bytes, alignment);
+    if (res)
+      maybe_sample(res->ptr, bytes);
+    return res;
+  }
+
+  [[nodiscard]] result<std::size_t>
+  expand_in_place(void *ptr, std::size_t old_size,
+                  std::size_t new_size) noexcept override {
+    return m_upstream->expand_in_place(ptr, old_size, new_size);
+  }
+
+  [[nodiscard]] result<mem_block>
+  reallocate(void *ptr, std::size_t old_size, std::size_t new_size,
+             std::size_t alignment) noexcept override {
+    // Forgotten first: once upstream frees the block, another thread may
+    // get the same address back and have it sampled
+    if (ptr)
+      forget(ptr);
+    auto res = m_upstream->reallocate(ptr, old_size, new_size, alignment);
+    if (res)
+      maybe_sample(res->ptr, new_size);
+    return res;
+  }
+
+  void deallocate(void *ptr, std::size_t bytes) noexcept override {
+    forget(ptr);
+    m_upstream->deallocate(ptr, bytes);
+  }
+
+  void advise(void *ptr, std::size_t bytes, usage_hint hint) noexcept override {
+    m_upstream->advise(ptr, bytes, hint);
+  }
+
+  // Even over an arena: containers that skip frees would leave their
+  // samples live for good, so the profiler has to see every one
+  [[nodiscard]] bool frees_are_noops() const noexcept override {
+    return false;
+  }
+
+  [[nodiscard]] const char *tag() const noexcept override {
+    return m_upstream->tag();
+  }
+
+  [[nodiscard]] std::size_t live_samples() const noexcept {
+    return m_live.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Samples not taken because max_live_samples were already live.
+   */
+  [[nodiscard]] std::size_t dropped_samples() const noexcept {
+    return m_dropped.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Copies the live samples, allocated from the upstream allocator.
+   */
+  [[nodiscard]] result<vector<heap_sample>> try_snapshot() noexcept {
+    std::unique_lock<mutex> lock(m_mutex);
+    RELOCO_TRY_ASSIGN(auto samples,
+                      vector<heap_sample>::try_allocate(*m_upstream,
+                                                        m_max_live));
+    for (std::size_t i = 0; i < m_slots; ++i) {
+      const void *key = m_keys[i].load(std::memory_order_relaxed);
+      if (key == nullptr || key == tombstone())
+        continue;
+      heap_sample copy = m_samples[i];
+      RELOCO_TRY(samples.try_push_back(std::move(copy)));
+    }
+    return samples;
+  }
+
+  /**
+   * @brief Appends the live samples in folded-stack form, one
+   * ``outer;...;inner bytes`` line per sample with the bytes it stands
+   * for, ready for flamegraph.pl or speedscope.
+   */
+  [[nodiscard]] result<void> try_write_folded(string &out) noexcept {
+    RELOCO_TRY_ASSIGN(const auto samples, try_snapshot());
+    for (const heap_sample &s : samples) {
+      if (s.depth <= internal_frames)
+        RELOCO_TRY(out.try_append("[unknown]"));
+      for (std::uint32_t i = s.depth; i-- > internal_frames;) {
+        RELOCO_TRY(detail::try_append_frame_name(out, s.frames[i]));
+        if (i > internal_frames)
+          RELOCO_TRY(out.try_append(";"));
+      }
+      RELOCO_TRY(out.try_append(" "));
+      RELOCO_TRY(detail::try_append_number(
+          out, static_cast<std::uint64_t>(std::llround(s.estimated_bytes()))));
+      RELOCO_TRY(out.try_append("\n"));
+    }
+    return {};
+  }
+
+  /**
+   * @brief Appends the live samples as a legacy ``heap_v2`` profile, which
+   * ``pprof`` reads and scales by the sampling interval itself. On Linux
+   * the process's memory map follows, so pprof can symbolize offline.
+   */
+  [[nodiscard]] result<void> try_write_pprof(string &out) noexcept {
+    RELOCO_TRY_ASSIGN(const auto samples, try_snapshot());
+    std::uint64_t total = 0;
+    std::uint64_t interval = m_interval.load(std::memory_order_relaxed);
+    for (const heap_sample &s : samples) {
+      total += s.size;
+      interval = s.interval;
+    }
+
+    RELOCO_TRY(out.try_append("heap profile: "));
+    RELOCO_TRY(append_counts(out, samples.size(), total));
+    RELOCO_TRY(out.try_append(" @ heap_v2/"));
+    RELOCO_TRY(detail::try_append_number(out, interval));
+    RELOCO_TRY(out.try_append("\n"));
+    for (const heap_sample &s : samples) {
+      RELOCO_TRY(out.try_append(" "));
+      RELOCO_TRY(append_counts(out, 1, s.size));
+      RELOCO_TRY(out.try_append(" @"));
+      for (std::uint32_t i = internal_frames; i < s.depth; ++i) {
+        RELOCO_TRY(out.try_append(" "));
+        RELOCO_TRY(detail::try_append_address(out, s.frames[i]));
+      }
+      RELOCO_TRY(out.try_append("\n"));
+    }
+
+#if defined(__linux__)
+    RELOCO_TRY(out.try_append("\nMAPPED_LIBRARIES:\n"));
+    RELOCO_TRY_ASSIGN(auto maps, file_reader::try_open("/proc/self/maps"));
+    for (;;) {
+      RELOCO_TRY_ASSIGN(const std::size_t n, maps.try_fill());
+      if (n == 0)
+        break;
+      const auto chunk = maps.buffered();
+      RELOCO_TRY(out.try_append(string_view(
+          reinterpret_cast<const char *>(chunk.unsafe_data()), chunk.size())));
+      maps.consume(chunk.size());
+    }
+#endif
+    return {};
+  }
+
+private:
+  static void *tombstone() noexcept {
+    return reinterpret_cast<void *>(std::uintptr_t{1});
+  }
+
+  static result<void> append_counts(string &out, std::uint64_t objects,
+                                    std::uint64_t bytes) noexcept {
+    // In-use, then allocated; only live blocks are kept, so both agree
+    RELOCO_TRY(detail::try_append_number(out, objects));
+    RELOCO_TRY(out.try_append(": "));
+    RELOCO_TRY(detail::try_append_number(out, bytes));
+    RELOCO_TRY(out.try_append(" ["));
+    RELOCO_TRY(detail::try_append_number(out, objects));
+    RELOCO_TRY(out.try_append(": "));
+    RELOCO_TRY(detail::try_append_number(out, bytes));
+    return out.try_append("]");
+  }
+
+  std::size_t home(const void *ptr) const noexcept {
+    const auto bits = static_cast<std::uint64_t>(
+        reinterpret_cast<std::uintptr_t>(ptr));
+    return static_cast<std::size_t>((bits * 0x9E3779B97F4A7C15ull) >> m_shift);
+  }
+
+  /**
+   * @brief Exponentially distributed gap to the next sample, from the
+   * thread's xorshift64* generator.
+   */
+  static std::int64_t next_gap(thread_state &t,
+                               std::size_t interval) noexcept {
+    t.rng ^= t.rng >> 12;
+    t.rng ^= t.rng << 25;
+    t.rng ^= t.rng >> 27;
+    const std::uint64_t bits = t.rng * 0x2545F4914F6CDD1Dull;
+    // Uniform in (0, 1], so the logarithm stays finite
+    const double u = static_cast<double>((bits >> 11) + 1) * 0x1.0p-53;
+    const double gap = -std::log(u) * static_cast<double>(interval);
+    return static_cast<std::int64_t>(std::min(gap, 0x1.0p62)) + 1;
+  }
+
+  void maybe_sample(void *ptr, std::size_t bytes) noexcept {
+    const std::size_t interval = m_interval.load(std::memory_order_relaxed);
+    if (interval == 0)
+      return;
+    auto local = m_threads.try_local();
+    if (!local) [[unlikely]]
+      return;
+    thread_state &t = **local;
+    t.countdown -= static_cast<std::int64_t>(bytes);
+    if (t.countdown > 0) [[likely]]
+      return;
+    on_countdown_expired(t, ptr, bytes, interval);
+  }
+
+  RELOCO_COLD void on_countdown_expired(thread_state &t, void *ptr,
+                                        std::size_t bytes,
+                                        std::size_t interval) noexcept {
+    if (t.rng == 0) {
+      // The thread's first allocation; it has no countdown yet
+      static std::atomic<std::uint64_t> streams{0};
+      t.rng = (reinterpret_cast<std::uintptr_t>(&t) ^
+               (streams.fetch_add(1, std::memory_order_relaxed) + 1) *
+                   0x9E3779B97F4A7C15ull) |
+              1;
+      t.countdown += next_gap(t, interval);
+      if (t.countdown > 0)
+        return;
+    }
+    t.countdown = next_gap(t, interval);
+    record_sample(ptr, bytes, interval);
+  }
+
+  RELOCO_COLD void record_sample(void *ptr, std::size_t bytes,
+                                 std::size_t interval) noexcept {
+    heap_sample sample;
+    sample.size = bytes;
+    sample.interval = interval;
+    sample.depth = detail::capture_stack(sample.frames, heap_sample::max_depth);
+
+    std::unique_lock<mutex> lock(m_mutex);
+    if (m_live.load(std::memory_order_relaxed) >= m_max_live) {
+      m_dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    // Keys never move once placed, so lock-free lookups in forget() only
+    // need to know how far any of them can be from its home slot
+    std::size_t i = home(ptr);
+    for (std::size_t distance = 0;; ++distance, i = (i + 1) & (m_slots - 1)) {
+      const void *key = m_keys[i].load(std::memory_order_relaxed);
+      if (key != nullptr && key != tombstone())
+        continue;
+      m_samples[i] = sample;
+      if (distance > m_max_probe.load(std::memory_order_relaxed))
+        m_max_probe.store(distance, std::memory_order_relaxed);
+      m_keys[i].store(ptr, std::memory_order_release);
+      m_live.fetch_add(1, std::memory_order_release);
+      return;
+    }
+  }
+
+  void forget(void *ptr) noexcept {
+    if (m_live.load(std::memory_order_acquire) == 0) [[likely]]
+      return;
+    const std::size_t probes = m_max_probe.load(std::memory_order_relaxed);
+    std::size_t i = home(ptr);
+    for (std::size_t distance = 0; distance <= probes;
+         ++distance, i = (i + 1) & (m_slots - 1)) {
+      const void *key = m_keys[i].load(std::memory_order_acquire);
+      if (key == ptr) {
+        erase(i);
+        return;
+      }
+      if (key == nullptr)
+        return;
+    }
+  }
+
+  RELOCO_COLD void erase(std::size_t slot) noexcept {
+    std::unique_lock<mutex> lock(m_mutex);
+    m_keys[slot].store(tombstone(), std::memory_order_relaxed);
+    m_live.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  fallible_allocator *m_upstream;
+  enumerable_thread_specific<thread_state> m_threads;
+  std::atomic<std::size_t> m_interval{0};
+  std::atomic<std::size_t> m_live{0};
+  std::atomic<std::size_t> m_dropped{0};
+  std::atomic<std::size_t> m_max_probe{0};
+
+  // Open-addressed by block address; written under m_mutex, keys read
+  // without it
+  mutex m_mutex;
+  std::atomic<void *> *m_keys = nullptr;
+  heap_sample *m_samples = nullptr;
+  std::size_t m_slots = 0;
+  unsigned m_shift = 64;
+  std::size_t m_max_live = 0;
+};
+
+} // namespace reloco
@@ -0,0 +1,433 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <initializer_list>
+#include <mutex>
+#include <reloco/allocator.hpp>
+#include <reloco/error_origin.hpp>
+#include <reloco/fallible_constructed.hpp>
+#include <reloco/function.hpp>
+#include <reloco/mutex.hpp>
+#include <reloco/span.hpp>
+#include <reloco/string.hpp>
+#include <reloco/string_view.hpp>
+#include <reloco/thread_pool.hpp>
+#include <reloco/vector.hpp>
+
+namespace reloco {
+
+/**
+ * @brief First initializer that failed during ``init_registry::try_run()``.
+ * ``deadlock`` means the dependency graph has a cycle through ``service``,
+ * ``not_found`` that ``service`` depends on a name nobody registered.
+ */
+struct init_failure {
+  string_view service = nullptr;
+  error code = error::not_initialized;
+};
+
+enum class init_status : std::uint8_t { not_run, succeeded, failed };
+
+/**
+ * @brief Per-service entry of the startup report.
+ * ``started_at`` is relative to the beginning of the run.
+ */
+struct init_timing {
+  string_view service = nullptr;
+  std::chrono::nanoseconds started_at{0};
+  std::chrono::nanoseconds duration{0};
+  init_status status = init_status::not_run;
+};
+
+/**
+ * @brief Runs service initializers in dependency order.
+ *
+ * Every service is registered under a unique name together with the names it
+ * depends on, registration order does not matter. ``try_run(pool)`` starts
+ * every service whose dependencies have all succeeded on the pool, so
+ * independent branches of the graph initialize in parallel; ``try_run()``
+ * does the same serially on the calling thread.
+ *
+ * The first failure stops the run: services already running finish, no new
+ * service is started, and the failing service's name and error are returned.
+ * Names are stored as views and must outlive the registry (string literals
+ * in practice).
+ */
+class init_registry {
+public:
+  explicit init_registry(
+      fallible_allocator &alloc = get_default_allocator()) noexcept
+      : m_alloc(&alloc), m_services(alloc), m_dependencies(alloc),
+        m_report(alloc) {}
+
+  init_registry(const init_registry &) = delete;
+  init_registry &operator=(const init_registry &) = delete;
+
+  /**
+   * @brief Registers ``init`` as service ``name``.
+   * @param init Callable returning ``result<void>``. It runs at most once per
+   * ``try_run()`` and possibly on a pool thread.
+   * @param dependencies Names of services that must succeed first.
+   */
+  template <typename F>
+    requires std::is_invocable_r_v<result<void>, F &>
+  result<void> try_add(string_view name, F &&init,
+                       std::initializer_list<string_view> dependencies =
+                           {}) & noexcept {
+    if (name.empty())
+      return RELOCO_ERROR(error::invalid_argument);
+    if (find(name) != NOT_FOUND)
+      return RELOCO_ERROR(error::already_exists);
+
+    auto fn = function<result<void>()>::try_allocate(std::forward<F>(init),
+                                                     *m_alloc);
+    if (!fn)
+      return unexpected(fn.error());
+
+    const auto first = static_cast<std::uint32_t>(m_dependencies.size());
+    if (auto res = m_dependencies.try_reserve(m_dependencies.size() +
+                                              dependencies.size());
+        !res)
+      return res;
+    for (string_view dep : dependencies)
+      std::ignore = m_dependencies.try_emplace_back(dep);
+
+    auto res = m_services.try_emplace_back(
+        name, std::move(*fn), first,
+        static_cast<std::uint32_t>(dependencies.size()));
+    if (!res) {
+      while (m_dependencies.size() > first)
+        std::ignore = m_dependencies.try_pop_back();
+      return unexpected(res.error());
+    }
+    return {};
+  }
+
+  /**
+   * @brief Registers the ``try_init()`` of a static storage slot.
+   */
+  template <is_fallible_initializable T>
+  result<void> try_add(string_view name,
+                       static_fallible_constructed<T> &storage,
+                       std::initializer_list<string_view> dependencies =
+                           {}) & noexcept {
+    return try_add(
+        name, [&storage] { return storage.try_init(); }, dependencies);
+  }
+
+  /**
+   * @brief Registers a singleton, e.g. ``concurrent_fallible_singleton<T>``,
+   * by forcing its ``instance()``.
+   */
+  template <typename Singleton>
+  result<void>
+  try_add_singleton(string_view name,
+                    std::initializer_list<string_view> dependencies =
+                        {}) & noexcept {
+    return try_add(
+        name,
+        []() -> result<void> {
+          auto res = Singleton::instance();
+          if (!res)
+            return unexpected(res.error());
+          return {};
+        },
+        dependencies);
+  }
+
+  [[nodiscard]] std::size_t size() const noexcept { return m_services.size(); }
+
+  /**
+   * @brief Initializes every service on ``pool``, which must be started.
+   * Blocks the calling thread, so it must not be a worker of ``pool``.
+   */
+  expected<void, init_failure> try_run(thread_pool &pool) & noexcept {
+    return run(&pool);
+  }
+
+  /**
+   * @brief Initializes every service serially on the calling thread.
+   */
+  expected<void, init_failure> try_run() & noexcept { return run(nullptr); }
+
+  /**
+   * @brief Timings of the last run, in registration order.
+   */
+  [[nodiscard]] span<const init_timing> report() const & noexcept {
+    return span<const init_timing>(m_report.begin(), m_report.size());
+  }
+
+  /**
+   * @brief Wall-clock duration of the last run.
+   */
+  [[nodiscard]] std::chrono::nanoseconds total_time() const noexcept {
+    return m_total_time;
+  }
+
+  /**
+   * @brief Appends a human readable version of ``report()`` to ``out``.
+   */
+  result<void> try_format_report(string &out) const & noexcept {
+    for (const init_timing &t : m_report) {
+      const char *status = t.status == init_status::succeeded ? "ok"
+                           : t.status == init_status::failed  ? "FAILED"
+                                                              : "not run";
+      auto res = out.try_append_fmt(
+          "%-32.*s start %10.3f ms  took %10.3f ms  %s\n",
+          static_cast<int>(t.service.size()), t.service.unsafe_data(),
+          to_millis(t.started_at), to_millis(t.duration), status);
+      if (!res)
+        return res;
+    }
+    return out.try_append_fmt("total %.3f ms\n", to_millis(m_total_time));
+  }
+
+private:
+  static constexpr std::uint32_t NOT_FOUND = UINT32_MAX;
+
+  using clock = std::chrono::steady_clock;
+
+  struct service {
+    service(string_view n, function<result<void>()> &&fn, std::uint32_t first,
+            std::uint32_t count) noexcept
+        : name(n), init(std::move(fn)), first_dependency(first),
+          dependency_count(count) {}
+
+    string_view name;
+    function<result<void>()> init;
+    std::uint32_t first_dependency;
+    std::uint32_t dependency_count;
+  };
+
+  /**
+   * Dependency graph in compressed form: ``dependents`` of service ``i``
+   * are ``edges[offsets[i] .. offsets[i + 1])``.
+   */
+  struct graph {
+    explicit graph(fallible_allocator &alloc) noexcept
+        : pending(alloc), offsets(alloc), edges(alloc), order(alloc) {}
+
+    vector<std::uint32_t> pending;
+    vector<std::uint32_t> offsets;
+    vector<std::uint32_t> edges;
+    // Topological order, only complete when the graph is acyclic
+    vector<std::uint32_t> order;
+    // Services without dependencies, they lead ``order``
+    std::uint32_t roots = 0;
+  };
+
+  struct run_state {
+    init_registry *self;
+    thread_pool *pool;
+    graph *g;
+    clock::time_point start;
+
+    std::atomic<bool> failed{false};
+    init_failure failure{};
+    // Scheduled services that have not finished yet, plus one for the caller
+    std::atomic<std::size_t> outstanding{1};
+    mutex done_mutex;
+    condition_variable done;
+  };
+
+  static double to_millis(std::chrono::nanoseconds ns) noexcept {
+    return std::chrono::duration<double, std::milli>(ns).count();
+  }
+
+  std::uint32_t find(string_view name) const noexcept {
+    for (std::size_t i = 0; i < m_services.size(); ++i) {
+      if (m_services[i].name == name)
+        return static_cast<std::uint32_t>(i);
+    }
+    return NOT_FOUND;
+  }
+
+  static result<void> try_fill(vector<std::uint32_t> &v, std::size_t count,
+                               std::uint32_t value) noexcept {
+    if (auto res = v.try_reserve(count); !res)
+      return res;
+    for (std::size_t i = 0; i < count; ++i)
+      std::ignore = v.try_emplace_back(value);
+    return {};
+  }
+
+  expected<void, init_failure> try_build_graph(graph &g) noexcept {
+    const std::size_t n = m_services.size();
+    const init_failure oom{nullptr, error::allocation_failed};
+
+    if (!try_fill(g.pending, n, 0) || !try_fill(g.offsets, n + 1, 0) ||
+        !try_fill(g.edges, m_dependencies.size(), 0) ||
+        !g.order.try_reserve(n))
+      return unexpected(oom);
+
+    // Resolve names and count the dependents of every service
+    for (std::uint32_t i = 0; i < n; ++i) {
+      const service &s = m_services[i];
+      g.pending[i] = s.dependency_count;
+      for (std::uint32_t d = 0; d < s.dependency_count; ++d) {
+        const std::uint32_t dep = find(m_dependencies[s.first_dependency + d]);
+        if (dep == NOT_FOUND)
+          return unexpected(init_failure{s.name, error::not_found});
+        ++g.offsets[dep + 1];
+      }
+    }
+    for (std::size_t i = 0; i < n; ++i)
+      g.offsets[i + 1] += g.offsets[i];
+
+    vector<std::uint32_t> cursor(*m_alloc);
+    if (!try_fill(cursor, n, 0))
+      return unexpected(oom);
+    for (std::uint32_t i = 0; i < n; ++i) {
+      const service &s = m_services[i];
+      for (std::uint32_t d = 0; d < s.dependency_count; ++d) {
+        const std::uint32_t dep = find(m_dependencies[s.first_dependency + d]);
+        g.edges[g.offsets[dep] + cursor[dep]++] = i;
+      }
+    }
+
+    // Kahn's algorithm, reusing cursor as the remaining in-degree
+    for (std::uint32_t i = 0; i < n; ++i) {
+      cursor[i] = g.pending[i];
+      if (cursor[i] == 0)
+        std::ignore = g.order.try_emplace_back(i);
+    }
+    g.roots = static_cast<std::uint32_t>(g.order.size());
+    for (std::size_t head = 0; head < g.order.size(); ++head) {
+      const std::uint32_t u = g.order[head];
+      for (std::uint32_t e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+        if (--cursor[g.edges[e]] == 0)
+          std::ignore = g.order.try_emplace_back(g.edges[e]);
+      }
+    }
+    if (g.order.size() != n) {
+      for (std::uint32_t i = 0; i < n; ++i) {
+        if (cursor[i] != 0)
+          return unexpected(init_failure{m_services[i].name, error::deadlock});
+      }
+    }
+    return {};
+  }
+
+  result<void> run_service(std::uint32_t index,
+                           clock::time_point start) noexcept {
+    init_timing &t = m_report[index];
+    const auto begin = clock::now();
+    auto res = m_services[index].init();
+    t.started_at = begin - start;
+    t.duration = clock::now() - begin;
+    t.status = res ? init_status::succeeded : init_status::failed;
+    return res;
+  }
+
+  expected<void, init_failure> run(thread_pool *pool) noexcept {
+    const auto start = clock::now();
+
+    m_report.clear();
+    if (!m_report.try_reserve(m_services.size()))
+      return unexpected(init_failure{nullptr, error::allocation_failed});
+    for (const service &s : m_services) {
+      init_timing t;
+      t.service = s.name;
+      std::ignore = m_report.try_emplace_back(t);
+    }
+
+    graph g(*m_alloc);
+    if (auto res = try_build_graph(g); !res)
+      return res;
+
+    expected<void, init_failure> res =
+        pool ? run_parallel(*pool, g, start) : run_serial(g, start);
+    m_total_time = clock::now() - start;
+    return res;
+  }
+
+  expected<void, init_failure> run_serial(graph &g,
+                                          clock::time_point start) noexcept {
+    for (std::uint32_t index : g.order) {
+      if (auto res = run_service(index, start); !res)
+        return unexpected(init_failure{m_services[index].name, res.error()});
+    }
+    return {};
+  }
+
+  expected<void, init_failure> run_parallel(thread_pool &pool, graph &g,
+                                            clock::time_point start) noexcept {
+    run_state state;
+    state.self = this;
+    state.pool = &pool;
+    state.g = &g;
+    state.start = start;
+
+    // Workers update ``pending`` from here on, so only look at ``order``
+    for (std::uint32_t i = 0; i < g.roots; ++i)
+      schedule(state, g.order[i]);
+    finish_one(state);
+
+    {
+      std::unique_lock<mutex> lock(state.done_mutex);
+      std::ignore = state.done.wait(lock, [&] {
+        return state.outstanding.load(std::memory_order_acquire) == 0;
+      });
+    }
+
+    if (state.failed.load(std::memory_order_acquire))
+      return unexpected(state.failure);
+    return {};
+  }
+
+  static void record_failure(run_state &state, string_view name,
+                             error code) noexcept {
+    bool expected = false;
+    if (state.failed.compare_exchange_strong(expected, true,
+                                             std::memory_order_acq_rel))
+      state.failure = init_failure{name, code};
+  }
+
+  static void schedule(run_state &state, std::uint32_t index) noexcept {
+    state.outstanding.fetch_add(1, std::memory_order_relaxed);
+    auto res =
+        state.pool->try_submit([&state, index] { execute(state, index); });
+    if (!res) {
+      record_failure(state, state.self->m_services[index].name, res.error());
+      finish_one(state);
+    }
+  }
+
+  static void execute(run_state &state, std::uint32_t index) noexcept {
+    init_registry &self = *state.self;
+    if (!state.failed.load(std::memory_order_acquire)) {
+      if (auto res = self.run_service(index, state.start); !res) {
+        record_failure(state, self.m_services[index].name, res.error());
+      } else {
+        graph &g = *state.g;
+        for (std::uint32_t e = g.offsets[index]; e < g.offsets[index + 1];
+             ++e) {
+          const std::uint32_t dependent = g.edges[e];
+          // The last dependency to finish releases the dependent
+          if (std::atomic_ref<std::uint32_t>(g.pending[dependent])
+                  .fetch_sub(1, std::memory_order_acq_rel) == 1)
+            schedule(state, dependent);
+        }
+      }
+    }
+    finish_one(state);
+  }
+
+  static void finish_one(run_state &state) noexcept {
+    // Decrement under the lock: the waiter owns ``state`` and may destroy it
+    // as soon as it observes zero, so nothing may touch ``state`` after the
+    // lock that published the zero is released
+    std::unique_lock<mutex> lock(state.done_mutex);
+    if (state.outstanding.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      state.done.notify_all();
+  }
+
+  fallible_allocator *m_alloc;
+  vector<service> m_services;
+  vector<string_view> m_dependencies;
+  vector<init_timing> m_report;
+  std::chrono::nanoseconds m_total_time{0};
+};
+
+} // namespace reloco
@@ -0,0 +1,671 @@
+#pragma once
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <reloco/allocator.hpp>
+#include <reloco/error_origin.hpp>
+#include <reloco/file_descriptor.hpp>
+#include <reloco/function.hpp>
+#include <reloco/mutex.hpp>
+#include <reloco/span.hpp>
+#include <reloco/thread_pool.hpp>
+#include <reloco/vector.hpp>
+#include <sys/uio.h>
+#include <tuple>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+namespace reloco {
+
+enum class io_backend { io_uring, thread_pool };
+
+struct io_ring_options {
+  /// Most operations in flight at once
+  std::uint32_t queue_depth = 128;
+  /// Workers running pread/pwrite when io_uring is unavailable
+  std::size_t fallback_threads = 4;
+  /// Use the thread pool even where the kernel has io_uring
+  bool force_fallback = false;
+};
+
+namespace detail {
+
+#if defined(__linux__)
+
+/**
+ * @brief The three shared mappings of an io_uring instance, driven by raw
+ * syscalls. Single-threaded: only the owning io_ring touches it.
+ */
+class uring {
+  int m_fd = -1;
+  void *m_sq_ring = nullptr;
+  void *m_cq_ring = nullptr;
+  std::size_t m_sq_ring_size = 0;
+  std::size_t m_cq_ring_size = 0;
+  io_uring_sqe *m_sqes = nullptr;
+  std::size_t m_sqes_size = 0;
+
+  unsigned *m_sq_tail = nullptr;
+  unsigned *m_sq_mask = nullptr;
+  unsigned *m_sq_array = nullptr;
+  unsigned *m_cq_head = nullptr;
+  unsigned *m_cq_tail = nullptr;
+  unsigned *m_cq_mask = nullptr;
+  io_uring_cqe *m_cqes = nullptr;
+  unsigned m_pending = 0; // Queued but not yet handed to the kernel
+
+  static void *map(const int fd, const std::size_t size,
+                   const off_t offset) noexcept {
+    void *ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, fd, offset);
+    return ptr == MAP_FAILED ? nullptr : ptr;
+  }
+
+  template <typename T>
+  static T *at(void *ring, const std::uint32_t offset) noexcept {
+    return reinterpret_cast<T *>(static_cast<char *>(ring) + offset);
+  }
+
+public:
+  uring() noexcept = default;
+  uring(const uring &) = delete;
+  uring &operator=(const uring &) = delete;
+  ~uring() { teardown(); }
+
+  [[nodiscard]] int fd() const noexcept { return m_fd; }
+
+  result<void> try_setup(const unsigned entries) noexcept {
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    const long fd = ::syscall(__NR_io_uring_setup, entries, &params);
+    if (fd < 0)
+      return RELOCO_ERROR(error_from_errno(errno));
+    m_fd = static_cast<int>(fd);
+
+    m_sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    m_cq_ring_size =
+        params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single) {
+      if (m_cq_ring_size > m_sq_ring_size)
+        m_sq_ring_size = m_cq_ring_size;
+      m_cq_ring_size = m_sq_ring_size;
+    }
+
+    m_sq_ring = map(m_fd, m_sq_ring_size, IORING_OFF_SQ_RING);
+    if (m_sq_ring)
+      m_cq_ring =
+          single ? m_sq_ring : map(m_fd, m_cq_ring_size, IORING_OFF_CQ_RING);
+    m_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    if (m_cq_ring)
+      m_sqes = static_cast<io_uring_sqe *>(
+          map(m_fd, m_sqes_size, IORING_OFF_SQES));
+    if (!m_sqes) {
+      teardown();
+      return RELOCO_ERROR(error::allocation_failed);
+    }
+
+    m_sq_tail = at<unsigned>(m_sq_ring, params.sq_off.tail);
+    m_sq_mask = at<unsigned>(m_sq_ring, params.sq_off.ring_mask);
+    m_sq_array = at<unsigned>(m_sq_ring, params.sq_off.array);
+    m_cq_head = at<unsigned>(m_cq_ring, params.cq_off.head);
+    m_cq_tail = at<unsigned>(m_cq_ring, params.cq_off.tail);
+    m_cq_mask = at<unsigned>(m_cq_ring, params.cq_off.ring_mask);
+    m_cqes = at<io_uring_cqe>(m_cq_ring, params.cq_off.cqes);
+    return {};
+  }
+
+  void teardown() noexcept {
+    if (m_sqes)
+      ::munmap(m_sqes, m_sqes_size);
+    if (m_cq_ring && m_cq_ring != m_sq_ring)
+      ::munmap(m_cq_ring, m_cq_ring_size);
+    if (m_sq_ring)
+      ::munmap(m_sq_ring, m_sq_ring_size);
+    if (m_fd >= 0)
+      ::close(m_fd);
+    m_sqes = nullptr;
+    m_cq_ring = m_sq_ring = nullptr;
+    m_fd = -1;
+  }
+
+  /**
+   * @brief Zeroed entry at the tail of the submission queue. The caller
+   * keeps the number in flight within the ring size.
+   */
+  io_uring_sqe &next_sqe() noexcept {
+    std::atomic_ref<unsigned> tail(*m_sq_tail);
+    const unsigned index = tail.load(std::memory_order_relaxed);
+    const unsigned slot = index & *m_sq_mask;
+    io_uring_sqe &sqe = m_sqes[slot];
+    std::memset(&sqe, 0, sizeof(sqe));
+    m_sq_array[slot] = slot;
+    tail.store(index + 1, std::memory_order_release);
+    ++m_pending;
+    return sqe;
+  }
+
+  /**
+   * @brief Submits the queued entries and, with ``min_complete`` above
+   * zero, waits for that many completions.
+   */
+  result<void> try_enter(const unsigned min_complete) noexcept {
+    const unsigned flags = min_complete > 0 ? IORING_ENTER_GETEVENTS : 0;
+    if (m_pending == 0 && flags == 0)
+      return {};
+    long n;
+    do {
+      n = ::syscall(__NR_io_uring_enter, m_fd, m_pending, min_complete,
+                    flags, nullptr, 0);
+    } while (n < 0 && errno == EINTR);
+    if (n < 0)
+      return RELOCO_ERROR(error_from_errno(errno));
+    m_pending -= static_cast<unsigned>(n);
+    return {};
+  }
+
+  /**
+   * @brief Calls ``f(user_data, res)`` for every completion posted so far.
+   */
+  template <typename F> std::size_t reap(F &&f) noexcept {
+    std::atomic_ref<unsigned> head_ref(*m_cq_head);
+    unsigned head = head_ref.load(std::memory_order_relaxed);
+    const unsigned tail =
+        std::atomic_ref<unsigned>(*m_cq_tail).load(std::memory_order_acquire);
+    std::size_t count = 0;
+    for (; head != tail; ++head, ++count) {
+      const io_uring_cqe &cqe = m_cqes[head & *m_cq_mask];
+      const std::uint64_t user_data = cqe.user_data;
+      const std::int32_t res = cqe.res;
+      head_ref.store(head + 1, std::memory_order_release);
+      f(user_data, res);
+    }
+    return count;
+  }
+};
+
+#endif
+
+} // namespace detail
+
+/**
+ * @brief Asynchronous positioned file reads and writes.
+ * Uses io_uring through raw syscalls where the kernel offers it (5.6 or
+ * newer), and otherwise a thread_pool running pread/pwrite. Either way,
+ * completion callbacks run on the thread that calls try_poll() or
+ * try_wait(), never concurrently.
+ *
+ * At most ``queue_depth`` operations are in flight; queueing another fails
+ * with ``try_again`` until completions are reaped. The destructor waits for
+ * operations still in flight and drops their callbacks uncalled.
+ *
+ * One operation moves at most 4 GiB - 1 bytes, the most an io_uring
+ * submission can describe. Longer ones fail with ``invalid_argument`` on
+ * both backends rather than being cut short.
+ */
+class io_ring {
+public:
+  using callback = function<void(result<std::size_t>)>;
+
+  /// Alignment of registered buffers, good for O_DIRECT as well
+  static constexpr std::size_t buffer_alignment = 4096;
+
+  class awaitable;
+
+  explicit io_ring(fallible_allocator &alloc = get_default_allocator()) noexcept
+      : m_alloc(&alloc), m_slots(alloc), m_free(alloc), m_buffers(alloc),
+        m_done(alloc), m_reaping(alloc), m_pool(alloc) {}
+
+  io_ring(const io_ring &) = delete;
+  io_ring &operator=(const io_ring &) = delete;
+
+  ~io_ring() {
+    m_discarding = true;
+    while (in_flight() > 0)
+      if (!try_wait(1))
+        break;
+    for (const iovec &buffer : m_buffers)
+      m_alloc->deallocate(buffer.iov_base, buffer.iov_len);
+  }
+
+  /**
+   * @brief Sets up io_uring, or the thread pool if io_uring is unavailable
+   * or ``opts.force_fallback`` is set. On failure the ring is left
+   * uninitialized, and try_init() may be called again.
+   */
+  result<void> try_init(const io_ring_options &opts = {}) & noexcept {
+    if (m_depth > 0)
+      return RELOCO_ERROR(error::already_exists);
+    if (opts.queue_depth == 0)
+      return RELOCO_ERROR(error::invalid_argument);
+
+    if (auto res = try_init_backend(opts); !res) {
+      m_slots.clear();
+      m_free.clear();
+#if defined(__linux__)
+      m_ring.teardown();
+#endif
+      m_backend = io_backend::thread_pool;
+      return res;
+    }
+    m_depth = opts.queue_depth;
+    return {};
+  }
+
+  [[nodiscard]] io_backend backend() const noexcept { return m_backend; }
+  [[nodiscard]] std::uint32_t queue_depth() const noexcept { return m_depth; }
+  [[nodiscard]] std::size_t in_flight() const noexcept {
+    return m_depth == 0 ? 0 : m_depth - m_free.size();
+  }
+
+  /**
+   * @brief Allocates ``count`` buffers of ``size`` bytes and registers them
+   * with the kernel, which then skips pinning them on every fixed read or
+   * write. If registration is refused (e.g. by RLIMIT_MEMLOCK) the buffers
+   * still work, through plain reads and writes.
+   */
+  result<void> try_register_buffers(const std::size_t count,
+                                    const std::size_t size) & noexcept {
+    if (m_depth == 0)
+      return RELOCO_ERROR(error::not_initialized);
+    if (!m_buffers.empty())
+      return RELOCO_ERROR(error::already_exists);
+    if (count == 0 || size == 0)
+      return RELOCO_ERROR(error::invalid_argument);
+
+    RELOCO_TRY(m_buffers.try_reserve(count));
+    for (std::size_t i = 0; i < count; ++i) {
+      auto block = m_alloc->allocate(size, buffer_alignment);
+      if (!block) {
+        release_buffers();
+        return RELOCO_ALLOC_ERROR(error::allocation_failed, *m_alloc);
+      }
+      std::ignore = m_buffers.try_push_back(iovec{block->ptr, size});
+    }
+#if defined(__linux__)
+    if (m_backend == io_backend::io_uring)
+      m_buffers_registered =
+          ::syscall(__NR_io_uring_register, m_ring.fd(),
+                    IORING_REGISTER_BUFFERS, m_buffers.begin(),
+                    static_cast<unsigned>(count)) == 0;
+#endif
+    return {};
+  }
+
+  [[nodiscard]] std::size_t buffer_count() const noexcept {
+    return m_buffers.size();
+  }
+
+  [[nodiscard]] bool buffers_registered() const noexcept {
+    return m_buffers_registered;
+  }
+
+  [[nodiscard]] span<std::byte> buffer(const std::size_t index) & noexcept {
+    RELOCO_ASSERT(index < m_buffers.size(), "buffer index out of range");
+    const iovec &b = m_buffers[index];
+    return span<std::byte>(static_cast<std::byte *>(b.iov_base), b.iov_len);
+  }
+
+  /**
+   * @brief Queues a read of ``into.size()`` bytes at ``offset`` of ``fd``.
+   * ``on_complete`` receives the bytes read (0 at end of file) or the
+   * error. ``into`` must stay valid until then.
+   */
+  template <typename F>
+  result<void> try_read(const int fd, span<std::byte> into,
+                        const std::uint64_t offset,
+                        F &&on_complete) & noexcept {
+    return try_queue(fd, into.empty() ? nullptr : into.unsafe_data(),
+                     into.size(), offset, false, -1,
+                     std::forward<F>(on_complete));
+  }
+
+  template <typename F>
+  result<void> try_write(const int fd, span<const std::byte> from,
+                         const std::uint64_t offset,
+                         F &&on_complete) & noexcept {
+    return try_queue(fd,
+                     const_cast<std::byte *>(
+                         from.empty() ? nullptr : from.unsafe_data()),
+                     from.size(), offset, true, -1,
+                     std::forward<F>(on_complete));
+  }
+
+  /**
+   * @brief Queues a read of ``length`` bytes into registered buffer
+   * ``index``.
+   */
+  template <typename F>
+  result<void> try_read_fixed(const int fd, const std::size_t index,
+                              const std::size_t length,
+                              const std::uint64_t offset,
+                              F &&on_complete) & noexcept {
+    if (index >= m_buffers.size() || length > m_buffers[index].iov_len)
+      return RELOCO_ERROR(error::out_of_bounds);
+    return try_queue(fd, static_cast<std::byte *>(m_buffers[index].iov_base),
+                     length, offset, false, static_cast<int>(index),
+                     std::forward<F>(on_complete));
+  }
+
+  template <typename F>
+  result<void> try_write_fixed(const int fd, const std::size_t index,
+                               const std::size_t length,
+                               const std::uint64_t offset,
+                               F &&on_complete) & noexcept {
+    if (index >= m_buffers.size() || length > m_buffers[index].iov_len)
+      return RELOCO_ERROR(error::out_of_bounds);
+    return try_queue(fd, static_cast<std::byte *>(m_buffers[index].iov_base),
+                     length, offset, true, static_cast<int>(index),
+                     std::forward<F>(on_complete));
+  }
+
+  /**
+   * @brief Awaitable form of try_read(); the coroutine resumes inside
+   * try_poll() or try_wait().
+   */
+  [[nodiscard]] awaitable async_read(int fd, span<std::byte> into,
+                                     std::uint64_t offset) & noexcept;
+
+  [[nodiscard]] awaitable async_write(int fd, span<const std::byte> from,
+                                      std::uint64_t offset) & noexcept;
+
+  /**
+   * @brief Hands queued io_uring operations to the kernel without waiting.
+   * The thread pool starts operations as they are queued.
+   */
+  result<void> try_submit() & noexcept {
+#if defined(__linux__)
+    if (m_backend == io_backend::io_uring)
+      return m_ring.try_enter(0);
+#endif
+    return {};
+  }
+
+  /**
+   * @brief Submits queued operations and runs the callbacks of those
+   * already complete.
+   * @return The number of callbacks run.
+   */
+  result<std::size_t> try_poll() & noexcept {
+    RELOCO_TRY(try_submit());
+    return reap();
+  }
+
+  /**
+   * @brief Submits queued operations and runs callbacks until at least
+   * ``min_complete`` operations (or all in flight, if fewer) are done.
+   * @return The number of callbacks run.
+   */
+  result<std::size_t> try_wait(std::size_t min_complete = 1) & noexcept {
+    if (min_complete > in_flight())
+      min_complete = in_flight();
+    RELOCO_TRY(try_submit());
+    std::size_t handled = reap();
+    while (handled < min_complete) {
+#if defined(__linux__)
+      if (m_backend == io_backend::io_uring) {
+        RELOCO_TRY(m_ring.try_enter(1));
+        handled += reap();
+        continue;
+      }
+#endif
+      {
+        std::unique_lock<mutex> lock(m_done_mutex);
+        RELOCO_TRY(m_done_cv.wait(lock, [this] { return !m_done.empty(); }));
+      }
+      handled += reap();
+    }
+    return handled;
+  }
+
+private:
+  /**
+   * @brief try_init() up to the point where it can fail; try_init() undoes
+   * whatever this got through.
+   */
+  result<void> try_init_backend(const io_ring_options &opts) noexcept {
+    RELOCO_TRY(m_slots.try_reserve(opts.queue_depth));
+    RELOCO_TRY(m_free.try_reserve(opts.queue_depth));
+    for (std::uint32_t i = 0; i < opts.queue_depth; ++i) {
+      RELOCO_TRY(m_slots.try_emplace_back());
+      RELOCO_TRY(m_free.try_emplace_back(opts.queue_depth - 1 - i));
+    }
+
+#if defined(__linux__)
+    if (!opts.force_fallback && m_ring.try_setup(opts.queue_depth))
+      m_backend = io_backend::io_uring;
+#endif
+    if (m_backend == io_backend::thread_pool) {
+      RELOCO_TRY(m_done.try_reserve(opts.queue_depth));
+      RELOCO_TRY(m_reaping.try_reserve(opts.queue_depth));
+      RELOCO_TRY(m_pool.try_start(opts.fallback_threads));
+    }
+    return {};
+  }
+
+  struct slot {
+    callback on_complete;
+    int fd = -1;
+    std::byte *data = nullptr;
+    std::size_t length = 0;
+    std::uint64_t offset = 0;
+    bool write = false;
+  };
+
+  struct completion {
+    std::uint32_t index;
+    std::int64_t res; // Bytes transferred, or -errno
+  };
+
+  template <typename F>
+  result<void> try_queue(const int fd, std::byte *data,
+                         const std::size_t length, const std::uint64_t offset,
+                         const bool write, const int buffer_index,
+                         F &&on_complete) noexcept {
+    if (m_depth == 0)
+      return RELOCO_ERROR(error::not_initialized);
+    // sqe.len is 32 bits; the thread pool keeps the same limit
+    if (length > std::numeric_limits<std::uint32_t>::max())
+      return RELOCO_ERROR(error::invalid_argument);
+    if (m_free.empty())
+      return RELOCO_ERROR(error::try_again);
+
+    callback cb;
+    if constexpr (std::is_same_v<std::decay_t<F>, callback>) {
+      cb = std::move(on_complete);
+    } else {
+      RELOCO_TRY_ASSIGN(cb, callback::try_allocate(
+                                std::forward<F>(on_complete), *m_alloc));
+    }
+
+    const std::uint32_t index = m_free[m_free.size() - 1];
+    std::ignore = m_free.try_pop_back();
+    slot &s = m_slots[index];
+    s.on_complete = std::move(cb);
+    s.fd = fd;
+    s.data = data;
+    s.length = length;
+    s.offset = offset;
+    s.write = write;
+
+#if defined(__linux__)
+    if (m_backend == io_backend::io_uring) {
+      io_uring_sqe &sqe = m_ring.next_sqe();
+      const bool fixed = buffer_index >= 0 && m_buffers_registered;
+      if (fixed) {
+        sqe.opcode = write ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED;
+        sqe.buf_index = static_cast<std::uint16_t>(buffer_index);
+      } else {
+        sqe.opcode = write ? IORING_OP_WRITE : IORING_OP_READ;
+      }
+      sqe.fd = fd;
+      sqe.off = offset;
+      sqe.addr = reinterpret_cast<std::uintptr_t>(data);
+      sqe.len = static_cast<std::uint32_t>(length);
+      sqe.user_data = index;
+      return {};
+    }
+#endif
+    std::ignore = buffer_index;
+    auto res = m_pool.try_submit([this, index] { run_blocking(index); });
+    if (!res) {
+      s.on_complete = callback();
+      std::ignore = m_free.try_emplace_back(index);
+      return res;
+    }
+    return {};
+  }
+
+  /**
+   * @brief Thread pool side of an operation: the blocking call, then the
+   * result handed to whoever reaps.
+   */
+  void run_blocking(const std::uint32_t index) noexcept {
+    const slot &s = m_slots[index];
+    ssize_t n;
+    do {
+      n = s.write ? ::pwrite(s.fd, s.data, s.length,
+                             static_cast<off_t>(s.offset))
+                  : ::pread(s.fd, s.data, s.length,
+                            static_cast<off_t>(s.offset));
+    } while (n < 0 && errno == EINTR);
+    const std::int64_t res = n < 0 ? -errno : n;
+    {
+      std::unique_lock<mutex> lock(m_done_mutex);
+      // Reserved for queue_depth entries, so this cannot fail
+      std::ignore = m_done.try_push_back(completion{index, res});
+    }
+    m_done_cv.notify_all();
+  }
+
+  std::size_t reap() noexcept {
+#if defined(__linux__)
+    if (m_backend == io_backend::io_uring)
+      return m_ring.reap([this](std::uint64_t user_data, std::int32_t res) {
+        complete(static_cast<std::uint32_t>(user_data), res);
+      });
+#endif
+    {
+      std::unique_lock<mutex> lock(m_done_mutex);
+      if (m_done.empty())
+        return 0;
+      std::ignore = m_reaping.try_append(
+          span<const completion>(m_done.begin(), m_done.size()));
+      m_done.clear();
+    }
+    const std::size_t count = m_reaping.size();
+    for (const completion &c : m_reaping)
+      complete(c.index, c.res);
+    m_reaping.clear();
+    return count;
+  }
+
+  void complete(const std::uint32_t index, const std::int64_t res) noexcept {
+    callback cb = std::move(m_slots[index].on_complete);
+    // The slot is free again before the callback, which may queue more
+    std::ignore = m_free.try_emplace_back(index);
+    if (m_discarding)
+      return;
+    if (res < 0) {
+      result<std::size_t> failed =
+          RELOCO_ERROR(detail::error_from_errno(static_cast<int>(-res)));
+      cb(std::move(failed));
+    } else {
+      cb(result<std::size_t>(static_cast<std::size_t>(res)));
+    }
+  }
+
+  void release_buffers() noexcept {
+    for (const iovec &buffer : m_buffers)
+      m_alloc->deallocate(buffer.iov_base, buffer.iov_len);
+    m_buffers.clear();
+  }
+
+  fallible_allocator *m_alloc;
+  io_backend m_backend = io_backend::thread_pool;
+  std::uint32_t m_depth = 0;
+  bool m_buffers_registered = false;
+  bool m_discarding = false;
+  vector<slot> m_slots;
+  vector<std::uint32_t> m_free;
+  vector<iovec> m_buffers;
+#if defined(__linux__)
+  detail::uring m_ring;
+#endif
+  // Thread pool backend: completions posted by workers, guarded by
+  // m_done_mutex, and the copy being reaped
+  mutex m_done_mutex;
+  condition_variable m_done_cv;
+  vector<completion> m_done;
+  vector<completion> m_reaping;
+  // Last, so that its workers are joined before the rest is destroyed
+  thread_pool m_pool;
+};
+
+/**
+ * @brief ``co_await``-able single read or write; evaluates to the bytes
+ * transferred or the error.
+ */
+class io_ring::awaitable {
+  io_ring *m_ring;
+  int m_fd;
+  std::byte *m_data;
+  std::size_t m_length;
+  std::uint64_t m_offset;
+  bool m_write;
+  result<std::size_t> m_result{std::size_t{0}};
+
+public:
+  awaitable(io_ring &ring, const int fd, std::byte *data,
+            const std::size_t length, const std::uint64_t offset,
+            const bool write) noexcept
+      : m_ring(&ring), m_fd(fd), m_data(data), m_length(length),
+        m_offset(offset), m_write(write) {}
+
+  bool await_ready() const noexcept { return false; }
+
+  bool await_suspend(std::coroutine_handle<> waiter) noexcept {
+    auto resume = [this, waiter](result<std::size_t> r) {
+      m_result = std::move(r);
+      waiter.resume();
+    };
+    auto res = m_ring->try_queue(m_fd, m_data, m_length, m_offset, m_write,
+                                 -1, resume);
+    if (!res) {
+      m_result = unexpected(res.error());
+      return false; // Resume right away with the error
+    }
+    return true;
+  }
+
+  result<std::size_t> await_resume() noexcept { return std::move(m_result); }
+};
+
+inline io_ring::awaitable io_ring::async_read(const int fd,
+                                              span<std::byte> into,
+                                              const std::uint64_t offset) &
+    noexcept {
+  return awaitable(*this, fd, into.empty() ? nullptr : into.unsafe_data(),
+                   into.size(), offset, false);
+}
+
+inline io_ring::awaitable io_ring::async_write(const int fd,
+                                               span<const std::byte> from,
+                                               const std::uint64_t offset) &
+    noexcept {
+  return awaitable(*this, fd,
+                   const_cast<std::byte *>(
+                       from.empty() ? nullptr : from.unsafe_data()),
+                   from.size(), offset, true);
+}
+
+} // namespace reloco
@@ -0,0 +1,375 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <reloco/allocator.hpp>
+#include <reloco/assert.hpp>
+#include <reloco/core.hpp>
+#include <reloco/error_origin.hpp>
+#include <reloco/intrusive_ptr.hpp>
+#include <reloco/span.hpp>
+#include <reloco/vector.hpp>
+#include <sys/uio.h>
+#include <utility>
+
+namespace reloco {
+
+/**
+ * @brief Reference-counted byte storage shared by the iobuf segments that
+ * point into it. The bytes follow the header in the same allocation.
+ */
+class iobuf_block : public intrusive_base_dynamic<iobuf_block> {
+  std::size_t m_capacity;
+  std::atomic<std::size_t> m_used{0};
+
+public:
+  explicit iobuf_block(const std::size_t capacity) noexcept
+      : m_capacity(capacity) {}
+
+  static result<boost::intrusive_ptr<iobuf_block>>
+  try_allocate_block(fallible_allocator &alloc,
+                     const std::size_t capacity) noexcept {
+    if (capacity > SIZE_MAX - sizeof(iobuf_block))
+      return RELOCO_ERROR(error::integer_overflow);
+    return try_allocate_intrusive_dynamic<iobuf_block>(
+        alloc, sizeof(iobuf_block) + capacity, capacity);
+  }
+
+  [[nodiscard]] std::byte *data() noexcept {
+    return reinterpret_cast<std::byte *>(this + 1);
+  }
+  [[nodiscard]] std::size_t capacity() const noexcept { return m_capacity; }
+
+  /**
+   * @brief Reserves ``n`` bytes at ``offset`` for the writer whose data ends
+   * there. Fails when the block is full or another segment already claimed
+   * the bytes past ``offset``, so shared blocks are never overwritten.
+   */
+  [[nodiscard]] bool try_claim(const std::size_t offset,
+                               const std::size_t n) noexcept {
+    if (n > m_capacity - offset)
+      return false;
+    std::size_t expected = offset;
+    return m_used.compare_exchange_strong(expected, offset + n,
+                                          std::memory_order_relaxed);
+  }
+};
+
+namespace detail {
+
+struct iobuf_segment {
+  /// Null when the segment borrows external memory
+  boost::intrusive_ptr<iobuf_block> block;
+  const std::byte *data;
+  std::size_t size;
+};
+
+} // namespace detail
+
+template <> struct is_relocatable<detail::iobuf_segment> : std::true_type {};
+
+/**
+ * @brief Chain of byte segments for scatter-gather I/O.
+ *
+ * A segment either borrows external memory, which must stay alive and
+ * unchanged while any chain refers to it, or points into a shared
+ * iobuf_block. Appending, prepending, splitting and cloning move segment
+ * descriptors only; bytes are copied by the ``_copy`` functions and
+ * try_coalesce() alone. A chain is not thread-safe, but chains sharing
+ * blocks may be used from different threads.
+ */
+class iobuf {
+  fallible_allocator *m_alloc;
+  vector<detail::iobuf_segment> m_segments;
+  std::size_t m_size = 0;
+
+  struct split_point {
+    std::size_t whole; ///< Segments entirely before the split
+    std::size_t rest;  ///< Bytes of the next segment before the split
+  };
+
+  [[nodiscard]] split_point find_split(std::size_t n) const noexcept {
+    std::size_t whole = 0;
+    while (whole < m_segments.size() && m_segments[whole].size <= n)
+      n -= m_segments[whole++].size;
+    return {whole, n};
+  }
+
+  [[nodiscard]] result<void>
+  try_push_copy(const span<const std::byte> bytes) noexcept {
+    const std::size_t n = bytes.size();
+    RELOCO_TRY_ASSIGN(auto block,
+                      iobuf_block::try_allocate_block(
+                          *m_alloc, std::max(n, default_block_size)));
+    const bool claimed = block->try_claim(0, n);
+    RELOCO_DEBUG_ASSERT(claimed, "fresh block has room for its first copy");
+    (void)claimed;
+    std::memcpy(block->data(), bytes.unsafe_data(), n);
+    const std::byte *data = block->data();
+    RELOCO_TRY(m_segments.try_emplace_back(
+        detail::iobuf_segment{std::move(block), data, n}));
+    m_size += n;
+    return {};
+  }
+
+public:
+  /// Smallest block try_append_copy() allocates, leaving room for more
+  static constexpr std::size_t default_block_size = 4096;
+
+  iobuf() noexcept : iobuf(get_default_allocator()) {}
+  explicit iobuf(fallible_allocator &alloc) noexcept
+      : m_alloc(&alloc), m_segments(alloc) {}
+
+  iobuf(const iobuf &) = delete;
+  iobuf &operator=(const iobuf &) = delete;
+
+  iobuf(iobuf &&other) noexcept
+      : m_alloc(other.m_alloc), m_segments(std::move(other.m_segments)),
+        m_size(std::exchange(other.m_size, 0)) {}
+
+  /// Total bytes across all segments
+  [[nodiscard]] std::size_t size() const noexcept { return m_size; }
+  [[nodiscard]] bool empty() const noexcept { return m_size == 0; }
+  [[nodiscard]] std::size_t segment_count() const noexcept {
+    return m_segments.size();
+  }
+
+  [[nodiscard]] span<const std::byte>
+  segment(const std::size_t index) const noexcept {
+    RELOCO_DEBUG_ASSERT(index < m_segments.size(), "segment out of range");
+    const auto &seg = m_segments[index];
+    return span<const std::byte>(seg.data, seg.size);
+  }
+
+  void clear() noexcept {
+    m_segments.clear();
+    m_size = 0;
+  }
+
+  /**
+   * @brief Appends a segment borrowing ``bytes`` without copying them.
+   */
+  [[nodiscard]] result<void>
+  try_append(const span<const std::byte> bytes) & noexcept {
+    if (bytes.empty())
+      return {};
+    RELOCO_TRY(m_segments.try_emplace_back(
+        detail::iobuf_segment{nullptr, bytes.unsafe_data(), bytes.size()}));
+    m_size += bytes.size();
+    return {};
+  }
+
+  /**
+   * @brief Prepends a segment borrowing ``bytes`` without copying them.
+   */
+  [[nodiscard]] result<void>
+  try_prepend(const span<const std::byte> bytes) & noexcept {
+    if (bytes.empty())
+      return {};
+    RELOCO_TRY(m_segments.try_insert(
+        0, detail::iobuf_segment{nullptr, bytes.unsafe_data(), bytes.size()}));
+    m_size += bytes.size();
+    return {};
+  }
+
+  /**
+   * @brief Moves every segment of ``other`` to the end of this chain.
+   * On failure both chains are unchanged.
+   */
+  [[nodiscard]] result<void> try_append(iobuf &&other) & noexcept {
+    RELOCO_TRY(m_segments.try_reserve(m_segments.size() +
+                                      other.m_segments.size()));
+    for (auto &seg : other.m_segments)
+      RELOCO_TRY(m_segments.try_emplace_back(std::move(seg)));
+    m_size += other.m_size;
+    other.clear();
+    return {};
+  }
+
+  /**
+   * @brief Moves every segment of ``other`` to the front of this chain.
+   * On failure both chains are unchanged.
+   */
+  [[nodiscard]] result<void> try_prepend(iobuf &&other) & noexcept {
+    RELOCO_TRY(other.m_segments.try_reserve(other.m_segments.size() +
+                                            m_segments.size()));
+    for (auto &seg : m_segments)
+      RELOCO_TRY(other.m_segments.try_emplace_back(std::move(seg)));
+    m_segments.swap(other.m_segments);
+    m_size += other.m_size;
+    other.clear();
+    return {};
+  }
+
+  /**
+   * @brief Copies ``bytes`` into owned storage at the end of the chain,
+   * filling the spare room of the last block before allocating another.
+   */
+  [[nodiscard]] result<void>
+  try_append_copy(const span<const std::byte> bytes) & noexcept {
+    if (bytes.empty())
+      return {};
+    if (!m_segments.empty()) {
+      auto &last = m_segments[m_segments.size() - 1];
+      if (last.block) {
+        const auto end =
+            static_cast<std::size_t>(last.data - last.block->data()) +
+            last.size;
+        if (last.block->try_claim(end, bytes.size())) {
+          std::memcpy(last.block->data() + end, bytes.unsafe_data(),
+                      bytes.size());
+          last.size += bytes.size();
+          m_size += bytes.size();
+          return {};
+        }
+      }
+    }
+    return try_push_copy(bytes);
+  }
+
+  /**
+   * @brief Copies ``bytes`` into a new owned segment at the front, e.g. a
+   * protocol header for a borrowed payload.
+   */
+  [[nodiscard]] result<void>
+  try_prepend_copy(const span<const std::byte> bytes) & noexcept {
+    if (bytes.empty())
+      return {};
+    iobuf head(*m_alloc);
+    RELOCO_TRY(head.try_push_copy(bytes));
+    return try_prepend(std::move(head));
+  }
+
+  /**
+   * @brief Shares every segment with a new chain; no bytes are copied.
+   */
+  [[nodiscard]] result<iobuf> try_clone() const noexcept {
+    iobuf clone(*m_alloc);
+    RELOCO_TRY(clone.m_segments.try_reserve(m_segments.size()));
+    for (const auto &seg : m_segments)
+      RELOCO_TRY(clone.m_segments.try_emplace_back(
+          detail::iobuf_segment{seg.block, seg.data, seg.size}));
+    clone.m_size = m_size;
+    return clone;
+  }
+
+  /**
+   * @brief Detaches the first ``n`` bytes into a new chain. A segment
+   * straddling the split is shared by both chains rather than copied.
+   */
+  [[nodiscard]] result<iobuf> try_split(const std::size_t n) & noexcept {
+    if (n > m_size)
+      return RELOCO_ERROR(error::out_of_range);
+    const split_point at = find_split(n);
+    iobuf head(*m_alloc);
+    RELOCO_TRY(head.m_segments.try_reserve(at.whole + (at.rest != 0)));
+    for (std::size_t i = 0; i < at.whole; ++i)
+      RELOCO_TRY(head.m_segments.try_emplace_back(std::move(m_segments[i])));
+    if (at.rest != 0) {
+      auto &seg = m_segments[at.whole];
+      RELOCO_TRY(head.m_segments.try_emplace_back(
+          detail::iobuf_segment{seg.block, seg.data, at.rest}));
+      seg.data += at.rest;
+      seg.size -= at.rest;
+    }
+    RELOCO_TRY(m_segments.try_erase(0, at.whole));
+    head.m_size = n;
+    m_size -= n;
+    return head;
+  }
+
+  /**
+   * @brief Drops the first ``n`` bytes, e.g. after a partial writev().
+   */
+  [[nodiscard]] result<void> try_trim_front(const std::size_t n) & noexcept {
+    if (n > m_size)
+      return RELOCO_ERROR(error::out_of_range);
+    const split_point at = find_split(n);
+    if (at.rest != 0) {
+      m_segments[at.whole].data += at.rest;
+      m_segments[at.whole].size -= at.rest;
+    }
+    RELOCO_TRY(m_segments.try_erase(0, at.whole));
+    m_size -= n;
+    return {};
+  }
+
+  /**
+   * @brief Makes the chain contiguous, copying it into one new block when it
+   * has more than one segment.
+   */
+  [[nodiscard]] result<span<const std::byte>> try_coalesce() & noexcept {
+    if (m_segments.size() > 1) {
+      RELOCO_TRY_ASSIGN(auto block,
+                        iobuf_block::try_allocate_block(*m_alloc, m_size));
+      const bool claimed = block->try_claim(0, m_size);
+      RELOCO_DEBUG_ASSERT(claimed, "fresh block has room for the chain");
+      (void)claimed;
+      std::byte *out = block->data();
+      for (const auto &seg : m_segments) {
+        std::memcpy(out, seg.data, seg.size);
+        out += seg.size;
+      }
+      const std::byte *data = block->data();
+      m_segments.clear();
+      // Cannot fail: the vector kept its capacity
+      RELOCO_TRY(m_segments.try_emplace_back(
+          detail::iobuf_segment{std::move(block), data, m_size}));
+    }
+    if (m_segments.empty())
+      return span<const std::byte>();
+    return segment(0);
+  }
+
+  /**
+   * @brief Copies up to ``out.size()`` bytes from the front of the chain.
+   * @return The number of bytes copied.
+   */
+  std::size_t copy_to(const span<std::byte> out) const noexcept {
+    std::size_t copied = 0;
+    for (const auto &seg : m_segments) {
+      if (copied == out.size())
+        break;
+      const std::size_t n = std::min(seg.size, out.size() - copied);
+      std::memcpy(out.unsafe_data() + copied, seg.data, n);
+      copied += n;
+    }
+    return copied;
+  }
+
+  /**
+   * @brief Describes segments from ``first_segment`` on as iovecs for
+   * writev() or ``msghdr::msg_iov``, as many as ``out`` holds. Chains longer
+   * than IOV_MAX are sent in batches by advancing ``first_segment``.
+   * @return The number of iovecs filled in.
+   */
+  std::size_t to_iovecs(const span<iovec> out,
+                        const std::size_t first_segment = 0) const noexcept {
+    if (first_segment >= m_segments.size())
+      return 0;
+    const std::size_t count =
+        std::min(out.size(), m_segments.size() - first_segment);
+    iovec *vecs = count == 0 ? nullptr : out.unsafe_data();
+    for (std::size_t i = 0; i < count; ++i) {
+      const auto &seg = m_segments[first_segment + i];
+      vecs[i].iov_base = const_cast<std::byte *>(seg.data);
+      vecs[i].iov_len = seg.size;
+    }
+    return count;
+  }
+
+  /**
+   * @brief Appends an iovec for every segment to ``out``.
+   */
+  [[nodiscard]] result<void> try_to_iovecs(vector<iovec> &out) const noexcept {
+    RELOCO_TRY(out.try_reserve(out.size() + m_segments.size()));
+    for (const auto &seg : m_segments)
+      RELOCO_TRY(out.try_emplace_back(
+          iovec{const_cast<std::byte *>(seg.data), seg.size}));
+    return {};
+  }
+};
+
+} // namespace reloco
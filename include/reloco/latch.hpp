@@ -0,0 +1,98 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <reloco/core.hpp>
+#include <reloco/error_origin.hpp>
+#include <reloco/futex.hpp>
+
+namespace reloco {
+
+/**
+ * @brief Single-use downward counter, threads block until it reaches zero.
+ * The counter and a "has waiters" flag share one futex word, so
+ * ``count_down()`` only performs a wake syscall when somebody is blocked.
+ */
+class latch {
+  static constexpr std::uint32_t WAITERS_BIT = 1u << 31;
+  static constexpr std::uint32_t COUNT_MASK = WAITERS_BIT - 1;
+
+public:
+  static constexpr std::uint32_t max() noexcept { return COUNT_MASK; }
+
+  constexpr explicit latch(std::uint32_t expected) noexcept
+      : m_state(expected) {
+    RELOCO_ASSERT(expected <= COUNT_MASK, "Latch count exceeds max()");
+  }
+
+  latch(const latch &) = delete;
+  latch &operator=(const latch &) = delete;
+
+  /**
+   * @brief Decrements the counter by ``n``.
+   * @return error::invalid_argument if ``n`` exceeds the remaining count.
+   */
+  result<void> count_down(std::uint32_t n = 1) & noexcept {
+    std::uint32_t current = m_state.load(std::memory_order_relaxed);
+    do {
+      if (n > (current & COUNT_MASK))
+        return RELOCO_ERROR(error::invalid_argument);
+    } while (!m_state.compare_exchange_weak(current, current - n,
+                                            std::memory_order_acq_rel,
+                                            std::memory_order_relaxed));
+
+    if ((current & COUNT_MASK) == n && (current & WAITERS_BIT)) [[unlikely]]
+      futex_wake_all(m_state);
+    return {};
+  }
+
+  [[nodiscard]] bool try_wait() const noexcept {
+    return (m_state.load(std::memory_order_acquire) & COUNT_MASK) == 0;
+  }
+
+  result<void> wait() & noexcept {
+    while (true) {
+      const std::uint32_t current = announce_waiter();
+      if ((current & COUNT_MASK) == 0)
+        return {};
+      std::ignore = futex_wait(m_state, current | WAITERS_BIT);
+    }
+  }
+
+  template <typename Clock, typename Duration>
+  result<void>
+  wait_until(const std::chrono::time_point<Clock, Duration> &deadline) & noexcept {
+    while (true) {
+      const std::uint32_t current = announce_waiter();
+      if ((current & COUNT_MASK) == 0)
+        return {};
+      auto res = futex_wait_until(m_state, current | WAITERS_BIT, deadline);
+      if (!res)
+        return try_wait() ? result<void>{} : res;
+    }
+  }
+
+  template <typename Rep, typename Period>
+  result<void>
+  wait_for(const std::chrono::duration<Rep, Period> &timeout) & noexcept {
+    return wait_until(std::chrono::steady_clock::now() + timeout);
+  }
+
+  result<void> arrive_and_wait(std::uint32_t n = 1) & noexcept {
+    auto res = count_down(n);
+    if (!res)
+      return res;
+    return wait();
+  }
+
+private:
+  std::uint32_t announce_waiter() noexcept {
+    const std::uint32_t current = m_state.load(std::memory_order_acquire);
+    if ((current & COUNT_MASK) == 0 || (current & WAITERS_BIT))
+      return current;
+    return m_state.fetch_or(WAITERS_BIT, std::memory_order_acq_rel);
+  }
+
+  futex_word m_state;
+};
+
+} // namespace reloco
@@ -1,47 +1,46 @@
 #pragma once
 #include <boost/intrusive/set.hpp>
 #include <reloco/construction_helpers.hpp>
+#include <reloco/error_origin.hpp>
 #include <reloco/vector.hpp>
 
 namespace reloco {
 
 template <typename K, typename V, typename Compare = std::less<K>> class map {
-  struct MapNode : public boost::intrusive::set_base_hook<> {
+  // Normal links: nothing walks the tree to reset hooks when it is cleared
+  using hook_t = boost::intrusive::set_base_hook<
+      boost::intrusive::link_mode<boost::intrusive::normal_link>>;
+
+  struct MapNode : public hook_t {
     K key;
     V value;
 
     MapNode(K &&k, V &&v) : key(std::move(k)), value(std::move(v)) {}
 
+    // Hooks are never transferred; the moved-to node starts unlinked
+    MapNode(MapNode &&other) noexcept
+        : key(std::move(other.key)), value(std::move(other.value)) {}
+
     template <typename... KArgs, typename... VArgs>
     static result<MapNode> try_create(fallible_allocator &alloc,
                                       std::tuple<KArgs...> k_args,
                                       std::tuple<VArgs...> v_args) noexcept {
-      result<K> k_res =
-          create_component<K>(alloc, std::move(k_args),
-                              std::make_index_sequence<sizeof...(KArgs)>{});
-      if (!k_res)
-        return unexpected(k_res.error());
-
-      result<V> v_res =
-          create_component<V>(alloc, std::move(v_args),
-                              std::make_index_sequence<sizeof...(VArgs)>{});
-      if (!v_res)
-        return unexpected(v_res.error());
-
-      return MapNode(std::move(*k_res), std::move(*v_res));
+      RELOCO_TRY_ASSIGN(
+          K k, create_component<K>(
+                   alloc, std::move(k_args),
+                   std::make_index_sequence<sizeof...(KArgs)>{}));
+      RELOCO_TRY_ASSIGN(
+          V v, create_component<V>(
+                   alloc, std::move(v_args),
+                   std::make_index_sequence<sizeof...(VArgs)>{}));
+      return MapNode(std::move(k), std::move(v));
     }
 
     [[nodiscard]] result<MapNode>
     try_clone(fallible_allocator &alloc) const noexcept {
-      auto k_res = construction_helpers::try_clone<K>(alloc, key);
-      if (!k_res)
-        return unexpected(k_res.error());
-
-      auto v_res = construction_helpers::try_clone<V>(alloc, value);
-      if (!v_res)
-        return unexpected(v_res.error());
-
-      return MapNode(std::move(*k_res), std::move(*v_res));
+      RELOCO_TRY_ASSIGN(K k, construction_helpers::try_clone<K>(alloc, key));
+      RELOCO_TRY_ASSIGN(V v, construction_helpers::try_clone<V>(alloc, value));
+      return MapNode(std::move(k), std::move(v));
     }
 
   private:
@@ -69,6 +68,14 @@ template <typename K, typename V, typename Compare = std::less<K>> class map {
     }
   };
 
+  // For allocators whose frees are no-ops
+  struct NodeDestroyer {
+    void operator()(MapNode *node) { node->~MapNode(); }
+  };
+
+  static constexpr bool trivial_nodes =
+      std::is_trivially_destructible_v<K> && std::is_trivially_destructible_v<V>;
+
   fallible_allocator *alloc_;
 
   using set_t =
@@ -105,7 +112,21 @@ public:
 
   ~map() { clear(); }
 
-  void clear() noexcept { set_.clear_and_dispose(NodeDisposer{alloc_}); }
+  /**
+   * @brief Destroys all nodes.
+   * On an allocator whose frees are no-ops, the nodes are not handed back,
+   * and for trivially destructible keys and values this is O(1).
+   */
+  void clear() noexcept {
+    if (alloc_->frees_are_noops()) {
+      if constexpr (trivial_nodes)
+        set_.clear();
+      else
+        set_.clear_and_dispose(NodeDestroyer{});
+      return;
+    }
+    set_.clear_and_dispose(NodeDisposer{alloc_});
+  }
 
   iterator begin() & noexcept { return set_.begin(); }
   const_iterator begin() const & noexcept { return set_.begin(); }
@@ -127,13 +148,12 @@ public:
     map new_map(alloc);
 
     for (const auto &node : set_) {
-      auto block = alloc.allocate(sizeof(MapNode), alignof(MapNode));
-      if (!block)
-        return unexpected(block.error());
-      MapNode *ptr = static_cast<MapNode *>(block->ptr);
+      RELOCO_TRY_ASSIGN(mem_block block,
+                        alloc.allocate(sizeof(MapNode), alignof(MapNode)));
+      MapNode *ptr = static_cast<MapNode *>(block.ptr);
 
       auto node_res = node.try_clone(alloc);
-      if (!node_res) {
+      if (!node_res) [[unlikely]] {
         alloc.deallocate(ptr, sizeof(MapNode));
         return unexpected(node_res.error());
       }
@@ -153,14 +173,12 @@ public:
     // Search for existing
     auto it = set_.find(key);
     if (it != set_.end()) {
-      return unexpected(error::already_exists);
+      return RELOCO_ERROR(error::already_exists);
     }
 
-    auto block = alloc_->allocate(sizeof(MapNode), alignof(MapNode));
-    if (!block)
-      return unexpected(block.error());
-
-    MapNode *node = new (block->ptr) MapNode(std::move(key), std::move(value));
+    RELOCO_TRY_ASSIGN(mem_block block,
+                      alloc_->allocate(sizeof(MapNode), alignof(MapNode)));
+    MapNode *node = new (block.ptr) MapNode(std::move(key), std::move(value));
 
     set_.insert_equal(*node);
     return &node->value;
@@ -169,7 +187,7 @@ public:
   [[nodiscard]] result<void> try_erase(const K &key) & noexcept {
     auto it = set_.find(key);
     if (it == set_.end()) {
-      return unexpected(error::out_of_range);
+      return RELOCO_ERROR(error::out_of_range);
     }
 
     // Unlink from tree and deallocate
@@ -198,7 +216,7 @@ public:
   [[nodiscard]] result<V *> try_at(const K &key) & noexcept {
     auto it = find(key);
     if (it == end()) {
-      return unexpected(error::out_of_range);
+      return RELOCO_ERROR(error::out_of_range);
     }
     return &(it->value);
   }
@@ -230,13 +248,13 @@ public:
 
     auto block = alloc_->allocate(sizeof(MapNode), alignof(MapNode));
     if (!block)
-      return unexpected(error::allocation_failed);
+      return RELOCO_ALLOC_ERROR(error::allocation_failed, *alloc_);
     MapNode *ptr = static_cast<MapNode *>(block->ptr);
 
     auto res = MapNode::try_create(
         std::make_tuple(key), std::make_tuple(std::forward<Args>(args)...));
 
-    if (!res) {
+    if (!res) [[unlikely]] {
       alloc_->deallocate(ptr, sizeof(MapNode));
       return unexpected(res.error());
     }
@@ -265,16 +283,19 @@ public:
   fallible_allocator &get_allocator() const noexcept { return *alloc_; }
 
   void merge(map &&other) & noexcept {
+    // One descent per node: the check remembers where the node would go,
+    // and nothing touches 'this' before the commit links it there
+    typename set_t::insert_commit_data commit;
     auto it = other.set_.begin();
     while (it != other.set_.end()) {
-      auto [inserted_it, success] = set_.insert_unique(*it);
-
-      if (success) {
-        // Effectively unlinks from 'other' and links into 'this'
-        it = other.set_.erase(it);
-      } else {
+      if (!set_.insert_unique_check(it->key, commit).second) {
         ++it;
+        continue;
       }
+      // Unlink from 'other' before the hook is reused by 'this'
+      MapNode &node = *it;
+      it = other.set_.erase(it);
+      set_.insert_unique_commit(node, commit);
     }
   }
 };
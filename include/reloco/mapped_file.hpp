@@ -0,0 +1,151 @@
+#pragma once
+#include <cstddef>
+#include <reloco/core.hpp>
+#include <reloco/error_origin.hpp>
+#include <reloco/file_descriptor.hpp>
+#include <reloco/posix_allocator.hpp>
+#include <reloco/span.hpp>
+#include <reloco/string_view.hpp>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace reloco {
+
+struct mapped_file_options {
+  /// Forwarded to madvise() right after mapping
+  usage_hint hint = usage_hint::normal;
+  /// Fault every page in up front (MAP_POPULATE, or will_need elsewhere)
+  bool populate = false;
+};
+
+/**
+ * @brief Read-only memory mapping of a whole file, unmapped on destruction.
+ * The file may be closed once mapped; its contents are then read straight
+ * from the page cache without a copy. Changes others make to the file may
+ * show through the mapping, and truncating it underneath raises SIGBUS on
+ * access to the lost pages.
+ */
+class mapped_file {
+  const std::byte *m_data = nullptr;
+  std::size_t m_size = 0;
+
+  mapped_file(const std::byte *data, const std::size_t size) noexcept
+      : m_data(data), m_size(size) {}
+
+public:
+  using options = mapped_file_options;
+
+  mapped_file() noexcept = default;
+
+  mapped_file(const mapped_file &) = delete;
+  mapped_file &operator=(const mapped_file &) = delete;
+
+  mapped_file(mapped_file &&other) noexcept
+      : m_data(other.m_data), m_size(other.m_size) {
+    other.m_data = nullptr;
+    other.m_size = 0;
+  }
+
+  mapped_file &operator=(mapped_file &&other) noexcept {
+    if (this != &other) {
+      unmap();
+      m_data = other.m_data;
+      m_size = other.m_size;
+      other.m_data = nullptr;
+      other.m_size = 0;
+    }
+    return *this;
+  }
+
+  ~mapped_file() { unmap(); }
+
+  /**
+   * @brief Maps the file at ``path``. An empty file gives an empty mapping.
+   */
+  static result<mapped_file> try_open(const char *path,
+                                      const options opts = {}) noexcept {
+    RELOCO_TRY_ASSIGN(unique_fd fd, unique_fd::try_open(path, O_RDONLY));
+    return try_map(fd.get(), opts);
+  }
+
+  /**
+   * @brief Maps the whole of the open file ``fd``, which stays owned by the
+   * caller.
+   */
+  static result<mapped_file> try_map(const int fd,
+                                     const options opts = {}) noexcept {
+    struct stat info;
+    if (::fstat(fd, &info) != 0)
+      return RELOCO_ERROR(detail::error_from_errno(errno));
+    if (info.st_size == 0)
+      return mapped_file{};
+
+    const auto size = static_cast<std::size_t>(info.st_size);
+    int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+    if (opts.populate)
+      flags |= MAP_POPULATE;
+#endif
+    void *ptr = ::mmap(nullptr, size, PROT_READ, flags, fd, 0);
+    if (ptr == MAP_FAILED)
+      return RELOCO_ERROR(detail::error_from_errno(errno));
+
+    mapped_file file(static_cast<const std::byte *>(ptr), size);
+#ifndef MAP_POPULATE
+    if (opts.populate)
+      file.advise(usage_hint::will_need);
+#endif
+    file.advise(opts.hint);
+    return file;
+  }
+
+  [[nodiscard]] std::size_t size() const noexcept { return m_size; }
+  [[nodiscard]] bool empty() const noexcept { return m_size == 0; }
+
+  [[nodiscard]] span<const std::byte> bytes() const & noexcept {
+    return span<const std::byte>(m_data, m_size);
+  }
+
+  [[nodiscard]] string_view text() const & noexcept {
+    return string_view(reinterpret_cast<const char *>(m_data), m_size);
+  }
+
+  /**
+   * @brief Forwards ``hint`` for the whole mapping to madvise(); like
+   * fallible_allocator::advise(), failure is ignored.
+   */
+  void advise(const usage_hint hint) noexcept {
+    if (const int posix_hint = detail::to_madvise(hint);
+        posix_hint >= 0 && m_size > 0)
+      ::madvise(const_cast<std::byte *>(m_data), m_size, posix_hint);
+  }
+
+  /**
+   * @brief Forwards ``hint`` for ``length`` bytes from ``offset``, widened to
+   * whole pages.
+   */
+  result<void> try_advise(const std::size_t offset, const std::size_t length,
+                          const usage_hint hint) noexcept {
+    if (offset > m_size || length > m_size - offset)
+      return RELOCO_ERROR(error::out_of_bounds);
+    const int posix_hint = detail::to_madvise(hint);
+    if (posix_hint < 0 || length == 0)
+      return {};
+
+    const auto page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    const std::size_t first = offset & ~(page - 1);
+    if (::madvise(const_cast<std::byte *>(m_data) + first,
+                  offset + length - first, posix_hint) != 0)
+      return RELOCO_ERROR(detail::error_from_errno(errno));
+    return {};
+  }
+
+private:
+  void unmap() noexcept {
+    if (m_data)
+      ::munmap(const_cast<std::byte *>(m_data), m_size);
+  }
+};
+
+} // namespace reloco
@@ -3,6 +3,7 @@
 #include <mutex>
 #include <reloco/config.hpp>
 #include <reloco/core.hpp>
+#include <reloco/error_origin.hpp>
 #include <reloco/fallible_constructed.hpp>
 
 #if defined(_WIN32)
@@ -55,7 +56,7 @@ protected:
     int result = pthread_mutex_lock(m);
     if (result == 0)
       return {};
-    return unexpected(from_posix_errno(result));
+    return RELOCO_ERROR(from_posix_errno(result));
   }
 
   static result<void> do_timed_lock(pthread_mutex_t *m,
@@ -63,35 +64,35 @@ protected:
     int result = pthread_mutex_timedlock(m, abs_timeout);
     if (result == 0)
       return {};
-    return unexpected(from_posix_errno(result));
+    return RELOCO_ERROR(from_posix_errno(result));
   }
 
   static result<void> do_unlock(pthread_mutex_t *m) noexcept {
     int result = pthread_mutex_unlock(m);
     if (result == 0)
       return {};
-    return unexpected(from_posix_errno(result));
+    return RELOCO_ERROR(from_posix_errno(result));
   }
 
   static result<void> do_lock(pthread_rwlock_t *m) noexcept {
     int result = pthread_rwlock_wrlock(m);
     if (result == 0)
       return {};
-    return unexpected(from_posix_errno(result));
+    return RELOCO_ERROR(from_posix_errno(result));
   }
 
   static result<void> do_rlock(pthread_rwlock_t *m) noexcept {
     int result = pthread_rwlock_rdlock(m);
     if (result == 0)
       return {};
-    return unexpected(from_posix_errno(result));
+    return RELOCO_ERROR(from_posix_errno(result));
   }
 
   static result<void> do_unlock(pthread_rwlock_t *m) noexcept {
     int result = pthread_rwlock_unlock(m);
     if (result == 0)
       return {};
-    return unexpected(from_posix_errno(result));
+    return RELOCO_ERROR(from_posix_errno(result));
   }
 };
 
@@ -224,7 +225,7 @@ public:
 
   result<void> wait(std::unique_lock<mutex> &locker) & noexcept {
     if (!locker.owns_lock())
-      return unexpected(error::not_locked);
+      return RELOCO_ERROR(error::not_locked);
     pthread_cond_wait(&m_cond, locker.mutex()->native_handle());
     return {};
   }
@@ -232,7 +233,7 @@ public:
   template <class Predicate>
   result<void> wait(std::unique_lock<mutex> &locker, Predicate pred) & {
     if (!locker.owns_lock())
-      return unexpected(error::not_locked);
+      return RELOCO_ERROR(error::not_locked);
     while (!pred()) {
       pthread_cond_wait(&m_cond, locker.mutex()->native_handle());
     }
@@ -297,7 +298,7 @@ public:
 
   result<void> wait(std::unique_lock<mutex> &locker) & noexcept {
     if (!locker.owns_lock())
-      return unexpected(error::not_locked);
+      return RELOCO_ERROR(error::not_locked);
     SleepConditionVariableSRW(&m_cv, locker.mutex()->native_handle(), INFINITE,
                               0);
     return {};
@@ -306,7 +307,7 @@ public:
   template <class Predicate>
   result<void> wait(std::unique_lock<mutex> &locker, Predicate pred) & {
     if (!locker.owns_lock())
-      return unexpected(error::not_locked);
+      return RELOCO_ERROR(error::not_locked);
     while (!pred()) {
       SleepConditionVariableSRW(&m_cv, locker.mutex()->native_handle(),
                                 INFINITE, 0);
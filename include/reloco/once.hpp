@@ -0,0 +1,85 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <reloco/core.hpp>
+#include <reloco/futex.hpp>
+#include <type_traits>
+
+namespace reloco {
+
+/**
+ * @brief Fallible one-time initialization flag.
+ * Once initialization succeeded, ``try_call()`` is a single acquire load.
+ * Threads racing the running initializer park on a futex instead of
+ * spinning or taking a lock. If the initializer fails, the flag goes back to
+ * its idle state: the failing caller gets the error, and every thread parked
+ * during that attempt wakes up and makes its own attempt.
+ */
+class once_flag {
+public:
+  constexpr once_flag() noexcept = default;
+
+  once_flag(const once_flag &) = delete;
+  once_flag &operator=(const once_flag &) = delete;
+
+  [[nodiscard]] bool is_done() const noexcept {
+    return m_state.load(std::memory_order_acquire) == DONE;
+  }
+
+  /**
+   * @brief Runs ``f`` unless a previous call already succeeded.
+   * @param f Callable returning ``result<void>``.
+   */
+  template <typename F>
+    requires std::is_invocable_r_v<result<void>, F &>
+  result<void> try_call(F &&f) noexcept {
+    if (m_state.load(std::memory_order_acquire) == DONE) [[likely]]
+      return {};
+    return try_call_slow(f);
+  }
+
+private:
+  static constexpr std::uint32_t IDLE = 0;
+  static constexpr std::uint32_t RUNNING = 1;
+  static constexpr std::uint32_t RUNNING_WITH_WAITERS = 2;
+  static constexpr std::uint32_t DONE = 3;
+
+  template <typename F> result<void> try_call_slow(F &f) noexcept {
+    std::uint32_t state = m_state.load(std::memory_order_acquire);
+    while (true) {
+      switch (state) {
+      case DONE:
+        return {};
+
+      case IDLE:
+        if (m_state.compare_exchange_strong(state, RUNNING,
+                                            std::memory_order_acquire,
+                                            std::memory_order_acquire)) {
+          result<void> res = f();
+          const std::uint32_t prev =
+              m_state.exchange(res ? DONE : IDLE, std::memory_order_acq_rel);
+          if (prev == RUNNING_WITH_WAITERS)
+            futex_wake_all(m_state);
+          return res;
+        }
+        break;
+
+      case RUNNING:
+        if (!m_state.compare_exchange_strong(state, RUNNING_WITH_WAITERS,
+                                             std::memory_order_acquire,
+                                             std::memory_order_acquire))
+          break;
+        [[fallthrough]];
+
+      default:
+        std::ignore = futex_wait(m_state, RUNNING_WITH_WAITERS);
+        state = m_state.load(std::memory_order_acquire);
+        break;
+      }
+    }
+  }
+
+  futex_word m_state{IDLE};
+};
+
+} // namespace reloco
@@ -0,0 +1,503 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <reloco/collection_view.hpp>
+#include <reloco/core.hpp>
+#include <reloco/span.hpp>
+#include <reloco/vector.hpp>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Lazy, push-based pipelines over contiguous data.
+ *
+ * @code
+ * namespace rp = reloco::pipeline;
+ * auto res = (rp::from(orders)
+ *             | rp::filter([](const order &o) { return o.open; })
+ *             | rp::transform([](const order &o) { return o.total; })
+ *             | rp::take(100))
+ *                .try_collect_into(totals);
+ * @endcode
+ *
+ * Every stage is a template wrapping the previous one, so running a pipeline
+ * inlines into a single loop over the source without intermediate buffers or
+ * allocations. Callables may return plain values or ``result``; the first
+ * error stops the loop and is returned. Sources refer to the data they were
+ * created from, which must outlive the pipeline.
+ */
+namespace reloco::pipeline {
+
+namespace detail {
+
+template <typename R> struct unwrap_result {
+  using type = R;
+};
+
+template <typename T> struct unwrap_result<result<T>> {
+  using type = T;
+};
+
+// Calls f, lifting a plain return value into a result
+template <typename F, typename... Args>
+auto invoke_fallible(const F &f, Args &&...args) noexcept {
+  using R = std::invoke_result_t<const F &, Args...>;
+  if constexpr (is_result_v<R>)
+    return f(std::forward<Args>(args)...);
+  else
+    return result<std::remove_cvref_t<R>>(f(std::forward<Args>(args)...));
+}
+
+// Up to N elements pushed by value, destroyed when the chunk is emptied
+template <typename T, std::size_t N> class chunk_buffer {
+public:
+  chunk_buffer() noexcept = default;
+  chunk_buffer(const chunk_buffer &) = delete;
+  chunk_buffer &operator=(const chunk_buffer &) = delete;
+  ~chunk_buffer() { clear(); }
+
+  template <typename U> void push(U &&value) noexcept {
+    new (slot(m_size)) T(std::forward<U>(value));
+    ++m_size;
+  }
+
+  void clear() noexcept {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      for (std::size_t i = 0; i < m_size; ++i)
+        slot(i)->~T();
+    }
+    m_size = 0;
+  }
+
+  [[nodiscard]] std::size_t size() const noexcept { return m_size; }
+
+  span<const T> view() const noexcept {
+    return span<const T>(std::launder(reinterpret_cast<const T *>(m_storage)),
+                         m_size);
+  }
+
+private:
+  T *slot(std::size_t i) noexcept {
+    return reinterpret_cast<T *>(m_storage) + i;
+  }
+
+  alignas(T) std::byte m_storage[N * sizeof(T)];
+  std::size_t m_size = 0;
+};
+
+} // namespace detail
+
+/**
+ * @brief Terminal operations shared by every pipeline stage.
+ * A stage provides ``reference`` (the type pushed downstream), ``sized`` with
+ * ``size()`` when the element count is known up front, and
+ * ``run(sink) -> result<void>`` where ``sink(reference) -> result<bool>``
+ * returns false to stop early.
+ */
+template <typename Derived> class node {
+public:
+  /**
+   * @brief Calls ``fn`` for each element. ``fn`` may return void,
+   * ``result<void>``, or ``bool``/``result<bool>`` where false stops early.
+   */
+  template <typename F> result<void> try_for_each(F &&fn) const noexcept {
+    return self().run([&](auto &&value) -> result<bool> {
+      using R = decltype(fn(std::forward<decltype(value)>(value)));
+      if constexpr (std::is_void_v<R>) {
+        fn(std::forward<decltype(value)>(value));
+        return true;
+      } else if constexpr (std::is_same_v<R, result<void>>) {
+        RELOCO_TRY(fn(std::forward<decltype(value)>(value)));
+        return true;
+      } else {
+        return fn(std::forward<decltype(value)>(value));
+      }
+    });
+  }
+
+  /**
+   * @brief Appends every element to ``out``, reserving up front when the
+   * element count is known. On failure ``out`` is restored to its old size.
+   */
+  template <typename T>
+  result<void> try_collect_into(vector<T> &out) const noexcept {
+    const std::size_t old_size = out.size();
+    if constexpr (Derived::sized)
+      RELOCO_TRY(out.try_reserve(old_size + self().size()));
+
+    auto res = self().run([&](auto &&value) -> result<bool> {
+      RELOCO_TRY(out.try_emplace_back(std::forward<decltype(value)>(value)));
+      return true;
+    });
+    if (!res) [[unlikely]] {
+      while (out.size() > old_size)
+        std::ignore = out.try_pop_back();
+    }
+    return res;
+  }
+
+  /**
+   * @brief Number of elements the pipeline produces.
+   */
+  result<std::size_t> try_count() const noexcept {
+    if constexpr (Derived::sized) {
+      return self().size();
+    } else {
+      std::size_t count = 0;
+      RELOCO_TRY(self().run([&](auto &&) -> result<bool> {
+        ++count;
+        return true;
+      }));
+      return count;
+    }
+  }
+
+private:
+  const Derived &self() const noexcept {
+    return static_cast<const Derived &>(*this);
+  }
+};
+
+template <typename T>
+concept stage = requires { typename std::remove_cvref_t<T>::reference; } &&
+                std::is_base_of_v<node<std::remove_cvref_t<T>>,
+                                  std::remove_cvref_t<T>>;
+
+/**
+ * @brief Source over a contiguous range.
+ */
+template <typename T> class span_source : public node<span_source<T>> {
+public:
+  using reference = const T &;
+  static constexpr bool sized = true;
+
+  constexpr span_source(const T *data, std::size_t size) noexcept
+      : m_data(data), m_size(size) {}
+
+  [[nodiscard]] std::size_t size() const noexcept { return m_size; }
+
+  const T &operator[](std::size_t i) const noexcept { return m_data[i]; }
+
+  template <typename Sink> result<void> run(Sink &&sink) const noexcept {
+    for (std::size_t i = 0; i < m_size; ++i) {
+      RELOCO_TRY_ASSIGN(const bool more, sink(m_data[i]));
+      if (!more)
+        break;
+    }
+    return {};
+  }
+
+private:
+  const T *m_data;
+  std::size_t m_size;
+};
+
+/**
+ * @brief Source over a collection_view or any_view, walked chunk by chunk.
+ */
+template <typename View, typename T>
+class view_source : public node<view_source<View, T>> {
+public:
+  using reference = const T &;
+  static constexpr bool sized = true;
+
+  explicit view_source(const View &view) noexcept : m_view(&view) {}
+
+  [[nodiscard]] std::size_t size() const noexcept { return m_view->size(); }
+
+  template <typename Sink> result<void> run(Sink &&sink) const noexcept {
+    result<void> status;
+    bool open = true;
+    m_view->for_each_chunk([&](span<const T> chunk) noexcept {
+      for (std::size_t i = 0; open && i < chunk.size(); ++i) {
+        auto more = sink(chunk.unsafe_at(i));
+        if (!more) [[unlikely]] {
+          status = unexpected(more.error());
+          open = false;
+        } else if (!*more) {
+          open = false;
+        }
+      }
+    });
+    return status;
+  }
+
+private:
+  const View *m_view;
+};
+
+template <typename T>
+span_source<T> from(const vector<T> &values) noexcept {
+  return span_source<T>(values.begin(), values.size());
+}
+
+// A temporary vector would be gone before the pipeline runs
+template <typename T> void from(const vector<T> &&) = delete;
+
+template <typename T> span_source<T> from(span<T> values) noexcept {
+  return span_source<T>(values.empty() ? nullptr : values.unsafe_data(),
+                        values.size());
+}
+
+template <typename Container, template <typename> typename Policy>
+auto from(const collection_view<Container, Policy> &view) noexcept {
+  return view_source<collection_view<Container, Policy>,
+                     typename Container::value_type>(view);
+}
+
+template <typename T> auto from(const any_view<T> &view) noexcept {
+  return view_source<any_view<T>, T>(view);
+}
+
+template <typename Up, typename Pred>
+class filter_node : public node<filter_node<Up, Pred>> {
+public:
+  using reference = typename Up::reference;
+  static constexpr bool sized = false;
+
+  filter_node(Up up, Pred pred) noexcept
+      : m_up(std::move(up)), m_pred(std::move(pred)) {}
+
+  template <typename Sink> result<void> run(Sink &&sink) const noexcept {
+    return m_up.run([&](auto &&value) -> result<bool> {
+      RELOCO_TRY_ASSIGN(const bool keep,
+                        detail::invoke_fallible(m_pred, std::as_const(value)));
+      if (!keep)
+        return true;
+      return sink(std::forward<decltype(value)>(value));
+    });
+  }
+
+private:
+  Up m_up;
+  Pred m_pred;
+};
+
+template <typename Up, typename Fn>
+class transform_node : public node<transform_node<Up, Fn>> {
+public:
+  using reference = typename detail::unwrap_result<std::remove_cvref_t<
+      std::invoke_result_t<const Fn &, typename Up::reference>>>::type;
+  static constexpr bool sized = Up::sized;
+
+  transform_node(Up up, Fn fn) noexcept
+      : m_up(std::move(up)), m_fn(std::move(fn)) {}
+
+  [[nodiscard]] std::size_t size() const noexcept
+    requires Up::sized
+  {
+    return m_up.size();
+  }
+
+  template <typename Sink> result<void> run(Sink &&sink) const noexcept {
+    return m_up.run([&](auto &&value) -> result<bool> {
+      RELOCO_TRY_ASSIGN(
+          reference mapped,
+          detail::invoke_fallible(m_fn, std::forward<decltype(value)>(value)));
+      return sink(std::move(mapped));
+    });
+  }
+
+private:
+  Up m_up;
+  Fn m_fn;
+};
+
+template <typename Up> class take_node : public node<take_node<Up>> {
+public:
+  using reference = typename Up::reference;
+  static constexpr bool sized = Up::sized;
+
+  take_node(Up up, std::size_t count) noexcept
+      : m_up(std::move(up)), m_count(count) {}
+
+  [[nodiscard]] std::size_t size() const noexcept
+    requires Up::sized
+  {
+    return std::min(m_up.size(), m_count);
+  }
+
+  template <typename Sink> result<void> run(Sink &&sink) const noexcept {
+    if (m_count == 0)
+      return {};
+    std::size_t taken = 0;
+    return m_up.run([&](auto &&value) -> result<bool> {
+      RELOCO_TRY_ASSIGN(const bool more,
+                        sink(std::forward<decltype(value)>(value)));
+      return more && ++taken < m_count;
+    });
+  }
+
+private:
+  Up m_up;
+  std::size_t m_count;
+};
+
+// Chunks copy elements into an inline buffer, which has no way to report a
+// failed copy
+template <typename Up>
+concept nothrow_chunkable =
+    std::is_nothrow_constructible_v<std::remove_cvref_t<typename Up::reference>,
+                                    typename Up::reference>;
+
+template <typename Up, std::size_t N>
+  requires nothrow_chunkable<Up>
+class chunk_node : public node<chunk_node<Up, N>> {
+  using element = std::remove_cvref_t<typename Up::reference>;
+
+public:
+  using reference = span<const element>;
+  static constexpr bool sized = Up::sized;
+
+  explicit chunk_node(Up up) noexcept : m_up(std::move(up)) {}
+
+  [[nodiscard]] std::size_t size() const noexcept
+    requires Up::sized
+  {
+    return (m_up.size() + N - 1) / N;
+  }
+
+  template <typename Sink> result<void> run(Sink &&sink) const noexcept {
+    detail::chunk_buffer<element, N> buffer;
+    bool open = true;
+    RELOCO_TRY(m_up.run([&](auto &&value) -> result<bool> {
+      buffer.push(std::forward<decltype(value)>(value));
+      if (buffer.size() < N)
+        return true;
+      RELOCO_TRY_ASSIGN(open, sink(buffer.view()));
+      buffer.clear();
+      return open;
+    }));
+    // Trailing partial chunk
+    if (open && buffer.size() != 0)
+      RELOCO_TRY(sink(buffer.view()));
+    return {};
+  }
+
+private:
+  Up m_up;
+};
+
+template <typename Up, typename T>
+class zip_node : public node<zip_node<Up, T>> {
+public:
+  using reference = std::pair<typename Up::reference, const T &>;
+  static constexpr bool sized = Up::sized;
+
+  zip_node(Up up, span_source<T> other) noexcept
+      : m_up(std::move(up)), m_other(other) {}
+
+  [[nodiscard]] std::size_t size() const noexcept
+    requires Up::sized
+  {
+    return std::min(m_up.size(), m_other.size());
+  }
+
+  template <typename Sink> result<void> run(Sink &&sink) const noexcept {
+    std::size_t index = 0;
+    return m_up.run([&](auto &&value) -> result<bool> {
+      if (index == m_other.size())
+        return false;
+      const T &paired = m_other[index++];
+      return sink(
+          reference(std::forward<decltype(value)>(value), paired));
+    });
+  }
+
+private:
+  Up m_up;
+  span_source<T> m_other;
+};
+
+// Stage descriptors, applied to a pipeline with operator|
+
+template <typename Pred> struct filter_stage {
+  Pred pred;
+  template <stage Up> auto apply(Up &&up) && noexcept {
+    return filter_node<std::remove_cvref_t<Up>, Pred>(std::forward<Up>(up),
+                                                      std::move(pred));
+  }
+};
+
+template <typename Fn> struct transform_stage {
+  Fn fn;
+  template <stage Up> auto apply(Up &&up) && noexcept {
+    return transform_node<std::remove_cvref_t<Up>, Fn>(std::forward<Up>(up),
+                                                       std::move(fn));
+  }
+};
+
+struct take_stage {
+  std::size_t count;
+  template <stage Up> auto apply(Up &&up) && noexcept {
+    return take_node<std::remove_cvref_t<Up>>(std::forward<Up>(up), count);
+  }
+};
+
+template <std::size_t N> struct chunk_stage {
+  template <stage Up>
+    requires nothrow_chunkable<std::remove_cvref_t<Up>>
+  auto apply(Up &&up) && noexcept {
+    return chunk_node<std::remove_cvref_t<Up>, N>(std::forward<Up>(up));
+  }
+};
+
+template <typename T> struct zip_stage {
+  span_source<T> other;
+  template <stage Up> auto apply(Up &&up) && noexcept {
+    return zip_node<std::remove_cvref_t<Up>, T>(std::forward<Up>(up), other);
+  }
+};
+
+/**
+ * @brief Keeps the elements for which ``pred`` returns true.
+ */
+template <typename Pred> filter_stage<Pred> filter(Pred pred) noexcept {
+  return {std::move(pred)};
+}
+
+/**
+ * @brief Replaces each element by ``fn(element)``; ``fn`` may fail.
+ */
+template <typename Fn> transform_stage<Fn> transform(Fn fn) noexcept {
+  return {std::move(fn)};
+}
+
+/**
+ * @brief Stops after the first ``count`` elements.
+ */
+inline take_stage take(std::size_t count) noexcept { return {count}; }
+
+/**
+ * @brief Groups elements into spans of ``N`` (the last may be shorter),
+ * buffered inline on the stack. Elements must be copyable (or movable, for
+ * stages that produce values) without throwing.
+ */
+template <std::size_t N>
+  requires(N > 0)
+chunk_stage<N> chunk() noexcept {
+  return {};
+}
+
+/**
+ * @brief Pairs each element with the element of ``other`` at the same
+ * position, stopping at the shorter of the two.
+ */
+template <typename T> zip_stage<T> zip(const vector<T> &other) noexcept {
+  return {from(other)};
+}
+
+template <typename T> zip_stage<T> zip(span<T> other) noexcept {
+  return {from(other)};
+}
+
+template <stage Up, typename Stage>
+  requires requires(Stage &&s, Up &&up) {
+    std::forward<Stage>(s).apply(std::forward<Up>(up));
+  }
+auto operator|(Up &&up, Stage &&s) noexcept {
+  return std::forward<Stage>(s).apply(std::forward<Up>(up));
+}
+
+} // namespace reloco::pipeline
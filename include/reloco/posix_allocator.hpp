@@ -2,11 +2,43 @@
 #include <cstdlib>
 #include <cstring>
 #include <reloco/core.hpp>
+#include <reloco/error_origin.hpp>
 #include <sys/mman.h>
 #include <unistd.h>
 
 namespace reloco {
 
+namespace detail {
+
+/**
+ * @brief The madvise() advice for ``hint``, or -1 when there is none to give
+ * ('normal', or a hint this kernel lacks).
+ */
+inline int to_madvise(const usage_hint hint) noexcept {
+  switch (hint) {
+  case usage_hint::sequential:
+    return MADV_SEQUENTIAL;
+  case usage_hint::random:
+    return MADV_RANDOM;
+  case usage_hint::will_need:
+    return MADV_WILLNEED;
+  case usage_hint::dont_need:
+    return MADV_DONTNEED;
+#ifdef MADV_COLD
+  case usage_hint::cold:
+    return MADV_COLD;
+#endif
+#ifdef MADV_HUGEPAGE
+  case usage_hint::huge_pages:
+    return MADV_HUGEPAGE;
+#endif
+  default:
+    return -1;
+  }
+}
+
+} // namespace detail
+
 class posix_allocator final : public fallible_allocator {
 public:
   result<mem_block> allocate(std::size_t bytes,
@@ -18,7 +50,7 @@ public:
 
     void *ptr = nullptr;
     if (::posix_memalign(&ptr, alignment, bytes) != 0) {
-      return unexpected(error::allocation_failed);
+      return RELOCO_ALLOC_ERROR(error::allocation_failed, *this);
     }
     return mem_block{ptr, bytes};
   }
@@ -38,14 +70,14 @@ public:
     if (alignment <= alignof(std::max_align_t)) {
       void *new_ptr = ::realloc(ptr, new_size);
       if (!new_ptr)
-        return unexpected(error::allocation_failed);
+        return RELOCO_ALLOC_ERROR(error::allocation_failed, *this);
       return mem_block{new_ptr, new_size};
     }
 
     // We can't trust realloc for 64-byte or 4096-byte alignment.
     auto new_block_res = allocate(new_size, alignment);
     if (!new_block_res)
-      return unexpected(error::allocation_failed);
+      return new_block_res;
 
     void *new_ptr = new_block_res->ptr;
     std::memcpy(new_ptr, ptr, old_size);
@@ -54,7 +86,21 @@ public:
     return mem_block{new_ptr, new_size};
   }
 
+  [[nodiscard]] result<mem_block>
+  allocate_zeroed(std::size_t bytes, std::size_t alignment) noexcept override {
+    // calloc gets fresh pages from the kernel without clearing them again
+    if (alignment > alignof(std::max_align_t))
+      return fallible_allocator::allocate_zeroed(bytes, alignment);
+
+    void *ptr = ::calloc(1, bytes);
+    if (!ptr)
+      return RELOCO_ALLOC_ERROR(error::allocation_failed, *this);
+    return mem_block{ptr, bytes};
+  }
+
   void deallocate(void *ptr, std::size_t) noexcept override { ::free(ptr); }
+
+  [[nodiscard]] const char *tag() const noexcept override { return "posix"; }
 };
 
 class mmap_allocator final : public fallible_allocator {
@@ -64,17 +110,24 @@ public:
            std::size_t const alignment) noexcept override {
     if (const auto page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
         alignment > page_size) {
-      return unexpected(error::invalid_argument);
+      return RELOCO_ALLOC_ERROR(error::invalid_argument, *this);
     }
     void *ptr = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
     if (ptr == MAP_FAILED) {
-      return unexpected(error::allocation_failed);
+      return RELOCO_ALLOC_ERROR(error::allocation_failed, *this);
     }
 
     return mem_block{ptr, bytes};
   }
 
+  // Anonymous mappings are always zero-filled
+  [[nodiscard]] result<mem_block>
+  allocate_zeroed(std::size_t const bytes,
+                  std::size_t const alignment) noexcept override {
+    return allocate(bytes, alignment);
+  }
+
   [[nodiscard]] result<std::size_t>
   expand_in_place(void *ptr, const std::size_t old_size,
                   const std::size_t new_size) noexcept override {
@@ -93,7 +146,7 @@ public:
     void *new_ptr = ::mremap(ptr, old_size, new_size, MREMAP_MAYMOVE);
 
     if (new_ptr == MAP_FAILED) {
-      return unexpected(error::allocation_failed);
+      return RELOCO_ALLOC_ERROR(error::allocation_failed, *this);
     }
 
     return mem_block{new_ptr, new_size};
@@ -105,39 +158,13 @@ public:
     }
   }
 
+  [[nodiscard]] const char *tag() const noexcept override { return "mmap"; }
+
   void advise(void *ptr, const std::size_t bytes,
               const usage_hint hint) noexcept override {
-    int posix_hint = 0;
-
-    switch (hint) {
-    case usage_hint::sequential:
-      posix_hint = MADV_SEQUENTIAL;
-      break;
-    case usage_hint::random:
-      posix_hint = MADV_RANDOM;
-      break;
-    case usage_hint::will_need:
-      posix_hint = MADV_WILLNEED;
-      break;
-    case usage_hint::dont_need:
-      posix_hint = MADV_DONTNEED;
-      break;
-#ifdef MADV_COLD
-    case usage_hint::cold:
-      posix_hint = MADV_COLD;
-      break;
-#endif
-#ifdef MADV_HUGEPAGE
-    case usage_hint::huge_pages:
-      posix_hint = MADV_HUGEPAGE;
-      break;
-#endif
-    default:
-      return; // Do nothing for 'normal' or unknown
-    }
-
     // madvise is a hint; we don't return a result because failure is non-fatal
-    ::madvise(ptr, bytes, posix_hint);
+    if (const int posix_hint = detail::to_madvise(hint); posix_hint >= 0)
+      ::madvise(ptr, bytes, posix_hint);
   }
 };
 
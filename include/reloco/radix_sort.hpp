@@ -0,0 +1,481 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <reloco/allocator.hpp>
+#include <reloco/allocator_helper.hpp>
+#include <reloco/core.hpp>
+#include <reloco/error_origin.hpp>
+#include <reloco/latch.hpp>
+#include <reloco/relocation.hpp>
+#include <reloco/span.hpp>
+#include <reloco/thread_pool.hpp>
+#include <reloco/vector.hpp>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace reloco {
+
+/**
+ * @brief Key types the LSD sorts order by their bit pattern.
+ */
+template <typename K>
+concept radix_key =
+    (std::integral<K> && !std::same_as<K, bool> && sizeof(K) <= 8) ||
+    std::same_as<K, float> || std::same_as<K, double>;
+
+/**
+ * @brief ``KeyFn`` extracts a radix_key from a ``T``, and ``T`` can be moved
+ * between buffers bitwise.
+ */
+template <typename T, typename KeyFn>
+concept radix_sortable =
+    std::invocable<KeyFn &, const T &> &&
+    radix_key<std::remove_cvref_t<std::invoke_result_t<KeyFn &, const T &>>> &&
+    is_relocatable<T>::value;
+
+/**
+ * @brief Key results a string_view may outlive: references into the
+ * element, or views such as string_view. Types that own their bytes, like
+ * std::string returned by value, would be gone before the view is read.
+ */
+template <typename R>
+concept string_key_result =
+    std::convertible_to<R, std::string_view> &&
+    (std::is_lvalue_reference_v<R> || std::is_trivially_copyable_v<R>);
+
+/**
+ * @brief ``KeyFn`` extracts a byte string from a ``T``.
+ */
+template <typename T, typename KeyFn>
+concept string_sortable =
+    std::invocable<KeyFn &, const T &> &&
+    string_key_result<std::invoke_result_t<KeyFn &, const T &>> &&
+    std::is_nothrow_move_constructible_v<T> && std::is_nothrow_swappable_v<T>;
+
+namespace detail {
+
+// Below this many elements, an insertion sort beats setting up the buckets
+inline constexpr std::size_t radix_small_sort_threshold = 64;
+inline constexpr std::size_t radix_buckets = 256;
+
+template <std::size_t Bytes> struct radix_unsigned;
+template <> struct radix_unsigned<1> {
+  using type = std::uint8_t;
+};
+template <> struct radix_unsigned<2> {
+  using type = std::uint16_t;
+};
+template <> struct radix_unsigned<4> {
+  using type = std::uint32_t;
+};
+template <> struct radix_unsigned<8> {
+  using type = std::uint64_t;
+};
+
+template <typename K>
+using radix_bits_t = typename radix_unsigned<sizeof(K)>::type;
+
+/**
+ * Maps a key to an unsigned integer with the same ordering: signed integers
+ * get their sign bit flipped; negative floats are inverted entirely,
+ * positive ones get the sign bit set.
+ */
+template <radix_key K> constexpr radix_bits_t<K> to_radix_bits(K key) noexcept {
+  using U = radix_bits_t<K>;
+  constexpr U sign = static_cast<U>(U{1} << (sizeof(K) * 8 - 1));
+  if constexpr (std::floating_point<K>) {
+    const U bits = std::bit_cast<U>(key);
+    return (bits & sign) ? static_cast<U>(~bits) : static_cast<U>(bits | sign);
+  } else if constexpr (std::is_signed_v<K>) {
+    return static_cast<U>(static_cast<U>(key) ^ sign);
+  } else {
+    return static_cast<U>(key);
+  }
+}
+
+template <typename T, typename KeyFn>
+auto radix_bits_of(KeyFn &key, const T &value) noexcept {
+  return to_radix_bits(std::invoke(key, value));
+}
+
+template <typename T, typename Less>
+void insertion_sort(T *data, std::size_t n, Less &&less) noexcept {
+  for (std::size_t i = 1; i < n; ++i) {
+    if (!less(data[i], data[i - 1]))
+      continue;
+    T current = std::move(data[i]);
+    std::size_t j = i;
+    for (; j > 0 && less(current, data[j - 1]); --j)
+      data[j] = std::move(data[j - 1]);
+    data[j] = std::move(current);
+  }
+}
+
+template <typename T>
+void relocate_one(T *dest, T *source) noexcept {
+  std::memcpy(static_cast<void *>(dest), static_cast<const void *>(source),
+              sizeof(T));
+}
+
+/**
+ * Raw storage for ``count`` objects of T, returned to the allocator on
+ * destruction. Never constructs or destroys elements.
+ */
+template <typename T> class radix_scratch {
+public:
+  static result<radix_scratch> try_allocate(fallible_allocator &alloc,
+                                            std::size_t count) noexcept {
+    std::size_t bytes;
+    if (check_mul(count, sizeof(T), &bytes))
+      return RELOCO_ERROR(error::integer_overflow);
+    RELOCO_TRY_ASSIGN(const mem_block block,
+                      alloc.allocate(bytes, alignof(T)));
+    return radix_scratch(alloc, static_cast<T *>(block.ptr), bytes);
+  }
+
+  radix_scratch(radix_scratch &&other) noexcept
+      : m_alloc(other.m_alloc), m_data(std::exchange(other.m_data, nullptr)),
+        m_bytes(other.m_bytes) {}
+
+  radix_scratch(const radix_scratch &) = delete;
+  radix_scratch &operator=(const radix_scratch &) = delete;
+  radix_scratch &operator=(radix_scratch &&) = delete;
+
+  ~radix_scratch() noexcept {
+    if (m_data)
+      m_alloc->deallocate(m_data, m_bytes);
+  }
+
+  T *get() const noexcept { return m_data; }
+
+private:
+  radix_scratch(fallible_allocator &alloc, T *data, std::size_t bytes) noexcept
+      : m_alloc(&alloc), m_data(data), m_bytes(bytes) {}
+
+  fallible_allocator *m_alloc;
+  T *m_data;
+  std::size_t m_bytes;
+};
+
+template <typename T, typename KeyFn>
+void radix_small_sort(T *data, std::size_t n, KeyFn &key) noexcept {
+  insertion_sort(data, n, [&](const T &a, const T &b) {
+    return radix_bits_of(key, a) < radix_bits_of(key, b);
+  });
+}
+
+/**
+ * Turns the digit histogram into bucket start offsets.
+ * @return false if all keys share the digit, so the pass can be skipped.
+ */
+inline bool radix_offsets(std::size_t *counts, std::size_t n) noexcept {
+  std::size_t running = 0;
+  for (std::size_t b = 0; b < radix_buckets; ++b) {
+    if (counts[b] == n)
+      return false;
+    const std::size_t count = counts[b];
+    counts[b] = running;
+    running += count;
+  }
+  return true;
+}
+
+template <typename T, typename KeyFn>
+result<void> lsd_radix_sort(T *data, std::size_t n, KeyFn &key,
+                            fallible_allocator &alloc) noexcept {
+  if (n < radix_small_sort_threshold) {
+    radix_small_sort(data, n, key);
+    return {};
+  }
+
+  using bits_t = decltype(radix_bits_of(key, *data));
+  constexpr std::size_t passes = sizeof(bits_t);
+
+  RELOCO_TRY_ASSIGN(auto scratch, radix_scratch<T>::try_allocate(alloc, n));
+
+  // One read computes the histograms of every pass
+  std::size_t counts[passes][radix_buckets] = {};
+  for (std::size_t i = 0; i < n; ++i) {
+    const bits_t bits = radix_bits_of(key, data[i]);
+    for (std::size_t p = 0; p < passes; ++p)
+      ++counts[p][(bits >> (8 * p)) & 0xff];
+  }
+
+  T *src = data;
+  T *dst = scratch.get();
+  for (std::size_t p = 0; p < passes; ++p) {
+    std::size_t *offsets = counts[p];
+    if (!radix_offsets(offsets, n))
+      continue;
+    for (std::size_t i = 0; i < n; ++i) {
+      const std::size_t digit = (radix_bits_of(key, src[i]) >> (8 * p)) & 0xff;
+      relocate_one(dst + offsets[digit]++, src + i);
+    }
+    std::swap(src, dst);
+  }
+
+  if (src != data)
+    std::memcpy(static_cast<void *>(data), static_cast<const void *>(src),
+                n * sizeof(T));
+  return {};
+}
+
+/**
+ * Runs ``body(0) ... body(chunks - 1)`` on the pool and the calling thread,
+ * returning once all have finished. Chunks the pool cannot take run inline.
+ */
+template <typename Body>
+void run_chunks(thread_pool &pool, std::size_t chunks, Body &body) noexcept {
+  latch done(static_cast<std::uint32_t>(chunks - 1));
+  for (std::size_t c = 1; c < chunks; ++c) {
+    auto task = [&body, &done, c] {
+      body(c);
+      std::ignore = done.count_down();
+    };
+    if (!pool.try_submit(task))
+      task();
+  }
+  body(0);
+  std::ignore = done.wait();
+}
+
+template <typename T, typename KeyFn>
+result<void> parallel_lsd_radix_sort(thread_pool &pool, T *data,
+                                     std::size_t n, KeyFn &key,
+                                     fallible_allocator &alloc) noexcept {
+  // Chunks below this size do not repay the synchronization per pass
+  constexpr std::size_t min_chunk = std::size_t{1} << 15;
+  constexpr std::size_t max_chunks = 64;
+  const std::size_t chunks =
+      std::min({pool.thread_count() + 1, n / min_chunk, max_chunks});
+  if (chunks < 2)
+    return lsd_radix_sort(data, n, key, alloc);
+
+  using bits_t = decltype(radix_bits_of(key, *data));
+  constexpr std::size_t passes = sizeof(bits_t);
+
+  RELOCO_TRY_ASSIGN(auto scratch, radix_scratch<T>::try_allocate(alloc, n));
+  RELOCO_TRY_ASSIGN(auto histograms,
+                    radix_scratch<std::size_t>::try_allocate(
+                        alloc, chunks * radix_buckets));
+
+  T *src = data;
+  T *dst = scratch.get();
+  std::size_t *hist = histograms.get();
+  const std::size_t chunk_size = (n + chunks - 1) / chunks;
+  std::size_t shift = 0;
+
+  auto count_chunk = [&](std::size_t c) noexcept {
+    std::size_t *counts = hist + c * radix_buckets;
+    std::fill_n(counts, radix_buckets, std::size_t{0});
+    const std::size_t end = std::min(n, (c + 1) * chunk_size);
+    for (std::size_t i = c * chunk_size; i < end; ++i)
+      ++counts[(radix_bits_of(key, src[i]) >> shift) & 0xff];
+  };
+  auto scatter_chunk = [&](std::size_t c) noexcept {
+    std::size_t *offsets = hist + c * radix_buckets;
+    const std::size_t end = std::min(n, (c + 1) * chunk_size);
+    for (std::size_t i = c * chunk_size; i < end; ++i) {
+      const std::size_t digit = (radix_bits_of(key, src[i]) >> shift) & 0xff;
+      relocate_one(dst + offsets[digit]++, src + i);
+    }
+  };
+
+  for (std::size_t p = 0; p < passes; ++p) {
+    shift = 8 * p;
+    run_chunks(pool, chunks, count_chunk);
+
+    // Chunk c writes bucket b after the same bucket of chunks [0, c)
+    std::size_t running = 0;
+    bool skip = false;
+    for (std::size_t b = 0; b < radix_buckets && !skip; ++b) {
+      std::size_t bucket_total = 0;
+      for (std::size_t c = 0; c < chunks; ++c) {
+        const std::size_t count = hist[c * radix_buckets + b];
+        hist[c * radix_buckets + b] = running + bucket_total;
+        bucket_total += count;
+      }
+      skip = bucket_total == n;
+      running += bucket_total;
+    }
+    if (skip)
+      continue;
+
+    run_chunks(pool, chunks, scatter_chunk);
+    std::swap(src, dst);
+  }
+
+  if (src != data)
+    std::memcpy(static_cast<void *>(data), static_cast<const void *>(src),
+                n * sizeof(T));
+  return {};
+}
+
+struct msd_frame {
+  std::size_t begin;
+  std::size_t end;
+  std::size_t depth;
+};
+
+// Bucket 0 holds strings that end at ``depth``, byte b goes to bucket b + 1
+inline std::size_t msd_digit(std::string_view key, std::size_t depth) noexcept {
+  return depth < key.size()
+             ? std::size_t{1} + static_cast<unsigned char>(key[depth])
+             : 0;
+}
+
+template <typename T, typename KeyFn>
+result<void> msd_radix_sort(T *data, std::size_t n, KeyFn &key,
+                            fallible_allocator &alloc) noexcept {
+  constexpr std::size_t buckets = radix_buckets + 1;
+  auto key_of = [&](const T &value) noexcept {
+    return std::string_view(std::invoke(key, value));
+  };
+  auto suffix_less = [&](std::size_t depth) noexcept {
+    return [&key_of, depth](const T &a, const T &b) noexcept {
+      const std::string_view ka = key_of(a);
+      const std::string_view kb = key_of(b);
+      return std::string_view(ka.data() + depth, ka.size() - depth) <
+             std::string_view(kb.data() + depth, kb.size() - depth);
+    };
+  };
+
+  // Explicit work list: recursion depth would follow the longest prefix
+  vector<msd_frame> work(alloc);
+  RELOCO_TRY(work.try_push_back(msd_frame{0, n, 0}));
+
+  while (!work.empty()) {
+    const msd_frame frame = work.unsafe_at(work.size() - 1);
+    std::ignore = work.try_pop_back();
+
+    T *first = data + frame.begin;
+    const std::size_t count = frame.end - frame.begin;
+    if (count < radix_small_sort_threshold) {
+      insertion_sort(first, count, suffix_less(frame.depth));
+      continue;
+    }
+
+    std::size_t counts[buckets] = {};
+    for (std::size_t i = 0; i < count; ++i)
+      ++counts[msd_digit(key_of(first[i]), frame.depth)];
+
+    std::size_t heads[buckets];
+    std::size_t ends[buckets];
+    std::size_t running = 0;
+    for (std::size_t b = 0; b < buckets; ++b) {
+      heads[b] = running;
+      running += counts[b];
+      ends[b] = running;
+    }
+
+    // American flag permutation: swap each element into its bucket
+    for (std::size_t b = 0; b < buckets; ++b) {
+      while (heads[b] < ends[b]) {
+        const std::size_t digit =
+            msd_digit(key_of(first[heads[b]]), frame.depth);
+        if (digit == b) {
+          ++heads[b];
+        } else {
+          using std::swap;
+          swap(first[heads[b]], first[heads[digit]++]);
+        }
+      }
+    }
+
+    for (std::size_t b = 1; b < buckets; ++b) {
+      if (counts[b] > 1)
+        RELOCO_TRY(work.try_push_back(msd_frame{
+            frame.begin + ends[b] - counts[b], frame.begin + ends[b],
+            frame.depth + 1}));
+    }
+  }
+  return {};
+}
+
+template <typename T> T *data_or_null(span<T> s) noexcept {
+  return s.empty() ? nullptr : s.unsafe_data();
+}
+
+} // namespace detail
+
+/**
+ * @brief Stable LSD radix sort by ``key(element)``, ascending.
+ * Makes one pass per key byte, skipping bytes all keys share, and moves
+ * elements bitwise through one scratch buffer of ``data.size()`` elements
+ * taken from ``alloc``. Signed keys and floats sort numerically; -0.0 sorts
+ * before +0.0, NaNs with the sign bit first and the others last.
+ * @return The allocation error, with ``data`` untouched.
+ */
+template <typename T, typename KeyFn = std::identity>
+  requires radix_sortable<T, KeyFn>
+result<void>
+try_radix_sort(span<T> data, KeyFn key = {},
+               fallible_allocator &alloc = get_default_allocator()) noexcept {
+  return detail::lsd_radix_sort(detail::data_or_null(data), data.size(), key,
+                                alloc);
+}
+
+template <typename T, typename KeyFn = std::identity>
+  requires radix_sortable<T, KeyFn>
+result<void>
+try_radix_sort(vector<T> &data, KeyFn key = {},
+               fallible_allocator &alloc = get_default_allocator()) noexcept {
+  return try_radix_sort(span<T>(data.begin(), data.size()), key, alloc);
+}
+
+/**
+ * @brief try_radix_sort() with every pass split across the pool's workers
+ * and the calling thread; each chunk counts, then scatters, its own range.
+ * Inputs too small to split, or a pool without workers, sort on the calling
+ * thread. Chunks the pool fails to queue run inline, so only the scratch
+ * allocations can fail. Must not be called from one of the pool's tasks.
+ */
+template <typename T, typename KeyFn = std::identity>
+  requires radix_sortable<T, KeyFn>
+result<void> try_parallel_radix_sort(
+    thread_pool &pool, span<T> data, KeyFn key = {},
+    fallible_allocator &alloc = get_default_allocator()) noexcept {
+  return detail::parallel_lsd_radix_sort(pool, detail::data_or_null(data),
+                                         data.size(), key, alloc);
+}
+
+template <typename T, typename KeyFn = std::identity>
+  requires radix_sortable<T, KeyFn>
+result<void> try_parallel_radix_sort(
+    thread_pool &pool, vector<T> &data, KeyFn key = {},
+    fallible_allocator &alloc = get_default_allocator()) noexcept {
+  return try_parallel_radix_sort(pool, span<T>(data.begin(), data.size()),
+                                 key, alloc);
+}
+
+/**
+ * @brief In-place MSD (American flag) radix sort by the bytes of
+ * ``key(element)``, lexicographically like ``std::string_view::compare``.
+ * Not stable. Only the list of pending buckets is allocated from ``alloc``.
+ * @return The allocation error; ``data`` is then a partially sorted
+ * permutation of its input.
+ */
+template <typename T, typename KeyFn = std::identity>
+  requires string_sortable<T, KeyFn>
+result<void> try_msd_radix_sort(
+    span<T> data, KeyFn key = {},
+    fallible_allocator &alloc = get_default_allocator()) noexcept {
+  return detail::msd_radix_sort(detail::data_or_null(data), data.size(), key,
+                                alloc);
+}
+
+template <typename T, typename KeyFn = std::identity>
+  requires string_sortable<T, KeyFn>
+result<void> try_msd_radix_sort(
+    vector<T> &data, KeyFn key = {},
+    fallible_allocator &alloc = get_default_allocator()) noexcept {
+  return try_msd_radix_sort(span<T>(data.begin(), data.size()), key, alloc);
+}
+
+} // namespace reloco
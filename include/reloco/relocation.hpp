@@ -0,0 +1,207 @@
+#pragma once
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <reloco/assert.hpp>
+#include <reloco/core.hpp>
+#include <type_traits>
+#include <utility>
+
+namespace reloco {
+
+namespace detail {
+
+// Stands in for any field when probing how many initializers T accepts
+template <typename T> struct any_field {
+  template <typename U>
+    requires(!std::is_same_v<std::remove_cvref_t<U>, T>)
+  operator U() const noexcept;
+};
+
+template <typename T, typename Indices> struct brace_initializable;
+
+template <typename T, std::size_t... I>
+struct brace_initializable<T, std::index_sequence<I...>>
+    : std::bool_constant<requires { T{(void(I), any_field<T>{})...}; }> {};
+
+inline constexpr std::size_t max_reflected_fields = 16;
+
+// Searches downwards: fields without a default constructor make every
+// shorter initializer list ill-formed
+template <typename T, std::size_t N = max_reflected_fields>
+consteval std::size_t aggregate_field_count() noexcept {
+  if constexpr (N == 0 ||
+                brace_initializable<T, std::make_index_sequence<N>>::value)
+    return N;
+  else
+    return aggregate_field_count<T, N - 1>();
+}
+
+template <typename... Fields>
+constexpr auto all_relocatable(const Fields &...) noexcept
+    -> std::conjunction<is_relocatable<std::remove_cv_t<Fields>>...> {
+  return {};
+}
+
+// Only named in decltype, the body merely yields the field types
+template <typename T> constexpr auto members_relocatable_of(T &value) noexcept {
+  constexpr std::size_t N = aggregate_field_count<T>();
+  if constexpr (N == 0) {
+    return std::true_type{};
+  } else if constexpr (N == 1) {
+    auto &[a] = value;
+    return all_relocatable(a);
+  } else if constexpr (N == 2) {
+    auto &[a, b] = value;
+    return all_relocatable(a, b);
+  } else if constexpr (N == 3) {
+    auto &[a, b, c] = value;
+    return all_relocatable(a, b, c);
+  } else if constexpr (N == 4) {
+    auto &[a, b, c, d] = value;
+    return all_relocatable(a, b, c, d);
+  } else if constexpr (N == 5) {
+    auto &[a, b, c, d, e] = value;
+    return all_relocatable(a, b, c, d, e);
+  } else if constexpr (N == 6) {
+    auto &[a, b, c, d, e, f] = value;
+    return all_relocatable(a, b, c, d, e, f);
+  } else if constexpr (N == 7) {
+    auto &[a, b, c, d, e, f, g] = value;
+    return all_relocatable(a, b, c, d, e, f, g);
+  } else if constexpr (N == 8) {
+    auto &[a, b, c, d, e, f, g, h] = value;
+    return all_relocatable(a, b, c, d, e, f, g, h);
+  } else if constexpr (N == 9) {
+    auto &[a, b, c, d, e, f, g, h, i] = value;
+    return all_relocatable(a, b, c, d, e, f, g, h, i);
+  } else if constexpr (N == 10) {
+    auto &[a, b, c, d, e, f, g, h, i, j] = value;
+    return all_relocatable(a, b, c, d, e, f, g, h, i, j);
+  } else if constexpr (N == 11) {
+    auto &[a, b, c, d, e, f, g, h, i, j, k] = value;
+    return all_relocatable(a, b, c, d, e, f, g, h, i, j, k);
+  } else if constexpr (N == 12) {
+    auto &[a, b, c, d, e, f, g, h, i, j, k, l] = value;
+    return all_relocatable(a, b, c, d, e, f, g, h, i, j, k, l);
+  } else if constexpr (N == 13) {
+    auto &[a, b, c, d, e, f, g, h, i, j, k, l, m] = value;
+    return all_relocatable(a, b, c, d, e, f, g, h, i, j, k, l, m);
+  } else if constexpr (N == 14) {
+    auto &[a, b, c, d, e, f, g, h, i, j, k, l, m, n] = value;
+    return all_relocatable(a, b, c, d, e, f, g, h, i, j, k, l, m, n);
+  } else if constexpr (N == 15) {
+    auto &[a, b, c, d, e, f, g, h, i, j, k, l, m, n, o] = value;
+    return all_relocatable(a, b, c, d, e, f, g, h, i, j, k, l, m, n, o);
+  } else if constexpr (N == 16) {
+    auto &[a, b, c, d, e, f, g, h, i, j, k, l, m, n, o, p] = value;
+    return all_relocatable(a, b, c, d, e, f, g, h, i, j, k, l, m, n, o, p);
+  }
+}
+
+} // namespace detail
+
+/**
+ * @brief True when every field of the aggregate ``T`` is relocatable.
+ * Fields are discovered by aggregate reflection, which supports up to
+ * ``detail::max_reflected_fields`` fields and neither base classes nor C array
+ * members. Use it to specialize is_relocatable, or through
+ * RELOCO_RELOCATABLE_AGGREGATE.
+ */
+template <typename T>
+struct members_relocatable
+    : decltype(detail::members_relocatable_of(std::declval<T &>())) {
+  static_assert(std::is_aggregate_v<T>,
+                "members_relocatable requires an aggregate type");
+};
+
+/**
+ * @brief A pair holds no pointers into itself, so it relocates whenever both
+ * members do.
+ */
+template <typename A, typename B>
+struct is_relocatable<std::pair<A, B>>
+    : std::conjunction<is_relocatable<A>, is_relocatable<B>> {};
+
+/**
+ * @brief Relocates ``[first, last)`` into the uninitialized storage at
+ * ``dest``; afterwards the source holds no objects. The ranges must not
+ * overlap.
+ * @return One past the last relocated element at the destination.
+ */
+template <typename T>
+T *uninitialized_relocate(T *first, T *last, T *dest) noexcept {
+  const std::size_t count = static_cast<std::size_t>(last - first);
+  RELOCO_DEBUG_ASSERT(dest + count <= first || last <= dest,
+                      "uninitialized_relocate ranges overlap");
+  if constexpr (is_relocatable<T>::value) {
+    if (count != 0)
+      std::memcpy(static_cast<void *>(dest), static_cast<const void *>(first),
+                  count * sizeof(T));
+  } else {
+    for (std::size_t i = 0; i < count; ++i) {
+      ::new (static_cast<void *>(dest + i)) T(std::move(first[i]));
+      first[i].~T();
+    }
+  }
+  return dest + count;
+}
+
+/**
+ * @brief Relocates ``count`` objects from ``first`` to ``dest``, front to
+ * back. The ranges may overlap as long as ``dest`` does not lie inside the
+ * source, i.e. when shifting elements towards the front.
+ * @return One past the last relocated element at the destination.
+ */
+template <typename T>
+T *relocate_n(T *first, std::size_t count, T *dest) noexcept {
+  RELOCO_DEBUG_ASSERT(dest <= first || first + count <= dest,
+                      "relocate_n would overwrite its own source");
+  if constexpr (is_relocatable<T>::value) {
+    if (count != 0)
+      std::memmove(static_cast<void *>(dest), static_cast<const void *>(first),
+                   count * sizeof(T));
+  } else {
+    for (std::size_t i = 0; i < count; ++i) {
+      ::new (static_cast<void *>(dest + i)) T(std::move(first[i]));
+      first[i].~T();
+    }
+  }
+  return dest + count;
+}
+
+/**
+ * @brief Relocates ``[first, last)`` so that it ends at ``dest_last``, back
+ * to front. The ranges may overlap when shifting elements towards the back.
+ * @return The first relocated element at the destination.
+ */
+template <typename T>
+T *relocate_backward(T *first, T *last, T *dest_last) noexcept {
+  const std::size_t count = static_cast<std::size_t>(last - first);
+  RELOCO_DEBUG_ASSERT(last <= dest_last || dest_last <= first,
+                      "relocate_backward would overwrite its own source");
+  T *dest = dest_last - count;
+  if constexpr (is_relocatable<T>::value) {
+    if (count != 0)
+      std::memmove(static_cast<void *>(dest), static_cast<const void *>(first),
+                   count * sizeof(T));
+  } else {
+    for (std::size_t i = count; i > 0; --i) {
+      ::new (static_cast<void *>(dest + i - 1)) T(std::move(first[i - 1]));
+      first[i - 1].~T();
+    }
+  }
+  return dest;
+}
+
+} // namespace reloco
+
+/**
+ * @def RELOCO_RELOCATABLE_AGGREGATE
+ * @brief Declares the aggregate relocatable whenever all of its fields are.
+ * Must be used at global scope, after the type is complete.
+ */
+#define RELOCO_RELOCATABLE_AGGREGATE(...)                                      \
+  template <>                                                                  \
+  struct reloco::is_relocatable<__VA_ARGS__>                                   \
+      : ::reloco::members_relocatable<__VA_ARGS__> {}
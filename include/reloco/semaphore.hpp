@@ -0,0 +1,111 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <reloco/core.hpp>
+#include <reloco/error_origin.hpp>
+#include <reloco/futex.hpp>
+
+namespace reloco {
+
+/**
+ * @brief Futex-based counting semaphore.
+ * ``release()`` only enters the kernel when some thread is actually parked in
+ * ``acquire()``, and an uncontended ``acquire()`` is a single CAS.
+ */
+template <std::uint32_t LeastMaxValue = std::numeric_limits<std::uint32_t>::max()>
+class counting_semaphore {
+public:
+  static constexpr std::uint32_t max() noexcept { return LeastMaxValue; }
+
+  constexpr explicit counting_semaphore(std::uint32_t desired) noexcept
+      : m_count(desired) {
+    RELOCO_ASSERT(desired <= LeastMaxValue,
+                  "Initial semaphore count exceeds max()");
+  }
+
+  ~counting_semaphore() noexcept = default;
+
+  counting_semaphore(const counting_semaphore &) = delete;
+  counting_semaphore &operator=(const counting_semaphore &) = delete;
+
+  /**
+   * @brief Adds ``update`` to the counter and wakes up to ``update`` waiters.
+   * @return error::integer_overflow if the counter would exceed max().
+   */
+  result<void> release(std::uint32_t update = 1) & noexcept {
+    std::uint32_t current = m_count.load(std::memory_order_relaxed);
+    do {
+      if (update > LeastMaxValue - current)
+        return RELOCO_ERROR(error::integer_overflow);
+    } while (!m_count.compare_exchange_weak(current, current + update,
+                                            std::memory_order_seq_cst,
+                                            std::memory_order_relaxed));
+
+    if (m_waiters.load(std::memory_order_seq_cst) != 0) [[unlikely]] {
+      if (update == 1)
+        futex_wake_one(m_count);
+      else
+        futex_wake_all(m_count);
+    }
+    return {};
+  }
+
+  [[nodiscard]] bool try_acquire() & noexcept {
+    std::uint32_t current = m_count.load(std::memory_order_seq_cst);
+    while (current != 0) {
+      if (m_count.compare_exchange_weak(current, current - 1,
+                                        std::memory_order_acquire,
+                                        std::memory_order_relaxed))
+        return true;
+    }
+    return false;
+  }
+
+  result<void> acquire() & noexcept {
+    if (try_acquire()) [[likely]]
+      return {};
+
+    m_waiters.fetch_add(1, std::memory_order_seq_cst);
+    while (!try_acquire()) {
+      std::ignore = futex_wait(m_count, 0);
+    }
+    m_waiters.fetch_sub(1, std::memory_order_relaxed);
+    return {};
+  }
+
+  template <typename Clock, typename Duration>
+  result<void> try_acquire_until(
+      const std::chrono::time_point<Clock, Duration> &deadline) & noexcept {
+    if (try_acquire()) [[likely]]
+      return {};
+
+    m_waiters.fetch_add(1, std::memory_order_seq_cst);
+    result<void> res;
+    while (!try_acquire()) {
+      res = futex_wait_until(m_count, 0, deadline);
+      if (!res) {
+        // One last look, a release may have raced with the timeout
+        if (try_acquire())
+          res = {};
+        break;
+      }
+    }
+    m_waiters.fetch_sub(1, std::memory_order_relaxed);
+    return res;
+  }
+
+  template <typename Rep, typename Period>
+  result<void>
+  try_acquire_for(const std::chrono::duration<Rep, Period> &timeout) & noexcept {
+    return try_acquire_until(std::chrono::steady_clock::now() + timeout);
+  }
+
+private:
+  futex_word m_count;
+  std::atomic<std::uint32_t> m_waiters{0};
+};
+
+using binary_semaphore = counting_semaphore<1>;
+
+} // namespace reloco
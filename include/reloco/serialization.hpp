@@ -0,0 +1,575 @@
+#pragma once
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <reloco/array.hpp>
+#include <reloco/core.hpp>
+#include <reloco/flat_set.hpp>
+#include <reloco/span.hpp>
+#include <reloco/string.hpp>
+#include <reloco/string_view.hpp>
+#include <reloco/vector.hpp>
+#include <tuple>
+#include <type_traits>
+
+/**
+ * @file serialization.hpp
+ * @brief Binary encoding of reloco containers with zero-copy decoding.
+ *
+ * Values are written in host byte order with every field padded to its
+ * natural alignment, relative to the start of the encoding. Decoding never
+ * copies: sequences of trivially copyable elements come back as
+ * span<const T>, strings as string_view, and everything else as lazy views
+ * that decode one element at a time. All of them point into the input
+ * buffer, which must outlive them and start at an address aligned for the
+ * widest element (any allocator result is).
+ *
+ * Layout, with ``u64`` always 8-aligned:
+ * - trivially copyable T: the object bytes.
+ * - string: u64 length, then the characters.
+ * - vector, flat_set, array of trivially copyable T: u64 count, then the
+ *   elements as one block.
+ * - sequence of any other element: u64 count, u64 end offset, a table of
+ *   count u64 element offsets, then the elements.
+ * - map: its keys as a sequence, then its values as a sequence.
+ */
+
+namespace reloco {
+
+template <typename T> class list_view;
+template <typename K, typename V> class map_view;
+
+/**
+ * @brief Destination for try_serialize(), e.g. a file or socket wrapper.
+ */
+template <typename S>
+concept byte_sink = requires(S &sink, span<const std::byte> bytes) {
+  { sink.try_write(bytes) } -> std::same_as<result<void>>;
+};
+
+namespace detail {
+
+template <typename T> struct serial_sequence : std::false_type {};
+
+template <typename T> struct serial_sequence<vector<T>> : std::true_type {
+  using element = T;
+  static constexpr std::size_t extent = 0;
+  static const T *data(const vector<T> &v) noexcept { return v.begin(); }
+  static std::size_t size(const vector<T> &v) noexcept { return v.size(); }
+};
+
+template <typename T, typename C>
+struct serial_sequence<flat_set<T, C>> : std::true_type {
+  using element = T;
+  static constexpr std::size_t extent = 0;
+  static const T *data(const flat_set<T, C> &s) noexcept { return s.begin(); }
+  static std::size_t size(const flat_set<T, C> &s) noexcept {
+    return s.size();
+  }
+};
+
+template <typename T, std::size_t N>
+struct serial_sequence<array<T, N>> : std::true_type {
+  using element = T;
+  static constexpr std::size_t extent = N;
+  static const T *data(const array<T, N> &a) noexcept { return a.data_; }
+  static constexpr std::size_t size(const array<T, N> &) noexcept { return N; }
+};
+
+// Matched structurally so that this header does not pull in boost
+template <typename M>
+concept serial_map = requires(const M &m) {
+  typename M::key_type;
+  typename M::mapped_type;
+  m.begin()->key;
+  m.begin()->value;
+  { m.size() } -> std::convertible_to<std::size_t>;
+};
+
+template <typename T>
+concept serial_string = std::same_as<T, basic_string>;
+
+template <typename T>
+concept serial_trivial =
+    std::is_trivially_copyable_v<T> && !std::is_pointer_v<T> &&
+    !std::is_member_pointer_v<T> && !serial_sequence<T>::value;
+
+template <typename T> consteval bool is_serializable() {
+  if constexpr (serial_string<T> || serial_trivial<T>)
+    return true;
+  else if constexpr (serial_sequence<T>::value)
+    return is_serializable<typename serial_sequence<T>::element>();
+  else if constexpr (serial_map<T>)
+    return is_serializable<typename T::key_type>() &&
+           is_serializable<typename T::mapped_type>();
+  else
+    return false;
+}
+
+} // namespace detail
+
+/**
+ * @brief Types try_serialize() can encode: trivially copyable values, strings
+ * and vector, flat_set, array and map of serializable types.
+ */
+template <typename T>
+concept serializable = detail::is_serializable<T>();
+
+namespace detail {
+
+template <typename T> struct serial_view;
+
+template <typename T>
+using sequence_view_t =
+    std::conditional_t<serial_trivial<T>, span<const T>, list_view<T>>;
+
+template <typename T> struct serial_view {
+  using type = T;
+};
+
+template <> struct serial_view<basic_string> {
+  using type = string_view;
+};
+
+template <typename T>
+  requires serial_sequence<T>::value
+struct serial_view<T> {
+  using type = sequence_view_t<typename serial_sequence<T>::element>;
+};
+
+template <typename T>
+  requires serial_map<T>
+struct serial_view<T> {
+  using type = map_view<typename T::key_type, typename T::mapped_type>;
+};
+
+} // namespace detail
+
+/**
+ * @brief What try_deserialize<T>() returns in place of a T.
+ */
+template <serializable T>
+using serialized_view_t = typename detail::serial_view<T>::type;
+
+namespace detail {
+
+constexpr std::size_t serial_word = sizeof(std::uint64_t);
+
+constexpr std::size_t serial_align_up(std::size_t pos,
+                                      std::size_t align) noexcept {
+  return (pos + align - 1) & ~(align - 1);
+}
+
+template <typename T> constexpr std::size_t serial_alignment() noexcept {
+  if constexpr (serial_trivial<T>)
+    return alignof(T);
+  else
+    return serial_word;
+}
+
+/**
+ * @brief Sink that only advances; used to size buffers and offset tables.
+ */
+struct counting_sink {
+  static constexpr bool counting = true;
+  std::size_t pos = 0;
+
+  std::size_t position() const noexcept { return pos; }
+  result<void> try_write(const void *, std::size_t n) noexcept {
+    pos += n;
+    return {};
+  }
+};
+
+template <typename Sink> struct positioned_sink {
+  static constexpr bool counting = false;
+  Sink *sink;
+  std::size_t pos = 0;
+
+  std::size_t position() const noexcept { return pos; }
+  result<void> try_write(const void *bytes, std::size_t n) noexcept {
+    if (n == 0)
+      return {};
+    RELOCO_TRY(sink->try_write(
+        span<const std::byte>(static_cast<const std::byte *>(bytes), n)));
+    pos += n;
+    return {};
+  }
+};
+
+struct byte_vector_sink {
+  vector<std::byte> *out;
+
+  result<void> try_write(span<const std::byte> bytes) noexcept {
+    return out->try_append(bytes);
+  }
+};
+
+template <typename Sink>
+result<void> try_pad(Sink &sink, std::size_t align) noexcept {
+  static constexpr std::byte zeros[64] = {};
+  std::size_t n = serial_align_up(sink.position(), align) - sink.position();
+  while (n > 0) {
+    const std::size_t chunk = n < sizeof(zeros) ? n : sizeof(zeros);
+    RELOCO_TRY(sink.try_write(zeros, chunk));
+    n -= chunk;
+  }
+  return {};
+}
+
+template <typename Sink>
+result<void> try_write_word(Sink &sink, std::uint64_t word) noexcept {
+  RELOCO_TRY(try_pad(sink, serial_word));
+  return sink.try_write(&word, sizeof(word));
+}
+
+template <typename T, typename Sink>
+result<void> try_encode(const T &value, Sink &sink) noexcept;
+
+/**
+ * @brief Writes ``count`` elements read through ``proj`` from ``first``.
+ * Pointer ranges of trivially copyable elements go out as one block.
+ */
+template <typename T, typename It, typename Proj, typename Sink>
+result<void> try_encode_sequence(It first, std::size_t count, Proj proj,
+                                 Sink &sink) noexcept {
+  RELOCO_TRY(try_write_word(sink, count));
+
+  if constexpr (serial_trivial<T>) {
+    RELOCO_TRY(try_pad(sink, alignof(T)));
+    if constexpr (std::is_same_v<It, const T *> &&
+                  std::is_same_v<Proj, std::identity>) {
+      return sink.try_write(first, count * sizeof(T));
+    } else {
+      for (std::size_t i = 0; i < count; ++i, ++first)
+        RELOCO_TRY(sink.try_write(&proj(*first), sizeof(T)));
+      return {};
+    }
+  } else {
+    // Element offsets are found by a dry run, then the real write follows
+    const std::size_t table = sink.position() + serial_word;
+    if constexpr (Sink::counting) {
+      RELOCO_TRY(sink.try_write(nullptr, serial_word * (count + 1)));
+    } else {
+      counting_sink dry{table + serial_word * count};
+      It it = first;
+      for (std::size_t i = 0; i < count; ++i, ++it)
+        RELOCO_TRY(try_encode(proj(*it), dry));
+      RELOCO_TRY(try_write_word(sink, dry.pos));
+
+      dry.pos = table + serial_word * count;
+      it = first;
+      for (std::size_t i = 0; i < count; ++i, ++it) {
+        const std::uint64_t offset =
+            serial_align_up(dry.pos, serial_alignment<T>());
+        RELOCO_TRY(sink.try_write(&offset, sizeof(offset)));
+        RELOCO_TRY(try_encode(proj(*it), dry));
+      }
+    }
+    for (std::size_t i = 0; i < count; ++i, ++first)
+      RELOCO_TRY(try_encode(proj(*first), sink));
+    return {};
+  }
+}
+
+struct map_key_of {
+  template <typename Node> const auto &operator()(const Node &n) const {
+    return n.key;
+  }
+};
+
+struct map_value_of {
+  template <typename Node> const auto &operator()(const Node &n) const {
+    return n.value;
+  }
+};
+
+template <typename T, typename Sink>
+result<void> try_encode(const T &value, Sink &sink) noexcept {
+  if constexpr (serial_string<T>) {
+    const string_view chars = value.view();
+    RELOCO_TRY(try_write_word(sink, chars.size()));
+    if (chars.empty())
+      return {};
+    return sink.try_write(chars.data(), chars.size());
+  } else if constexpr (serial_sequence<T>::value) {
+    using traits = serial_sequence<T>;
+    return try_encode_sequence<typename traits::element>(
+        traits::data(value), traits::size(value), std::identity{}, sink);
+  } else if constexpr (serial_map<T>) {
+    RELOCO_TRY(try_encode_sequence<typename T::key_type>(
+        value.begin(), value.size(), map_key_of{}, sink));
+    return try_encode_sequence<typename T::mapped_type>(
+        value.begin(), value.size(), map_value_of{}, sink);
+  } else {
+    RELOCO_TRY(try_pad(sink, alignof(T)));
+    return sink.try_write(&value, sizeof(T));
+  }
+}
+
+/**
+ * @brief Encoded bytes being decoded; offsets are relative to ``base``.
+ */
+struct serial_input {
+  const std::byte *base;
+  std::size_t size;
+};
+
+inline result<void> try_skip_to(serial_input in, std::size_t &pos,
+                                std::size_t align) noexcept {
+  pos = serial_align_up(pos, align);
+  if (pos > in.size)
+    return RELOCO_ERROR(error::invalid_format);
+  return {};
+}
+
+inline result<std::uint64_t> try_read_word(serial_input in,
+                                           std::size_t &pos) noexcept {
+  RELOCO_TRY(try_skip_to(in, pos, serial_word));
+  if (in.size - pos < serial_word)
+    return RELOCO_ERROR(error::invalid_format);
+  std::uint64_t word;
+  std::memcpy(&word, in.base + pos, sizeof(word));
+  pos += serial_word;
+  return word;
+}
+
+template <typename T>
+result<typename serial_view<T>::type> try_decode(serial_input in,
+                                                 std::size_t &pos) noexcept;
+
+template <typename T>
+result<sequence_view_t<T>> try_decode_sequence(serial_input in,
+                                               std::size_t &pos) noexcept {
+  RELOCO_TRY_ASSIGN(const std::uint64_t count, try_read_word(in, pos));
+
+  if constexpr (serial_trivial<T>) {
+    RELOCO_TRY(try_skip_to(in, pos, alignof(T)));
+    if (count > (in.size - pos) / sizeof(T))
+      return RELOCO_ERROR(error::invalid_format);
+    const std::byte *first = in.base + pos;
+    if (count > 0 && reinterpret_cast<std::uintptr_t>(first) % alignof(T))
+      return RELOCO_ERROR(error::invalid_argument);
+    pos += count * sizeof(T);
+    return span<const T>(reinterpret_cast<const T *>(first), count);
+  } else {
+    RELOCO_TRY_ASSIGN(const std::uint64_t end, try_read_word(in, pos));
+    if (count > (in.size - pos) / serial_word)
+      return RELOCO_ERROR(error::invalid_format);
+    const std::size_t table = pos;
+    if (end < table + count * serial_word || end > in.size)
+      return RELOCO_ERROR(error::invalid_format);
+    pos = end;
+    return list_view<T>(in.base, table, count, end);
+  }
+}
+
+template <typename T>
+result<typename serial_view<T>::type> try_decode(serial_input in,
+                                                 std::size_t &pos) noexcept {
+  if constexpr (serial_string<T>) {
+    RELOCO_TRY_ASSIGN(const std::uint64_t length, try_read_word(in, pos));
+    if (length > in.size - pos)
+      return RELOCO_ERROR(error::invalid_format);
+    const char *chars = reinterpret_cast<const char *>(in.base + pos);
+    pos += length;
+    return string_view(chars, length);
+  } else if constexpr (serial_sequence<T>::value) {
+    using traits = serial_sequence<T>;
+    RELOCO_TRY_ASSIGN(auto elements,
+                      try_decode_sequence<typename traits::element>(in, pos));
+    if (traits::extent != 0 && elements.size() != traits::extent)
+      return RELOCO_ERROR(error::invalid_format);
+    return elements;
+  } else if constexpr (serial_map<T>) {
+    using K = typename T::key_type;
+    using V = typename T::mapped_type;
+    RELOCO_TRY_ASSIGN(auto keys, try_decode_sequence<K>(in, pos));
+    RELOCO_TRY_ASSIGN(auto values, try_decode_sequence<V>(in, pos));
+    if (keys.size() != values.size())
+      return RELOCO_ERROR(error::invalid_format);
+    return map_view<K, V>(keys, values);
+  } else {
+    RELOCO_TRY(try_skip_to(in, pos, alignof(T)));
+    if (in.size - pos < sizeof(T))
+      return RELOCO_ERROR(error::invalid_format);
+    T value;
+    std::memcpy(&value, in.base + pos, sizeof(T));
+    pos += sizeof(T);
+    return value;
+  }
+}
+
+template <typename T>
+result<T> try_sequence_at(span<const T> elements, std::size_t i) noexcept {
+  if (i >= elements.size())
+    return RELOCO_ERROR(error::out_of_bounds);
+  return elements.unsafe_data()[i];
+}
+
+template <typename T>
+auto try_sequence_at(const list_view<T> &elements, std::size_t i) noexcept {
+  return elements.try_at(i);
+}
+
+} // namespace detail
+
+/**
+ * @brief Decoded sequence of non-trivially-copyable elements.
+ * Elements are decoded on access; a malformed one fails only its own access.
+ */
+template <typename T> class list_view {
+  const std::byte *m_base = nullptr;
+  std::size_t m_table = 0;
+  std::size_t m_size = 0;
+  std::size_t m_end = 0;
+
+public:
+  using value_type = serialized_view_t<T>;
+
+  list_view() noexcept = default;
+  list_view(const std::byte *base, std::size_t table, std::size_t size,
+            std::size_t end) noexcept
+      : m_base(base), m_table(table), m_size(size), m_end(end) {}
+
+  std::size_t size() const noexcept { return m_size; }
+  bool empty() const noexcept { return m_size == 0; }
+
+  [[nodiscard]] result<value_type> try_at(std::size_t index) const noexcept {
+    if (index >= m_size)
+      return RELOCO_ERROR(error::out_of_bounds);
+    std::uint64_t offset;
+    std::memcpy(&offset, m_base + m_table + index * detail::serial_word,
+                sizeof(offset));
+    if (offset < m_table + m_size * detail::serial_word || offset >= m_end)
+      return RELOCO_ERROR(error::invalid_format);
+    std::size_t pos = offset;
+    return detail::try_decode<T>(detail::serial_input{m_base, m_end}, pos);
+  }
+
+  /**
+   * @brief Calls ``f`` with each element in order, stopping at the first
+   * one that fails to decode.
+   */
+  template <typename F> result<void> try_for_each(F &&f) const noexcept {
+    for (std::size_t i = 0; i < m_size; ++i) {
+      RELOCO_TRY_ASSIGN(auto element, try_at(i));
+      std::invoke(f, element);
+    }
+    return {};
+  }
+};
+
+/**
+ * @brief Decoded map: keys and values in the map's iteration order.
+ */
+template <typename K, typename V> class map_view {
+  detail::sequence_view_t<K> m_keys;
+  detail::sequence_view_t<V> m_values;
+
+public:
+  map_view() noexcept = default;
+  map_view(detail::sequence_view_t<K> keys,
+           detail::sequence_view_t<V> values) noexcept
+      : m_keys(keys), m_values(values) {}
+
+  std::size_t size() const noexcept { return m_keys.size(); }
+  bool empty() const noexcept { return m_keys.size() == 0; }
+
+  const detail::sequence_view_t<K> &keys() const noexcept { return m_keys; }
+  const detail::sequence_view_t<V> &values() const noexcept {
+    return m_values;
+  }
+
+  [[nodiscard]] result<serialized_view_t<K>>
+  try_key_at(std::size_t index) const noexcept {
+    return detail::try_sequence_at(m_keys, index);
+  }
+
+  [[nodiscard]] result<serialized_view_t<V>>
+  try_value_at(std::size_t index) const noexcept {
+    return detail::try_sequence_at(m_values, index);
+  }
+
+  /**
+   * @brief Binary search for ``key``; ``comp`` must order decoded keys the
+   * way the source map's comparator ordered them.
+   */
+  template <typename Key, typename Compare = std::less<>>
+  [[nodiscard]] result<serialized_view_t<V>>
+  try_find(const Key &key, Compare comp = {}) const noexcept {
+    std::size_t lo = 0;
+    std::size_t hi = size();
+    while (lo < hi) {
+      const std::size_t mid = lo + (hi - lo) / 2;
+      RELOCO_TRY_ASSIGN(auto candidate, try_key_at(mid));
+      if (comp(candidate, key))
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    if (lo == size())
+      return RELOCO_ERROR(error::not_found);
+    RELOCO_TRY_ASSIGN(auto found, try_key_at(lo));
+    if (comp(key, found))
+      return RELOCO_ERROR(error::not_found);
+    return try_value_at(lo);
+  }
+};
+
+/**
+ * @brief Number of bytes try_serialize() produces for ``value``.
+ */
+template <serializable T>
+[[nodiscard]] std::size_t serialized_size(const T &value) noexcept {
+  detail::counting_sink counter;
+  std::ignore = detail::try_encode(value, counter);
+  return counter.pos;
+}
+
+/**
+ * @brief Encodes ``value`` through ``sink`` in order, in as few writes as the
+ * layout allows.
+ */
+template <serializable T, byte_sink Sink>
+[[nodiscard]] result<void> try_serialize(const T &value, Sink &sink) noexcept {
+  detail::positioned_sink<Sink> positioned{&sink};
+  return detail::try_encode(value, positioned);
+}
+
+/**
+ * @brief Appends the encoding of ``value`` to ``out``, growing it once.
+ * Offsets are relative to where the encoding starts, so the bytes appended
+ * can be handed to try_deserialize() on their own.
+ */
+template <serializable T>
+[[nodiscard]] result<void> try_serialize(const T &value,
+                                         vector<std::byte> &out) noexcept {
+  const std::size_t needed = serialized_size(value);
+  if (needed > SIZE_MAX - out.size())
+    return RELOCO_ERROR(error::integer_overflow);
+  RELOCO_TRY(out.try_reserve(out.size() + needed));
+  detail::byte_vector_sink sink{&out};
+  return try_serialize(value, sink);
+}
+
+/**
+ * @brief Decodes a T written by try_serialize() without copying.
+ * @return invalid_format if ``bytes`` is truncated, has trailing data or is
+ * otherwise malformed; invalid_argument if it is misaligned for an element.
+ */
+template <serializable T>
+[[nodiscard]] result<serialized_view_t<T>>
+try_deserialize(span<const std::byte> bytes) noexcept {
+  const detail::serial_input in{bytes.empty() ? nullptr : bytes.unsafe_data(),
+                                 bytes.size()};
+  std::size_t pos = 0;
+  RELOCO_TRY_ASSIGN(auto view, detail::try_decode<T>(in, pos));
+  if (pos != bytes.size())
+    return RELOCO_ERROR(error::invalid_format);
+  return view;
+}
+
+} // namespace reloco
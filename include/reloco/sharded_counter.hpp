@@ -0,0 +1,62 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <reloco/allocator.hpp>
+#include <reloco/cache_aligned.hpp>
+#include <reloco/thread_specific.hpp>
+
+namespace reloco {
+
+/**
+ * @brief Counter that many threads can bump without sharing a cache line.
+ *
+ * Every thread adds to its own slot with a relaxed load and store, there is
+ * no locked read-modify-write on the hot path. ``read()`` sums all slots,
+ * so it is linear in the number of threads that ever touched the counter
+ * and only approximate while writers are active.
+ *
+ * ``add()`` never fails: if a thread cannot get a slot of its own, its
+ * updates go to a shared atomic instead.
+ */
+class sharded_counter {
+public:
+  using value_type = std::int64_t;
+
+  explicit sharded_counter(
+      fallible_allocator &alloc = get_default_allocator()) noexcept
+      : m_shards(alloc) {}
+
+  sharded_counter(const sharded_counter &) = delete;
+  sharded_counter &operator=(const sharded_counter &) = delete;
+
+  void add(value_type n) noexcept {
+    auto shard = m_shards.try_local();
+    if (!shard) [[unlikely]] {
+      m_shared->fetch_add(n, std::memory_order_relaxed);
+      return;
+    }
+    // Only the owning thread writes its shard
+    std::atomic<value_type> &v = **shard;
+    v.store(v.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+  }
+
+  void sub(value_type n) noexcept { add(-n); }
+
+  void increment() noexcept { add(1); }
+
+  void decrement() noexcept { add(-1); }
+
+  [[nodiscard]] value_type read() const noexcept {
+    return m_shards.combine(
+        m_shared->load(std::memory_order_relaxed),
+        [](value_type sum, const std::atomic<value_type> &v) {
+          return sum + v.load(std::memory_order_relaxed);
+        });
+  }
+
+private:
+  enumerable_thread_specific<std::atomic<value_type>> m_shards;
+  cache_aligned<std::atomic<value_type>> m_shared{std::in_place, 0};
+};
+
+} // namespace reloco
@@ -1,8 +1,10 @@
 #pragma once
+#include <atomic>
 #include <reloco/allocator.hpp>
 #include <reloco/assert.hpp>
 #include <reloco/concepts.hpp>
 #include <reloco/core.hpp>
+#include <reloco/error_origin.hpp>
 #include <reloco/rvalue_safety.hpp>
 
 namespace reloco {
@@ -45,6 +47,8 @@ struct sp_control_block_no_dp : sp_control_block {
     if constexpr (!std::is_trivially_destructible_v<T>) {
       static_cast<T *>(this->ptr_)->~T();
     }
+    // The object has a block of its own, separate from this one
+    this->alloc_->deallocate(this->ptr_, sizeof(T));
   }
 
   void delete_control_block() override {
@@ -163,7 +167,7 @@ public:
 
   result<T *> try_get() const noexcept {
     if (!ptr_)
-      return unexpected(error::empty_pointer);
+      return RELOCO_ERROR(error::empty_pointer);
     return ptr_;
   }
 
@@ -296,7 +300,7 @@ public:
 
   [[nodiscard]] result<shared_ptr<T>> lock() const noexcept {
     if (!block_)
-      return unexpected(error::empty_pointer);
+      return RELOCO_ERROR(error::empty_pointer);
 
     auto count = block_->shared_count_.load(std::memory_order_relaxed);
     while (count != 0) {
@@ -306,7 +310,7 @@ public:
         return shared_ptr<T>(block_, ptr_);
       }
     }
-    return unexpected(error::pointer_expired);
+    return RELOCO_ERROR(error::pointer_expired);
   }
 
   template <typename U>
@@ -0,0 +1,546 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <reloco/config.hpp>
+#include <reloco/core.hpp>
+#include <reloco/error_origin.hpp>
+#include <reloco/span.hpp>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @def RELOCO_SIMD_X86
+ * @brief 1 when the x86 vector kernels are compiled in.
+ * Needs GCC or Clang (vector extensions and per-function ``target``
+ * attributes). Define ``RELOCO_DISABLE_SIMD`` to force the scalar loops.
+ */
+#if !defined(RELOCO_DISABLE_SIMD) &&                                           \
+    (defined(__GNUC__) || defined(__clang__)) &&                               \
+    (defined(__x86_64__) || defined(__i386__))
+#define RELOCO_SIMD_X86 1
+#else
+#define RELOCO_SIMD_X86 0
+#endif
+
+namespace reloco::simd {
+
+/**
+ * @brief Instruction set levels the kernels are built for, ordered by width.
+ */
+enum class isa : int { scalar = 0, sse2, avx2, avx512 };
+
+/**
+ * @brief Element types the kernels accept.
+ */
+template <typename T>
+concept element = (std::integral<T> && !std::same_as<T, bool>) ||
+                  std::same_as<T, float> || std::same_as<T, double>;
+
+inline constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+namespace detail {
+
+// Integers accumulate in unsigned lanes so sums wrap instead of overflowing
+template <typename T> struct accumulator {
+  using type = T;
+};
+
+template <std::integral T> struct accumulator<T> {
+  using type = std::make_unsigned_t<T>;
+};
+
+template <typename T> using accumulator_t = typename accumulator<T>::type;
+
+template <std::size_t Bytes> struct unsigned_of_size;
+template <> struct unsigned_of_size<1> {
+  using type = std::uint8_t;
+};
+template <> struct unsigned_of_size<2> {
+  using type = std::uint16_t;
+};
+template <> struct unsigned_of_size<4> {
+  using type = std::uint32_t;
+};
+template <> struct unsigned_of_size<8> {
+  using type = std::uint64_t;
+};
+
+template <std::size_t Bytes>
+using unsigned_of_size_t = typename unsigned_of_size<Bytes>::type;
+
+struct scalar_kernels {
+  template <typename T>
+  static std::size_t find(const T *p, std::size_t n, T value) noexcept {
+    for (std::size_t i = 0; i < n; ++i)
+      if (p[i] == value)
+        return i;
+    return npos;
+  }
+
+  template <typename T>
+  static std::size_t count(const T *p, std::size_t n, T value) noexcept {
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < n; ++i)
+      total += p[i] == value;
+    return total;
+  }
+
+  template <typename T>
+  static std::pair<T, T> minmax(const T *p, std::size_t n) noexcept {
+    T lo = p[0];
+    T hi = p[0];
+    for (std::size_t i = 1; i < n; ++i) {
+      lo = p[i] < lo ? p[i] : lo;
+      hi = p[i] > hi ? p[i] : hi;
+    }
+    return {lo, hi};
+  }
+
+  template <typename T> static T sum(const T *p, std::size_t n) noexcept {
+    accumulator_t<T> acc = 0;
+    for (std::size_t i = 0; i < n; ++i)
+      acc += static_cast<accumulator_t<T>>(p[i]);
+    return static_cast<T>(acc);
+  }
+
+  template <typename T>
+  static T dot(const T *a, const T *b, std::size_t n) noexcept {
+    accumulator_t<T> acc = 0;
+    for (std::size_t i = 0; i < n; ++i)
+      acc += static_cast<accumulator_t<T>>(
+          static_cast<accumulator_t<T>>(a[i]) *
+          static_cast<accumulator_t<T>>(b[i]));
+    return static_cast<T>(acc);
+  }
+
+  template <typename T>
+  static void clamp(T *p, std::size_t n, T lo, T hi) noexcept {
+    for (std::size_t i = 0; i < n; ++i) {
+      const T v = p[i] < lo ? lo : p[i];
+      p[i] = v > hi ? hi : v;
+    }
+  }
+};
+
+#if RELOCO_SIMD_X86
+
+#define RELOCO_SIMD_INLINE __attribute__((always_inline)) inline
+
+#pragma GCC diagnostic push
+// Vectors never cross a non-inlined call, the ABI note does not apply
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+/**
+ * Kernels over W-byte vectors written with the GCC vector extensions. Every
+ * function is force-inlined into an ISA wrapper carrying the matching
+ * ``target`` attribute, which is where the actual instructions are chosen.
+ */
+template <typename T, std::size_t W> struct vector_kernels {
+  using acc_t = accumulator_t<T>;
+  // Unaligned and aliasing, like the intrinsics headers' __m256i_u
+  typedef T vec
+      __attribute__((vector_size(W), aligned(alignof(T)), may_alias));
+  typedef acc_t acc_vec __attribute__((vector_size(W)));
+  using mask = decltype(vec{} == vec{});
+  // Comparisons yield all-ones lanes of the element's width
+  using mask_lane = unsigned_of_size_t<sizeof(T)>;
+  typedef mask_lane counter __attribute__((vector_size(W)));
+
+  static constexpr std::size_t lanes = W / sizeof(T);
+
+  // Vectors only travel by reference: passing them by value across a
+  // default-target function would change the ABI
+  RELOCO_SIMD_INLINE static const vec &load(const T *p) noexcept {
+    return *reinterpret_cast<const vec *>(p);
+  }
+
+  RELOCO_SIMD_INLINE static vec &at(T *p) noexcept {
+    return *reinterpret_cast<vec *>(p);
+  }
+
+  RELOCO_SIMD_INLINE static bool any(const mask &m) noexcept {
+    std::uint64_t words[W / sizeof(std::uint64_t)];
+    std::memcpy(words, &m, W);
+    std::uint64_t bits = 0;
+    for (std::uint64_t word : words)
+      bits |= word;
+    return bits != 0;
+  }
+
+  template <typename Lane, typename V>
+  RELOCO_SIMD_INLINE static Lane reduce_add(const V &v) noexcept {
+    Lane total = 0;
+    for (std::size_t j = 0; j < lanes; ++j)
+      total += v[j];
+    return total;
+  }
+
+  RELOCO_SIMD_INLINE static std::size_t find(const T *p, std::size_t n,
+                                             T value) noexcept {
+    const vec needle = vec{} + value;
+    std::size_t i = 0;
+    // Four vectors per test keeps the branch off the critical path
+    for (; i + 4 * lanes <= n; i += 4 * lanes) {
+      const mask m = (load(p + i) == needle) |
+                     (load(p + i + lanes) == needle) |
+                     (load(p + i + 2 * lanes) == needle) |
+                     (load(p + i + 3 * lanes) == needle);
+      if (any(m))
+        break;
+    }
+    for (; i + lanes <= n; i += lanes)
+      if (any(load(p + i) == needle))
+        break;
+    const std::size_t rest = scalar_kernels::find(p + i, n - i, value);
+    return rest == npos ? npos : i + rest;
+  }
+
+  RELOCO_SIMD_INLINE static std::size_t count(const T *p, std::size_t n,
+                                              T value) noexcept {
+    // Lanes count matches in place and are flushed before they can wrap
+    constexpr std::size_t flush_every = std::numeric_limits<mask_lane>::max();
+    const vec needle = vec{} + value;
+    std::size_t total = 0;
+    std::size_t i = 0;
+    while (i + lanes <= n) {
+      const std::size_t blocks = std::min((n - i) / lanes, flush_every);
+      counter hits = {};
+      for (std::size_t b = 0; b < blocks; ++b, i += lanes)
+        hits -= (counter)(load(p + i) == needle);
+      total += reduce_add<std::size_t>(hits);
+    }
+    return total + scalar_kernels::count(p + i, n - i, value);
+  }
+
+  RELOCO_SIMD_INLINE static std::pair<T, T> minmax(const T *p,
+                                                   std::size_t n) noexcept {
+    if (n < lanes)
+      return scalar_kernels::minmax(p, n);
+
+    vec lo = load(p);
+    vec hi = lo;
+    std::size_t i = lanes;
+    for (; i + lanes <= n; i += lanes) {
+      const vec v = load(p + i);
+      lo = v < lo ? v : lo;
+      hi = v > hi ? v : hi;
+    }
+    // The tail overlaps the last full vector instead of running scalar
+    if (i < n) {
+      const vec v = load(p + n - lanes);
+      lo = v < lo ? v : lo;
+      hi = v > hi ? v : hi;
+    }
+
+    T lanes_lo[lanes];
+    T lanes_hi[lanes];
+    std::memcpy(lanes_lo, &lo, W);
+    std::memcpy(lanes_hi, &hi, W);
+    return {scalar_kernels::minmax(lanes_lo, lanes).first,
+            scalar_kernels::minmax(lanes_hi, lanes).second};
+  }
+
+  RELOCO_SIMD_INLINE static T sum(const T *p, std::size_t n) noexcept {
+    // Independent accumulators hide the add latency
+    acc_vec acc0 = {}, acc1 = {}, acc2 = {}, acc3 = {};
+    std::size_t i = 0;
+    for (; i + 4 * lanes <= n; i += 4 * lanes) {
+      acc0 += (acc_vec)load(p + i);
+      acc1 += (acc_vec)load(p + i + lanes);
+      acc2 += (acc_vec)load(p + i + 2 * lanes);
+      acc3 += (acc_vec)load(p + i + 3 * lanes);
+    }
+    for (; i + lanes <= n; i += lanes)
+      acc0 += (acc_vec)load(p + i);
+    const acc_t total = reduce_add<acc_t>((acc0 + acc1) + (acc2 + acc3));
+    return static_cast<T>(total + static_cast<acc_t>(
+                                      scalar_kernels::sum(p + i, n - i)));
+  }
+
+  RELOCO_SIMD_INLINE static T dot(const T *a, const T *b,
+                                  std::size_t n) noexcept {
+    acc_vec acc0 = {}, acc1 = {};
+    std::size_t i = 0;
+    for (; i + 2 * lanes <= n; i += 2 * lanes) {
+      acc0 += (acc_vec)load(a + i) * (acc_vec)load(b + i);
+      acc1 += (acc_vec)load(a + i + lanes) * (acc_vec)load(b + i + lanes);
+    }
+    for (; i + lanes <= n; i += lanes)
+      acc0 += (acc_vec)load(a + i) * (acc_vec)load(b + i);
+    const acc_t total = reduce_add<acc_t>(acc0 + acc1);
+    return static_cast<T>(total + static_cast<acc_t>(scalar_kernels::dot(
+                                      a + i, b + i, n - i)));
+  }
+
+  RELOCO_SIMD_INLINE static void clamp(T *p, std::size_t n, T lo,
+                                       T hi) noexcept {
+    const vec vlo = vec{} + lo;
+    const vec vhi = vec{} + hi;
+    std::size_t i = 0;
+    for (; i + lanes <= n; i += lanes) {
+      vec &v = at(p + i);
+      v = v < vlo ? vlo : v;
+      v = v > vhi ? vhi : v;
+    }
+    scalar_kernels::clamp(p + i, n - i, lo, hi);
+  }
+};
+
+/**
+ * Defines a kernel set whose entry points are compiled for ``features`` and
+ * run the W-byte vector_kernels.
+ */
+#define RELOCO_SIMD_KERNEL_SET(name, features, width)                          \
+  struct name {                                                                \
+    template <typename T>                                                      \
+    __attribute__((target(features))) static std::size_t                       \
+    find(const T *p, std::size_t n, T value) noexcept {                        \
+      return vector_kernels<T, width>::find(p, n, value);                      \
+    }                                                                          \
+    template <typename T>                                                      \
+    __attribute__((target(features))) static std::size_t                       \
+    count(const T *p, std::size_t n, T value) noexcept {                       \
+      return vector_kernels<T, width>::count(p, n, value);                     \
+    }                                                                          \
+    template <typename T>                                                      \
+    __attribute__((target(features))) static std::pair<T, T>                   \
+    minmax(const T *p, std::size_t n) noexcept {                               \
+      return vector_kernels<T, width>::minmax(p, n);                           \
+    }                                                                          \
+    template <typename T>                                                      \
+    __attribute__((target(features))) static T sum(const T *p,                 \
+                                                 std::size_t n) noexcept {     \
+      return vector_kernels<T, width>::sum(p, n);                              \
+    }                                                                          \
+    template <typename T>                                                      \
+    __attribute__((target(features))) static T                                 \
+    dot(const T *a, const T *b, std::size_t n) noexcept {                      \
+      return vector_kernels<T, width>::dot(a, b, n);                           \
+    }                                                                          \
+    template <typename T>                                                      \
+    __attribute__((target(features))) static void                              \
+    clamp(T *p, std::size_t n, T lo, T hi) noexcept {                          \
+      vector_kernels<T, width>::clamp(p, n, lo, hi);                           \
+    }                                                                          \
+  }
+
+RELOCO_SIMD_KERNEL_SET(sse2_kernels, "sse2", 16);
+RELOCO_SIMD_KERNEL_SET(avx2_kernels, "avx2", 32);
+RELOCO_SIMD_KERNEL_SET(avx512_kernels, "avx512f,avx512bw", 64);
+
+#undef RELOCO_SIMD_KERNEL_SET
+#undef RELOCO_SIMD_INLINE
+
+#pragma GCC diagnostic pop
+
+#endif // RELOCO_SIMD_X86
+
+inline isa detect_isa() noexcept {
+#if RELOCO_SIMD_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw"))
+    return isa::avx512;
+  if (__builtin_cpu_supports("avx2"))
+    return isa::avx2;
+  if (__builtin_cpu_supports("sse2"))
+    return isa::sse2;
+#endif
+  return isa::scalar;
+}
+
+inline isa best_isa() noexcept {
+  static const isa best = detect_isa();
+  return best;
+}
+
+inline std::atomic<isa> &selected_isa() noexcept {
+  static std::atomic<isa> selected{best_isa()};
+  return selected;
+}
+
+/**
+ * Calls ``op`` with a ``std::type_identity`` of the kernel set for the
+ * selected ISA.
+ */
+template <typename Op> decltype(auto) dispatch(Op &&op) noexcept {
+  switch (selected_isa().load(std::memory_order_relaxed)) {
+#if RELOCO_SIMD_X86
+  case isa::avx512:
+    return op(std::type_identity<avx512_kernels>{});
+  case isa::avx2:
+    return op(std::type_identity<avx2_kernels>{});
+  case isa::sse2:
+    return op(std::type_identity<sse2_kernels>{});
+#endif
+  default:
+    return op(std::type_identity<scalar_kernels>{});
+  }
+}
+
+template <typename T> const T *data_or_null(span<T> s) noexcept {
+  return s.empty() ? nullptr : s.unsafe_data();
+}
+
+} // namespace detail
+
+/**
+ * @brief Widest instruction set the running CPU supports.
+ */
+[[nodiscard]] inline isa best_isa() noexcept { return detail::best_isa(); }
+
+/**
+ * @brief Instruction set the kernels currently dispatch to.
+ */
+[[nodiscard]] inline isa active_isa() noexcept {
+  return detail::selected_isa().load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Pins the kernels to ``level`` for every thread, e.g. to compare
+ * widths in benchmarks or to rule out a vector path while debugging.
+ * @return ``unsupported_operation`` if the CPU (or build) lacks ``level``.
+ */
+inline result<void> try_select_isa(isa level) noexcept {
+  if (level > detail::best_isa())
+    return RELOCO_ERROR(error::unsupported_operation);
+  detail::selected_isa().store(level, std::memory_order_relaxed);
+  return {};
+}
+
+/**
+ * @brief Index of the first element equal to ``value``, or ``npos``.
+ */
+template <typename T>
+  requires element<std::remove_cv_t<T>>
+[[nodiscard]] std::size_t find(span<T> s,
+                               std::remove_cv_t<T> value) noexcept {
+  return detail::dispatch([&]<typename K>(std::type_identity<K>) {
+    return K::find(detail::data_or_null(s), s.size(), value);
+  });
+}
+
+template <typename T>
+  requires element<std::remove_cv_t<T>>
+[[nodiscard]] bool any_of_equal(span<T> s,
+                                std::remove_cv_t<T> value) noexcept {
+  return find(s, value) != npos;
+}
+
+template <typename T>
+  requires element<std::remove_cv_t<T>>
+[[nodiscard]] std::size_t count(span<T> s,
+                                std::remove_cv_t<T> value) noexcept {
+  return detail::dispatch([&]<typename K>(std::type_identity<K>) {
+    return K::count(detail::data_or_null(s), s.size(), value);
+  });
+}
+
+/**
+ * @brief Smallest and largest element.
+ * Spans containing NaN give an unspecified (but non-NaN-ordered) answer.
+ * @return ``container_empty`` for an empty span.
+ */
+template <typename T>
+  requires element<std::remove_cv_t<T>>
+[[nodiscard]] result<std::pair<std::remove_cv_t<T>, std::remove_cv_t<T>>>
+try_minmax(span<T> s) noexcept {
+  if (s.empty())
+    return RELOCO_ERROR(error::container_empty);
+  return detail::dispatch([&]<typename K>(std::type_identity<K>) {
+    return K::minmax(detail::data_or_null(s), s.size());
+  });
+}
+
+template <typename T>
+  requires element<std::remove_cv_t<T>>
+[[nodiscard]] result<std::remove_cv_t<T>> try_min(span<T> s) noexcept {
+  RELOCO_TRY_ASSIGN(const auto bounds, try_minmax(s));
+  return bounds.first;
+}
+
+template <typename T>
+  requires element<std::remove_cv_t<T>>
+[[nodiscard]] result<std::remove_cv_t<T>> try_max(span<T> s) noexcept {
+  RELOCO_TRY_ASSIGN(const auto bounds, try_minmax(s));
+  return bounds.second;
+}
+
+/**
+ * @brief Sum of all elements, zero for an empty span.
+ * Integers wrap modulo 2^bits. Floating point lanes are added in a different
+ * order than a sequential loop would, so results may differ in the last bits.
+ */
+template <typename T>
+  requires element<std::remove_cv_t<T>>
+[[nodiscard]] std::remove_cv_t<T> sum(span<T> s) noexcept {
+  return detail::dispatch([&]<typename K>(std::type_identity<K>) {
+    return K::sum(detail::data_or_null(s), s.size());
+  });
+}
+
+/**
+ * @brief Inner product, with the same wrapping and ordering caveats as sum().
+ * @return ``invalid_argument`` if the spans differ in size.
+ */
+template <typename T, typename U>
+  requires element<std::remove_cv_t<T>> &&
+           std::same_as<std::remove_cv_t<T>, std::remove_cv_t<U>>
+[[nodiscard]] result<std::remove_cv_t<T>> try_dot(span<T> a,
+                                                  span<U> b) noexcept {
+  if (a.size() != b.size())
+    return RELOCO_ERROR(error::invalid_argument);
+  return detail::dispatch([&]<typename K>(std::type_identity<K>) {
+    return K::dot(detail::data_or_null(a), detail::data_or_null(b), a.size());
+  });
+}
+
+/**
+ * @brief Clamps every element into ``[lo, hi]`` in place.
+ * @return ``invalid_argument`` if ``lo > hi``.
+ */
+template <element T>
+result<void> try_clamp(span<T> s, T lo, T hi) noexcept {
+  if (hi < lo)
+    return RELOCO_ERROR(error::invalid_argument);
+  detail::dispatch([&]<typename K>(std::type_identity<K>) {
+    if (!s.empty())
+      K::clamp(s.unsafe_data(), s.size(), lo, hi);
+  });
+  return {};
+}
+
+/**
+ * @brief ``out[i] = source[indices[i]]``.
+ * Indices are validated with one vectorized max() pass, the loads themselves
+ * stay scalar: hardware gathers are rarely faster than independent loads.
+ * @return ``invalid_argument`` if ``out`` and ``indices`` differ in size,
+ * ``out_of_bounds`` if any index is past the end of ``source``; ``out`` is
+ * untouched on failure.
+ */
+template <typename T, typename U, typename Index>
+  requires std::same_as<std::remove_cv_t<T>, U> &&
+           std::unsigned_integral<std::remove_cv_t<Index>>
+result<void> try_gather(span<T> source, span<Index> indices,
+                        span<U> out) noexcept {
+  if (indices.size() != out.size())
+    return RELOCO_ERROR(error::invalid_argument);
+  if (indices.empty())
+    return {};
+  RELOCO_TRY_ASSIGN(const auto highest, try_max(indices));
+  if (highest >= source.size())
+    return RELOCO_ERROR(error::out_of_bounds);
+
+  const T *src = source.unsafe_data();
+  const Index *idx = indices.unsafe_data();
+  U *dst = out.unsafe_data();
+  for (std::size_t i = 0; i < out.size(); ++i)
+    dst[i] = src[idx[i]];
+  return {};
+}
+
+} // namespace reloco::simd
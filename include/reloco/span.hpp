@@ -1,6 +1,7 @@
 #pragma once
 #include <reloco/assert.hpp>
 #include <reloco/core.hpp>
+#include <reloco/error_origin.hpp>
 #include <reloco/rvalue_safety.hpp>
 #include <span>
 
@@ -44,7 +45,7 @@ public:
   [[nodiscard]] constexpr result<std::reference_wrapper<T>>
   try_at(size_type index) const & noexcept {
     if (index >= span_.size()) [[unlikely]] {
-      return unexpected(error::out_of_bounds);
+      return RELOCO_ERROR(error::out_of_bounds);
     }
     return std::ref(span_[index]);
   }
@@ -63,12 +64,12 @@ public:
   try_subspan(size_type offset,
               size_type count = std::dynamic_extent) const & noexcept {
     if (offset > span_.size())
-      return reloco::unexpected(error::out_of_bounds);
+      return RELOCO_ERROR(error::out_of_bounds);
 
     size_type actual_count =
         (count == std::dynamic_extent) ? (span_.size() - offset) : count;
     if (offset + actual_count > span_.size())
-      return reloco::unexpected(error::out_of_bounds);
+      return RELOCO_ERROR(error::out_of_bounds);
 
     return span<T>(span_.data() + offset, actual_count);
   }
@@ -104,14 +105,14 @@ public:
   [[nodiscard]] constexpr result<std::reference_wrapper<T>>
   try_front() const & noexcept {
     if (empty()) [[unlikely]]
-      return unexpected(error::out_of_bounds);
+      return RELOCO_ERROR(error::out_of_bounds);
     return std::ref(span_.front());
   }
 
   [[nodiscard]] constexpr result<std::reference_wrapper<T>>
   try_back() const & noexcept {
     if (empty()) [[unlikely]]
-      return unexpected(error::out_of_bounds);
+      return RELOCO_ERROR(error::out_of_bounds);
     return std::ref(span_.back());
   }
 
@@ -128,14 +129,14 @@ public:
   [[nodiscard]] constexpr result<span<T>>
   try_first(size_type n) const & noexcept {
     if (n > size())
-      return unexpected(error::out_of_bounds);
+      return RELOCO_ERROR(error::out_of_bounds);
     return span<T>(span_.data(), n);
   }
 
   [[nodiscard]] constexpr result<span<T>>
   try_last(size_type n) const & noexcept {
     if (n > size())
-      return unexpected(error::out_of_bounds);
+      return RELOCO_ERROR(error::out_of_bounds);
     return span<T>(span_.data() + (size() - n), n);
   }
 
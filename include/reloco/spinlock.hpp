@@ -0,0 +1,230 @@
+#pragma once
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <reloco/assert.hpp>
+#include <reloco/config.hpp>
+#include <reloco/core.hpp>
+#include <reloco/error_origin.hpp>
+#include <thread>
+
+namespace reloco {
+
+namespace detail {
+
+/**
+ * Spin-wait helper that gives the CPU away once spinning clearly is not
+ * paying off, so a preempted lock holder (or the next thread in a FIFO
+ * queue) gets to run on oversubscribed machines.
+ */
+class spin_backoff {
+public:
+  void pause(std::uint32_t weight = 1) noexcept {
+    if (m_spins < YIELD_THRESHOLD) {
+      for (std::uint32_t i = weight; i > 0; --i)
+        cpu_relax();
+      m_spins += weight;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+
+private:
+  static constexpr std::uint32_t YIELD_THRESHOLD = 1u << 14;
+  std::uint32_t m_spins = 0;
+};
+
+} // namespace detail
+
+/**
+ * @brief FIFO spinlock in 8 bytes.
+ * Waiters take a ticket and spin on the "now serving" counter, backing off
+ * proportionally to their distance from the head of the queue. All waiters
+ * still share one cache line, prefer mcs_lock when many cores contend.
+ */
+class ticket_lock {
+public:
+  constexpr ticket_lock() noexcept = default;
+
+  ticket_lock(const ticket_lock &) = delete;
+  ticket_lock &operator=(const ticket_lock &) = delete;
+
+  result<void> lock() & noexcept {
+    const std::uint32_t ticket = m_next.fetch_add(1, std::memory_order_relaxed);
+    detail::spin_backoff backoff;
+    while (true) {
+      const std::uint32_t serving = m_serving.load(std::memory_order_acquire);
+      if (serving == ticket)
+        return {};
+      backoff.pause((ticket - serving) * BACKOFF_PER_WAITER);
+    }
+  }
+
+  [[nodiscard]] bool try_lock() & noexcept {
+    std::uint32_t serving = m_serving.load(std::memory_order_relaxed);
+    return m_next.compare_exchange_strong(serving, serving + 1,
+                                          std::memory_order_acquire,
+                                          std::memory_order_relaxed);
+  }
+
+  result<void> unlock() & noexcept {
+    const std::uint32_t serving = m_serving.load(std::memory_order_relaxed);
+    if (m_next.load(std::memory_order_relaxed) == serving)
+      return RELOCO_ERROR(error::not_locked);
+    m_serving.store(serving + 1, std::memory_order_release);
+    return {};
+  }
+
+  [[nodiscard]] bool is_locked() const noexcept {
+    return m_next.load(std::memory_order_relaxed) !=
+           m_serving.load(std::memory_order_relaxed);
+  }
+
+private:
+  static constexpr std::uint32_t BACKOFF_PER_WAITER = 32;
+
+  std::atomic<std::uint32_t> m_next{0};
+  std::atomic<std::uint32_t> m_serving{0};
+};
+
+/**
+ * @brief Queue entry of an mcs_lock waiter, one cache line per waiter.
+ */
+struct alignas(cache_line_size) mcs_node {
+  std::atomic<mcs_node *> next{nullptr};
+  std::atomic<bool> locked{false};
+};
+
+namespace detail {
+
+/**
+ * Per-thread pool backing the node-less mcs_lock::lock() overload. Nesting
+ * depth is bounded by the pool size, release order is free.
+ */
+struct mcs_thread_nodes {
+  static constexpr std::uint32_t capacity = 8;
+
+  mcs_node nodes[capacity];
+  std::uint32_t used = 0;
+};
+
+inline mcs_thread_nodes &local_mcs_nodes() noexcept {
+  static thread_local mcs_thread_nodes pool;
+  return pool;
+}
+
+} // namespace detail
+
+/**
+ * @brief Mellor-Crummey/Scott queue lock.
+ * Every waiter spins on the ``locked`` flag of its own mcs_node, so a release
+ * only invalidates the cache line of the next thread in line, and ownership
+ * is handed off in FIFO order.
+ *
+ * The node-less ``lock()``/``unlock()`` overloads draw nodes from a small
+ * thread-local pool and make the lock usable with ``std::unique_lock``; the
+ * explicit-node overloads let callers keep the node on their own stack.
+ */
+class mcs_lock {
+public:
+  constexpr mcs_lock() noexcept = default;
+
+  mcs_lock(const mcs_lock &) = delete;
+  mcs_lock &operator=(const mcs_lock &) = delete;
+
+  result<void> lock(mcs_node &node) & noexcept {
+    node.next.store(nullptr, std::memory_order_relaxed);
+    node.locked.store(true, std::memory_order_relaxed);
+
+    mcs_node *pred = m_tail.exchange(&node, std::memory_order_acq_rel);
+    if (pred) {
+      pred->next.store(&node, std::memory_order_release);
+      detail::spin_backoff backoff;
+      while (node.locked.load(std::memory_order_acquire))
+        backoff.pause();
+    }
+    return {};
+  }
+
+  [[nodiscard]] bool try_lock(mcs_node &node) & noexcept {
+    node.next.store(nullptr, std::memory_order_relaxed);
+    mcs_node *expected = nullptr;
+    return m_tail.compare_exchange_strong(expected, &node,
+                                          std::memory_order_acquire,
+                                          std::memory_order_relaxed);
+  }
+
+  result<void> unlock(mcs_node &node) & noexcept {
+    mcs_node *next = node.next.load(std::memory_order_acquire);
+    if (!next) {
+      mcs_node *expected = &node;
+      if (m_tail.compare_exchange_strong(expected, nullptr,
+                                         std::memory_order_release,
+                                         std::memory_order_relaxed))
+        return {};
+      // A successor swapped itself in but has not linked yet
+      detail::spin_backoff backoff;
+      while (!(next = node.next.load(std::memory_order_acquire)))
+        backoff.pause();
+    }
+    next->locked.store(false, std::memory_order_release);
+    return {};
+  }
+
+  result<void> lock() & noexcept {
+    mcs_node *node = acquire_local_node();
+    auto res = lock(*node);
+    m_owner = node;
+    return res;
+  }
+
+  [[nodiscard]] bool try_lock() & noexcept {
+    mcs_node *node = acquire_local_node();
+    if (!try_lock(*node)) {
+      release_local_node(node);
+      return false;
+    }
+    m_owner = node;
+    return true;
+  }
+
+  result<void> unlock() & noexcept {
+    mcs_node *node = m_owner;
+    if (!node)
+      return RELOCO_ERROR(error::not_locked);
+
+    auto &pool = detail::local_mcs_nodes();
+    if (node < pool.nodes || node >= pool.nodes + pool.capacity)
+      return RELOCO_ERROR(error::invalid_owner);
+
+    m_owner = nullptr;
+    auto res = unlock(*node);
+    release_local_node(node);
+    return res;
+  }
+
+  [[nodiscard]] bool is_locked() const noexcept {
+    return m_tail.load(std::memory_order_relaxed) != nullptr;
+  }
+
+private:
+  static mcs_node *acquire_local_node() noexcept {
+    auto &pool = detail::local_mcs_nodes();
+    const auto index = static_cast<std::uint32_t>(std::countr_one(pool.used));
+    RELOCO_ASSERT(index < pool.capacity,
+                  "Too many mcs_lock instances held by one thread");
+    pool.used |= 1u << index;
+    return &pool.nodes[index];
+  }
+
+  static void release_local_node(mcs_node *node) noexcept {
+    auto &pool = detail::local_mcs_nodes();
+    pool.used &= ~(1u << static_cast<std::uint32_t>(node - pool.nodes));
+  }
+
+  std::atomic<mcs_node *> m_tail{nullptr};
+  // Only read and written by the current holder
+  mcs_node *m_owner = nullptr;
+};
+
+} // namespace reloco
@@ -1,6 +1,7 @@
 #pragma once
 #include <memory>
 #include <reloco/core.hpp>
+#include <reloco/error_origin.hpp>
 
 namespace reloco {
 
@@ -16,7 +17,7 @@ public:
     std::size_t space = capacity_ - offset_;
     void *aligned_ptr = std::align(alignment, bytes, current_ptr, space);
     if (!aligned_ptr) {
-      return unexpected(error::allocation_failed);
+      return RELOCO_ALLOC_ERROR(error::allocation_failed, *this);
     }
     offset_ = static_cast<std::byte *>(aligned_ptr) + bytes - buffer_;
     return mem_block{aligned_ptr, bytes};
@@ -39,11 +40,15 @@ public:
 
   [[nodiscard]] result<mem_block> reallocate(void *, std::size_t, std::size_t,
                                              std::size_t) noexcept override {
-    return unexpected(error::allocation_failed);
+    return RELOCO_ALLOC_ERROR(error::allocation_failed, *this);
   }
 
   void deallocate(void *, std::size_t) noexcept override {}
 
+  [[nodiscard]] bool frees_are_noops() const noexcept override { return true; }
+
+  [[nodiscard]] const char *tag() const noexcept override { return "stack"; }
+
   // Reset the whole arena
   void reset() noexcept { offset_ = 0; }
 
@@ -0,0 +1,130 @@
+#pragma once
+#include <cstdint>
+#include <reloco/core.hpp>
+#include <reloco/sharded_counter.hpp>
+
+namespace reloco {
+
+/**
+ * @brief Snapshot of a statistics_allocator's counters.
+ */
+struct allocation_statistics {
+  std::int64_t allocations = 0;
+  std::int64_t deallocations = 0;
+  std::int64_t reallocations = 0;
+  std::int64_t failures = 0;
+  // Bytes handed out and not yet returned
+  std::int64_t bytes_in_use = 0;
+  // Bytes handed out over the allocator's lifetime
+  std::int64_t bytes_allocated = 0;
+};
+
+/**
+ * @brief Forwards to an upstream allocator and counts what passes through.
+ * Counters are sharded per thread, so heavily concurrent allocation does
+ * not serialize on the statistics. Shards are allocated from the upstream
+ * allocator and do not show up in the numbers.
+ */
+class statistics_allocator final : public fallible_allocator {
+public:
+  explicit statistics_allocator(fallible_allocator &upstream) noexcept
+      : m_upstream(&upstream), m_allocations(upstream),
+        m_deallocations(upstream), m_reallocations(upstream),
+        m_failures(upstream), m_bytes_in_use(upstream),
+        m_bytes_allocated(upstream) {}
+
+  [[nodiscard]] result<mem_block>
+  allocate(std::size_t bytes, std::size_t alignment) noexcept override {
+    auto res = m_upstream->allocate(bytes, alignment);
+    if (!res) {
+      m_failures.increment();
+      return res;
+    }
+    m_allocations.increment();
+    record_growth(static_cast<std::int64_t>(res->size));
+    return res;
+  }
+
+  [[nodiscard]] result<mem_block>
+  allocate_zeroed(std::size_t bytes, std::size_t alignment) noexcept override {
+    auto res = m_upstream->allocate_zeroed(bytes, alignment);
+    if (!res) {
+      m_failures.increment();
+      return res;
+    }
+    m_allocations.increment();
+    record_growth(static_cast<std::int64_t>(res->size));
+    return res;
+  }
+
+  [[nodiscard]] result<std::size_t>
+  expand_in_place(void *ptr, std::size_t old_size,
+                  std::size_t new_size) noexcept override {
+    auto res = m_upstream->expand_in_place(ptr, old_size, new_size);
+    if (res)
+      record_resize(old_size, *res);
+    return res;
+  }
+
+  [[nodiscard]] result<mem_block>
+  reallocate(void *ptr, std::size_t old_size, std::size_t new_size,
+             std::size_t alignment) noexcept override {
+    auto res = m_upstream->reallocate(ptr, old_size, new_size, alignment);
+    if (!res) {
+      m_failures.increment();
+      return res;
+    }
+    m_reallocations.increment();
+    record_resize(old_size, res->size);
+    return res;
+  }
+
+  void deallocate(void *ptr, std::size_t bytes) noexcept override {
+    m_upstream->deallocate(ptr, bytes);
+    m_deallocations.increment();
+    m_bytes_in_use.sub(static_cast<std::int64_t>(bytes));
+  }
+
+  void advise(void *ptr, std::size_t bytes, usage_hint hint) noexcept override {
+    m_upstream->advise(ptr, bytes, hint);
+  }
+
+  [[nodiscard]] const char *tag() const noexcept override {
+    return m_upstream->tag();
+  }
+
+  [[nodiscard]] allocation_statistics statistics() const noexcept {
+    allocation_statistics s;
+    s.allocations = m_allocations.read();
+    s.deallocations = m_deallocations.read();
+    s.reallocations = m_reallocations.read();
+    s.failures = m_failures.read();
+    s.bytes_in_use = m_bytes_in_use.read();
+    s.bytes_allocated = m_bytes_allocated.read();
+    return s;
+  }
+
+private:
+  void record_growth(std::int64_t bytes) noexcept {
+    m_bytes_in_use.add(bytes);
+    m_bytes_allocated.add(bytes);
+  }
+
+  void record_resize(std::size_t old_size, std::size_t new_size) noexcept {
+    const auto delta = static_cast<std::int64_t>(new_size) -
+                       static_cast<std::int64_t>(old_size);
+    m_bytes_in_use.add(delta);
+    if (delta > 0)
+      m_bytes_allocated.add(delta);
+  }
+
+  fallible_allocator *m_upstream;
+  sharded_counter m_allocations;
+  sharded_counter m_deallocations;
+  sharded_counter m_reallocations;
+  sharded_counter m_failures;
+  sharded_counter m_bytes_in_use;
+  sharded_counter m_bytes_allocated;
+};
+
+} // namespace reloco
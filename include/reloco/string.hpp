@@ -10,6 +10,7 @@
 #include <iterator>
 #include <reloco/allocator.hpp>
 #include <reloco/concepts.hpp>
+#include <reloco/error_origin.hpp>
 #include <reloco/rvalue_safety.hpp>
 #include <reloco/string_view.hpp>
 
@@ -62,38 +63,27 @@ public:
   }
 
   result<void> try_construct(basic_string *storage, const char *s) noexcept {
-    if (s) {
-      auto res = storage->try_append(s);
-      if (!res)
-        return unexpected(res.error());
-    }
+    if (s)
+      RELOCO_TRY(storage->try_append(s));
     return {};
   }
 
   result<void> try_construct(basic_string *storage, string_view sv) noexcept {
-    auto res = storage->try_append(sv);
-    if (!res)
-      return unexpected(res.error());
+    RELOCO_TRY(storage->try_append(sv));
     return {};
   }
 
   static result<basic_string> try_create(const char *s) noexcept {
     basic_string str;
-    if (s) {
-      auto res = str.try_append(s);
-      if (!res)
-        return unexpected(res.error());
-    }
+    if (s)
+      RELOCO_TRY(str.try_append(s));
     return str;
   }
 
   static result<basic_string> try_create(string_view sv) noexcept {
     basic_string str;
-    if (!sv.empty()) {
-      auto res = str.try_append(sv);
-      if (!res)
-        return unexpected(res.error());
-    }
+    if (!sv.empty())
+      RELOCO_TRY(str.try_append(sv));
     return str;
   }
 
@@ -103,7 +93,7 @@ public:
     new (storage) basic_string(alloc);
     if (!source.empty()) {
       auto res = storage->try_assign(source.view());
-      if (!res) {
+      if (!res) [[unlikely]] {
         storage->~basic_string();
         return unexpected(res.error());
       }
@@ -115,11 +105,8 @@ public:
   try_clone(fallible_allocator &clone_alloc) const noexcept {
     basic_string clone(clone_alloc);
 
-    if (size_ > 0) {
-      auto res = clone.try_assign(this->view());
-      if (!res)
-        return unexpected(res.error());
-    }
+    if (size_ > 0)
+      RELOCO_TRY(clone.try_assign(this->view()));
 
     return clone;
   }
@@ -143,12 +130,14 @@ public:
       }
     }
 
-    // Bitwise Reallocate (Strings are always relocatable)
-    auto old_ptr = (cap_ == 0) ? nullptr : data_;
-    auto res =
-        alloc_->reallocate(old_ptr, cap_ + 1, required_bytes, alignof(char));
+    // Bitwise Reallocate (Strings are always relocatable); the first block
+    // has nothing to carry over
+    auto res = cap_ == 0
+                   ? alloc_->allocate(required_bytes, alignof(char))
+                   : alloc_->reallocate(data_, cap_ + 1, required_bytes,
+                                        alignof(char));
     if (!res)
-      return unexpected(error::allocation_failed);
+      return RELOCO_ALLOC_ERROR(error::allocation_failed, *alloc_);
 
     data_ = static_cast<char *>(res->ptr);
     cap_ = new_cap;
@@ -166,9 +155,7 @@ public:
     if (new_size > cap_) {
       // Standard geometric growth or exact size if huge
       std::size_t growth = std::max(cap_ * 2, new_size);
-      auto res = try_reserve(growth);
-      if (!res)
-        return res;
+      RELOCO_TRY(try_reserve(growth));
     }
 
     // Copy the data (sv.data() might not be null-terminated, which is fine)
@@ -277,7 +264,7 @@ public:
     // Use reallocate to potentially release memory back to OS
     auto res = alloc_->reallocate(data_, cap_ + 1, size_ + 1, alignof(char));
     if (!res)
-      return unexpected(error::allocation_failed);
+      return RELOCO_ALLOC_ERROR(error::allocation_failed, *alloc_);
 
     data_ = static_cast<char *>(res->ptr);
     cap_ = size_;
@@ -323,9 +310,7 @@ public:
 
   [[nodiscard]] static result<basic_string> from_view(string_view sv) noexcept {
     basic_string str;
-    auto res = str.try_reserve(sv.size());
-    if (!res)
-      return unexpected(res.error());
+    RELOCO_TRY(str.try_reserve(sv.size()));
 
     std::memcpy(str.data_, sv.data(), sv.size());
     str.size_ = sv.size();
@@ -345,7 +330,7 @@ public:
 
     if (needed < 0) {
       va_end(args);
-      return unexpected(error::unsupported_operation);
+      return RELOCO_ERROR(error::unsupported_operation);
     }
 
     std::size_t len = static_cast<std::size_t>(needed);
@@ -377,7 +362,7 @@ public:
 
   [[nodiscard]] result<void> try_pop_back() & noexcept {
     if (size_ == 0) {
-      return unexpected(error::out_of_range);
+      return RELOCO_ERROR(error::out_of_range);
     }
     --size_;
     data_[size_] = '\0';
@@ -393,9 +378,7 @@ public:
       return {};
     }
 
-    auto res = try_reserve(count);
-    if (!res)
-      return res;
+    RELOCO_TRY(try_reserve(count));
 
     std::memset(data_ + size_, ch, count - size_);
     size_ = count;
@@ -409,15 +392,13 @@ public:
       return {};
 
     if (pos > size_)
-      return unexpected(error::out_of_range);
+      return RELOCO_ERROR(error::out_of_range);
 
     if (sv.empty())
       return {};
 
     const size_type len = sv.size();
-    auto res = try_reserve(size_ + len);
-    if (!res)
-      return res;
+    RELOCO_TRY(try_reserve(size_ + len));
 
     // Move existing data to the right
     std::memmove(data_ + pos + len, data_ + pos, size_ - pos);
@@ -448,7 +429,7 @@ public:
   [[nodiscard]] result<void> try_erase(size_type pos = 0,
                                        size_type count = npos) & noexcept {
     if (pos > size_) {
-      return unexpected(error::out_of_range);
+      return RELOCO_ERROR(error::out_of_range);
     }
 
     size_type actual_count = std::min(count, size_ - pos);
@@ -479,7 +460,7 @@ public:
 
     auto res = alloc_->allocate(sv.size() + 1, alignof(char));
     if (!res)
-      return unexpected(error::allocation_failed);
+      return RELOCO_ALLOC_ERROR(error::allocation_failed, *alloc_);
 
     if (cap_ > 0 && data_ != &empty_char) {
       alloc_->deallocate(data_, cap_ + 1);
@@ -1,6 +1,7 @@
 #pragma once
 #include <reloco/assert.hpp>
 #include <reloco/core.hpp>
+#include <reloco/error_origin.hpp>
 #include <reloco/rvalue_safety.hpp>
 #include <string_view>
 
@@ -18,8 +19,9 @@ struct basic_string_view : std::basic_string_view<CharT, TraitsT> {
 
   RELOCO_BLOCK_RVALUE_ACCESS(CharT);
 
-  constexpr basic_string_view(const basic_string_view &rhs) noexcept
-      : std::basic_string_view<CharT, TraitsT>(rhs) {}
+  constexpr basic_string_view(const basic_string_view &rhs) noexcept = default;
+  constexpr basic_string_view &
+  operator=(const basic_string_view &rhs) noexcept = default;
 
   constexpr basic_string_view(
       const std::basic_string_view<CharT, TraitsT> &rhs) noexcept
@@ -55,14 +57,14 @@ struct basic_string_view : std::basic_string_view<CharT, TraitsT> {
   [[nodiscard]] constexpr result<std::reference_wrapper<const CharT>>
   try_front() const & noexcept {
     if (empty)
-      return unexpected(error::container_empty);
+      return RELOCO_ERROR(error::container_empty);
     return base::front();
   }
 
   [[nodiscard]] constexpr result<std::reference_wrapper<const CharT>>
   try_back() const & noexcept {
     if (empty)
-      return unexpected(error::container_empty);
+      return RELOCO_ERROR(error::container_empty);
     return base::back();
   }
 
@@ -101,7 +103,7 @@ struct basic_string_view : std::basic_string_view<CharT, TraitsT> {
   [[nodiscard]] constexpr result<std::reference_wrapper<const CharT>>
   try_at(size_type pos) const & noexcept {
     if (pos >= size()) {
-      return unexpected(error::out_of_bounds);
+      return RELOCO_ERROR(error::out_of_bounds);
     }
     return std::ref(base::operator[](pos));
   }
@@ -109,7 +111,7 @@ struct basic_string_view : std::basic_string_view<CharT, TraitsT> {
   [[nodiscard]] constexpr result<basic_string_view>
   try_substr(size_type pos, size_type count = base::npos) const & noexcept {
     if (pos > size()) {
-      return unexpected(error::out_of_bounds);
+      return RELOCO_ERROR(error::out_of_bounds);
     }
     return basic_string_view(base::substr(pos, count));
   }
@@ -130,7 +132,7 @@ struct basic_string_view : std::basic_string_view<CharT, TraitsT> {
    */
   [[nodiscard]] constexpr result<const_pointer> try_data() const & noexcept {
     if (empty()) {
-      return unexpected(error::container_empty);
+      return RELOCO_ERROR(error::container_empty);
     }
     return base::data();
   }
@@ -168,14 +170,14 @@ struct basic_string_view : std::basic_string_view<CharT, TraitsT> {
 
   constexpr result<void> try_remove_prefix(size_type n) & noexcept {
     if (n > size())
-      return unexpected(error::out_of_bounds);
+      return RELOCO_ERROR(error::out_of_bounds);
     base::remove_prefix(n);
     return {};
   }
 
   constexpr result<void> try_remove_suffix(size_type n) & noexcept {
     if (n > size())
-      return unexpected(error::out_of_bounds);
+      return RELOCO_ERROR(error::out_of_bounds);
     base::remove_suffix(n);
     return {};
   }
@@ -0,0 +1,215 @@
+#pragma once
+#include <cstddef>
+#include <mutex>
+#include <reloco/allocator.hpp>
+#include <reloco/error_origin.hpp>
+#include <reloco/function.hpp>
+#include <reloco/mutex.hpp>
+#include <reloco/vector.hpp>
+#include <thread>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <cerrno>
+#include <pthread.h>
+#endif
+
+namespace reloco {
+
+/**
+ * @brief Fixed-size pool of worker threads draining a FIFO task queue.
+ * Two-phase: the constructor never fails, ``try_start()`` spawns the
+ * workers and reports thread creation failures. Submitting a task may fail
+ * when the queue cannot grow or the callable does not fit the inline buffer
+ * of ``function`` and its allocation fails; the task is then not queued.
+ *
+ * Destruction runs every task still queued, then joins the workers.
+ */
+class thread_pool {
+public:
+  explicit thread_pool(
+      fallible_allocator &alloc = get_default_allocator()) noexcept
+      : m_alloc(&alloc), m_workers(alloc), m_tasks(alloc) {}
+
+  thread_pool(const thread_pool &) = delete;
+  thread_pool &operator=(const thread_pool &) = delete;
+
+  ~thread_pool() noexcept { stop(); }
+
+  /**
+   * @brief Number of hardware threads, never less than one.
+   */
+  [[nodiscard]] static std::size_t hardware_concurrency() noexcept {
+    const unsigned n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : n;
+  }
+
+  /**
+   * @brief Spawns ``thread_count`` workers.
+   * If a thread cannot be created, the already running workers are joined
+   * again and the pool is left stopped.
+   */
+  result<void> try_start(std::size_t thread_count) & noexcept {
+    if (thread_count == 0)
+      return RELOCO_ERROR(error::invalid_argument);
+    if (!m_workers.empty())
+      return RELOCO_ERROR(error::already_exists);
+
+    if (auto res = m_workers.try_reserve(thread_count); !res)
+      return res;
+
+    m_stopping = false;
+    for (std::size_t i = 0; i < thread_count; ++i) {
+      auto handle = spawn();
+      if (!handle) {
+        stop();
+        return unexpected(handle.error());
+      }
+      std::ignore = m_workers.try_push_back(std::move(*handle));
+    }
+    return {};
+  }
+
+  [[nodiscard]] std::size_t thread_count() const noexcept {
+    return m_workers.size();
+  }
+
+  /**
+   * @brief Queues ``f`` for execution on one of the workers.
+   * @return ``not_initialized`` if the pool has not been started.
+   */
+  template <typename F>
+    requires std::is_invocable_v<F &>
+  result<void> try_submit(F &&f) & noexcept {
+    auto fn = function<void()>::try_allocate(std::forward<F>(f), *m_alloc);
+    if (!fn)
+      return unexpected(fn.error());
+
+    {
+      std::unique_lock<mutex> lock(m_mutex);
+      if (m_workers.empty() || m_stopping)
+        return RELOCO_ERROR(error::not_initialized);
+      auto res = m_tasks.try_emplace_back(std::move(*fn));
+      if (!res)
+        return unexpected(res.error());
+    }
+    m_work_available.notify_one();
+    return {};
+  }
+
+  /**
+   * @brief Blocks until the queue is empty and no task is running.
+   * Tasks submitted by other tasks are waited for as well.
+   */
+  result<void> wait_idle() & noexcept {
+    std::unique_lock<mutex> lock(m_mutex);
+    return m_idle.wait(lock, [this] { return is_idle(); });
+  }
+
+private:
+#if defined(_WIN32)
+  using native_thread = HANDLE;
+#else
+  using native_thread = pthread_t;
+#endif
+
+  struct task {
+    explicit task(function<void()> &&f) noexcept : fn(std::move(f)) {}
+    function<void()> fn;
+  };
+
+  result<native_thread> spawn() noexcept {
+#if defined(_WIN32)
+    HANDLE handle = CreateThread(nullptr, 0, &worker_entry, this, 0, nullptr);
+    if (!handle)
+      return RELOCO_ERROR(error::try_again);
+    return handle;
+#else
+    pthread_t handle;
+    const int rc = pthread_create(&handle, nullptr, &worker_entry, this);
+    if (rc == EAGAIN)
+      return RELOCO_ERROR(error::try_again);
+    if (rc != 0)
+      return RELOCO_ERROR(error::unsupported_operation);
+    return handle;
+#endif
+  }
+
+  static void join(native_thread handle) noexcept {
+#if defined(_WIN32)
+    WaitForSingleObject(handle, INFINITE);
+    CloseHandle(handle);
+#else
+    pthread_join(handle, nullptr);
+#endif
+  }
+
+#if defined(_WIN32)
+  static DWORD WINAPI worker_entry(LPVOID self) {
+    static_cast<thread_pool *>(self)->worker_loop();
+    return 0;
+  }
+#else
+  static void *worker_entry(void *self) {
+    static_cast<thread_pool *>(self)->worker_loop();
+    return nullptr;
+  }
+#endif
+
+  void stop() noexcept {
+    {
+      std::unique_lock<mutex> lock(m_mutex);
+      m_stopping = true;
+    }
+    m_work_available.notify_all();
+    for (native_thread handle : m_workers)
+      join(handle);
+    m_workers.clear();
+    m_tasks.clear();
+    m_head = 0;
+  }
+
+  bool is_idle() const noexcept {
+    return m_head == m_tasks.size() && m_active == 0;
+  }
+
+  void worker_loop() noexcept {
+    std::unique_lock<mutex> lock(m_mutex);
+    while (true) {
+      std::ignore = m_work_available.wait(
+          lock, [this] { return m_stopping || m_head < m_tasks.size(); });
+      if (m_head == m_tasks.size())
+        return; // Stopping with an empty queue
+
+      function<void()> fn = std::move(m_tasks[m_head++].fn);
+      if (m_head == m_tasks.size()) {
+        // Queue drained, reuse the buffer from the start
+        m_tasks.clear();
+        m_head = 0;
+      }
+      ++m_active;
+
+      lock.unlock();
+      fn();
+      lock.lock();
+
+      if (--m_active == 0 && is_idle())
+        m_idle.notify_all();
+    }
+  }
+
+  fallible_allocator *m_alloc;
+  vector<native_thread> m_workers;
+
+  mutex m_mutex;
+  condition_variable m_work_available;
+  condition_variable m_idle;
+  // Guarded by m_mutex, pending tasks are [m_head, m_tasks.size())
+  vector<task> m_tasks;
+  std::size_t m_head = 0;
+  std::size_t m_active = 0;
+  bool m_stopping = false;
+};
+
+} // namespace reloco
@@ -0,0 +1,179 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <reloco/allocator.hpp>
+#include <reloco/config.hpp>
+#include <reloco/construction_helpers.hpp>
+#include <thread>
+#include <type_traits>
+
+namespace reloco {
+
+namespace detail {
+
+/**
+ * Small direct-mapped per-thread cache from enumerable_thread_specific
+ * instance ids to the calling thread's slot. Ids are never reused, so
+ * entries of destroyed instances simply never match again.
+ */
+struct ets_thread_cache {
+  static constexpr std::size_t capacity = 16;
+
+  struct entry {
+    std::uint64_t id = 0;
+    void *slot = nullptr;
+  };
+
+  entry entries[capacity];
+};
+
+inline ets_thread_cache &local_ets_cache() noexcept {
+  static thread_local ets_thread_cache cache;
+  return cache;
+}
+
+inline std::uint64_t next_ets_id() noexcept {
+  static std::atomic<std::uint64_t> next{1};
+  return next.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace detail
+
+/**
+ * @brief One lazily created ``T`` per thread, all of them enumerable.
+ *
+ * Each thread's value lives in its own cache line, allocated from the given
+ * allocator on the thread's first ``try_local()``. Finding the slot again is
+ * a thread-local cache hit in the common case and a walk of the lock-free
+ * slot list otherwise. Slots outlive their threads, so ``combine()`` still
+ * sees the contributions of threads that have exited; a thread that happens
+ * to reuse an exited thread's id inherits its slot.
+ */
+template <typename T> class enumerable_thread_specific {
+  struct alignas(cache_line_size) slot {
+    alignas(T) std::byte storage[sizeof(T)];
+    slot *next;
+    std::thread::id owner;
+
+    T *value() noexcept { return std::launder(reinterpret_cast<T *>(storage)); }
+    const T *value() const noexcept {
+      return std::launder(reinterpret_cast<const T *>(storage));
+    }
+  };
+
+public:
+  explicit enumerable_thread_specific(
+      fallible_allocator &alloc = get_default_allocator()) noexcept
+      : m_alloc(&alloc), m_id(detail::next_ets_id()) {}
+
+  enumerable_thread_specific(const enumerable_thread_specific &) = delete;
+  enumerable_thread_specific &
+  operator=(const enumerable_thread_specific &) = delete;
+
+  ~enumerable_thread_specific() noexcept {
+    slot *s = m_head.load(std::memory_order_acquire);
+    while (s) {
+      slot *next = s->next;
+      s->value()->~T();
+      m_alloc->deallocate(s, sizeof(slot));
+      s = next;
+    }
+  }
+
+  /**
+   * @brief The calling thread's value, created on first use.
+   * Fails only if the slot cannot be allocated or ``T`` cannot be
+   * constructed.
+   */
+  result<T *> try_local() & noexcept {
+    auto &entry = detail::local_ets_cache()
+                      .entries[m_id % detail::ets_thread_cache::capacity];
+    if (entry.id == m_id) [[likely]]
+      return static_cast<slot *>(entry.slot)->value();
+
+    slot *s = find_own_slot();
+    if (!s) {
+      auto res = try_create_slot();
+      if (!res)
+        return unexpected(res.error());
+      s = *res;
+    }
+    entry.id = m_id;
+    entry.slot = s;
+    return s->value();
+  }
+
+  /**
+   * @brief Visits every thread's value.
+   * Values owned by running threads may change concurrently; ``T`` has to
+   * make such reads safe (e.g. by being atomic).
+   */
+  template <typename F> void for_each(F &&f) const noexcept {
+    for (const slot *s = m_head.load(std::memory_order_acquire); s;
+         s = s->next)
+      f(*s->value());
+  }
+
+  template <typename F> void for_each(F &&f) noexcept {
+    for (slot *s = m_head.load(std::memory_order_acquire); s; s = s->next)
+      f(*s->value());
+  }
+
+  /**
+   * @brief Folds every thread's value into ``init`` with ``op``.
+   */
+  template <typename U, typename BinaryOp>
+  [[nodiscard]] U combine(U init, BinaryOp &&op) const noexcept {
+    for_each([&](const T &v) { init = op(std::move(init), v); });
+    return init;
+  }
+
+  /**
+   * @brief Number of threads that have created a value so far.
+   */
+  [[nodiscard]] std::size_t size() const noexcept {
+    std::size_t n = 0;
+    for_each([&n](const T &) { ++n; });
+    return n;
+  }
+
+private:
+  slot *find_own_slot() const noexcept {
+    const auto self = std::this_thread::get_id();
+    for (slot *s = m_head.load(std::memory_order_acquire); s; s = s->next) {
+      if (s->owner == self)
+        return s;
+    }
+    return nullptr;
+  }
+
+  result<slot *> try_create_slot() noexcept {
+    auto block = m_alloc->allocate(sizeof(slot), alignof(slot));
+    if (!block)
+      return unexpected(block.error());
+
+    slot *s = new (block->ptr) slot;
+    auto res = construction_helpers::try_construct<T>(
+        *m_alloc, reinterpret_cast<T *>(s->storage));
+    if (!res) {
+      m_alloc->deallocate(s, sizeof(slot));
+      return unexpected(res.error());
+    }
+    s->owner = std::this_thread::get_id();
+
+    // Publish, readers only ever walk from the head
+    s->next = m_head.load(std::memory_order_relaxed);
+    while (!m_head.compare_exchange_weak(s->next, s, std::memory_order_release,
+                                         std::memory_order_relaxed)) {
+    }
+    return s;
+  }
+
+  fallible_allocator *m_alloc;
+  std::uint64_t m_id;
+  std::atomic<slot *> m_head{nullptr};
+};
+
+} // namespace reloco
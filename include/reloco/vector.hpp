@@ -1,4 +1,8 @@
 #pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
 #include <initializer_list>
 #include <iterator>
 #include <reloco/allocator.hpp>
@@ -6,7 +10,10 @@
 #include <reloco/collection_view.hpp>
 #include <reloco/concepts.hpp>
 #include <reloco/construction_helpers.hpp>
+#include <reloco/error_origin.hpp>
+#include <reloco/relocation.hpp>
 #include <reloco/rvalue_safety.hpp>
+#include <reloco/span.hpp>
 #include <span>
 
 namespace reloco {
@@ -58,14 +65,21 @@ public:
     }
   }
 
+  /**
+   * @brief Exchanges contents and allocators with ``other``.
+   */
+  void swap(vector &other) noexcept {
+    std::swap(alloc_, other.alloc_);
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+    std::swap(cap_, other.cap_);
+  }
+
   static result<vector> try_allocate(fallible_allocator &alloc,
                                      ::size_t initial_cap = 0) noexcept {
     vector v{alloc};
-    if (initial_cap > 0) {
-      auto res = v.try_reserve(initial_cap);
-      if (!res)
-        return unexpected(res.error());
-    }
+    if (initial_cap > 0)
+      RELOCO_TRY(v.try_reserve(initial_cap));
     return v;
   }
 
@@ -106,12 +120,14 @@ public:
       }
     }
 
-    // Optimized Relocation
+    // Optimized Relocation; the first block has nothing to carry over, so
+    // it comes from a plain allocate()
     if constexpr (is_relocatable<T>::value) {
-      auto res = alloc_->reallocate(data_, cap_ * sizeof(T),
-                                    new_cap * sizeof(T), alignof(T));
+      auto res = data_ ? alloc_->reallocate(data_, cap_ * sizeof(T),
+                                            new_cap * sizeof(T), alignof(T))
+                       : alloc_->allocate(new_cap * sizeof(T), alignof(T));
       if (!res)
-        return unexpected(error::allocation_failed);
+        return RELOCO_ALLOC_ERROR(error::allocation_failed, *alloc_);
       data_ = static_cast<T *>(res->ptr);
       cap_ = new_cap;
     }
@@ -119,13 +135,10 @@ public:
     else {
       auto res = alloc_->allocate(new_cap * sizeof(T), alignof(T));
       if (!res)
-        return unexpected(error::allocation_failed);
+        return RELOCO_ALLOC_ERROR(error::allocation_failed, *alloc_);
 
       T *new_ptr = static_cast<T *>(res->ptr);
-      for (size_type i = 0; i < size_; ++i) {
-        new (new_ptr + i) T(std::move(data_[i]));
-        data_[i].~T();
-      }
+      uninitialized_relocate(data_, data_ + size_, new_ptr);
       if (data_)
         alloc_->deallocate(data_, cap_ * sizeof(T));
       data_ = new_ptr;
@@ -136,38 +149,24 @@ public:
 
   template <typename... Args>
   [[nodiscard]] result<T *> try_emplace_back(Args &&...args) & noexcept {
-    if (size_ == cap_) {
-      auto res = try_reserve(cap_ == 0 ? 8 : cap_ * 2);
-      if (!res)
-        return unexpected(res.error());
-    }
+    if (size_ == cap_) [[unlikely]]
+      RELOCO_TRY(try_reserve(cap_ == 0 ? 8 : cap_ * 2));
 
     T *ptr = data_ + size_;
-
-    auto res = construction_helpers::try_construct<T>(
-        *alloc_, ptr, std::forward<Args>(args)...);
-    if (!res) {
-      return unexpected(res.error());
-    }
+    RELOCO_TRY(construction_helpers::try_construct<T>(
+        *alloc_, ptr, std::forward<Args>(args)...));
 
     size_++;
     return ptr;
   }
 
   [[nodiscard]] result<T *> try_push_back(T &&val) & noexcept {
-    if (size_ == cap_) {
-      auto res = try_reserve(cap_ == 0 ? 8 : cap_ * 2);
-      if (!res)
-        return unexpected(res.error());
-    }
+    if (size_ == cap_) [[unlikely]]
+      RELOCO_TRY(try_reserve(cap_ == 0 ? 8 : cap_ * 2));
 
     T *ptr = data_ + size_;
-
-    auto res =
-        construction_helpers::try_construct<T>(*alloc_, ptr, std::move(val));
-    if (!res) {
-      return unexpected(res.error());
-    }
+    RELOCO_TRY(
+        construction_helpers::try_construct<T>(*alloc_, ptr, std::move(val)));
 
     size_++;
     return ptr;
@@ -175,7 +174,7 @@ public:
 
   [[nodiscard]] result<void> try_pop_back() & noexcept {
     if (size_ == 0)
-      return unexpected(error::out_of_range);
+      return RELOCO_ERROR(error::out_of_range);
     --size_;
     if constexpr (!std::is_trivially_destructible_v<T>) {
       data_[size_].~T();
@@ -201,9 +200,7 @@ public:
   [[nodiscard]] result<vector>
   try_clone(fallible_allocator &clone_alloc) const noexcept {
     vector clone(clone_alloc);
-    auto res = clone.try_reserve(size_);
-    if (!res)
-      return unexpected(res.error());
+    RELOCO_TRY(clone.try_reserve(size_));
 
     if constexpr (!has_try_clone<T> && std::is_trivially_copyable_v<T>) {
       // FAST PATH: Single memcpy for the entire range
@@ -213,10 +210,8 @@ public:
       }
     } else {
       for (size_type i = 0; i < size_; ++i) {
-        auto item_res = construction_helpers::try_clone_at<T>(
-            clone_alloc, clone.data_ + i, data_[i]);
-        if (!item_res)
-          return unexpected(item_res.error());
+        RELOCO_TRY(construction_helpers::try_clone_at<T>(
+            clone_alloc, clone.data_ + i, data_[i]));
         ++clone.size_;
       }
     }
@@ -227,71 +222,94 @@ public:
     return try_clone(*alloc_);
   }
 
+  /**
+   * @brief Appends copies of ``values``, growing at most once.
+   * Elements are cloned like in try_clone(); if one fails, the copies
+   * appended before it stay. ``values`` may be a part of this vector.
+   */
+  [[nodiscard]] result<void> try_append(span<const T> values) & noexcept {
+    const size_type count = values.size();
+    if (count == 0)
+      return {};
+
+    const T *source = values.unsafe_data();
+    if (count > cap_ - size_) {
+      if (count > SIZE_MAX / sizeof(T) - size_)
+        return RELOCO_ERROR(error::integer_overflow);
+      // Growing moves our elements, so re-find a source that lies among
+      // them in the new block
+      const std::less<const T *> before;
+      const bool aliased =
+          !before(source, data_) && before(source, data_ + size_);
+      const size_type offset = aliased ? size_type(source - data_) : 0;
+      RELOCO_TRY(try_reserve(std::max(size_ + count, cap_ * 2)));
+      if (aliased)
+        source = data_ + offset;
+    }
+
+    if constexpr (!has_try_clone<T> && std::is_trivially_copyable_v<T>) {
+      std::memcpy(data_ + size_, source, count * sizeof(T));
+      size_ += count;
+    } else {
+      for (size_type i = 0; i < count; ++i) {
+        RELOCO_TRY(construction_helpers::try_clone_at<T>(
+            *alloc_, data_ + size_, source[i]));
+        ++size_;
+      }
+    }
+    return {};
+  }
+
   [[nodiscard]] result<void> try_erase(size_type pos) & noexcept {
     if (pos >= size_)
-      return unexpected(error::out_of_range);
+      return RELOCO_ERROR(error::out_of_range);
 
     if constexpr (!std::is_trivially_destructible_v<T>) {
       data_[pos].~T();
     }
     size_type move_count = size_ - pos - 1;
 
-    if (move_count > 0) {
-      if constexpr (is_relocatable<T>::value) {
-        std::memmove(data_ + pos, data_ + pos + 1, move_count * sizeof(T));
-      } else {
-        // Manual move loop for non-relocatable types
-        for (size_type i = 0; i < move_count; ++i) {
-          new (data_ + pos + i) T(std::move(data_[pos + i + 1]));
-          data_[pos + i + 1].~T();
-        }
-      }
-    }
+    relocate_n(data_ + pos + 1, move_count, data_ + pos);
     size_--;
     return {};
   }
 
+  /**
+   * @brief Erases ``count`` elements starting at ``pos``, shifting the tail
+   * down once.
+   */
+  [[nodiscard]] result<void> try_erase(size_type pos,
+                                       size_type count) & noexcept {
+    if (pos > size_ || count > size_ - pos)
+      return RELOCO_ERROR(error::out_of_range);
+
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      for (size_type i = 0; i < count; ++i)
+        data_[pos + i].~T();
+    }
+    relocate_n(data_ + pos + count, size_ - pos - count, data_ + pos);
+    size_ -= count;
+    return {};
+  }
+
   template <typename... Args>
   [[nodiscard]] result<T *> try_insert(size_type pos, Args &&...args) & noexcept {
     if (pos > size_) {
-      return unexpected(error::out_of_range);
+      return RELOCO_ERROR(error::out_of_range);
     }
 
     // Ensure capacity
-    if (size_ == cap_) {
-      auto res = try_reserve(cap_ == 0 ? 8 : cap_ * 2);
-      if (!res) {
-        return unexpected(res.error());
-      }
-    }
+    if (size_ == cap_) [[unlikely]]
+      RELOCO_TRY(try_reserve(cap_ == 0 ? 8 : cap_ * 2));
 
-    auto obj_to_insert = construction_helpers::try_allocate<T>(
-        *alloc_, std::forward<Args>(args)...);
-    if (!obj_to_insert) {
-      return unexpected(obj_to_insert.error());
-    }
-
-    size_type move_count = size_ - pos;
-
-    if (move_count > 0) {
-      if constexpr (is_relocatable<T>::value) {
-        // Relocatable: Just shift the bytes to the right
-        std::memmove(data_ + pos + 1, data_ + pos, move_count * sizeof(T));
-      } else {
-        new (data_ + size_) T(std::move(data_[size_ - 1]));
+    RELOCO_TRY_ASSIGN(T obj_to_insert, construction_helpers::try_allocate<T>(
+                                           *alloc_, std::forward<Args>(args)...));
 
-        for (size_type i = size_ - 1; i > pos; --i) {
-          data_[i] = std::move(data_[i - 1]);
-        }
-
-        if constexpr (!std::is_trivially_destructible_v<T>) {
-          data_[pos].~T();
-        }
-      }
-    }
+    // Open a hole at pos
+    relocate_backward(data_ + pos, data_ + size_, data_ + size_ + 1);
 
     // Construct the new element in the hole
-    T *ptr = new (data_ + pos) T(std::move(*obj_to_insert));
+    T *ptr = new (data_ + pos) T(std::move(obj_to_insert));
 
     size_++;
     return ptr;
@@ -299,27 +317,27 @@ public:
 
   result<const value_type *> try_data() const & noexcept {
     if (empty())
-      return unexpected(error::container_empty);
+      return RELOCO_ERROR(error::container_empty);
     return data_;
   }
 
   result<value_type *> try_data() & noexcept {
     if (empty())
-      return unexpected(error::container_empty);
+      return RELOCO_ERROR(error::container_empty);
     return data_;
   }
 
   [[nodiscard]] result<std::reference_wrapper<const T>>
   try_at(const size_t index) const & noexcept {
     if (index >= size_)
-      return unexpected(error::out_of_range);
+      return RELOCO_ERROR(error::out_of_range);
     return std::ref(data_[index]);
   }
 
   [[nodiscard]] result<std::reference_wrapper<T>>
   try_at(const size_t index) & noexcept {
     if (index >= size_)
-      return unexpected(error::out_of_range);
+      return RELOCO_ERROR(error::out_of_range);
     return std::ref(data_[index]);
   }
 
@@ -364,10 +382,10 @@ public:
   }
 
   /**
-   * Construct non-owning view of this vector
+   * Construct non-owning view of this vector; stored inline, never allocates
    */
-  result<any_view<T>> as_view() & noexcept {
-    return any_view<T>::try_create(
+  any_view<T> as_view() & noexcept {
+    return any_view<T>::create(
         collection_view<vector<T>, policy::non_owner>(this), *alloc_);
   }
 };
@@ -2,6 +2,7 @@
 #include <cstring>
 #include <malloc.h>
 #include <reloco/core.hpp>
+#include <reloco/error_origin.hpp>
 
 namespace reloco {
 
@@ -12,7 +13,16 @@ public:
     void *ptr = _aligned_malloc(bytes, alignment);
 
     if (!ptr)
-      return unexpected(error::allocation_failed);
+      return RELOCO_ALLOC_ERROR(error::allocation_failed, *this);
+    return mem_block{ptr, bytes};
+  }
+
+  [[nodiscard]] result<mem_block>
+  allocate_zeroed(std::size_t bytes, std::size_t alignment) noexcept override {
+    void *ptr = _aligned_recalloc(nullptr, 1, bytes, alignment);
+
+    if (!ptr)
+      return RELOCO_ALLOC_ERROR(error::allocation_failed, *this);
     return mem_block{ptr, bytes};
   }
 
@@ -27,7 +37,7 @@ public:
     void *new_ptr = _aligned_realloc(ptr, new_size, alignment);
 
     if (!new_ptr)
-      return unexpected(error::allocation_failed);
+      return RELOCO_ALLOC_ERROR(error::allocation_failed, *this);
     return mem_block{new_ptr, new_size};
   }
 
@@ -35,6 +45,8 @@ public:
     // Windows requires _aligned_free for pointers from _aligned_malloc
     _aligned_free(ptr);
   }
+
+  [[nodiscard]] const char *tag() const noexcept override { return "win"; }
 };
 
 } // namespace reloco
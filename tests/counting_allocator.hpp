@@ -0,0 +1,118 @@
+#pragma once
+#include <cstddef>
+#include <ostream>
+#include <reloco/allocator.hpp>
+
+namespace reloco::test {
+
+/**
+ * @brief Calls and bytes seen by a counting_allocator. A reallocation
+ * counts its new size as allocated and its old size as deallocated.
+ */
+struct allocation_counts {
+  // allocate() and allocate_zeroed()
+  std::size_t allocations = 0;
+  std::size_t reallocations = 0;
+  // expand_in_place() attempts; counting_allocator declines them all
+  std::size_t expansions = 0;
+  std::size_t deallocations = 0;
+  std::size_t bytes_allocated = 0;
+  std::size_t bytes_deallocated = 0;
+
+  bool operator==(const allocation_counts &) const = default;
+
+  friend std::ostream &operator<<(std::ostream &os,
+                                  const allocation_counts &c) {
+    return os << "{allocations=" << c.allocations
+              << ", reallocations=" << c.reallocations
+              << ", expansions=" << c.expansions
+              << ", deallocations=" << c.deallocations
+              << ", bytes_allocated=" << c.bytes_allocated
+              << ", bytes_deallocated=" << c.bytes_deallocated << "}";
+  }
+};
+
+/**
+ * @brief Forwards to an upstream allocator and counts every call, for tests
+ * that pin down exactly how often a container operation allocates.
+ *
+ * expand_in_place() always fails, so growth takes the same path whatever
+ * the upstream allocator can do. Counters are plain integers; use it from
+ * one thread at a time.
+ */
+class counting_allocator final : public fallible_allocator {
+public:
+  counting_allocator() noexcept : m_upstream(&get_default_allocator()) {}
+  explicit counting_allocator(fallible_allocator &upstream) noexcept
+      : m_upstream(&upstream) {}
+
+  [[nodiscard]] result<mem_block>
+  allocate(std::size_t bytes, std::size_t alignment) noexcept override {
+    auto res = m_upstream->allocate(bytes, alignment);
+    if (res)
+      record_allocation(bytes);
+    return res;
+  }
+
+  [[nodiscard]] result<mem_block>
+  allocate_zeroed(std::size_t bytes, std::size_t alignment) noexcept override {
+    auto res = m_upstream->allocate_zeroed(bytes, alignment);
+    if (res)
+      record_allocation(bytes);
+    return res;
+  }
+
+  [[nodiscard]] result<std::size_t>
+  expand_in_place(void *, std::size_t, std::size_t) noexcept override {
+    ++m_counts.expansions;
+    return unexpected(error::in_place_growth_failed);
+  }
+
+  [[nodiscard]] result<mem_block>
+  reallocate(void *ptr, std::size_t old_size, std::size_t new_size,
+             std::size_t alignment) noexcept override {
+    auto res = m_upstream->reallocate(ptr, old_size, new_size, alignment);
+    if (res) {
+      ++m_counts.reallocations;
+      m_counts.bytes_allocated += new_size;
+      if (ptr)
+        m_counts.bytes_deallocated += old_size;
+    }
+    return res;
+  }
+
+  void deallocate(void *ptr, std::size_t bytes) noexcept override {
+    m_upstream->deallocate(ptr, bytes);
+    ++m_counts.deallocations;
+    m_counts.bytes_deallocated += bytes;
+  }
+
+  void advise(void *ptr, std::size_t bytes, usage_hint hint) noexcept override {
+    m_upstream->advise(ptr, bytes, hint);
+  }
+
+  [[nodiscard]] const char *tag() const noexcept override {
+    return "counting";
+  }
+
+  [[nodiscard]] const allocation_counts &counts() const noexcept {
+    return m_counts;
+  }
+
+  /**
+   * @brief Zeroes the counters, so a test can measure just the operation
+   * that follows. Blocks already handed out stay valid.
+   */
+  void reset() noexcept { m_counts = {}; }
+
+private:
+  void record_allocation(std::size_t bytes) noexcept {
+    ++m_counts.allocations;
+    m_counts.bytes_allocated += bytes;
+  }
+
+  fallible_allocator *m_upstream;
+  allocation_counts m_counts;
+};
+
+} // namespace reloco::test
@@ -0,0 +1,288 @@
+#include "counting_allocator.hpp"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <reloco/flat_set.hpp>
+#include <reloco/function.hpp>
+#include <reloco/shared_ptr.hpp>
+#include <reloco/string.hpp>
+#include <reloco/vector.hpp>
+
+using reloco::test::allocation_counts;
+
+// Every test states the exact calls an operation makes, so a change that
+// adds an allocation or loses a free fails here rather than in a profile.
+class AllocationCountTest : public ::testing::Test {
+protected:
+  reloco::test::counting_allocator alloc;
+
+  // Everything allocated since the last reset() has been handed back
+  void expect_all_freed() const {
+    EXPECT_EQ(alloc.counts().deallocations, alloc.counts().allocations);
+    EXPECT_EQ(alloc.counts().bytes_deallocated, alloc.counts().bytes_allocated);
+  }
+};
+
+namespace {
+
+// Not trivially copyable, so vectors of it grow by allocate and free
+struct pinned {
+  int value;
+  explicit pinned(int v) noexcept : value(v) {}
+  pinned(pinned &&other) noexcept : value(other.value) {}
+  ~pinned() {}
+};
+
+} // namespace
+
+TEST_F(AllocationCountTest, VectorGrowthFromEmpty) {
+  {
+    reloco::vector<int> v(alloc);
+    for (int i = 0; i < 65; ++i)
+      ASSERT_TRUE(v.try_push_back(int{i}));
+
+    // Capacities 8, 16, 32, 64 and 128: the first block is allocated and
+    // each doubling after it is a single reallocation
+    EXPECT_EQ(alloc.counts(),
+              (allocation_counts{
+                  .allocations = 1,
+                  .reallocations = 4,
+                  .expansions = 4,
+                  .bytes_allocated = (8 + 16 + 32 + 64 + 128) * sizeof(int),
+                  .bytes_deallocated = (8 + 16 + 32 + 64) * sizeof(int)}));
+  }
+  EXPECT_EQ(alloc.counts().deallocations, 1u);
+  expect_all_freed();
+}
+
+TEST_F(AllocationCountTest, VectorReserveThenFillAllocatesOnce) {
+  {
+    auto v = reloco::vector<int>::try_allocate(alloc, 100);
+    ASSERT_TRUE(v);
+    for (int i = 0; i < 100; ++i)
+      ASSERT_TRUE(v->try_push_back(int{i}));
+
+    EXPECT_EQ(alloc.counts(),
+              (allocation_counts{.allocations = 1,
+                                 .bytes_allocated = 100 * sizeof(int)}));
+  }
+  expect_all_freed();
+}
+
+TEST_F(AllocationCountTest, VectorCloneOfTriviallyCopyableAllocatesOnce) {
+  auto v = reloco::vector<int>::try_allocate(alloc, 128);
+  ASSERT_TRUE(v);
+  for (int i = 0; i < 100; ++i)
+    ASSERT_TRUE(v->try_push_back(int{i}));
+  alloc.reset();
+
+  {
+    // Sized to the elements, not to the source's capacity
+    auto clone = v->try_clone();
+    ASSERT_TRUE(clone);
+    EXPECT_EQ(alloc.counts(),
+              (allocation_counts{.allocations = 1,
+                                 .bytes_allocated = 100 * sizeof(int)}));
+  }
+  expect_all_freed();
+}
+
+TEST_F(AllocationCountTest, CloneOfEmptyVectorDoesNotAllocate) {
+  reloco::vector<int> empty(alloc);
+  auto clone = empty.try_clone();
+  ASSERT_TRUE(clone);
+  EXPECT_EQ(alloc.counts(), allocation_counts{});
+}
+
+TEST_F(AllocationCountTest, VectorAppendGrowsOnce) {
+  reloco::vector<int> v(alloc);
+  for (int i = 0; i < 8; ++i)
+    ASSERT_TRUE(v.try_push_back(int{i}));
+  int values[100] = {};
+  alloc.reset();
+
+  ASSERT_TRUE(v.try_append(reloco::span<const int>(values, 100)));
+  EXPECT_EQ(alloc.counts(),
+            (allocation_counts{.reallocations = 1,
+                               .expansions = 1,
+                               .bytes_allocated = 108 * sizeof(int),
+                               .bytes_deallocated = 8 * sizeof(int)}));
+}
+
+TEST_F(AllocationCountTest, VectorOfNonRelocatableMovesIntoFreshBlocks) {
+  {
+    reloco::vector<pinned> v(alloc);
+    for (int i = 0; i < 9; ++i)
+      ASSERT_TRUE(v.try_emplace_back(i));
+
+    EXPECT_EQ(alloc.counts(),
+              (allocation_counts{.allocations = 2,
+                                 .expansions = 1,
+                                 .deallocations = 1,
+                                 .bytes_allocated = 24 * sizeof(pinned),
+                                 .bytes_deallocated = 8 * sizeof(pinned)}));
+  }
+  expect_all_freed();
+}
+
+TEST_F(AllocationCountTest, VectorShrinkingOperationsNeverAllocate) {
+  reloco::vector<int> v(alloc);
+  for (int i = 0; i < 16; ++i)
+    ASSERT_TRUE(v.try_push_back(int{i}));
+  alloc.reset();
+
+  ASSERT_TRUE(v.try_erase(0));
+  ASSERT_TRUE(v.try_erase(0, 4));
+  ASSERT_TRUE(v.try_pop_back());
+  v.clear();
+  EXPECT_EQ(alloc.counts(), allocation_counts{});
+}
+
+TEST_F(AllocationCountTest, StringAppendGrowth) {
+  {
+    reloco::string s(alloc);
+    ASSERT_TRUE(s.try_append("abc"));
+    ASSERT_TRUE(s.try_append("defghijklm"));
+    ASSERT_TRUE(s.try_append("n"));
+
+    // Capacities 3, 13 and 26, each one byte larger for the terminator
+    EXPECT_EQ(alloc.counts(),
+              (allocation_counts{.allocations = 1,
+                                 .reallocations = 2,
+                                 .expansions = 2,
+                                 .bytes_allocated = 4 + 14 + 27,
+                                 .bytes_deallocated = 4 + 14}));
+  }
+  expect_all_freed();
+}
+
+TEST_F(AllocationCountTest, StringCloneAllocatesExactSize) {
+  reloco::string s(alloc);
+  ASSERT_TRUE(s.try_reserve(64));
+  ASSERT_TRUE(s.try_append("hello world"));
+  alloc.reset();
+
+  {
+    auto clone = s.try_clone();
+    ASSERT_TRUE(clone);
+    EXPECT_EQ(alloc.counts(),
+              (allocation_counts{.allocations = 1, .bytes_allocated = 12}));
+  }
+  expect_all_freed();
+}
+
+TEST_F(AllocationCountTest, CloneOfEmptyStringDoesNotAllocate) {
+  reloco::string s(alloc);
+  auto clone = s.try_clone();
+  ASSERT_TRUE(clone);
+  EXPECT_EQ(alloc.counts(), allocation_counts{});
+}
+
+TEST_F(AllocationCountTest, FunctionWithSmallCaptureNeverAllocates) {
+  const std::int64_t bias = 3;
+  {
+    auto f = reloco::function<std::int64_t(std::int64_t)>::try_allocate(
+        [bias](std::int64_t x) noexcept { return x + bias; }, alloc);
+    ASSERT_TRUE(f);
+    auto moved = std::move(*f);
+    EXPECT_EQ(moved(4), 7);
+    auto copy = moved.try_clone();
+    ASSERT_TRUE(copy);
+    EXPECT_EQ((*copy)(5), 8);
+  }
+  EXPECT_EQ(alloc.counts(), allocation_counts{});
+}
+
+TEST_F(AllocationCountTest, FunctionWithLargeCaptureAllocatesOncePerCopy) {
+  struct big {
+    std::int64_t values[8] = {};
+  } captured;
+  constexpr std::size_t capture_size = sizeof(big);
+  static_assert(capture_size >
+                reloco::function<std::int64_t(std::int64_t)>::SOO_SIZE);
+  {
+    auto f = reloco::function<std::int64_t(std::int64_t)>::try_allocate(
+        [captured](std::int64_t x) noexcept { return x + captured.values[0]; },
+        alloc);
+    ASSERT_TRUE(f);
+    EXPECT_EQ(alloc.counts(),
+              (allocation_counts{.allocations = 1,
+                                 .bytes_allocated = capture_size}));
+
+    // Moving hands over the heap block
+    auto moved = std::move(*f);
+    auto copy = moved.try_clone();
+    ASSERT_TRUE(copy);
+    EXPECT_EQ(alloc.counts().allocations, 2u);
+  }
+  EXPECT_EQ(alloc.counts().deallocations, 2u);
+  expect_all_freed();
+}
+
+TEST_F(AllocationCountTest, SharedPtrHoldsObjectAndControlBlock) {
+  {
+    auto p = reloco::try_allocate_shared<std::int64_t>(alloc, 5);
+    ASSERT_TRUE(p);
+    EXPECT_EQ(alloc.counts().allocations, 2u);
+
+    auto copy = *p;
+    EXPECT_EQ(alloc.counts().allocations, 2u);
+    EXPECT_EQ(alloc.counts().deallocations, 0u);
+  }
+  EXPECT_EQ(alloc.counts().deallocations, 2u);
+  expect_all_freed();
+}
+
+TEST_F(AllocationCountTest, CombinedSharedPtrAllocatesOnce) {
+  {
+    auto p = reloco::try_allocate_combined_shared<std::int64_t>(alloc, 5);
+    ASSERT_TRUE(p);
+    EXPECT_EQ(alloc.counts().allocations, 1u);
+  }
+  EXPECT_EQ(alloc.counts().deallocations, 1u);
+  expect_all_freed();
+}
+
+TEST_F(AllocationCountTest, FlatSetInsertGrowth) {
+  auto set = reloco::flat_set<int>::try_allocate(alloc);
+  ASSERT_TRUE(set);
+  for (int i = 0; i < 9; ++i)
+    ASSERT_TRUE(set->try_insert(int{i}));
+  EXPECT_EQ(alloc.counts(),
+            (allocation_counts{.allocations = 1,
+                               .reallocations = 1,
+                               .expansions = 1,
+                               .bytes_allocated = (8 + 16) * sizeof(int),
+                               .bytes_deallocated = 8 * sizeof(int)}));
+
+  // A duplicate is rejected before anything is reserved
+  alloc.reset();
+  EXPECT_FALSE(set->try_insert(int{3}));
+  EXPECT_EQ(alloc.counts(), allocation_counts{});
+}
+
+TEST_F(AllocationCountTest, FlatSetAlgebraReservesOnce) {
+  auto a = reloco::flat_set<int>::try_allocate(alloc, 100);
+  auto b = reloco::flat_set<int>::try_allocate(alloc, 100);
+  ASSERT_TRUE(a);
+  ASSERT_TRUE(b);
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_TRUE(a->try_insert(int{i}));
+    ASSERT_TRUE(b->try_insert(i + 50));
+  }
+  alloc.reset();
+
+  {
+    auto united = a->try_set_union(*b);
+    auto common = a->try_set_intersection(*b);
+    auto only_a = a->try_set_difference(*b);
+    ASSERT_TRUE(united);
+    ASSERT_TRUE(common);
+    ASSERT_TRUE(only_a);
+    EXPECT_EQ(united->size(), 150u);
+    EXPECT_EQ(alloc.counts(),
+              (allocation_counts{.allocations = 3,
+                                 .bytes_allocated =
+                                     (200 + 100 + 100) * sizeof(int)}));
+  }
+  EXPECT_EQ(alloc.counts().deallocations, 3u);
+}
@@ -1,3 +1,4 @@
+#include <cstring>
 #include <gtest/gtest.h>
 #include <reloco/allocator.hpp>
 #include <reloco/allocator_helper.hpp>
@@ -221,3 +222,69 @@ TEST_F(FallibleArrayPtrTest, LvalueStability) {
   // The following would fail to compile:
   // int& dangling = std::move(array)[0];
 }
+
+namespace {
+
+// Hands out storage filled with garbage unless zeroed memory is requested
+class zeroed_tracking_allocator final : public reloco::fallible_allocator {
+public:
+  reloco::result<reloco::mem_block>
+  allocate(std::size_t bytes, std::size_t alignment) noexcept override {
+    auto res = reloco::get_default_allocator().allocate(bytes, alignment);
+    if (res)
+      std::memset(res->ptr, 0xCD, bytes);
+    return res;
+  }
+
+  reloco::result<reloco::mem_block>
+  allocate_zeroed(std::size_t bytes, std::size_t alignment) noexcept override {
+    ++zeroed_calls;
+    return reloco::get_default_allocator().allocate_zeroed(bytes, alignment);
+  }
+
+  reloco::result<std::size_t> expand_in_place(void *, std::size_t,
+                                              std::size_t) noexcept override {
+    return reloco::unexpected(reloco::error::in_place_growth_failed);
+  }
+
+  reloco::result<reloco::mem_block>
+  reallocate(void *, std::size_t, std::size_t, std::size_t) noexcept override {
+    return reloco::unexpected(reloco::error::unsupported_operation);
+  }
+
+  void deallocate(void *ptr, std::size_t bytes) noexcept override {
+    reloco::get_default_allocator().deallocate(ptr, bytes);
+  }
+
+  int zeroed_calls = 0;
+};
+
+struct point {
+  int x;
+  int y;
+};
+
+} // namespace
+
+static_assert(reloco::is_zero_initializable<point>::value);
+static_assert(!reloco::is_zero_initializable<LifecycleMock>::value);
+static_assert(!reloco::is_zero_initializable<int point::*>::value);
+
+TEST(AllocatorHelperTest, ValueInitializedArrayUsesZeroedAllocation) {
+  zeroed_tracking_allocator alloc;
+  reloco::allocator_helper helper(alloc);
+
+  auto res = helper.allocate_array<point>(1000);
+  ASSERT_TRUE(res.has_value());
+  EXPECT_EQ(alloc.zeroed_calls, 1);
+  for (std::size_t i = 0; i < res->size(); ++i) {
+    EXPECT_EQ((*res)[i].x, 0);
+    EXPECT_EQ((*res)[i].y, 0);
+  }
+
+  // Explicit initializers still construct every element
+  auto filled = helper.allocate_array<int>(4, 7);
+  ASSERT_TRUE(filled.has_value());
+  EXPECT_EQ(alloc.zeroed_calls, 1);
+  EXPECT_EQ((*filled)[3], 7);
+}
@@ -193,3 +193,186 @@ TEST_F(AnyViewTest, DeepCloneSupportedForMoveOwner) {
   EXPECT_NE(&erased.try_at(0).value().get(),
             &(*cloned_res).try_at(0).value().get());
 }
+
+namespace {
+
+// Elements split over two fixed segments
+struct segmented_ints {
+  using value_type = int;
+
+  int first[3] = {1, 2, 3};
+  int second[2] = {4, 5};
+
+  size_t size() const noexcept { return 5; }
+  bool empty() const noexcept { return false; }
+  const int &unsafe_at(size_t i) const noexcept {
+    return i < 3 ? first[i] : second[i - 3];
+  }
+  const int &at(size_t i) const noexcept { return unsafe_at(i); }
+  reloco::result<std::reference_wrapper<const int>>
+  try_at(size_t i) const noexcept {
+    if (i >= size())
+      return reloco::unexpected(reloco::error::out_of_range);
+    return std::cref(unsafe_at(i));
+  }
+  reloco::result<const int *> try_data() const noexcept {
+    return reloco::unexpected(reloco::error::unsupported_operation);
+  }
+  const int *data() const noexcept { return nullptr; }
+  const int *unsafe_data() const noexcept { return nullptr; }
+
+  template <typename F> void for_each_chunk(F &&fn) const noexcept {
+    fn(reloco::span<const int>(first, 3));
+    fn(reloco::span<const int>(second, 2));
+  }
+};
+
+} // namespace
+
+TEST_F(CollectionViewTest, AnyViewVisitsContiguousVectorAsOneChunk) {
+  auto vec = create_vec();
+  auto view = vec.as_view();
+
+  int chunks = 0;
+  int sum = 0;
+  view.for_each_chunk([&](reloco::span<const int> chunk) {
+    ++chunks;
+    for (int v : chunk)
+      sum += v;
+  });
+  EXPECT_EQ(chunks, 1);
+  EXPECT_EQ(sum, 30);
+}
+
+TEST_F(CollectionViewTest, AnyViewCopyTo) {
+  auto vec = create_vec();
+  std::ignore = vec.try_push_back(30);
+  auto view = vec.as_view();
+
+  int out[8] = {};
+  auto copied = view.try_copy_to(reloco::span<int>(out, 8), 1);
+  ASSERT_TRUE(copied.has_value());
+  EXPECT_EQ(*copied, 2u);
+  EXPECT_EQ(out[0], 20);
+  EXPECT_EQ(out[1], 30);
+
+  auto past_end = view.try_copy_to(reloco::span<int>(out, 8), 4);
+  ASSERT_FALSE(past_end.has_value());
+  EXPECT_EQ(past_end.error(), reloco::error::out_of_range);
+}
+
+TEST_F(CollectionViewTest, SegmentedContainerExposesEachSegment) {
+  segmented_ints segments;
+  auto view = reloco::any_view<int>::try_create(
+      reloco::collection_view<segmented_ints, reloco::policy::non_owner>(
+          &segments),
+      reloco::get_default_allocator());
+  ASSERT_TRUE(view.has_value());
+
+  int chunks = 0;
+  view->for_each_chunk([&](reloco::span<const int>) { ++chunks; });
+  EXPECT_EQ(chunks, 2);
+
+  // Copy straddling both segments
+  int out[3] = {};
+  auto copied = view->try_copy_to(reloco::span<int>(out, 3), 2);
+  ASSERT_TRUE(copied.has_value());
+  EXPECT_EQ(*copied, 3u);
+  EXPECT_EQ(out[0], 3);
+  EXPECT_EQ(out[1], 4);
+  EXPECT_EQ(out[2], 5);
+}
+
+namespace {
+
+// Tracks the allocations it serves
+class counting_allocator final : public reloco::fallible_allocator {
+public:
+  reloco::result<reloco::mem_block>
+  allocate(std::size_t bytes, std::size_t alignment) noexcept override {
+    ++allocations;
+    return reloco::get_default_allocator().allocate(bytes, alignment);
+  }
+  reloco::result<std::size_t>
+  expand_in_place(void *ptr, std::size_t old_size,
+                  std::size_t new_size) noexcept override {
+    return reloco::get_default_allocator().expand_in_place(ptr, old_size,
+                                                           new_size);
+  }
+  reloco::result<reloco::mem_block>
+  reallocate(void *ptr, std::size_t old_size, std::size_t new_size,
+             std::size_t alignment) noexcept override {
+    ++allocations;
+    return reloco::get_default_allocator().reallocate(ptr, old_size, new_size,
+                                                      alignment);
+  }
+  void deallocate(void *ptr, std::size_t bytes) noexcept override {
+    reloco::get_default_allocator().deallocate(ptr, bytes);
+  }
+
+  int allocations = 0;
+};
+
+// Too large for the inline buffer
+struct padded_ints {
+  using value_type = int;
+
+  reloco::vector<int> items;
+  char padding[64] = {};
+
+  size_t size() const noexcept { return items.size(); }
+  bool empty() const noexcept { return items.empty(); }
+  reloco::result<std::reference_wrapper<const int>>
+  try_at(size_t i) const noexcept {
+    return items.try_at(i);
+  }
+  reloco::result<const int *> try_data() const noexcept {
+    return items.try_data();
+  }
+  const int &at(size_t i) const noexcept { return items.at(i); }
+  const int *data() const noexcept { return items.data(); }
+  const int &unsafe_at(size_t i) const noexcept { return items.unsafe_at(i); }
+  const int *unsafe_data() const noexcept { return items.unsafe_data(); }
+};
+
+} // namespace
+
+TEST_F(AnyViewTest, SmallViewsAreStoredInline) {
+  counting_allocator counting;
+  auto vec = create_populated_vec(3);
+
+  auto non_owning = reloco::any_view<int>::try_create(
+      reloco::collection_view<reloco::vector<int>, reloco::policy::non_owner>(
+          &vec),
+      counting);
+  auto owning = reloco::any_view<int>::try_create(
+      reloco::collection_view<reloco::vector<int>, reloco::policy::move_owner>(
+          create_populated_vec(2)),
+      counting);
+  ASSERT_TRUE(non_owning.has_value());
+  ASSERT_TRUE(owning.has_value());
+  EXPECT_EQ(counting.allocations, 0);
+
+  // Moving relocates the inline context
+  auto moved = std::move(*owning);
+  EXPECT_EQ(moved.size(), 2u);
+  EXPECT_EQ(moved.at(1), 10);
+  EXPECT_TRUE(owning->empty());
+}
+
+TEST_F(AnyViewTest, LargeViewsUseTheAllocator) {
+  counting_allocator counting;
+  padded_ints backing;
+  std::ignore = backing.items.try_push_back(7);
+
+  auto view = reloco::any_view<int>::try_create(
+      reloco::collection_view<padded_ints, reloco::policy::move_owner>(
+          std::move(backing)),
+      counting);
+  ASSERT_TRUE(view.has_value());
+  EXPECT_EQ(counting.allocations, 1);
+
+  auto moved = std::move(*view);
+  EXPECT_EQ(counting.allocations, 1);
+  EXPECT_EQ(moved.at(0), 7);
+}
@@ -0,0 +1,97 @@
+#include <cstring>
+#include <gtest/gtest.h>
+#include <reloco/error_origin.hpp>
+#include <reloco/stack_allocator.hpp>
+#include <reloco/vector.hpp>
+#include <thread>
+
+namespace {
+
+class ErrorOriginTest : public ::testing::Test {
+protected:
+  void SetUp() override { reloco::clear_error_origins(); }
+  void TearDown() override {
+    reloco::enable_error_origins(false);
+    reloco::clear_error_origins();
+  }
+};
+
+} // namespace
+
+TEST_F(ErrorOriginTest, DisabledByDefault) {
+  EXPECT_FALSE(reloco::error_origins_enabled());
+
+  alignas(16) std::byte buffer[16];
+  reloco::stack_allocator alloc(buffer, sizeof(buffer));
+  EXPECT_FALSE(alloc.allocate(64, 1).has_value());
+  EXPECT_EQ(reloco::last_error_origin(), nullptr);
+}
+
+TEST_F(ErrorOriginTest, RecordsAllocatorFailure) {
+  reloco::enable_error_origins();
+
+  alignas(16) std::byte buffer[16];
+  reloco::stack_allocator alloc(buffer, sizeof(buffer));
+  auto res = alloc.allocate(64, 1);
+  ASSERT_FALSE(res.has_value());
+
+  const reloco::error_origin *origin = reloco::last_error_origin();
+  ASSERT_NE(origin, nullptr);
+  EXPECT_EQ(origin->code, reloco::error::allocation_failed);
+  EXPECT_STREQ(origin->allocator_tag, "stack");
+  EXPECT_NE(std::strstr(origin->file, "stack_allocator.hpp"), nullptr);
+  EXPECT_GT(origin->line, 0u);
+}
+
+TEST_F(ErrorOriginTest, ContainerFailureKeepsTrail) {
+  reloco::enable_error_origins();
+
+  alignas(16) std::byte buffer[16];
+  reloco::stack_allocator alloc(buffer, sizeof(buffer));
+  reloco::vector<int> v(alloc);
+  auto res = v.try_reserve(64);
+  ASSERT_FALSE(res.has_value());
+
+  // Newest first: the vector, then the allocator it called into
+  const char *files[2] = {};
+  int count = 0;
+  reloco::for_each_error_origin([&](const reloco::error_origin &origin) {
+    if (count < 2)
+      files[count] = origin.file;
+    EXPECT_STREQ(origin.allocator_tag, "stack");
+    ++count;
+  });
+  ASSERT_EQ(count, 2);
+  EXPECT_NE(std::strstr(files[0], "vector.hpp"), nullptr);
+  EXPECT_NE(std::strstr(files[1], "stack_allocator.hpp"), nullptr);
+}
+
+TEST_F(ErrorOriginTest, RingKeepsNewest) {
+  reloco::enable_error_origins();
+
+  reloco::vector<int> v;
+  for (int i = 0; i < 100; ++i)
+    EXPECT_FALSE(v.try_at(static_cast<std::size_t>(i)).has_value());
+
+  int count = 0;
+  reloco::for_each_error_origin([&](const reloco::error_origin &origin) {
+    EXPECT_EQ(origin.code, reloco::error::out_of_range);
+    EXPECT_EQ(origin.allocator_tag, nullptr);
+    ++count;
+  });
+  EXPECT_EQ(count,
+            static_cast<int>(reloco::detail::error_origin_ring::capacity));
+}
+
+TEST_F(ErrorOriginTest, RingIsPerThread) {
+  reloco::enable_error_origins();
+
+  std::thread other([] {
+    reloco::vector<int> v;
+    EXPECT_FALSE(v.try_at(0).has_value());
+    EXPECT_NE(reloco::last_error_origin(), nullptr);
+  });
+  other.join();
+
+  EXPECT_EQ(reloco::last_error_origin(), nullptr);
+}
@@ -0,0 +1,148 @@
+#include <functional>
+#include <gtest/gtest.h>
+#include <reloco/core.hpp>
+#include <reloco/vector.hpp>
+#include <type_traits>
+
+using reloco::error;
+using reloco::result;
+
+// Niche-encoded results are exactly as large as their payload and cheap to
+// return in registers
+static_assert(sizeof(result<int *>) == sizeof(int *));
+static_assert(sizeof(result<std::reference_wrapper<int>>) == sizeof(int *));
+static_assert(sizeof(result<reloco::mem_block>) == sizeof(reloco::mem_block));
+static_assert(sizeof(result<void>) == sizeof(error));
+static_assert(std::is_trivially_copyable_v<result<int *>>);
+static_assert(std::is_trivially_copyable_v<result<std::reference_wrapper<int>>>);
+static_assert(std::is_trivially_copyable_v<result<reloco::mem_block>>);
+static_assert(std::is_trivially_copyable_v<result<void>>);
+
+// Trivial payloads without a niche still get a trivial destructor
+static_assert(std::is_trivially_copyable_v<result<int>>);
+static_assert(!std::is_trivially_destructible_v<result<reloco::vector<int>>>);
+
+// Value paths stay usable in constant expressions
+static_assert(result<const int *>(nullptr).has_value());
+static_assert(result<void>().has_value());
+
+TEST(ExpectedNicheTest, NullPointerIsAValue) {
+  result<int *> res(nullptr);
+  ASSERT_TRUE(res.has_value());
+  EXPECT_EQ(*res, nullptr);
+}
+
+TEST(ExpectedNicheTest, PointerRoundTrip) {
+  int x = 5;
+  result<int *> ok(&x);
+  ASSERT_TRUE(ok.has_value());
+  EXPECT_EQ(**ok, 5);
+
+  result<int *> err = reloco::unexpected(error::out_of_bounds);
+  ASSERT_FALSE(err.has_value());
+  EXPECT_EQ(err.error(), error::out_of_bounds);
+  EXPECT_NE(ok, err);
+}
+
+TEST(ExpectedNicheTest, ReferenceWrapperRoundTrip) {
+  int x = 7;
+  result<std::reference_wrapper<int>> ok = std::ref(x);
+  ASSERT_TRUE(ok.has_value());
+  ok->get() = 8;
+  EXPECT_EQ(x, 8);
+
+  result<std::reference_wrapper<int>> err =
+      reloco::unexpected(error::integer_overflow);
+  ASSERT_FALSE(err.has_value());
+  EXPECT_EQ(err.error(), error::integer_overflow);
+}
+
+TEST(ExpectedNicheTest, MemBlockRoundTrip) {
+  result<reloco::mem_block> empty(reloco::mem_block{nullptr, 0});
+  EXPECT_TRUE(empty.has_value());
+
+  result<reloco::mem_block> err = reloco::unexpected(error::allocation_failed);
+  ASSERT_FALSE(err.has_value());
+  EXPECT_EQ(err.error(), error::allocation_failed);
+}
+
+TEST(ExpectedNicheTest, VoidUsesZeroForSuccess) {
+  result<void> ok;
+  EXPECT_TRUE(ok.has_value());
+
+  result<void> err = reloco::unexpected(error::timed_out);
+  ASSERT_FALSE(err.has_value());
+  EXPECT_EQ(err.error(), error::timed_out);
+  EXPECT_NE(ok, err);
+}
+
+TEST(ExpectedNicheTest, ConvertsBetweenNicheAndTagged) {
+  result<int *> err = reloco::unexpected(error::not_found);
+  result<const int *> converted(std::move(err));
+  ASSERT_FALSE(converted.has_value());
+  EXPECT_EQ(converted.error(), error::not_found);
+
+  auto mapped = converted.transform([](const int *p) { return p != nullptr; });
+  static_assert(std::is_same_v<decltype(mapped), result<bool>>);
+  ASSERT_FALSE(mapped.has_value());
+  EXPECT_EQ(mapped.error(), error::not_found);
+}
+
+TEST(ExpectedNicheTest, TryAtUsesNiche) {
+  auto v = reloco::vector<int>::try_create(4);
+  ASSERT_TRUE(v.has_value());
+  ASSERT_TRUE(v->try_push_back(1).has_value());
+
+  auto hit = v->try_at(0);
+  static_assert(sizeof(hit) == sizeof(void *));
+  ASSERT_TRUE(hit.has_value());
+  EXPECT_EQ(hit->get(), 1);
+
+  auto miss = v->try_at(1);
+  ASSERT_FALSE(miss.has_value());
+  EXPECT_EQ(miss.error(), error::out_of_range);
+}
+
+namespace {
+
+result<int> parse_digit(char c) {
+  if (c < '0' || c > '9')
+    return reloco::unexpected(error::invalid_argument);
+  return c - '0';
+}
+
+result<int> parse_pair(const char *s) {
+  RELOCO_TRY_ASSIGN(int hi, parse_digit(s[0]));
+  RELOCO_TRY_ASSIGN(int lo, parse_digit(s[1]));
+  return hi * 10 + lo;
+}
+
+result<void> check_pair(const char *s, int &out) {
+  RELOCO_TRY(parse_pair(s));
+  RELOCO_TRY_ASSIGN(out, parse_pair(s));
+  return {};
+}
+
+} // namespace
+
+TEST(TryMacroTest, AssignsOnSuccess) {
+  auto res = parse_pair("42");
+  ASSERT_TRUE(res.has_value());
+  EXPECT_EQ(*res, 42);
+
+  int out = 0;
+  EXPECT_TRUE(check_pair("17", out).has_value());
+  EXPECT_EQ(out, 17);
+}
+
+TEST(TryMacroTest, PropagatesFirstError) {
+  auto res = parse_pair("4x");
+  ASSERT_FALSE(res.has_value());
+  EXPECT_EQ(res.error(), error::invalid_argument);
+
+  int out = -1;
+  auto checked = check_pair("x1", out);
+  ASSERT_FALSE(checked.has_value());
+  EXPECT_EQ(checked.error(), error::invalid_argument);
+  EXPECT_EQ(out, -1);
+}
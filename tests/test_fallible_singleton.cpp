@@ -1,3 +1,5 @@
+#include <atomic>
+#include <chrono>
 #include <gtest/gtest.h>
 #include <mutex>
 #include <reloco/fallible_singleton.hpp>
@@ -118,3 +120,85 @@ TEST(AtomicSingletonTest, FastPathDoesNotLock) {
     EXPECT_EQ(*res1, *res2);
   }
 }
+
+namespace {
+
+class SlowResource {
+public:
+  using reloco_fallible_t = void;
+  static inline std::atomic<int> constructor_calls{0};
+  static inline std::atomic<int> init_calls{0};
+
+  SlowResource(reloco::detail::constructor_key<SlowResource>) {
+    constructor_calls++;
+  }
+
+  reloco::result<void>
+  try_init(reloco::detail::constructor_key<SlowResource>) {
+    init_calls++;
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    return {};
+  }
+};
+
+class FlakyResource {
+public:
+  using reloco_fallible_t = void;
+  static inline int init_calls = 0;
+  static inline int failures_left = 0;
+
+  FlakyResource(reloco::detail::constructor_key<FlakyResource>) {}
+
+  reloco::result<void>
+  try_init(reloco::detail::constructor_key<FlakyResource>) {
+    init_calls++;
+    if (failures_left > 0) {
+      failures_left--;
+      return reloco::unexpected(reloco::error::try_again);
+    }
+    return {};
+  }
+};
+
+} // namespace
+
+TEST(ConcurrentSingletonTest, ConcurrentInitialization) {
+  using Singleton = reloco::concurrent_fallible_singleton<SlowResource>;
+  const int thread_count = 32;
+  std::vector<std::thread> threads;
+  std::vector<SlowResource *> results(thread_count, nullptr);
+
+  for (int i = 0; i < thread_count; ++i) {
+    threads.emplace_back([&results, i]() {
+      auto res = Singleton::instance();
+      if (res)
+        results[i] = *res;
+    });
+  }
+
+  for (auto &t : threads)
+    t.join();
+
+  ASSERT_NE(results[0], nullptr);
+  for (auto *ptr : results)
+    EXPECT_EQ(ptr, results[0]);
+
+  EXPECT_TRUE(Singleton::is_initialized());
+  EXPECT_EQ(SlowResource::constructor_calls.load(), 1);
+  EXPECT_EQ(SlowResource::init_calls.load(), 1);
+}
+
+TEST(ConcurrentSingletonTest, FailedInitIsRetried) {
+  using Singleton = reloco::concurrent_fallible_singleton<FlakyResource>;
+  FlakyResource::failures_left = 1;
+  FlakyResource::init_calls = 0;
+
+  auto first = Singleton::instance();
+  ASSERT_FALSE(first.has_value());
+  EXPECT_EQ(first.error(), reloco::error::try_again);
+  EXPECT_FALSE(Singleton::is_initialized());
+
+  auto second = Singleton::instance();
+  ASSERT_TRUE(second.has_value());
+  EXPECT_EQ(FlakyResource::init_calls, 2);
+}
@@ -0,0 +1,274 @@
+#ifndef _WIN32
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <reloco/file_io.hpp>
+#include <reloco/stack_allocator.hpp>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+
+namespace {
+
+reloco::span<const std::byte> as_bytes(std::string_view text) {
+  return reloco::span<const std::byte>(
+      reinterpret_cast<const std::byte *>(text.data()), text.size());
+}
+
+std::string_view as_text(reloco::span<const std::byte> bytes) {
+  if (bytes.empty())
+    return {};
+  return std::string_view(reinterpret_cast<const char *>(bytes.unsafe_data()),
+                          bytes.size());
+}
+
+/**
+ * @brief Fresh temporary path, removed on destruction.
+ */
+class temp_path {
+  std::string m_path;
+
+public:
+  temp_path() {
+    char name[] = "/tmp/reloco_io_XXXXXX";
+    const int fd = ::mkstemp(name);
+    EXPECT_GE(fd, 0);
+    ::close(fd);
+    m_path = name;
+  }
+  ~temp_path() { ::unlink(m_path.c_str()); }
+
+  const char *c_str() const { return m_path.c_str(); }
+};
+
+void write_file(const temp_path &path, std::string_view contents) {
+  auto writer = reloco::file_writer::try_open(path.c_str());
+  ASSERT_TRUE(writer.has_value());
+  ASSERT_TRUE(writer->try_write(as_bytes(contents)).has_value());
+  ASSERT_TRUE(writer->try_close().has_value());
+}
+
+std::string read_file(const temp_path &path) {
+  auto reader = reloco::file_reader::try_open(path.c_str());
+  EXPECT_TRUE(reader.has_value());
+  std::string contents(1 << 20, '\0');
+  auto n = reader->try_read_into(reloco::span<std::byte>(
+      reinterpret_cast<std::byte *>(contents.data()), contents.size()));
+  EXPECT_TRUE(n.has_value());
+  contents.resize(*n);
+  return contents;
+}
+
+std::string pattern(std::size_t n) {
+  std::string s(n, '\0');
+  for (std::size_t i = 0; i < n; ++i)
+    s[i] = static_cast<char>('a' + i * 7 % 26);
+  return s;
+}
+
+} // namespace
+
+TEST(FileIoTest, WriteThenReadBackThroughSmallBuffers) {
+  temp_path path;
+  const std::string contents = pattern(100000);
+  reloco::file_io_options small;
+  small.buffer_size = 64;
+  {
+    auto writer = reloco::file_writer::try_open(path.c_str(), small);
+    ASSERT_TRUE(writer.has_value());
+    // Pieces both smaller and larger than the buffer; the destructor flushes
+    std::string_view rest = contents;
+    for (std::size_t step = 1; !rest.empty(); step = step * 3 % 1009) {
+      const std::size_t n = std::min(step, rest.size());
+      ASSERT_TRUE(writer->try_write(as_bytes(rest.substr(0, n))).has_value());
+      rest.remove_prefix(n);
+    }
+  }
+
+  auto reader = reloco::file_reader::try_open(path.c_str(), small);
+  ASSERT_TRUE(reader.has_value());
+  std::string back(contents.size() + 10, '\0');
+  std::size_t at = 0;
+  for (std::size_t step = 5;; step = step * 7 % 997 + 1) {
+    const std::size_t n = std::min(step, back.size() - at);
+    auto got = reader->try_read_into(reloco::span<std::byte>(
+        reinterpret_cast<std::byte *>(back.data() + at), n));
+    ASSERT_TRUE(got.has_value());
+    at += *got;
+    if (*got < n)
+      break;
+  }
+  back.resize(at);
+  EXPECT_EQ(back, contents);
+  EXPECT_TRUE(reader->at_eof());
+}
+
+TEST(FileIoTest, ReadLinesBorrowTheBuffer) {
+  temp_path path;
+  const std::string long_line = pattern(300);
+  write_file(path, "first\n\n" + long_line + "\nno newline at end");
+
+  reloco::file_io_options small;
+  small.buffer_size = 16;
+  auto reader = reloco::file_reader::try_open(path.c_str(), small);
+  ASSERT_TRUE(reader.has_value());
+
+  EXPECT_EQ(reader->try_read_line().value(), "first");
+  EXPECT_EQ(reader->try_read_line().value(), "");
+  EXPECT_EQ(reader->try_read_line().value(), long_line); // grows the buffer
+  EXPECT_EQ(reader->try_read_line().value(), "no newline at end");
+  auto end = reader->try_read_line();
+  ASSERT_FALSE(end.has_value());
+  EXPECT_EQ(end.error(), reloco::error::end_of_file);
+}
+
+TEST(FileIoTest, FixedSizeRecords) {
+  temp_path path;
+  write_file(path, "aaaabbbbccccdd");
+  auto reader = reloco::file_reader::try_open(path.c_str());
+  ASSERT_TRUE(reader.has_value());
+
+  EXPECT_EQ(as_text(reader->try_read_exact(4).value()), "aaaa");
+  EXPECT_EQ(as_text(reader->try_read_exact(4).value()), "bbbb");
+  EXPECT_EQ(as_text(reader->buffered()), "ccccdd");
+  reader->consume(4);
+  auto truncated = reader->try_read_exact(4);
+  ASSERT_FALSE(truncated.has_value());
+  EXPECT_EQ(truncated.error(), reloco::error::invalid_format);
+  reader->consume(2);
+  EXPECT_EQ(reader->try_read_exact(4).error(), reloco::error::end_of_file);
+}
+
+TEST(FileIoTest, BatchWriteKeepsOrder) {
+  temp_path path;
+  auto writer = reloco::file_writer::try_open(path.c_str());
+  ASSERT_TRUE(writer.has_value());
+  ASSERT_TRUE(writer->try_write(reloco::string_view("head:")).has_value());
+
+  std::string words[200];
+  reloco::span<const std::byte> pieces[200];
+  std::string expected = "head:";
+  for (int i = 0; i < 200; ++i) {
+    words[i] = std::to_string(i) + ",";
+    pieces[i] = as_bytes(words[i]);
+    expected += words[i];
+  }
+  using piece_span = reloco::span<const reloco::span<const std::byte>>;
+  ASSERT_TRUE(writer->try_write_batch(piece_span(pieces, 200)).has_value());
+  ASSERT_TRUE(writer->try_close().has_value());
+  EXPECT_EQ(read_file(path), expected);
+}
+
+TEST(FileIoTest, FlushAfterPartialWriteDoesNotRepeatBytes) {
+  // A non-blocking pipe takes what fits and then fails with try_again;
+  // the test drains it between flushes
+  int fds[2];
+  ASSERT_EQ(::pipe(fds), 0);
+  reloco::unique_fd read_end(fds[0]);
+  ASSERT_EQ(::fcntl(fds[0], F_SETFL, O_NONBLOCK), 0);
+  ASSERT_EQ(::fcntl(fds[1], F_SETFL, O_NONBLOCK), 0);
+
+  reloco::file_io_options big;
+  big.buffer_size = 1 << 20;
+  auto writer =
+      reloco::file_writer::try_adopt(reloco::unique_fd(fds[1]), big);
+  ASSERT_TRUE(writer.has_value());
+  const std::string expected = pattern(512 * 1024);
+  ASSERT_TRUE(writer->try_write(as_bytes(expected)).has_value());
+
+  std::string received;
+  char chunk[4096];
+  bool blocked = false;
+  while (received.size() < expected.size()) {
+    auto res = writer->try_flush();
+    if (!res) {
+      ASSERT_EQ(res.error(), reloco::error::try_again);
+      blocked = true;
+    }
+    ssize_t n;
+    while ((n = ::read(read_end.get(), chunk, sizeof(chunk))) > 0)
+      received.append(chunk, static_cast<std::size_t>(n));
+    ASSERT_LE(received.size(), expected.size());
+  }
+  EXPECT_TRUE(blocked);
+  EXPECT_TRUE(received == expected);
+}
+
+TEST(FileIoTest, PrepareAndCommitFormatInPlace) {
+  temp_path path;
+  {
+    reloco::file_io_options small;
+    small.buffer_size = 8;
+    auto writer = reloco::file_writer::try_open(path.c_str(), small);
+    ASSERT_TRUE(writer.has_value());
+    ASSERT_TRUE(writer->try_write(reloco::string_view("0123")).has_value());
+
+    auto space = writer->try_prepare(20);
+    ASSERT_TRUE(space.has_value());
+    ASSERT_GE(space->size(), 20u);
+    const std::string_view record = "record of twenty....";
+    std::memcpy(space->unsafe_data(), record.data(), record.size());
+    writer->commit(record.size());
+  }
+  EXPECT_EQ(read_file(path), "0123record of twenty....");
+}
+
+TEST(FileIoTest, AppendMode) {
+  temp_path path;
+  write_file(path, "one ");
+  reloco::file_io_options append;
+  append.append = true;
+  auto writer = reloco::file_writer::try_open(path.c_str(), append);
+  ASSERT_TRUE(writer.has_value());
+  ASSERT_TRUE(writer->try_write(reloco::string_view("two")).has_value());
+  ASSERT_TRUE(writer->try_close().has_value());
+  EXPECT_EQ(read_file(path), "one two");
+}
+
+TEST(FileIoTest, DirectIoUsesAlignedBuffers) {
+  temp_path path;
+  reloco::file_io_options direct;
+  direct.direct = true;
+  direct.buffer_size = 5000; // rounded up to whole blocks
+
+  auto writer = reloco::file_writer::try_open(path.c_str(), direct);
+  if (!writer.has_value())
+    GTEST_SKIP() << "O_DIRECT not supported on this file system";
+  const std::string contents = pattern(3 * reloco::direct_io_alignment + 123);
+  ASSERT_TRUE(writer->try_write(as_bytes(contents)).has_value());
+  ASSERT_TRUE(writer->try_close().has_value());
+
+  auto reader = reloco::file_reader::try_open(path.c_str(), direct);
+  ASSERT_TRUE(reader.has_value());
+  auto first = reader->try_read_exact(10);
+  ASSERT_TRUE(first.has_value());
+  EXPECT_EQ(as_text(*first), contents.substr(0, 10));
+  auto rest = reader->try_read_exact(contents.size() - 10);
+  ASSERT_TRUE(rest.has_value());
+  EXPECT_EQ(as_text(*rest), contents.substr(10));
+  EXPECT_EQ(reader->try_read_exact(1).error(), reloco::error::end_of_file);
+}
+
+TEST(FileIoTest, BuffersComeFromTheAllocator) {
+  temp_path path;
+  alignas(16) std::byte storage[128];
+  reloco::stack_allocator tiny(storage, sizeof(storage));
+  auto reader = reloco::file_reader::try_open(path.c_str(), {}, tiny);
+  ASSERT_FALSE(reader.has_value());
+  EXPECT_EQ(reader.error(), reloco::error::allocation_failed);
+
+  reloco::file_io_options small;
+  small.buffer_size = 64;
+  auto fits = reloco::file_reader::try_open(path.c_str(), small, tiny);
+  EXPECT_TRUE(fits.has_value());
+}
+
+TEST(FileIoTest, MissingFileIsNotFound) {
+  auto reader = reloco::file_reader::try_open("/nonexistent/reloco/input");
+  ASSERT_FALSE(reader.has_value());
+  EXPECT_EQ(reader.error(), reloco::error::not_found);
+}
+
+#endif
@@ -1,5 +1,10 @@
+#include <algorithm>
+#include <cstdint>
+#include <functional>
 #include <gtest/gtest.h>
+#include <iterator>
 #include <reloco/flat_set.hpp>
+#include <vector>
 
 TEST(FlatSetTest, SortingAndUniqueness) {
   auto set = std::move(*reloco::flat_set<int>::try_create());
@@ -14,7 +19,7 @@ TEST(FlatSetTest, SortingAndUniqueness) {
   EXPECT_EQ(dup_res.error(), reloco::error::already_exists);
 
   // Sorted verification via view
-  auto view = set.as_view().value();
+  auto view = set.as_view();
   ASSERT_EQ(view.size(), 3);
   EXPECT_EQ(view.at(0), 10);
   EXPECT_EQ(view.at(1), 30);
@@ -56,3 +61,100 @@ TEST(FlatSetTest, HandlesMoveOnlyTypes) {
   ASSERT_TRUE(res.has_value());
   EXPECT_EQ(set.size(), 1);
 }
+
+namespace {
+
+template <typename T, typename Compare = std::less<T>>
+reloco::flat_set<T, Compare> make_set(std::size_t count, std::size_t stride,
+                                      std::size_t offset) {
+  auto set = std::move(*reloco::flat_set<T, Compare>::try_create(count));
+  for (std::size_t i = 0; i < count; ++i)
+    std::ignore = set.try_insert(static_cast<T>(offset + i * stride));
+  return set;
+}
+
+template <typename T, typename Compare>
+std::vector<T> to_std(const reloco::flat_set<T, Compare> &set) {
+  return std::vector<T>(set.begin(), set.end());
+}
+
+template <typename T, typename Compare = std::less<T>>
+void check_set_operations(std::size_t na, std::size_t stride_a,
+                          std::size_t nb, std::size_t stride_b) {
+  auto a = make_set<T, Compare>(na, stride_a, 3);
+  auto b = make_set<T, Compare>(nb, stride_b, 0);
+  const auto sa = to_std(a);
+  const auto sb = to_std(b);
+  const Compare comp;
+
+  std::vector<T> expected;
+  std::set_intersection(sa.begin(), sa.end(), sb.begin(), sb.end(),
+                        std::back_inserter(expected), comp);
+  auto intersection = a.try_set_intersection(b);
+  ASSERT_TRUE(intersection.has_value());
+  EXPECT_EQ(to_std(*intersection), expected);
+
+  expected.clear();
+  std::set_union(sa.begin(), sa.end(), sb.begin(), sb.end(),
+                 std::back_inserter(expected), comp);
+  auto united = reloco::try_set_union(a, b);
+  ASSERT_TRUE(united.has_value());
+  EXPECT_EQ(to_std(*united), expected);
+
+  expected.clear();
+  std::set_difference(sa.begin(), sa.end(), sb.begin(), sb.end(),
+                      std::back_inserter(expected), comp);
+  auto difference = a.try_set_difference(b);
+  ASSERT_TRUE(difference.has_value());
+  EXPECT_EQ(to_std(*difference), expected);
+
+  expected.clear();
+  std::set_difference(sb.begin(), sb.end(), sa.begin(), sa.end(),
+                      std::back_inserter(expected), comp);
+  auto reverse_difference = b.try_set_difference(a);
+  ASSERT_TRUE(reverse_difference.has_value());
+  EXPECT_EQ(to_std(*reverse_difference), expected);
+}
+
+} // namespace
+
+TEST(FlatSetTest, SetOperationsOnBalancedInputs) {
+  // 32-bit keys take the block intersection, 64-bit keys the scalar merge
+  check_set_operations<std::uint32_t>(1000, 3, 1200, 2);
+  check_set_operations<std::int32_t>(257, 1, 263, 1);
+  check_set_operations<std::uint64_t>(1000, 3, 1200, 2);
+  check_set_operations<int, std::greater<int>>(500, 5, 700, 3);
+}
+
+TEST(FlatSetTest, SetOperationsOnSkewedInputs) {
+  check_set_operations<std::uint32_t>(10, 97, 5000, 1);
+  check_set_operations<std::uint32_t>(5000, 1, 10, 97);
+  check_set_operations<std::uint64_t>(3, 1000, 4000, 1);
+}
+
+TEST(FlatSetTest, SetOperationsWithEmptyInputs) {
+  check_set_operations<std::uint32_t>(0, 1, 100, 1);
+  check_set_operations<std::uint32_t>(100, 1, 0, 1);
+  check_set_operations<std::uint32_t>(0, 1, 0, 1);
+}
+
+TEST(FlatSetTest, SetOperationsReserveOnce) {
+  auto a = make_set<std::uint32_t>(300, 2, 0);
+  auto b = make_set<std::uint32_t>(200, 3, 0);
+  auto united = a.try_set_union(b);
+  ASSERT_TRUE(united.has_value());
+  EXPECT_EQ(united->as_span().size(), 400u);
+
+  reloco::vector<std::uint32_t> out;
+  ASSERT_TRUE(reloco::try_set_intersection(a.as_span(), b.as_span(), out)
+                  .has_value());
+  EXPECT_EQ(out.size(), 100u);
+  EXPECT_EQ(out.capacity(), 200u);
+}
+
+TEST(FlatSetTest, CloneKeepsElements) {
+  auto set = make_set<int>(10, 1, 0);
+  auto clone = set.try_clone();
+  ASSERT_TRUE(clone.has_value());
+  EXPECT_EQ(to_std(*clone), to_std(set));
+}
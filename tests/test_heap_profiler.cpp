@@ -0,0 +1,250 @@
+#include "counting_allocator.hpp"
+#include <gtest/gtest.h>
+#include <reloco/heap_profiler.hpp>
+#if __has_include(<boost/intrusive/set.hpp>)
+#include <reloco/map.hpp>
+#define RELOCO_TEST_HAS_MAP 1
+#else
+#define RELOCO_TEST_HAS_MAP 0
+#endif
+#include <reloco/stack_allocator.hpp>
+#include <reloco/vector.hpp>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t block_size = 4096;
+
+// With a one-byte interval the countdown never reaches past a block this
+// big, so every block is sampled
+reloco::heap_profiler_options sample_everything(std::size_t max_live = 64) {
+  reloco::heap_profiler_options opts;
+  opts.sample_interval = 1;
+  opts.max_live_samples = max_live;
+  return opts;
+}
+
+std::size_t count_lines(std::string_view text) {
+  std::size_t lines = 0;
+  for (const char c : text)
+    lines += c == '\n';
+  return lines;
+}
+
+} // namespace
+
+TEST(HeapProfilerTest, ForwardsWithoutSamplingUntilStarted) {
+  reloco::test::counting_allocator upstream;
+  reloco::heap_profiler profiler(upstream);
+
+  auto block = profiler.allocate(block_size, 16);
+  ASSERT_TRUE(block);
+  EXPECT_EQ(upstream.counts().allocations, 1u);
+  EXPECT_FALSE(profiler.sampling());
+  EXPECT_EQ(profiler.live_samples(), 0u);
+  profiler.deallocate(block->ptr, block_size);
+  EXPECT_EQ(upstream.counts().deallocations, 1u);
+}
+
+TEST(HeapProfilerTest, TracksSampledBlocksUntilFreed) {
+  reloco::heap_profiler profiler(reloco::get_default_allocator());
+  ASSERT_TRUE(profiler.try_start(sample_everything()));
+
+  void *blocks[10];
+  for (auto &b : blocks)
+    b = profiler.allocate(block_size, 16).value().ptr;
+  EXPECT_EQ(profiler.live_samples(), 10u);
+
+  auto snapshot = profiler.try_snapshot();
+  ASSERT_TRUE(snapshot);
+  ASSERT_EQ(snapshot->size(), 10u);
+  for (const auto &sample : *snapshot) {
+    EXPECT_EQ(sample.size, block_size);
+    EXPECT_EQ(sample.interval, 1u);
+#if defined(__GLIBC__) || defined(_WIN32)
+    EXPECT_GT(sample.depth, 0u);
+#endif
+  }
+
+  for (std::size_t i = 0; i < 5; ++i)
+    profiler.deallocate(blocks[i], block_size);
+  EXPECT_EQ(profiler.live_samples(), 5u);
+  for (std::size_t i = 5; i < 10; ++i)
+    profiler.deallocate(blocks[i], block_size);
+  EXPECT_EQ(profiler.live_samples(), 0u);
+}
+
+TEST(HeapProfilerTest, StoppedProfilerKeepsTrackingFrees) {
+  reloco::heap_profiler profiler(reloco::get_default_allocator());
+  ASSERT_TRUE(profiler.try_start(sample_everything()));
+  void *sampled = profiler.allocate(block_size, 16).value().ptr;
+
+  profiler.stop();
+  void *unsampled = profiler.allocate(block_size, 16).value().ptr;
+  EXPECT_EQ(profiler.live_samples(), 1u);
+
+  profiler.deallocate(unsampled, block_size);
+  EXPECT_EQ(profiler.live_samples(), 1u);
+  profiler.deallocate(sampled, block_size);
+  EXPECT_EQ(profiler.live_samples(), 0u);
+}
+
+TEST(HeapProfilerTest, ReallocateMovesTheSample) {
+  reloco::heap_profiler profiler(reloco::get_default_allocator());
+  ASSERT_TRUE(profiler.try_start(sample_everything()));
+
+  auto block = profiler.allocate(block_size, 16);
+  ASSERT_TRUE(block);
+  auto grown = profiler.reallocate(block->ptr, block_size, 4 * block_size, 16);
+  ASSERT_TRUE(grown);
+  EXPECT_EQ(profiler.live_samples(), 1u);
+
+  auto snapshot = profiler.try_snapshot();
+  ASSERT_TRUE(snapshot);
+  ASSERT_EQ(snapshot->size(), 1u);
+  EXPECT_EQ((*snapshot)[0].size, 4 * block_size);
+
+  profiler.deallocate(grown->ptr, 4 * block_size);
+  EXPECT_EQ(profiler.live_samples(), 0u);
+}
+
+TEST(HeapProfilerTest, DropsSamplesPastTheLimit) {
+  reloco::heap_profiler profiler(reloco::get_default_allocator());
+  ASSERT_TRUE(profiler.try_start(sample_everything(4)));
+
+  void *blocks[8];
+  for (auto &b : blocks)
+    b = profiler.allocate(block_size, 16).value().ptr;
+  EXPECT_EQ(profiler.live_samples(), 4u);
+  EXPECT_EQ(profiler.dropped_samples(), 4u);
+
+  for (auto *b : blocks)
+    profiler.deallocate(b, block_size);
+  EXPECT_EQ(profiler.live_samples(), 0u);
+}
+
+TEST(HeapProfilerTest, EstimatesLiveBytesFromSamples) {
+  reloco::heap_profiler profiler(reloco::get_default_allocator());
+  reloco::heap_profiler_options opts;
+  opts.sample_interval = 64 * 1024;
+  opts.max_live_samples = 1024;
+  ASSERT_TRUE(profiler.try_start(opts));
+
+  // 16 MiB in 1 KiB blocks: about 256 samples
+  constexpr std::size_t count = 16 * 1024;
+  constexpr std::size_t size = 1024;
+  auto blocks = reloco::vector<void *>::try_create(count);
+  ASSERT_TRUE(blocks);
+  for (std::size_t i = 0; i < count; ++i)
+    ASSERT_TRUE(blocks->try_push_back(profiler.allocate(size, 16).value().ptr));
+
+  auto snapshot = profiler.try_snapshot();
+  ASSERT_TRUE(snapshot);
+  double estimate = 0;
+  for (const auto &sample : *snapshot)
+    estimate += sample.estimated_bytes();
+  EXPECT_NEAR(estimate, double(count * size), 0.3 * double(count * size));
+
+  for (auto *b : *blocks)
+    profiler.deallocate(b, size);
+  EXPECT_EQ(profiler.live_samples(), 0u);
+}
+
+TEST(HeapProfilerTest, BookkeepingComesFromUpstream) {
+  reloco::test::counting_allocator upstream;
+  reloco::heap_profiler profiler(upstream);
+  ASSERT_TRUE(profiler.try_start(sample_everything()));
+  const auto before = upstream.counts().allocations;
+
+  void *block = profiler.allocate(block_size, 16).value().ptr;
+  // The block itself, plus this thread's countdown on first use
+  EXPECT_EQ(upstream.counts().allocations, before + 2);
+  profiler.deallocate(block, block_size);
+}
+
+TEST(HeapProfilerTest, WritesFoldedStacks) {
+  reloco::heap_profiler profiler(reloco::get_default_allocator());
+  ASSERT_TRUE(profiler.try_start(sample_everything()));
+  void *blocks[3];
+  for (auto &b : blocks)
+    b = profiler.allocate(block_size, 16).value().ptr;
+
+  reloco::string out;
+  ASSERT_TRUE(profiler.try_write_folded(out));
+  const std::string_view text(out.unsafe_c_str(), out.size());
+  EXPECT_EQ(count_lines(text), 3u);
+  // Each line ends in the bytes the sample stands for
+  EXPECT_NE(text.find(" 4096\n"), std::string_view::npos);
+
+  for (auto *b : blocks)
+    profiler.deallocate(b, block_size);
+}
+
+TEST(HeapProfilerTest, WritesLegacyPprofHeapProfile) {
+  reloco::heap_profiler profiler(reloco::get_default_allocator());
+  ASSERT_TRUE(profiler.try_start(sample_everything()));
+  void *blocks[2];
+  for (auto &b : blocks)
+    b = profiler.allocate(block_size, 16).value().ptr;
+
+  reloco::string out;
+  ASSERT_TRUE(profiler.try_write_pprof(out));
+  const std::string_view text(out.unsafe_c_str(), out.size());
+  EXPECT_EQ(text.rfind("heap profile: 2: 8192 [2: 8192] @ heap_v2/1\n", 0),
+            0u);
+  EXPECT_NE(text.find(" 1: 4096 [1: 4096] @"), std::string_view::npos);
+#if defined(__linux__)
+  EXPECT_NE(text.find("\nMAPPED_LIBRARIES:\n"), std::string_view::npos);
+#endif
+
+  for (auto *b : blocks)
+    profiler.deallocate(b, block_size);
+}
+
+TEST(HeapProfilerTest, InstallsAsTheDefaultAllocator) {
+  reloco::heap_profiler profiler(reloco::get_default_allocator());
+  ASSERT_TRUE(profiler.try_start(sample_everything()));
+  {
+    reloco::scoped_default_allocator installed(profiler);
+    EXPECT_EQ(&reloco::get_default_allocator(), &profiler);
+    EXPECT_EQ(&installed.previous(), &reloco::get_core_allocator());
+
+    reloco::vector<std::byte> v;
+    ASSERT_TRUE(v.try_reserve(block_size));
+    EXPECT_EQ(profiler.live_samples(), 1u);
+  }
+  EXPECT_EQ(&reloco::get_default_allocator(), &reloco::get_core_allocator());
+  EXPECT_EQ(profiler.live_samples(), 0u);
+}
+
+TEST(HeapProfilerTest, SeesFreesOverAnArena) {
+  // Room for the map's nodes and for the profiler's own tables
+  std::vector<std::byte> arena(1024 * 1024);
+  reloco::stack_allocator upstream(arena.data(), arena.size());
+  ASSERT_TRUE(upstream.frees_are_noops());
+  reloco::heap_profiler profiler(upstream);
+  EXPECT_FALSE(profiler.frees_are_noops());
+
+#if RELOCO_TEST_HAS_MAP
+  ASSERT_TRUE(profiler.try_start(sample_everything()));
+  {
+    // map skips node frees when told they are no-ops, which would leave
+    // every sample live
+    reloco::map<int, int> m(profiler);
+    for (int i = 0; i < 3; ++i)
+      ASSERT_TRUE(m.try_insert(int{i}, int{i}));
+    EXPECT_EQ(profiler.live_samples(), 3u);
+  }
+  EXPECT_EQ(profiler.live_samples(), 0u);
+#endif
+}
+
+TEST(HeapProfilerTest, RejectsZeroInterval) {
+  reloco::heap_profiler profiler(reloco::get_default_allocator());
+  reloco::heap_profiler_options opts;
+  opts.sample_interval = 0;
+  auto res = profiler.try_start(opts);
+  ASSERT_FALSE(res);
+  EXPECT_EQ(res.error(), reloco::error::invalid_argument);
+}
@@ -0,0 +1,183 @@
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <reloco/init_registry.hpp>
+#include <reloco/latch.hpp>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+// Records the order initializers ran in
+struct trace {
+  std::mutex lock;
+  std::vector<std::string> order;
+
+  auto step(const char *name, reloco::result<void> outcome = {}) {
+    return [this, name, outcome]() -> reloco::result<void> {
+      std::lock_guard<std::mutex> guard(lock);
+      order.emplace_back(name);
+      return outcome;
+    };
+  }
+
+  std::size_t position(const char *name) {
+    for (std::size_t i = 0; i < order.size(); ++i) {
+      if (order[i] == name)
+        return i;
+    }
+    return order.size();
+  }
+};
+
+class ConfigService {
+public:
+  using reloco_fallible_t = void;
+  static inline int init_calls = 0;
+
+  ConfigService(reloco::detail::constructor_key<ConfigService>) {}
+  reloco::result<void> try_init(reloco::detail::constructor_key<ConfigService>) {
+    ++init_calls;
+    return {};
+  }
+};
+
+} // namespace
+
+TEST(InitRegistryTest, DuplicateNameIsRejected) {
+  reloco::init_registry registry;
+  trace t;
+  ASSERT_TRUE(registry.try_add("a", t.step("a")).has_value());
+  auto res = registry.try_add("a", t.step("a"));
+  ASSERT_FALSE(res.has_value());
+  EXPECT_EQ(res.error(), reloco::error::already_exists);
+}
+
+TEST(InitRegistryTest, SerialRunRespectsDependencies) {
+  reloco::init_registry registry;
+  trace t;
+  // Registered before their dependencies on purpose
+  ASSERT_TRUE(registry.try_add("app", t.step("app"), {"db", "cache"}));
+  ASSERT_TRUE(registry.try_add("db", t.step("db"), {"config"}));
+  ASSERT_TRUE(registry.try_add("cache", t.step("cache"), {"config"}));
+  ASSERT_TRUE(registry.try_add("config", t.step("config")));
+
+  ASSERT_TRUE(registry.try_run().has_value());
+  ASSERT_EQ(t.order.size(), 4u);
+  EXPECT_EQ(t.order.front(), "config");
+  EXPECT_EQ(t.order.back(), "app");
+}
+
+TEST(InitRegistryTest, ParallelRunRespectsDependencies) {
+  reloco::thread_pool pool;
+  ASSERT_TRUE(pool.try_start(4).has_value());
+
+  reloco::init_registry registry;
+  trace t;
+  ASSERT_TRUE(registry.try_add("config", t.step("config")));
+  ASSERT_TRUE(registry.try_add("log", t.step("log"), {"config"}));
+  ASSERT_TRUE(registry.try_add("db", t.step("db"), {"config", "log"}));
+  ASSERT_TRUE(registry.try_add("cache", t.step("cache"), {"config"}));
+  ASSERT_TRUE(registry.try_add("metrics", t.step("metrics")));
+  ASSERT_TRUE(registry.try_add("app", t.step("app"), {"db", "cache"}));
+
+  ASSERT_TRUE(registry.try_run(pool).has_value());
+  ASSERT_EQ(t.order.size(), 6u);
+  EXPECT_LT(t.position("config"), t.position("log"));
+  EXPECT_LT(t.position("log"), t.position("db"));
+  EXPECT_LT(t.position("cache"), t.position("app"));
+  EXPECT_LT(t.position("db"), t.position("app"));
+
+  for (const auto &entry : registry.report())
+    EXPECT_EQ(entry.status, reloco::init_status::succeeded);
+}
+
+TEST(InitRegistryTest, IndependentServicesOverlap) {
+  reloco::thread_pool pool;
+  ASSERT_TRUE(pool.try_start(4).has_value());
+
+  // Each service waits for all four to have started, which can only happen
+  // if they run at the same time; run one by one, the first times out
+  reloco::latch all_started(4);
+  reloco::init_registry registry;
+  auto meet = [&]() -> reloco::result<void> {
+    RELOCO_TRY(all_started.count_down());
+    return all_started.wait_for(10s);
+  };
+  ASSERT_TRUE(registry.try_add("a", meet));
+  ASSERT_TRUE(registry.try_add("b", meet));
+  ASSERT_TRUE(registry.try_add("c", meet));
+  ASSERT_TRUE(registry.try_add("d", meet));
+
+  ASSERT_TRUE(registry.try_run(pool).has_value());
+  for (const auto &entry : registry.report())
+    EXPECT_EQ(entry.status, reloco::init_status::succeeded);
+}
+
+TEST(InitRegistryTest, FirstFailureStopsDependents) {
+  reloco::thread_pool pool;
+  ASSERT_TRUE(pool.try_start(2).has_value());
+
+  reloco::init_registry registry;
+  trace t;
+  ASSERT_TRUE(registry.try_add("config", t.step("config")));
+  ASSERT_TRUE(registry.try_add(
+      "db", t.step("db", reloco::unexpected(reloco::error::timed_out)),
+      {"config"}));
+  ASSERT_TRUE(registry.try_add("app", t.step("app"), {"db"}));
+
+  auto res = registry.try_run(pool);
+  ASSERT_FALSE(res.has_value());
+  EXPECT_EQ(res.error().service, "db");
+  EXPECT_EQ(res.error().code, reloco::error::timed_out);
+  EXPECT_EQ(t.position("app"), t.order.size());
+
+  auto report = registry.report();
+  ASSERT_EQ(report.size(), 3u);
+  EXPECT_EQ(report[0].status, reloco::init_status::succeeded);
+  EXPECT_EQ(report[1].status, reloco::init_status::failed);
+  EXPECT_EQ(report[2].status, reloco::init_status::not_run);
+}
+
+TEST(InitRegistryTest, CycleIsReported) {
+  reloco::init_registry registry;
+  trace t;
+  ASSERT_TRUE(registry.try_add("root", t.step("root")));
+  ASSERT_TRUE(registry.try_add("a", t.step("a"), {"root", "b"}));
+  ASSERT_TRUE(registry.try_add("b", t.step("b"), {"a"}));
+
+  auto res = registry.try_run();
+  ASSERT_FALSE(res.has_value());
+  EXPECT_EQ(res.error().code, reloco::error::deadlock);
+  EXPECT_EQ(res.error().service, "a");
+  EXPECT_TRUE(t.order.empty());
+}
+
+TEST(InitRegistryTest, UnknownDependencyIsReported) {
+  reloco::init_registry registry;
+  trace t;
+  ASSERT_TRUE(registry.try_add("a", t.step("a"), {"missing"}));
+
+  auto res = registry.try_run();
+  ASSERT_FALSE(res.has_value());
+  EXPECT_EQ(res.error().code, reloco::error::not_found);
+  EXPECT_EQ(res.error().service, "a");
+}
+
+TEST(InitRegistryTest, StaticStorageAndReport) {
+  static reloco::static_fallible_constructed<ConfigService> config;
+  reloco::init_registry registry;
+  ASSERT_TRUE(registry.try_add("config", config));
+  ASSERT_TRUE(registry.try_run().has_value());
+  EXPECT_TRUE(static_cast<bool>(config));
+  EXPECT_EQ(ConfigService::init_calls, 1);
+
+  reloco::string out;
+  ASSERT_TRUE(registry.try_format_report(out).has_value());
+  const std::string_view text(out.unsafe_c_str());
+  EXPECT_NE(text.find("config"), std::string_view::npos);
+  EXPECT_NE(text.find("ok"), std::string_view::npos);
+  EXPECT_NE(text.find("total"), std::string_view::npos);
+}
@@ -0,0 +1,303 @@
+#ifndef _WIN32
+#include <coroutine>
+#include <cstdlib>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <reloco/io_uring.hpp>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Temporary file holding a known pattern, removed on destruction.
+ */
+class temp_file {
+  std::string m_path;
+  int m_fd = -1;
+
+public:
+  explicit temp_file(const std::size_t size) {
+    char name[] = "/tmp/reloco_ring_XXXXXX";
+    m_fd = ::mkstemp(name);
+    EXPECT_GE(m_fd, 0);
+    m_path = name;
+    std::vector<char> contents(size);
+    for (std::size_t i = 0; i < size; ++i)
+      contents[i] = expected_at(i);
+    EXPECT_EQ(::write(m_fd, contents.data(), size),
+              static_cast<ssize_t>(size));
+  }
+  ~temp_file() {
+    ::close(m_fd);
+    ::unlink(m_path.c_str());
+  }
+
+  static char expected_at(std::size_t offset) {
+    return static_cast<char>(offset * 31 % 251);
+  }
+
+  int fd() const { return m_fd; }
+};
+
+/**
+ * @brief Runs ``check`` against io_uring (where available) and the thread
+ * pool fallback.
+ */
+template <typename F> void for_each_backend(F &&check) {
+  for (bool force_fallback : {false, true}) {
+    reloco::io_ring ring;
+    reloco::io_ring_options opts;
+    opts.queue_depth = 64;
+    opts.force_fallback = force_fallback;
+    ASSERT_TRUE(ring.try_init(opts).has_value());
+    if (force_fallback) {
+      EXPECT_EQ(ring.backend(), reloco::io_backend::thread_pool);
+    }
+    SCOPED_TRACE(ring.backend() == reloco::io_backend::io_uring
+                     ? "io_uring"
+                     : "thread_pool");
+    check(ring);
+  }
+}
+
+bool matches_file(const std::byte *data, std::size_t length,
+                  std::size_t offset) {
+  for (std::size_t i = 0; i < length; ++i)
+    if (static_cast<char>(data[i]) != temp_file::expected_at(offset + i))
+      return false;
+  return true;
+}
+
+/**
+ * @brief Coroutine that starts eagerly and is never awaited.
+ */
+struct detached {
+  struct promise_type {
+    detached get_return_object() noexcept { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { std::abort(); }
+  };
+};
+
+detached read_two_blocks(reloco::io_ring &ring, int fd, std::byte *out,
+                         std::size_t &total, bool &done) {
+  auto first =
+      co_await ring.async_read(fd, reloco::span<std::byte>(out, 100), 0);
+  auto second = co_await ring.async_read(
+      fd, reloco::span<std::byte>(out + 100, 100), 5000);
+  total = first.value() + second.value();
+  done = true;
+}
+
+} // namespace
+
+TEST(IoRingTest, ManyReadsInFlight) {
+  temp_file file(1 << 20);
+  for_each_backend([&](reloco::io_ring &ring) {
+    constexpr std::size_t reads = 64;
+    constexpr std::size_t length = 512;
+    std::vector<std::byte> buffers(reads * length);
+    std::size_t completed = 0;
+    for (std::size_t i = 0; i < reads; ++i) {
+      const std::size_t offset = (i * 7919 * 4096 + i * 13) % (1 << 19);
+      std::byte *into = buffers.data() + i * length;
+      auto check = [&, into, offset](reloco::result<std::size_t> n) {
+        ASSERT_TRUE(n.has_value());
+        EXPECT_EQ(*n, length);
+        EXPECT_TRUE(matches_file(into, length, offset));
+        ++completed;
+      };
+      ASSERT_TRUE(ring.try_read(file.fd(),
+                                reloco::span<std::byte>(into, length), offset,
+                                check)
+                      .has_value());
+    }
+    EXPECT_EQ(ring.in_flight(), reads);
+    auto handled = ring.try_wait(reads);
+    ASSERT_TRUE(handled.has_value());
+    EXPECT_EQ(*handled, reads);
+    EXPECT_EQ(completed, reads);
+    EXPECT_EQ(ring.in_flight(), 0u);
+  });
+}
+
+TEST(IoRingTest, QueueDepthBoundsInFlight) {
+  temp_file file(4096);
+  reloco::io_ring ring;
+  reloco::io_ring_options opts;
+  opts.queue_depth = 2;
+  ASSERT_TRUE(ring.try_init(opts).has_value());
+
+  std::byte out[3][16];
+  auto ignore = [](reloco::result<std::size_t>) {};
+  ASSERT_TRUE(ring.try_read(file.fd(), reloco::span<std::byte>(out[0], 16), 0,
+                            ignore));
+  ASSERT_TRUE(ring.try_read(file.fd(), reloco::span<std::byte>(out[1], 16), 0,
+                            ignore));
+  auto full = ring.try_read(file.fd(), reloco::span<std::byte>(out[2], 16), 0,
+                            ignore);
+  ASSERT_FALSE(full.has_value());
+  EXPECT_EQ(full.error(), reloco::error::try_again);
+
+  ASSERT_TRUE(ring.try_wait(2).has_value());
+  EXPECT_TRUE(ring.try_read(file.fd(), reloco::span<std::byte>(out[2], 16), 0,
+                            ignore));
+}
+
+TEST(IoRingTest, RegisteredBuffers) {
+  temp_file file(64 * 1024);
+  for_each_backend([&](reloco::io_ring &ring) {
+    ASSERT_TRUE(ring.try_register_buffers(4, 8192).has_value());
+    EXPECT_EQ(ring.buffer_count(), 4u);
+    const auto last = ring.buffer(3);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(last.unsafe_data()) %
+                  reloco::io_ring::buffer_alignment,
+              0u);
+
+    for (std::size_t i = 0; i < 4; ++i)
+      ASSERT_TRUE(ring.try_read_fixed(file.fd(), i, 8192, i * 8192,
+                                      [](reloco::result<std::size_t> n) {
+                                        EXPECT_EQ(n.value(), 8192u);
+                                      })
+                      .has_value());
+    ASSERT_TRUE(ring.try_wait(4).has_value());
+    for (std::size_t i = 0; i < 4; ++i) {
+      const auto buffer = ring.buffer(i);
+      EXPECT_TRUE(matches_file(buffer.unsafe_data(), 8192, i * 8192));
+    }
+
+    auto ignore = [](reloco::result<std::size_t>) {};
+    EXPECT_EQ(ring.try_read_fixed(file.fd(), 4, 16, 0, ignore).error(),
+              reloco::error::out_of_bounds);
+    EXPECT_EQ(ring.try_read_fixed(file.fd(), 0, 8193, 0, ignore).error(),
+              reloco::error::out_of_bounds);
+  });
+}
+
+TEST(IoRingTest, WriteThenRead) {
+  temp_file file(0);
+  for_each_backend([&](reloco::io_ring &ring) {
+    const char text[] = "written asynchronously";
+    const auto *bytes = reinterpret_cast<const std::byte *>(text);
+    std::size_t written = 0;
+    ASSERT_TRUE(ring.try_write(file.fd(),
+                               reloco::span<const std::byte>(bytes, 22), 10,
+                               [&](reloco::result<std::size_t> n) {
+                                 written = n.value();
+                               })
+                    .has_value());
+    ASSERT_TRUE(ring.try_wait().has_value());
+    EXPECT_EQ(written, 22u);
+
+    char back[22] = {};
+    ASSERT_EQ(::pread(file.fd(), back, 22, 10), 22);
+    EXPECT_EQ(std::memcmp(back, text, 22), 0);
+  });
+}
+
+TEST(IoRingTest, ErrorsReachTheCallback) {
+  for_each_backend([&](reloco::io_ring &ring) {
+    std::byte out[8];
+    reloco::error seen{};
+    ASSERT_TRUE(ring.try_read(-1, reloco::span<std::byte>(out, 8), 0,
+                              [&](reloco::result<std::size_t> n) {
+                                ASSERT_FALSE(n.has_value());
+                                seen = n.error();
+                              })
+                    .has_value());
+    ASSERT_TRUE(ring.try_wait().has_value());
+    EXPECT_EQ(seen, reloco::error::invalid_argument);
+  });
+}
+
+TEST(IoRingTest, CoroutinesResumeOnCompletion) {
+  temp_file file(8192);
+  for_each_backend([&](reloco::io_ring &ring) {
+    std::byte out[200];
+    std::size_t total = 0;
+    bool done = false;
+    read_two_blocks(ring, file.fd(), out, total, done);
+    while (!done)
+      ASSERT_TRUE(ring.try_wait().has_value());
+    EXPECT_EQ(total, 200u);
+    EXPECT_TRUE(matches_file(out, 100, 0));
+    EXPECT_TRUE(matches_file(out + 100, 100, 5000));
+  });
+}
+
+TEST(IoRingTest, RequiresInit) {
+  reloco::io_ring ring;
+  std::byte out[8];
+  auto res = ring.try_read(0, reloco::span<std::byte>(out, 8), 0,
+                           [](reloco::result<std::size_t>) {});
+  ASSERT_FALSE(res.has_value());
+  EXPECT_EQ(res.error(), reloco::error::not_initialized);
+  EXPECT_EQ(ring.try_register_buffers(1, 64).error(),
+            reloco::error::not_initialized);
+
+  ASSERT_TRUE(ring.try_init().has_value());
+  EXPECT_EQ(ring.try_init().error(), reloco::error::already_exists);
+}
+
+TEST(IoRingTest, FailedInitLeavesRingUninitialized) {
+  reloco::io_ring ring;
+  reloco::io_ring_options opts;
+  opts.force_fallback = true;
+  opts.fallback_threads = 0;
+  auto res = ring.try_init(opts);
+  ASSERT_FALSE(res.has_value());
+  EXPECT_EQ(res.error(), reloco::error::invalid_argument);
+  EXPECT_EQ(ring.queue_depth(), 0u);
+  EXPECT_EQ(ring.in_flight(), 0u);
+
+  std::byte out[8];
+  EXPECT_EQ(ring.try_read(0, reloco::span<std::byte>(out, 8), 0,
+                          [](reloco::result<std::size_t>) {})
+                .error(),
+            reloco::error::not_initialized);
+
+  // Nothing was left half set up, so a second attempt starts clean
+  opts.fallback_threads = 1;
+  ASSERT_TRUE(ring.try_init(opts).has_value());
+  EXPECT_EQ(ring.in_flight(), 0u);
+}
+
+TEST(IoRingTest, RejectsLengthsPastFourGiB) {
+  for_each_backend([&](reloco::io_ring &ring) {
+    // Never dereferenced: the length is rejected before anything is queued
+    std::byte out[1];
+    const std::size_t too_long = std::size_t{1} << 32;
+    auto res = ring.try_read(0, reloco::span<std::byte>(out, too_long), 0,
+                             [](reloco::result<std::size_t>) {});
+    ASSERT_FALSE(res.has_value());
+    EXPECT_EQ(res.error(), reloco::error::invalid_argument);
+    EXPECT_EQ(ring.in_flight(), 0u);
+  });
+}
+
+TEST(IoRingTest, DestructorWaitsForPendingOperations) {
+  temp_file file(4096);
+  for (bool force_fallback : {false, true}) {
+    std::vector<std::byte> out(4096);
+    bool called = false;
+    {
+      reloco::io_ring ring;
+      reloco::io_ring_options opts;
+      opts.force_fallback = force_fallback;
+      ASSERT_TRUE(ring.try_init(opts).has_value());
+      ASSERT_TRUE(ring.try_read(file.fd(),
+                                reloco::span<std::byte>(out.data(), 4096), 0,
+                                [&](reloco::result<std::size_t>) {
+                                  called = true;
+                                })
+                      .has_value());
+    }
+    EXPECT_FALSE(called);
+  }
+}
+
+#endif
@@ -0,0 +1,178 @@
+#ifndef _WIN32
+#include <gtest/gtest.h>
+#include <reloco/iobuf.hpp>
+#include <reloco/stack_allocator.hpp>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+
+namespace {
+
+reloco::span<const std::byte> as_bytes(std::string_view text) {
+  return reloco::span<const std::byte>(
+      reinterpret_cast<const std::byte *>(text.data()), text.size());
+}
+
+std::string contents(const reloco::iobuf &buf) {
+  std::string out(buf.size(), '\0');
+  EXPECT_EQ(buf.copy_to(reloco::span<std::byte>(
+                reinterpret_cast<std::byte *>(out.data()), out.size())),
+            buf.size());
+  return out;
+}
+
+} // namespace
+
+TEST(IobufTest, AppendBorrowsWithoutCopying) {
+  const std::string_view payload = "payload bytes";
+  reloco::iobuf buf;
+  ASSERT_TRUE(buf.try_append(as_bytes(payload)).has_value());
+  ASSERT_TRUE(buf.try_append(reloco::span<const std::byte>()).has_value());
+  ASSERT_EQ(buf.segment_count(), 1u);
+  const auto seg = buf.segment(0);
+  EXPECT_EQ(reinterpret_cast<const char *>(seg.unsafe_data()), payload.data());
+  EXPECT_EQ(buf.size(), payload.size());
+}
+
+TEST(IobufTest, HeaderPrependedToBorrowedPayload) {
+  reloco::iobuf buf;
+  ASSERT_TRUE(buf.try_append(as_bytes("body")).has_value());
+  ASSERT_TRUE(buf.try_prepend_copy(as_bytes("len=4;")).has_value());
+  ASSERT_TRUE(buf.try_prepend(as_bytes("v1 ")).has_value());
+  EXPECT_EQ(buf.segment_count(), 3u);
+  EXPECT_EQ(contents(buf), "v1 len=4;body");
+}
+
+TEST(IobufTest, CopiesFillTheLastBlock) {
+  reloco::iobuf buf;
+  for (int i = 0; i < 100; ++i)
+    ASSERT_TRUE(buf.try_append_copy(as_bytes("0123456789")).has_value());
+  EXPECT_EQ(buf.segment_count(), 1u);
+  EXPECT_EQ(buf.size(), 1000u);
+
+  // A borrowed segment in between forces a fresh block
+  ASSERT_TRUE(buf.try_append(as_bytes("|")).has_value());
+  ASSERT_TRUE(buf.try_append_copy(as_bytes("tail")).has_value());
+  EXPECT_EQ(buf.segment_count(), 3u);
+  EXPECT_EQ(contents(buf).substr(995), "56789|tail");
+}
+
+TEST(IobufTest, SplitSharesTheStraddlingSegment) {
+  reloco::iobuf buf;
+  ASSERT_TRUE(buf.try_append(as_bytes("abc")).has_value());
+  ASSERT_TRUE(buf.try_append_copy(as_bytes("defgh")).has_value());
+  ASSERT_TRUE(buf.try_append(as_bytes("ij")).has_value());
+
+  auto head = buf.try_split(5);
+  ASSERT_TRUE(head.has_value());
+  EXPECT_EQ(contents(*head), "abcde");
+  EXPECT_EQ(contents(buf), "fghij");
+  EXPECT_EQ(head->segment_count(), 2u);
+  EXPECT_EQ(buf.segment_count(), 2u);
+  const auto head_tail = head->segment(1);
+  const auto rest_front = buf.segment(0);
+  EXPECT_EQ(head_tail.unsafe_data() + 2, rest_front.unsafe_data());
+
+  // The head's part of the block is followed by bytes it does not own
+  ASSERT_TRUE(head->try_append_copy(as_bytes("XY")).has_value());
+  EXPECT_EQ(contents(*head), "abcdeXY");
+  EXPECT_EQ(contents(buf), "fghij");
+
+  EXPECT_EQ(buf.try_split(6).error(), reloco::error::out_of_range);
+  auto all = buf.try_split(5);
+  ASSERT_TRUE(all.has_value());
+  EXPECT_TRUE(buf.empty());
+  EXPECT_EQ(buf.segment_count(), 0u);
+}
+
+TEST(IobufTest, ClonesShareBlocksButNotAppends) {
+  reloco::iobuf buf;
+  ASSERT_TRUE(buf.try_append_copy(as_bytes("shared")).has_value());
+  auto clone = buf.try_clone();
+  ASSERT_TRUE(clone.has_value());
+  const auto cloned = clone->segment(0);
+  const auto original = buf.segment(0);
+  EXPECT_EQ(cloned.unsafe_data(), original.unsafe_data());
+
+  ASSERT_TRUE(clone->try_append_copy(as_bytes("+clone")).has_value());
+  ASSERT_TRUE(buf.try_append_copy(as_bytes("+orig")).has_value());
+  EXPECT_EQ(contents(*clone), "shared+clone");
+  EXPECT_EQ(contents(buf), "shared+orig");
+  EXPECT_EQ(clone->segment_count(), 1u);
+  EXPECT_EQ(buf.segment_count(), 2u);
+}
+
+TEST(IobufTest, ChainsSpliceWithoutCopying) {
+  reloco::iobuf a;
+  reloco::iobuf b;
+  ASSERT_TRUE(a.try_append(as_bytes("middle")).has_value());
+  ASSERT_TRUE(b.try_append(as_bytes("end")).has_value());
+  ASSERT_TRUE(a.try_append(std::move(b)).has_value());
+  EXPECT_TRUE(b.empty());
+
+  reloco::iobuf front;
+  ASSERT_TRUE(front.try_append_copy(as_bytes("start-")).has_value());
+  ASSERT_TRUE(a.try_prepend(std::move(front)).has_value());
+  EXPECT_EQ(contents(a), "start-middleend");
+  EXPECT_EQ(a.segment_count(), 3u);
+}
+
+TEST(IobufTest, CoalesceFlattensTheChain) {
+  reloco::iobuf buf;
+  auto empty = buf.try_coalesce();
+  ASSERT_TRUE(empty.has_value());
+  EXPECT_TRUE(empty->empty());
+
+  ASSERT_TRUE(buf.try_append(as_bytes("one ")).has_value());
+  ASSERT_TRUE(buf.try_append_copy(as_bytes("two ")).has_value());
+  ASSERT_TRUE(buf.try_append(as_bytes("three")).has_value());
+  auto flat = buf.try_coalesce();
+  ASSERT_TRUE(flat.has_value());
+  EXPECT_EQ(buf.segment_count(), 1u);
+  EXPECT_EQ(std::string_view(
+                reinterpret_cast<const char *>(flat->unsafe_data()),
+                flat->size()),
+            "one two three");
+}
+
+TEST(IobufTest, WritevSendsEverySegment) {
+  int fds[2];
+  ASSERT_EQ(::pipe(fds), 0);
+  reloco::iobuf buf;
+  ASSERT_TRUE(buf.try_append(as_bytes("scatter ")).has_value());
+  ASSERT_TRUE(buf.try_append_copy(as_bytes("gather ")).has_value());
+  ASSERT_TRUE(buf.try_append(as_bytes("io")).has_value());
+
+  iovec vecs[2];
+  EXPECT_EQ(buf.to_iovecs(reloco::span<iovec>(vecs, 2)), 2u);
+  EXPECT_EQ(buf.to_iovecs(reloco::span<iovec>(vecs, 2), 2), 1u);
+
+  reloco::vector<iovec> all;
+  ASSERT_TRUE(buf.try_to_iovecs(all).has_value());
+  ASSERT_EQ(all.size(), 3u);
+  const ssize_t n = ::writev(fds[1], all.begin(), static_cast<int>(3));
+  ASSERT_EQ(n, static_cast<ssize_t>(buf.size()));
+
+  char back[32] = {};
+  ASSERT_EQ(::read(fds[0], back, sizeof(back)), n);
+  EXPECT_EQ(std::string_view(back, n), "scatter gather io");
+
+  // A partial write leaves the unsent suffix
+  ASSERT_TRUE(buf.try_trim_front(10).has_value());
+  EXPECT_EQ(contents(buf), "ther io");
+  ::close(fds[0]);
+  ::close(fds[1]);
+}
+
+TEST(IobufTest, BlocksComeFromTheAllocator) {
+  alignas(16) std::byte storage[256];
+  reloco::stack_allocator tiny(storage, sizeof(storage));
+  reloco::iobuf buf(tiny);
+  auto res = buf.try_append_copy(as_bytes("needs a default-sized block"));
+  ASSERT_FALSE(res.has_value());
+  EXPECT_EQ(res.error(), reloco::error::allocation_failed);
+  EXPECT_TRUE(buf.empty());
+  EXPECT_EQ(buf.segment_count(), 0u);
+}
+
+#endif
@@ -1,5 +1,21 @@
 #include <gtest/gtest.h>
 #include <reloco/map.hpp>
+#include <reloco/stack_allocator.hpp>
+#include <vector>
+
+namespace {
+
+// Arena that counts the deallocations it is asked to perform
+class counting_arena final : public reloco::stack_allocator {
+public:
+  using stack_allocator::stack_allocator;
+
+  void deallocate(void *, std::size_t) noexcept override { ++deallocations; }
+
+  int deallocations = 0;
+};
+
+} // namespace
 
 TEST(RelocoMapTest, RangeBasedLoop) {
   reloco::map<int, int> m;
@@ -33,3 +49,42 @@ TEST(RelocoMapTest, TryCloneSuccess) {
   EXPECT_EQ(clone_res->size(), 2);
   EXPECT_EQ((*clone_res->find(1)).value, 10);
 }
+
+TEST(RelocoMapTest, MergeMovesMissingKeys) {
+  reloco::map<int, int> a;
+  reloco::map<int, int> b;
+  ASSERT_TRUE(a.try_insert(1, 10));
+  ASSERT_TRUE(b.try_insert(1, 100));
+  ASSERT_TRUE(b.try_insert(2, 200));
+  ASSERT_TRUE(b.try_insert(3, 300));
+
+  a.merge(std::move(b));
+  EXPECT_EQ(a.size(), 3u);
+  EXPECT_EQ(a.find(1)->value, 10);
+  EXPECT_EQ(a.find(3)->value, 300);
+  ASSERT_EQ(b.size(), 1u);
+  EXPECT_EQ(b.begin()->value, 100);
+}
+
+TEST(RelocoMapTest, ClearOnArenaSkipsDeallocation) {
+  std::vector<std::byte> buffer(1 << 20);
+  counting_arena arena(buffer.data(), buffer.size());
+  ASSERT_TRUE(arena.frees_are_noops());
+
+  {
+    reloco::map<int, int> m(arena);
+    for (int i = 0; i < 1000; ++i)
+      ASSERT_TRUE(m.try_insert(i, i));
+    ASSERT_TRUE(m.try_erase(7));
+    EXPECT_EQ(arena.deallocations, 1);
+
+    m.clear();
+    EXPECT_TRUE(m.empty());
+    EXPECT_EQ(m.begin(), m.end());
+
+    // Still usable after the constant-time clear
+    ASSERT_TRUE(m.try_insert(42, 1));
+    EXPECT_EQ(m.size(), 1u);
+  }
+  EXPECT_EQ(arena.deallocations, 1);
+}
@@ -0,0 +1,100 @@
+#ifndef _WIN32
+#include <cstdio>
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <reloco/mapped_file.hpp>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * @brief Temporary file with the given contents, removed on destruction.
+ */
+class temp_file {
+  std::string m_path;
+
+public:
+  explicit temp_file(std::string_view contents) {
+    char name[] = "/tmp/reloco_mapped_XXXXXX";
+    const int fd = ::mkstemp(name);
+    EXPECT_GE(fd, 0);
+    m_path = name;
+    EXPECT_EQ(::write(fd, contents.data(), contents.size()),
+              static_cast<ssize_t>(contents.size()));
+    ::close(fd);
+  }
+  ~temp_file() { ::unlink(m_path.c_str()); }
+
+  const char *path() const { return m_path.c_str(); }
+};
+
+} // namespace
+
+TEST(MappedFileTest, MapsWholeFile) {
+  temp_file file("first line\nsecond line\n");
+  auto mapped = reloco::mapped_file::try_open(file.path());
+  ASSERT_TRUE(mapped.has_value());
+  EXPECT_EQ(mapped->size(), 23u);
+  EXPECT_EQ(mapped->text(), "first line\nsecond line\n");
+  const auto bytes = mapped->bytes();
+  EXPECT_EQ(bytes.size(), 23u);
+  EXPECT_EQ(static_cast<char>(bytes[11]), 's');
+}
+
+TEST(MappedFileTest, EmptyFileGivesEmptyMapping) {
+  temp_file file("");
+  auto mapped = reloco::mapped_file::try_open(file.path());
+  ASSERT_TRUE(mapped.has_value());
+  EXPECT_TRUE(mapped->empty());
+  EXPECT_TRUE(mapped->bytes().empty());
+  EXPECT_TRUE(mapped->text().empty());
+}
+
+TEST(MappedFileTest, MissingFileIsNotFound) {
+  auto mapped = reloco::mapped_file::try_open("/nonexistent/reloco/file");
+  ASSERT_FALSE(mapped.has_value());
+  EXPECT_EQ(mapped.error(), reloco::error::not_found);
+}
+
+TEST(MappedFileTest, PopulateAndHints) {
+  const std::string contents(3 * 4096 + 17, 'x');
+  temp_file file(contents);
+  reloco::mapped_file::options opts;
+  opts.populate = true;
+  opts.hint = reloco::usage_hint::sequential;
+  auto mapped = reloco::mapped_file::try_open(file.path(), opts);
+  ASSERT_TRUE(mapped.has_value());
+  EXPECT_EQ(mapped->text(), contents);
+
+  mapped->advise(reloco::usage_hint::huge_pages);
+  EXPECT_TRUE(
+      mapped->try_advise(5000, 100, reloco::usage_hint::will_need).has_value());
+  EXPECT_TRUE(
+      mapped->try_advise(0, contents.size(), reloco::usage_hint::random)
+          .has_value());
+  auto res = mapped->try_advise(5000, contents.size(),
+                                reloco::usage_hint::will_need);
+  ASSERT_FALSE(res.has_value());
+  EXPECT_EQ(res.error(), reloco::error::out_of_bounds);
+}
+
+TEST(MappedFileTest, OutlivesDescriptorAndMoves) {
+  temp_file file("payload");
+  auto fd = reloco::unique_fd::try_open(file.path(), O_RDONLY);
+  ASSERT_TRUE(fd.has_value());
+  auto mapped = reloco::mapped_file::try_map(fd->get());
+  ASSERT_TRUE(mapped.has_value());
+  fd->reset();
+
+  reloco::mapped_file moved(std::move(*mapped));
+  EXPECT_TRUE(mapped->empty());
+  EXPECT_EQ(moved.text(), "payload");
+
+  reloco::mapped_file assigned;
+  assigned = std::move(moved);
+  EXPECT_EQ(assigned.text(), "payload");
+}
+
+#endif
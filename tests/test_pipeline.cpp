@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include <reloco/pipeline.hpp>
+#include <string>
+
+namespace rp = reloco::pipeline;
+
+namespace {
+
+reloco::vector<int> iota(int count) {
+  reloco::vector<int> v;
+  for (int i = 0; i < count; ++i)
+    std::ignore = v.try_push_back(int{i});
+  return v;
+}
+
+template <typename Source>
+concept chunkable = requires(Source source) { source | rp::chunk<2>(); };
+
+} // namespace
+
+TEST(PipelineTest, FilterTransformTake) {
+  auto input = iota(100);
+  reloco::vector<long> out;
+
+  auto res = (rp::from(input) | rp::filter([](int v) { return v % 3 == 0; }) |
+              rp::transform([](int v) { return long{v} * 10; }) | rp::take(4))
+                 .try_collect_into(out);
+  ASSERT_TRUE(res.has_value());
+  ASSERT_EQ(out.size(), 4u);
+  EXPECT_EQ(out[0], 0);
+  EXPECT_EQ(out[1], 30);
+  EXPECT_EQ(out[3], 90);
+}
+
+TEST(PipelineTest, KnownSizeReservesExactly) {
+  auto input = iota(50);
+  reloco::vector<int> out;
+
+  auto pipeline = rp::from(input) |
+                  rp::transform([](int v) { return v + 1; }) | rp::take(20);
+  static_assert(decltype(pipeline)::sized);
+  ASSERT_TRUE(pipeline.try_collect_into(out).has_value());
+  EXPECT_EQ(out.size(), 20u);
+  EXPECT_EQ(out.capacity(), 20u);
+  EXPECT_EQ(out[19], 20);
+}
+
+TEST(PipelineTest, TransformErrorStopsAndRollsBack) {
+  auto input = iota(10);
+  reloco::vector<int> out;
+  std::ignore = out.try_push_back(-1);
+
+  int calls = 0;
+  auto res = (rp::from(input) |
+              rp::transform([&](int v) -> reloco::result<int> {
+                ++calls;
+                if (v == 5)
+                  return reloco::unexpected(reloco::error::invalid_argument);
+                return v;
+              }))
+                 .try_collect_into(out);
+  ASSERT_FALSE(res.has_value());
+  EXPECT_EQ(res.error(), reloco::error::invalid_argument);
+  EXPECT_EQ(calls, 6);
+  ASSERT_EQ(out.size(), 1u);
+  EXPECT_EQ(out[0], -1);
+}
+
+TEST(PipelineTest, ChunkGroupsElements) {
+  auto input = iota(7);
+  reloco::vector<int> sums;
+
+  auto res =
+      (rp::from(input) | rp::chunk<3>() |
+       rp::transform([](reloco::span<const int> chunk) {
+         int sum = 0;
+         for (std::size_t i = 0; i < chunk.size(); ++i)
+           sum += chunk.unsafe_at(i);
+         return sum;
+       }))
+          .try_collect_into(sums);
+  ASSERT_TRUE(res.has_value());
+  ASSERT_EQ(sums.size(), 3u);
+  EXPECT_EQ(sums[0], 0 + 1 + 2);
+  EXPECT_EQ(sums[1], 3 + 4 + 5);
+  EXPECT_EQ(sums[2], 6);
+}
+
+TEST(PipelineTest, ChunkRejectsElementsWhoseCopyCanThrow) {
+  static_assert(chunkable<rp::span_source<int>>);
+  // A throwing copy inside the noexcept buffer would terminate
+  static_assert(!chunkable<rp::span_source<std::string>>);
+  // Values produced by a stage are moved in, which cannot throw
+  std::string words[] = {"a", "b", "c"};
+  auto upper = rp::from(reloco::span<std::string>(words, 3)) |
+               rp::transform([](const std::string &w) { return w + w; });
+  static_assert(chunkable<decltype(upper)>);
+}
+
+TEST(PipelineTest, ZipStopsAtShorter) {
+  auto left = iota(5);
+  auto right = iota(3);
+  int dot = 0;
+
+  auto pipeline = rp::from(left) | rp::zip(right);
+  EXPECT_EQ(pipeline.try_count().value(), 3u);
+  auto res =
+      pipeline.try_for_each([&](std::pair<const int &, const int &> p) {
+        dot += p.first * p.second;
+      });
+  ASSERT_TRUE(res.has_value());
+  EXPECT_EQ(dot, 0 + 1 + 4);
+}
+
+TEST(PipelineTest, ForEachCanStopEarly) {
+  auto input = iota(10);
+  int seen = 0;
+  auto res = rp::from(input).try_for_each([&](int v) {
+    ++seen;
+    return v < 3;
+  });
+  ASSERT_TRUE(res.has_value());
+  EXPECT_EQ(seen, 4);
+}
+
+TEST(PipelineTest, SourcesFromViewsAndSpans) {
+  auto input = iota(6);
+  auto view = input.as_view();
+  auto odd = rp::from(view) | rp::filter([](int v) { return v % 2 == 1; });
+  auto count = odd.try_count();
+  ASSERT_TRUE(count.has_value());
+  EXPECT_EQ(*count, 3u);
+
+  reloco::span<int> window(input.begin() + 2, 3);
+  int sum = 0;
+  ASSERT_TRUE(
+      rp::from(window).try_for_each([&](int v) { sum += v; }).has_value());
+  EXPECT_EQ(sum, 2 + 3 + 4);
+}
@@ -73,3 +73,16 @@ TEST_F(PosixAllocatorTest, AdviseDoesNotCrash) {
 
   alloc.deallocate(block->ptr, 4096);
 }
+
+TEST_F(PosixAllocatorTest, AllocateZeroed) {
+  for (std::size_t alignment : {std::size_t{16}, std::size_t{64}}) {
+    auto block = alloc.allocate_zeroed(8192, alignment);
+    ASSERT_TRUE(block.has_value());
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(block->ptr) % alignment, 0u);
+
+    const auto *bytes = static_cast<const unsigned char *>(block->ptr);
+    for (std::size_t i = 0; i < 8192; ++i)
+      ASSERT_EQ(bytes[i], 0u);
+    alloc.deallocate(block->ptr, 8192);
+  }
+}
@@ -0,0 +1,176 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <limits>
+#include <reloco/radix_sort.hpp>
+#include <reloco/stack_allocator.hpp>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace {
+
+std::uint64_t next_random(std::uint64_t &state) {
+  // xorshift64*, deterministic across platforms
+  state ^= state >> 12;
+  state ^= state << 25;
+  state ^= state >> 27;
+  return state * 0x2545F4914F6CDD1DULL;
+}
+
+template <typename T> reloco::vector<T> random_values(std::size_t n) {
+  reloco::vector<T> values;
+  EXPECT_TRUE(values.try_reserve(n).has_value());
+  std::uint64_t state = 0x9E3779B97F4A7C15ULL;
+  for (std::size_t i = 0; i < n; ++i)
+    std::ignore = values.try_push_back(static_cast<T>(next_random(state)));
+  return values;
+}
+
+template <typename T> bool is_sorted(const reloco::vector<T> &values) {
+  return std::is_sorted(values.begin(), values.end());
+}
+
+} // namespace
+
+TEST(RadixSortTest, SortsUnsignedIntegers) {
+  for (std::size_t n : {0u, 1u, 10u, 63u, 64u, 1000u, 100000u}) {
+    auto values = random_values<std::uint64_t>(n);
+    ASSERT_TRUE(reloco::try_radix_sort(values).has_value());
+    EXPECT_EQ(values.size(), n);
+    EXPECT_TRUE(is_sorted(values)) << n;
+  }
+}
+
+TEST(RadixSortTest, SortsSignedIntegersNumerically) {
+  auto values = random_values<std::int32_t>(5000);
+  ASSERT_TRUE(values.try_push_back(std::numeric_limits<int>::min()));
+  ASSERT_TRUE(values.try_push_back(std::numeric_limits<int>::max()));
+  ASSERT_TRUE(reloco::try_radix_sort(values).has_value());
+  EXPECT_TRUE(is_sorted(values));
+  EXPECT_EQ(values.at(0), std::numeric_limits<int>::min());
+  EXPECT_EQ(values.at(values.size() - 1), std::numeric_limits<int>::max());
+}
+
+TEST(RadixSortTest, SortsFloatsNumerically) {
+  reloco::vector<double> values;
+  std::uint64_t state = 42;
+  for (int i = 0; i < 2000; ++i) {
+    const auto raw = static_cast<std::int64_t>(next_random(state) % 2000001);
+    ASSERT_TRUE(values.try_push_back(static_cast<double>(raw - 1000000) / 7));
+  }
+  ASSERT_TRUE(values.try_push_back(-std::numeric_limits<double>::infinity()));
+  ASSERT_TRUE(values.try_push_back(std::numeric_limits<double>::infinity()));
+  ASSERT_TRUE(values.try_push_back(-0.0));
+  ASSERT_TRUE(values.try_push_back(0.0));
+
+  ASSERT_TRUE(reloco::try_radix_sort(values).has_value());
+  EXPECT_TRUE(is_sorted(values));
+  EXPECT_TRUE(std::isinf(values.at(0)));
+  EXPECT_TRUE(std::isinf(values.at(values.size() - 1)));
+}
+
+TEST(RadixSortTest, KeyExtractorSortsStably) {
+  using entry = std::pair<std::uint32_t, std::uint32_t>;
+  static_assert(reloco::is_relocatable<entry>::value);
+
+  reloco::vector<entry> values;
+  std::uint64_t state = 7;
+  for (std::uint32_t i = 0; i < 3000; ++i)
+    ASSERT_TRUE(values.try_push_back(
+        entry{static_cast<std::uint32_t>(next_random(state) % 50), i}));
+
+  auto by_first = [](const entry &e) { return e.first; };
+  ASSERT_TRUE(reloco::try_radix_sort(values, by_first).has_value());
+  for (std::size_t i = 1; i < values.size(); ++i) {
+    const entry &prev = values.at(i - 1);
+    const entry &cur = values.at(i);
+    ASSERT_LE(prev.first, cur.first);
+    if (prev.first == cur.first) {
+      ASSERT_LT(prev.second, cur.second) << "order of equal keys changed";
+    }
+  }
+}
+
+TEST(RadixSortTest, ScratchComesFromTheAllocator) {
+  auto values = random_values<std::uint32_t>(1000);
+  auto original = values.try_clone().value();
+
+  alignas(16) std::byte buffer[256];
+  reloco::stack_allocator tiny(buffer, sizeof(buffer));
+  auto res = reloco::try_radix_sort(values, std::identity{}, tiny);
+  ASSERT_FALSE(res.has_value());
+  EXPECT_EQ(res.error(), reloco::error::allocation_failed);
+  EXPECT_TRUE(std::equal(values.begin(), values.end(), original.begin()));
+}
+
+TEST(RadixSortTest, ParallelMatchesSerial) {
+  reloco::thread_pool pool;
+  ASSERT_TRUE(pool.try_start(3).has_value());
+
+  auto values = random_values<std::int64_t>(300000);
+  auto expected = values.try_clone().value();
+  ASSERT_TRUE(reloco::try_radix_sort(expected).has_value());
+  ASSERT_TRUE(reloco::try_parallel_radix_sort(pool, values).has_value());
+  EXPECT_TRUE(std::equal(values.begin(), values.end(), expected.begin()));
+}
+
+TEST(RadixSortTest, ParallelWithoutWorkersRunsInline) {
+  reloco::thread_pool pool;
+  auto values = random_values<std::uint16_t>(100000);
+  ASSERT_TRUE(reloco::try_parallel_radix_sort(pool, values).has_value());
+  EXPECT_TRUE(is_sorted(values));
+}
+
+TEST(RadixSortTest, MsdSortsStrings) {
+  static constexpr std::string_view words[] = {
+      "banana", "apple", "", "app", "apricot", "band", "bandana", "b",
+      "zebra",  "a",     "ab", "abc", "cherry", "apple", "\xff", "apples"};
+
+  reloco::vector<std::string_view> values;
+  for (int repeat = 0; repeat < 20; ++repeat)
+    for (std::string_view word : words)
+      ASSERT_TRUE(values.try_push_back(std::string_view(word)));
+
+  ASSERT_TRUE(reloco::try_msd_radix_sort(values).has_value());
+  EXPECT_TRUE(is_sorted(values));
+  EXPECT_EQ(values.at(0), "");
+  EXPECT_EQ(values.at(values.size() - 1), "\xff");
+}
+
+TEST(RadixSortTest, MsdWithKeyExtractor) {
+  struct record {
+    std::string_view name;
+    int id;
+  };
+  record values[] = {{"delta", 0}, {"alpha", 1}, {"charlie", 2}, {"bravo", 3}};
+  auto by_name = [](const record &r) { return r.name; };
+  ASSERT_TRUE(reloco::try_msd_radix_sort(reloco::span<record>(values, 4),
+                                         by_name)
+                  .has_value());
+  EXPECT_EQ(values[0].id, 1);
+  EXPECT_EQ(values[1].id, 3);
+  EXPECT_EQ(values[2].id, 2);
+  EXPECT_EQ(values[3].id, 0);
+}
+
+TEST(RadixSortTest, MsdKeyMustNotReturnOwnedStrings) {
+  struct record {
+    std::string name;
+    int id;
+  };
+  // A string returned by value dies before the sort reads its bytes
+  auto by_copy = [](const record &r) { return r.name; };
+  static_assert(!reloco::string_sortable<record, decltype(by_copy)>);
+
+  auto by_ref = [](const record &r) -> const std::string & { return r.name; };
+  static_assert(reloco::string_sortable<record, decltype(by_ref)>);
+  record values[] = {{"delta", 0}, {"alpha", 1}, {"charlie", 2}};
+  ASSERT_TRUE(reloco::try_msd_radix_sort(reloco::span<record>(values, 3),
+                                         by_ref)
+                  .has_value());
+  EXPECT_EQ(values[0].id, 1);
+  EXPECT_EQ(values[1].id, 2);
+  EXPECT_EQ(values[2].id, 0);
+}
@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include <reloco/relocation.hpp>
+#include <reloco/string.hpp>
+#include <reloco/unique_ptr.hpp>
+#include <reloco/vector.hpp>
+
+namespace {
+
+struct particle {
+  reloco::unique_ptr<int> payload;
+  reloco::vector<int> neighbours;
+  double mass;
+  const int id;
+};
+
+// Keeps a pointer to itself, so it must never be moved bitwise
+struct pinned {
+  explicit pinned(int v) noexcept : value(v), self(this) {}
+  pinned(pinned &&other) noexcept : value(other.value), self(this) {
+    ++moves;
+  }
+  ~pinned() { ++destroyed; }
+
+  bool intact() const noexcept { return self == this; }
+
+  int value;
+  pinned *self;
+
+  static inline int moves = 0;
+  static inline int destroyed = 0;
+};
+
+struct holds_pinned {
+  int tag;
+  pinned inner;
+};
+
+struct empty_aggregate {};
+
+} // namespace
+
+RELOCO_RELOCATABLE_AGGREGATE(particle);
+
+static_assert(reloco::detail::aggregate_field_count<particle>() == 4);
+static_assert(reloco::detail::aggregate_field_count<empty_aggregate>() == 0);
+static_assert(!std::is_trivially_copyable_v<particle>);
+static_assert(reloco::is_relocatable<particle>::value);
+static_assert(!reloco::members_relocatable<holds_pinned>::value);
+static_assert(!reloco::is_relocatable<holds_pinned>::value);
+static_assert(reloco::members_relocatable<empty_aggregate>::value);
+
+class RelocationTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    pinned::moves = 0;
+    pinned::destroyed = 0;
+  }
+
+  // Raw storage for up to 8 pinned objects
+  alignas(pinned) std::byte storage[8 * sizeof(pinned)];
+  pinned *slots() noexcept { return reinterpret_cast<pinned *>(storage); }
+};
+
+TEST_F(RelocationTest, UninitializedRelocateMovesAndDestroys) {
+  alignas(pinned) std::byte target[3 * sizeof(pinned)];
+  pinned *src = slots();
+  for (int i = 0; i < 3; ++i)
+    new (src + i) pinned(i);
+
+  pinned *dest = reinterpret_cast<pinned *>(target);
+  EXPECT_EQ(reloco::uninitialized_relocate(src, src + 3, dest), dest + 3);
+  EXPECT_EQ(pinned::moves, 3);
+  EXPECT_EQ(pinned::destroyed, 3);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(dest[i].value, i);
+    EXPECT_TRUE(dest[i].intact());
+    dest[i].~pinned();
+  }
+}
+
+TEST_F(RelocationTest, RelocateNShiftsTowardsFront) {
+  pinned *p = slots();
+  for (int i = 1; i < 5; ++i)
+    new (p + i) pinned(i);
+
+  EXPECT_EQ(reloco::relocate_n(p + 1, 4, p), p + 4);
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(p[i].value, i + 1);
+    EXPECT_TRUE(p[i].intact());
+    p[i].~pinned();
+  }
+}
+
+TEST_F(RelocationTest, RelocateBackwardShiftsTowardsBack) {
+  pinned *p = slots();
+  for (int i = 0; i < 4; ++i)
+    new (p + i) pinned(i);
+
+  EXPECT_EQ(reloco::relocate_backward(p, p + 4, p + 6), p + 2);
+  for (int i = 2; i < 6; ++i) {
+    EXPECT_EQ(p[i].value, i - 2);
+    EXPECT_TRUE(p[i].intact());
+    p[i].~pinned();
+  }
+}
+
+TEST_F(RelocationTest, RelocatableRangesAreShiftedBitwise) {
+  int values[6] = {1, 2, 3, 4, 0, 0};
+  reloco::relocate_backward(values, values + 4, values + 6);
+  EXPECT_EQ(values[2], 1);
+  EXPECT_EQ(values[5], 4);
+  reloco::relocate_n(values + 2, 4, values);
+  EXPECT_EQ(values[0], 1);
+  EXPECT_EQ(values[3], 4);
+}
+
+TEST_F(RelocationTest, VectorOfPinnedKeepsObjectsIntact) {
+  reloco::vector<pinned> v;
+  for (int i = 0; i < 20; ++i)
+    ASSERT_TRUE(v.try_emplace_back(i).has_value());
+  ASSERT_TRUE(v.try_insert(5, 100).has_value());
+  ASSERT_TRUE(v.try_erase(0).has_value());
+
+  ASSERT_EQ(v.size(), 20u);
+  EXPECT_EQ(v[4].value, 100);
+  EXPECT_EQ(v[5].value, 5);
+  for (const pinned &p : v)
+    EXPECT_TRUE(p.intact());
+}
+
+TEST_F(RelocationTest, VectorOfRelocatableAggregate) {
+  reloco::vector<particle> v;
+  for (int i = 0; i < 20; ++i) {
+    auto payload = reloco::unique_ptr<int>::try_create(i);
+    ASSERT_TRUE(payload.has_value());
+    ASSERT_TRUE(
+        v.try_push_back(particle{std::move(*payload), {}, 1.0, i}).has_value());
+  }
+  ASSERT_TRUE(v.try_erase(3).has_value());
+
+  ASSERT_EQ(v.size(), 19u);
+  EXPECT_EQ(v[3].id, 4);
+  EXPECT_EQ(*v[3].payload, 4);
+  EXPECT_EQ(*v[18].payload, 19);
+}
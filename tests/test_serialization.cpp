@@ -0,0 +1,244 @@
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <reloco/map.hpp>
+#include <reloco/serialization.hpp>
+#include <string_view>
+
+namespace {
+
+struct point {
+  float x;
+  float y;
+};
+
+reloco::span<const std::byte> bytes_of(const reloco::vector<std::byte> &v) {
+  return reloco::span<const std::byte>(v.begin(), v.size());
+}
+
+reloco::string make_string(std::string_view text) {
+  return reloco::string::try_create(reloco::string_view(text)).value();
+}
+
+/**
+ * @brief Sink that records how many writes it received.
+ */
+struct recording_sink {
+  reloco::vector<std::byte> bytes;
+  std::size_t writes = 0;
+
+  reloco::result<void> try_write(reloco::span<const std::byte> chunk) {
+    ++writes;
+    return bytes.try_append(chunk);
+  }
+};
+
+struct failing_sink {
+  reloco::result<void> try_write(reloco::span<const std::byte>) {
+    return RELOCO_ERROR(reloco::error::allocation_failed);
+  }
+};
+
+} // namespace
+
+static_assert(reloco::serializable<int>);
+static_assert(reloco::serializable<reloco::vector<reloco::string>>);
+static_assert(reloco::serializable<reloco::map<int, reloco::vector<int>>>);
+static_assert(!reloco::serializable<int *>);
+static_assert(!reloco::serializable<reloco::vector<const char *>>);
+
+TEST(SerializationTest, TrivialValueRoundTrip) {
+  reloco::vector<std::byte> out;
+  ASSERT_TRUE(reloco::try_serialize(point{1.5f, -2.0f}, out).has_value());
+  EXPECT_EQ(out.size(), sizeof(point));
+
+  auto decoded = reloco::try_deserialize<point>(bytes_of(out));
+  ASSERT_TRUE(decoded.has_value());
+  EXPECT_EQ(decoded->x, 1.5f);
+  EXPECT_EQ(decoded->y, -2.0f);
+}
+
+TEST(SerializationTest, TrivialVectorDecodesToSpanIntoBuffer) {
+  reloco::vector<std::uint32_t> values;
+  for (std::uint32_t i = 0; i < 100; ++i)
+    ASSERT_TRUE(values.try_push_back(i * 3));
+
+  reloco::vector<std::byte> out;
+  ASSERT_TRUE(reloco::try_serialize(values, out).has_value());
+  EXPECT_EQ(out.size(), reloco::serialized_size(values));
+  EXPECT_EQ(out.capacity(), out.size()) << "expected a single reservation";
+
+  auto decoded = reloco::try_deserialize<decltype(values)>(bytes_of(out));
+  ASSERT_TRUE(decoded.has_value());
+  static_assert(std::is_same_v<decltype(decoded)::value_type,
+                               reloco::span<const std::uint32_t>>);
+  ASSERT_EQ(decoded->size(), values.size());
+  const auto *first = reinterpret_cast<const std::byte *>(
+      decoded->unsafe_data());
+  EXPECT_GE(first, out.begin());
+  EXPECT_LT(first, out.end());
+  for (std::size_t i = 0; i < values.size(); ++i)
+    EXPECT_EQ((*decoded)[i], values.at(i));
+}
+
+TEST(SerializationTest, TrivialPayloadIsWrittenInOneBlock) {
+  reloco::vector<double> values;
+  for (int i = 0; i < 1000; ++i)
+    ASSERT_TRUE(values.try_push_back(i * 0.5));
+
+  recording_sink sink;
+  ASSERT_TRUE(reloco::try_serialize(values, sink).has_value());
+  EXPECT_EQ(sink.writes, 2u); // count, then every element at once
+  EXPECT_EQ(sink.bytes.size(), reloco::serialized_size(values));
+}
+
+TEST(SerializationTest, StringsDecodeToStringViews) {
+  reloco::vector<reloco::string> words;
+  for (std::string_view w : {"alpha", "", "gamma ray", "d"})
+    ASSERT_TRUE(words.try_push_back(make_string(w)));
+
+  reloco::vector<std::byte> out;
+  ASSERT_TRUE(reloco::try_serialize(words, out).has_value());
+
+  auto decoded = reloco::try_deserialize<decltype(words)>(bytes_of(out));
+  ASSERT_TRUE(decoded.has_value());
+  ASSERT_EQ(decoded->size(), 4u);
+  EXPECT_EQ(decoded->try_at(0).value(), "alpha");
+  EXPECT_EQ(decoded->try_at(1).value(), "");
+  EXPECT_EQ(decoded->try_at(2).value(), "gamma ray");
+  EXPECT_EQ(decoded->try_at(3).value(), "d");
+  EXPECT_EQ(decoded->try_at(4).error(), reloco::error::out_of_bounds);
+
+  std::size_t total = 0;
+  ASSERT_TRUE(decoded
+                  ->try_for_each([&](reloco::string_view word) {
+                    total += word.size();
+                  })
+                  .has_value());
+  EXPECT_EQ(total, 15u);
+}
+
+TEST(SerializationTest, NestedContainers) {
+  reloco::vector<reloco::vector<std::int16_t>> rows;
+  for (int r = 0; r < 5; ++r) {
+    reloco::vector<std::int16_t> row;
+    for (int c = 0; c < r * 3; ++c)
+      ASSERT_TRUE(row.try_push_back(static_cast<std::int16_t>(r * 100 + c)));
+    ASSERT_TRUE(rows.try_push_back(std::move(row)));
+  }
+
+  reloco::vector<std::byte> out;
+  ASSERT_TRUE(reloco::try_serialize(rows, out).has_value());
+  auto decoded = reloco::try_deserialize<decltype(rows)>(bytes_of(out));
+  ASSERT_TRUE(decoded.has_value());
+  ASSERT_EQ(decoded->size(), 5u);
+  for (std::size_t r = 0; r < 5; ++r) {
+    auto row = decoded->try_at(r);
+    ASSERT_TRUE(row.has_value());
+    ASSERT_EQ(row->size(), r * 3);
+    for (std::size_t c = 0; c < row->size(); ++c)
+      EXPECT_EQ((*row)[c], static_cast<std::int16_t>(r * 100 + c));
+  }
+}
+
+TEST(SerializationTest, ArrayAndFlatSet) {
+  reloco::array<reloco::string, 2> pair = {make_string("left"),
+                                           make_string("right")};
+  reloco::vector<std::byte> out;
+  ASSERT_TRUE(reloco::try_serialize(pair, out).has_value());
+  auto strings = reloco::try_deserialize<decltype(pair)>(bytes_of(out));
+  ASSERT_TRUE(strings.has_value());
+  EXPECT_EQ(strings->try_at(1).value(), "right");
+
+  auto set = reloco::flat_set<int>::try_create().value();
+  for (int v : {9, 3, 7, 1})
+    ASSERT_TRUE(set.try_insert(int{v}));
+  reloco::vector<std::byte> set_out;
+  ASSERT_TRUE(reloco::try_serialize(set, set_out).has_value());
+  auto sorted = reloco::try_deserialize<decltype(set)>(bytes_of(set_out));
+  ASSERT_TRUE(sorted.has_value());
+  ASSERT_EQ(sorted->size(), 4u);
+  EXPECT_EQ((*sorted)[0], 1);
+  EXPECT_EQ((*sorted)[3], 9);
+
+  // An array of the wrong length does not decode
+  auto wrong = reloco::try_deserialize<reloco::array<int, 3>>(
+      bytes_of(set_out));
+  ASSERT_FALSE(wrong.has_value());
+  EXPECT_EQ(wrong.error(), reloco::error::invalid_format);
+}
+
+TEST(SerializationTest, MapLookupWithoutCopy) {
+  reloco::map<int, reloco::string> names;
+  for (int i = 0; i < 50; ++i)
+    ASSERT_TRUE(
+        names.try_insert(i * 2, make_string(std::to_string(i * 2))));
+
+  reloco::vector<std::byte> out;
+  ASSERT_TRUE(reloco::try_serialize(names, out).has_value());
+  auto decoded = reloco::try_deserialize<decltype(names)>(bytes_of(out));
+  ASSERT_TRUE(decoded.has_value());
+  ASSERT_EQ(decoded->size(), 50u);
+  EXPECT_EQ(decoded->try_key_at(3).value(), 6);
+  EXPECT_EQ(decoded->try_find(42).value(), "42");
+  EXPECT_EQ(decoded->try_find(43).error(), reloco::error::not_found);
+  EXPECT_EQ(decoded->try_find(1000).error(), reloco::error::not_found);
+}
+
+TEST(SerializationTest, TruncatedInputIsRejected) {
+  reloco::vector<reloco::string> words;
+  ASSERT_TRUE(words.try_push_back(make_string("truncate me")));
+  reloco::vector<std::byte> out;
+  ASSERT_TRUE(reloco::try_serialize(words, out).has_value());
+
+  for (std::size_t n = 0; n < out.size(); ++n) {
+    auto res = reloco::try_deserialize<decltype(words)>(
+        reloco::span<const std::byte>(out.begin(), n));
+    ASSERT_FALSE(res.has_value()) << n;
+    EXPECT_EQ(res.error(), reloco::error::invalid_format) << n;
+  }
+}
+
+TEST(SerializationTest, TrailingBytesAreRejected) {
+  reloco::vector<std::byte> out;
+  ASSERT_TRUE(reloco::try_serialize(std::uint64_t{7}, out).has_value());
+  ASSERT_TRUE(out.try_push_back(std::byte{0}));
+  auto res = reloco::try_deserialize<std::uint64_t>(bytes_of(out));
+  ASSERT_FALSE(res.has_value());
+  EXPECT_EQ(res.error(), reloco::error::invalid_format);
+}
+
+TEST(SerializationTest, CorruptOffsetFailsOnlyThatElement) {
+  reloco::vector<reloco::string> words;
+  ASSERT_TRUE(words.try_push_back(make_string("one")));
+  ASSERT_TRUE(words.try_push_back(make_string("two")));
+  reloco::vector<std::byte> out;
+  ASSERT_TRUE(reloco::try_serialize(words, out).has_value());
+
+  // Point the first table entry back into the header
+  const std::uint64_t bogus = 0;
+  std::memcpy(out.begin() + 16, &bogus, sizeof(bogus));
+  auto decoded = reloco::try_deserialize<decltype(words)>(bytes_of(out));
+  ASSERT_TRUE(decoded.has_value());
+  EXPECT_EQ(decoded->try_at(0).error(), reloco::error::invalid_format);
+  EXPECT_EQ(decoded->try_at(1).value(), "two");
+}
+
+TEST(SerializationTest, MisalignedInputIsRejected) {
+  reloco::vector<std::uint64_t> values;
+  ASSERT_TRUE(values.try_push_back(1));
+  reloco::vector<std::byte> out;
+  ASSERT_TRUE(out.try_push_back(std::byte{0}));
+  ASSERT_TRUE(reloco::try_serialize(values, out).has_value());
+
+  auto res = reloco::try_deserialize<decltype(values)>(
+      reloco::span<const std::byte>(out.begin() + 1, out.size() - 1));
+  ASSERT_FALSE(res.has_value());
+  EXPECT_EQ(res.error(), reloco::error::invalid_argument);
+}
+
+TEST(SerializationTest, SinkErrorsPropagate) {
+  failing_sink sink;
+  auto res = reloco::try_serialize(reloco::vector<int>{}, sink);
+  ASSERT_FALSE(res.has_value());
+  EXPECT_EQ(res.error(), reloco::error::allocation_failed);
+}
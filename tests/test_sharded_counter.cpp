@@ -0,0 +1,112 @@
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <memory>
+#include <reloco/cache_aligned.hpp>
+#include <reloco/sharded_counter.hpp>
+#include <reloco/statistics_allocator.hpp>
+#include <reloco/thread_specific.hpp>
+#include <thread>
+#include <vector>
+
+TEST(CacheAlignedTest, Layout) {
+  static_assert(alignof(reloco::cache_aligned<char>) ==
+                reloco::cache_line_size);
+  static_assert(sizeof(reloco::cache_aligned<char>) ==
+                reloco::cache_line_size);
+  static_assert(sizeof(reloco::cache_aligned<char[100]>) ==
+                2 * reloco::cache_line_size);
+
+  static_assert(alignof(reloco::padded<std::uint32_t>) ==
+                alignof(std::uint32_t));
+  static_assert(sizeof(reloco::padded<std::uint32_t>) ==
+                reloco::cache_line_size);
+  static_assert(sizeof(reloco::padded<char[reloco::cache_line_size]>) ==
+                reloco::cache_line_size);
+
+  reloco::cache_aligned<int> a{std::in_place, 42};
+  EXPECT_EQ(*a, 42);
+  reloco::padded<int> p{std::in_place, 7};
+  EXPECT_EQ(p.get(), 7);
+}
+
+TEST(EnumerableThreadSpecificTest, OneSlotPerThread) {
+  reloco::enumerable_thread_specific<int> ets;
+
+  auto mine = ets.try_local();
+  ASSERT_TRUE(mine.has_value());
+  **mine = 1;
+  // Second lookup hits the thread-local cache and returns the same slot
+  EXPECT_EQ(*ets.try_local(), *mine);
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&ets, i] {
+      auto local = ets.try_local();
+      ASSERT_TRUE(local.has_value());
+      **local = 10 * (i + 1);
+    });
+  }
+  for (auto &t : threads)
+    t.join();
+
+  EXPECT_EQ(ets.size(), 5u);
+  EXPECT_EQ(ets.combine(0, [](int a, int b) { return a + b; }), 101);
+}
+
+TEST(EnumerableThreadSpecificTest, InstancesDoNotAlias) {
+  // More instances than the thread-local cache has entries
+  constexpr int count = 40;
+  std::vector<std::unique_ptr<reloco::enumerable_thread_specific<int>>> all;
+  for (int i = 0; i < count; ++i) {
+    all.push_back(
+        std::make_unique<reloco::enumerable_thread_specific<int>>());
+    **all.back()->try_local() = i;
+  }
+  for (int i = 0; i < count; ++i) {
+    EXPECT_EQ(**all[i]->try_local(), i);
+    EXPECT_EQ(all[i]->size(), 1u);
+  }
+}
+
+TEST(ShardedCounterTest, ConcurrentIncrements) {
+  reloco::sharded_counter counter;
+  constexpr int thread_count = 4;
+  constexpr int iterations = 100000;
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < thread_count; ++t) {
+    threads.emplace_back([&] {
+      for (int i = 0; i < iterations; ++i)
+        counter.increment();
+    });
+  }
+  for (auto &t : threads)
+    t.join();
+
+  EXPECT_EQ(counter.read(), thread_count * iterations);
+  counter.sub(thread_count * iterations);
+  EXPECT_EQ(counter.read(), 0);
+}
+
+TEST(StatisticsAllocatorTest, CountsTraffic) {
+  reloco::statistics_allocator stats(reloco::get_default_allocator());
+
+  auto a = stats.allocate(100, 8);
+  auto b = stats.allocate(50, 8);
+  ASSERT_TRUE(a.has_value());
+  ASSERT_TRUE(b.has_value());
+
+  auto grown = stats.reallocate(a->ptr, 100, 300, 8);
+  ASSERT_TRUE(grown.has_value());
+  stats.deallocate(b->ptr, 50);
+
+  auto s = stats.statistics();
+  EXPECT_EQ(s.allocations, 2);
+  EXPECT_EQ(s.reallocations, 1);
+  EXPECT_EQ(s.deallocations, 1);
+  EXPECT_EQ(s.bytes_in_use, 300);
+  EXPECT_EQ(s.bytes_allocated, 350);
+
+  stats.deallocate(grown->ptr, 300);
+  EXPECT_EQ(stats.statistics().bytes_in_use, 0);
+}
@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <reloco/simd.hpp>
+#include <vector>
+
+namespace rs = reloco::simd;
+
+namespace {
+
+const rs::isa all_levels[] = {rs::isa::scalar, rs::isa::sse2, rs::isa::avx2,
+                              rs::isa::avx512};
+
+/**
+ * Runs ``check`` once per instruction set the CPU supports and restores the
+ * best one afterwards.
+ */
+template <typename F> void for_each_supported_isa(F &&check) {
+  for (rs::isa level : all_levels) {
+    if (!rs::try_select_isa(level).has_value())
+      continue;
+    SCOPED_TRACE(static_cast<int>(level));
+    check();
+  }
+  ASSERT_TRUE(rs::try_select_isa(rs::best_isa()).has_value());
+}
+
+template <typename T> std::vector<T> pattern(std::size_t n) {
+  std::vector<T> values(n);
+  for (std::size_t i = 0; i < n; ++i)
+    values[i] = static_cast<T>((i * 37 + 11) % 101);
+  return values;
+}
+
+// Every length up to a few 64-byte vectors hits each tail shape
+constexpr std::size_t max_length = 300;
+
+template <typename T> void check_against_scalar() {
+  for_each_supported_isa([] {
+    for (std::size_t n = 0; n <= max_length; n += 7) {
+      auto values = pattern<T>(n);
+      reloco::span<const T> s(values.data(), values.size());
+      const T needle = static_cast<T>(42);
+
+      const auto it = std::find(values.begin(), values.end(), needle);
+      const std::size_t expected_index =
+          it == values.end() ? rs::npos
+                             : static_cast<std::size_t>(it - values.begin());
+      EXPECT_EQ(rs::find(s, needle), expected_index);
+      EXPECT_EQ(rs::any_of_equal(s, needle), it != values.end());
+      EXPECT_EQ(rs::count(s, needle),
+                static_cast<std::size_t>(
+                    std::count(values.begin(), values.end(), needle)));
+      EXPECT_EQ(rs::sum(s), static_cast<T>(std::accumulate(
+                                values.begin(), values.end(), T{})));
+
+      if (n == 0) {
+        EXPECT_FALSE(rs::try_minmax(s).has_value());
+        continue;
+      }
+      const auto [lo, hi] = std::minmax_element(values.begin(), values.end());
+      ASSERT_TRUE(rs::try_minmax(s).has_value());
+      EXPECT_EQ(rs::try_min(s).value(), *lo);
+      EXPECT_EQ(rs::try_max(s).value(), *hi);
+    }
+  });
+}
+
+} // namespace
+
+TEST(SimdTest, BestIsaIsSelectedByDefault) {
+  EXPECT_EQ(rs::active_isa(), rs::best_isa());
+  EXPECT_TRUE(rs::try_select_isa(rs::isa::scalar).has_value());
+  EXPECT_EQ(rs::active_isa(), rs::isa::scalar);
+  EXPECT_TRUE(rs::try_select_isa(rs::best_isa()).has_value());
+}
+
+TEST(SimdTest, UnsupportedIsaIsRejected) {
+  if (rs::best_isa() == rs::isa::avx512)
+    GTEST_SKIP() << "Every level is supported";
+  auto res = rs::try_select_isa(rs::isa::avx512);
+  ASSERT_FALSE(res.has_value());
+  EXPECT_EQ(res.error(), reloco::error::unsupported_operation);
+}
+
+TEST(SimdTest, MatchesScalarForEveryElementType) {
+  check_against_scalar<std::int8_t>();
+  check_against_scalar<std::uint8_t>();
+  check_against_scalar<std::int16_t>();
+  check_against_scalar<std::uint32_t>();
+  check_against_scalar<std::int64_t>();
+  check_against_scalar<float>();
+  check_against_scalar<double>();
+}
+
+TEST(SimdTest, CountDoesNotWrapNarrowLanes) {
+  // More matches per lane than an 8-bit counter can hold
+  std::vector<std::uint8_t> values(64 * 1000, 7);
+  reloco::span<const std::uint8_t> s(values.data(), values.size());
+  for_each_supported_isa(
+      [&] { EXPECT_EQ(rs::count(s, std::uint8_t{7}), values.size()); });
+}
+
+TEST(SimdTest, MinMaxOfNegativeValues) {
+  std::vector<int> values(100);
+  std::iota(values.begin(), values.end(), -50);
+  values[73] = -1000;
+  values[5] = 1000;
+  reloco::span<const int> s(values.data(), values.size());
+  for_each_supported_isa([&] {
+    auto bounds = rs::try_minmax(s);
+    ASSERT_TRUE(bounds.has_value());
+    EXPECT_EQ(bounds->first, -1000);
+    EXPECT_EQ(bounds->second, 1000);
+  });
+}
+
+TEST(SimdTest, DotProduct) {
+  std::vector<std::int32_t> a(131);
+  std::vector<std::int32_t> b(131);
+  std::iota(a.begin(), a.end(), -60);
+  std::iota(b.begin(), b.end(), 3);
+  const auto expected = std::inner_product(a.begin(), a.end(), b.begin(), 0);
+  reloco::span<const std::int32_t> sa(a.data(), a.size());
+  reloco::span<const std::int32_t> sb(b.data(), b.size());
+  for_each_supported_isa(
+      [&] { EXPECT_EQ(rs::try_dot(sa, sb).value(), expected); });
+
+  auto res = rs::try_dot(sa, sb.unsafe_first(10));
+  ASSERT_FALSE(res.has_value());
+  EXPECT_EQ(res.error(), reloco::error::invalid_argument);
+}
+
+TEST(SimdTest, FloatSumIsCloseToSequential) {
+  std::vector<float> values(1000);
+  for (std::size_t i = 0; i < values.size(); ++i)
+    values[i] = 0.5f + static_cast<float>(i % 10);
+  reloco::span<const float> s(values.data(), values.size());
+  for_each_supported_isa([&] { EXPECT_FLOAT_EQ(rs::sum(s), 5000.0f); });
+}
+
+TEST(SimdTest, ClampInPlace) {
+  for_each_supported_isa([] {
+    auto values = pattern<std::int16_t>(77);
+    reloco::span<std::int16_t> s(values.data(), values.size());
+    ASSERT_TRUE(rs::try_clamp<std::int16_t>(s, 20, 80).has_value());
+    for (std::int16_t v : values) {
+      EXPECT_GE(v, 20);
+      EXPECT_LE(v, 80);
+    }
+  });
+
+  std::int16_t one = 5;
+  auto res = rs::try_clamp<std::int16_t>(reloco::span<std::int16_t>(&one, 1),
+                                         10, 0);
+  ASSERT_FALSE(res.has_value());
+  EXPECT_EQ(res.error(), reloco::error::invalid_argument);
+}
+
+TEST(SimdTest, GatherByIndex) {
+  const double source[] = {0.5, 1.5, 2.5, 3.5};
+  const std::uint32_t indices[] = {3, 0, 0, 2, 1};
+  double out[5] = {};
+  ASSERT_TRUE(rs::try_gather(reloco::span<const double>(source, 4),
+                             reloco::span<const std::uint32_t>(indices, 5),
+                             reloco::span<double>(out, 5))
+                  .has_value());
+  EXPECT_EQ(out[0], 3.5);
+  EXPECT_EQ(out[1], 0.5);
+  EXPECT_EQ(out[3], 2.5);
+  EXPECT_EQ(out[4], 1.5);
+}
+
+TEST(SimdTest, GatherRejectsOutOfBoundsIndex) {
+  const int source[] = {1, 2, 3};
+  const std::uint32_t indices[] = {0, 3};
+  int out[2] = {-1, -1};
+  auto res = rs::try_gather(reloco::span<const int>(source, 3),
+                            reloco::span<const std::uint32_t>(indices, 2),
+                            reloco::span<int>(out, 2));
+  ASSERT_FALSE(res.has_value());
+  EXPECT_EQ(res.error(), reloco::error::out_of_bounds);
+  EXPECT_EQ(out[0], -1);
+}
@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include <mutex>
+#include <reloco/spinlock.hpp>
+#include <thread>
+#include <vector>
+
+namespace {
+
+template <typename Lock> void hammer(Lock &lock, std::uint64_t &counter) {
+  constexpr int thread_count = 4;
+  constexpr int iterations = 5000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < thread_count; ++t) {
+    threads.emplace_back([&] {
+      for (int i = 0; i < iterations; ++i) {
+        std::unique_lock<Lock> guard(lock);
+        ++counter;
+      }
+    });
+  }
+  for (auto &t : threads)
+    t.join();
+}
+
+} // namespace
+
+TEST(TicketLockTest, TryLockRespectsHolder) {
+  reloco::ticket_lock lock;
+  EXPECT_TRUE(lock.try_lock());
+  EXPECT_TRUE(lock.is_locked());
+  EXPECT_FALSE(lock.try_lock());
+  EXPECT_TRUE(lock.unlock().has_value());
+  EXPECT_FALSE(lock.is_locked());
+}
+
+TEST(TicketLockTest, UnlockWithoutLock) {
+  reloco::ticket_lock lock;
+  auto res = lock.unlock();
+  ASSERT_FALSE(res.has_value());
+  EXPECT_EQ(res.error(), reloco::error::not_locked);
+}
+
+TEST(TicketLockTest, MutualExclusion) {
+  reloco::ticket_lock lock;
+  std::uint64_t counter = 0;
+  hammer(lock, counter);
+  EXPECT_EQ(counter, 4u * 5000u);
+}
+
+TEST(McsLockTest, NodeSpansOwnCacheLine) {
+  static_assert(alignof(reloco::mcs_node) == reloco::cache_line_size);
+  static_assert(sizeof(reloco::mcs_node) == reloco::cache_line_size);
+}
+
+TEST(McsLockTest, TryLockRespectsHolder) {
+  reloco::mcs_lock lock;
+  EXPECT_TRUE(lock.try_lock());
+  EXPECT_TRUE(lock.is_locked());
+  EXPECT_FALSE(lock.try_lock());
+  EXPECT_TRUE(lock.unlock().has_value());
+  EXPECT_FALSE(lock.is_locked());
+}
+
+TEST(McsLockTest, ExplicitNode) {
+  reloco::mcs_lock lock;
+  reloco::mcs_node node;
+  EXPECT_TRUE(lock.lock(node).has_value());
+  EXPECT_FALSE(lock.try_lock());
+  EXPECT_TRUE(lock.unlock(node).has_value());
+  EXPECT_TRUE(lock.try_lock());
+  EXPECT_TRUE(lock.unlock().has_value());
+}
+
+TEST(McsLockTest, NestedLocksReleasedOutOfOrder) {
+  reloco::mcs_lock a;
+  reloco::mcs_lock b;
+  std::ignore = a.lock();
+  std::ignore = b.lock();
+  EXPECT_TRUE(a.unlock().has_value());
+  EXPECT_TRUE(b.unlock().has_value());
+  EXPECT_FALSE(a.is_locked());
+  EXPECT_FALSE(b.is_locked());
+}
+
+TEST(McsLockTest, UnlockFromOtherThreadIsRejected) {
+  reloco::mcs_lock lock;
+  std::ignore = lock.lock();
+
+  reloco::result<void> res;
+  std::thread other([&] { res = lock.unlock(); });
+  other.join();
+
+  ASSERT_FALSE(res.has_value());
+  EXPECT_EQ(res.error(), reloco::error::invalid_owner);
+  EXPECT_TRUE(lock.unlock().has_value());
+}
+
+TEST(McsLockTest, MutualExclusion) {
+  reloco::mcs_lock lock;
+  std::uint64_t counter = 0;
+  hammer(lock, counter);
+  EXPECT_EQ(counter, 4u * 5000u);
+}
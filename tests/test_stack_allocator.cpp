@@ -1,5 +1,6 @@
 
 #include <array>
+#include <cstring>
 #include <gtest/gtest.h>
 #include <reloco/stack_allocator.hpp>
 
@@ -57,3 +58,17 @@ TEST_F(StackAllocatorTest, ExpandInPlaceSuccess) {
   EXPECT_EQ(static_cast<std::byte *>(next->ptr),
             static_cast<std::byte *>(original_ptr) + 200);
 }
+
+TEST_F(StackAllocatorTest, AllocateZeroedClearsReusedMemory) {
+  auto dirty = alloc.allocate(64, 8);
+  ASSERT_TRUE(dirty.has_value());
+  std::memset(dirty->ptr, 0xAB, 64);
+  alloc.reset();
+
+  auto zeroed = alloc.allocate_zeroed(64, 8);
+  ASSERT_TRUE(zeroed.has_value());
+  EXPECT_EQ(zeroed->ptr, dirty->ptr);
+  const auto *bytes = static_cast<const unsigned char *>(zeroed->ptr);
+  for (std::size_t i = 0; i < 64; ++i)
+    EXPECT_EQ(bytes[i], 0u);
+}
@@ -0,0 +1,221 @@
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <reloco/barrier.hpp>
+#include <reloco/eventcount.hpp>
+#include <reloco/latch.hpp>
+#include <reloco/once.hpp>
+#include <reloco/semaphore.hpp>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+TEST(SemaphoreTest, AcquireWithoutContention) {
+  reloco::counting_semaphore<4> sem(2);
+  EXPECT_TRUE(sem.acquire().has_value());
+  EXPECT_TRUE(sem.try_acquire());
+  EXPECT_FALSE(sem.try_acquire());
+
+  EXPECT_TRUE(sem.release(2).has_value());
+  EXPECT_TRUE(sem.try_acquire());
+  EXPECT_TRUE(sem.try_acquire());
+}
+
+TEST(SemaphoreTest, ReleaseOverflow) {
+  reloco::binary_semaphore sem(1);
+  auto res = sem.release();
+  ASSERT_FALSE(res.has_value());
+  EXPECT_EQ(res.error(), reloco::error::integer_overflow);
+}
+
+TEST(SemaphoreTest, TimedAcquireTimesOut) {
+  reloco::binary_semaphore sem(0);
+  auto res = sem.try_acquire_for(10ms);
+  ASSERT_FALSE(res.has_value());
+  EXPECT_EQ(res.error(), reloco::error::timed_out);
+}
+
+TEST(SemaphoreTest, HandoffBetweenThreads) {
+  reloco::binary_semaphore ping(0);
+  reloco::binary_semaphore pong(0);
+  int rounds = 0;
+
+  std::thread worker([&] {
+    for (int i = 0; i < 1000; ++i) {
+      std::ignore = ping.acquire();
+      ++rounds;
+      std::ignore = pong.release();
+    }
+  });
+
+  for (int i = 0; i < 1000; ++i) {
+    std::ignore = ping.release();
+    std::ignore = pong.acquire();
+  }
+  worker.join();
+  EXPECT_EQ(rounds, 1000);
+}
+
+TEST(LatchTest, CountDownReleasesWaiters) {
+  reloco::latch done(4);
+  std::atomic<int> finished{0};
+  std::vector<std::thread> threads;
+
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&] {
+      finished.fetch_add(1);
+      std::ignore = done.count_down();
+    });
+  }
+
+  EXPECT_TRUE(done.wait().has_value());
+  EXPECT_EQ(finished.load(), 4);
+  EXPECT_TRUE(done.try_wait());
+
+  for (auto &t : threads)
+    t.join();
+}
+
+TEST(LatchTest, CountDownBelowZeroIsRejected) {
+  reloco::latch l(1);
+  auto res = l.count_down(2);
+  ASSERT_FALSE(res.has_value());
+  EXPECT_EQ(res.error(), reloco::error::invalid_argument);
+  EXPECT_FALSE(l.try_wait());
+}
+
+TEST(LatchTest, TimedWaitTimesOut) {
+  reloco::latch l(1);
+  auto res = l.wait_for(10ms);
+  ASSERT_FALSE(res.has_value());
+  EXPECT_EQ(res.error(), reloco::error::timed_out);
+}
+
+TEST(BarrierTest, PhasesRunCompletion) {
+  constexpr int thread_count = 4;
+  constexpr int phases = 50;
+  std::atomic<int> completions{0};
+  std::atomic<int> counter{0};
+
+  struct on_completion {
+    std::atomic<int> *completions;
+    void operator()() noexcept { completions->fetch_add(1); }
+  };
+
+  reloco::barrier<on_completion> sync(thread_count,
+                                      on_completion{&completions});
+  std::vector<std::thread> threads;
+  std::atomic<bool> mismatch{false};
+
+  for (int t = 0; t < thread_count; ++t) {
+    threads.emplace_back([&] {
+      for (int p = 0; p < phases; ++p) {
+        counter.fetch_add(1);
+        std::ignore = sync.arrive_and_wait();
+        // Every thread of this phase has incremented before anybody passes
+        if (counter.load() < (p + 1) * thread_count)
+          mismatch.store(true);
+        std::ignore = sync.arrive_and_wait();
+      }
+    });
+  }
+
+  for (auto &t : threads)
+    t.join();
+
+  EXPECT_FALSE(mismatch.load());
+  EXPECT_EQ(completions.load(), phases * 2);
+}
+
+TEST(BarrierTest, ArriveAndDrop) {
+  reloco::barrier<> sync(2);
+  sync.arrive_and_drop();
+  // Only one participant remains, so it never blocks
+  EXPECT_TRUE(sync.arrive_and_wait().has_value());
+  EXPECT_TRUE(sync.arrive_and_wait().has_value());
+}
+
+TEST(EventcountTest, WaitTimesOutWithoutNotify) {
+  reloco::eventcount ec;
+  auto key = ec.prepare_wait();
+  auto res = ec.wait_for(key, 10ms);
+  ASSERT_FALSE(res.has_value());
+  EXPECT_EQ(res.error(), reloco::error::timed_out);
+}
+
+TEST(EventcountTest, ConsumerSeesPublishedItems) {
+  reloco::eventcount ec;
+  std::atomic<int> available{0};
+  constexpr int items = 10000;
+  int consumed = 0;
+
+  std::thread consumer([&] {
+    while (consumed < items) {
+      if (available.load() > 0) {
+        available.fetch_sub(1);
+        ++consumed;
+        continue;
+      }
+      auto key = ec.prepare_wait();
+      if (available.load() > 0) {
+        ec.cancel_wait();
+        continue;
+      }
+      std::ignore = ec.wait(key);
+    }
+  });
+
+  for (int i = 0; i < items; ++i) {
+    available.fetch_add(1);
+    ec.notify_one();
+  }
+
+  consumer.join();
+  EXPECT_EQ(consumed, items);
+}
+
+TEST(OnceFlagTest, RunsOnceAcrossThreads) {
+  reloco::once_flag flag;
+  std::atomic<int> calls{0};
+  std::vector<std::thread> threads;
+
+  for (int i = 0; i < 16; ++i) {
+    threads.emplace_back([&] {
+      auto res = flag.try_call([&]() -> reloco::result<void> {
+        calls.fetch_add(1);
+        std::this_thread::sleep_for(5ms);
+        return {};
+      });
+      EXPECT_TRUE(res.has_value());
+    });
+  }
+  for (auto &t : threads)
+    t.join();
+
+  EXPECT_EQ(calls.load(), 1);
+  EXPECT_TRUE(flag.is_done());
+}
+
+TEST(OnceFlagTest, FailureAllowsRetry) {
+  reloco::once_flag flag;
+  auto res = flag.try_call([]() -> reloco::result<void> {
+    return reloco::unexpected(reloco::error::not_initialized);
+  });
+  ASSERT_FALSE(res.has_value());
+  EXPECT_EQ(res.error(), reloco::error::not_initialized);
+  EXPECT_FALSE(flag.is_done());
+
+  int calls = 0;
+  EXPECT_TRUE(flag.try_call([&]() -> reloco::result<void> {
+                    ++calls;
+                    return {};
+                  })
+                  .has_value());
+  EXPECT_TRUE(flag.try_call([&]() -> reloco::result<void> {
+                    ++calls;
+                    return {};
+                  })
+                  .has_value());
+  EXPECT_EQ(calls, 1);
+}
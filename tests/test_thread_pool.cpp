@@ -0,0 +1,57 @@
+#include <atomic>
+#include <gtest/gtest.h>
+#include <reloco/thread_pool.hpp>
+
+TEST(ThreadPoolTest, SubmitBeforeStartFails) {
+  reloco::thread_pool pool;
+  auto res = pool.try_submit([] {});
+  ASSERT_FALSE(res.has_value());
+  EXPECT_EQ(res.error(), reloco::error::not_initialized);
+}
+
+TEST(ThreadPoolTest, StartTwiceFails) {
+  reloco::thread_pool pool;
+  ASSERT_TRUE(pool.try_start(2).has_value());
+  EXPECT_EQ(pool.thread_count(), 2u);
+
+  auto res = pool.try_start(2);
+  ASSERT_FALSE(res.has_value());
+  EXPECT_EQ(res.error(), reloco::error::already_exists);
+}
+
+TEST(ThreadPoolTest, RunsAllTasks) {
+  reloco::thread_pool pool;
+  ASSERT_TRUE(pool.try_start(4).has_value());
+
+  std::atomic<int> counter{0};
+  for (int i = 0; i < 1000; ++i)
+    ASSERT_TRUE(pool.try_submit([&counter] { counter.fetch_add(1); }));
+
+  EXPECT_TRUE(pool.wait_idle().has_value());
+  EXPECT_EQ(counter.load(), 1000);
+}
+
+TEST(ThreadPoolTest, WaitIdleCoversNestedSubmissions) {
+  reloco::thread_pool pool;
+  ASSERT_TRUE(pool.try_start(2).has_value());
+
+  std::atomic<int> counter{0};
+  ASSERT_TRUE(pool.try_submit([&] {
+    for (int i = 0; i < 10; ++i)
+      std::ignore = pool.try_submit([&counter] { counter.fetch_add(1); });
+  }));
+
+  EXPECT_TRUE(pool.wait_idle().has_value());
+  EXPECT_EQ(counter.load(), 10);
+}
+
+TEST(ThreadPoolTest, DestructorDrainsQueue) {
+  std::atomic<int> counter{0};
+  {
+    reloco::thread_pool pool;
+    ASSERT_TRUE(pool.try_start(1).has_value());
+    for (int i = 0; i < 100; ++i)
+      ASSERT_TRUE(pool.try_submit([&counter] { counter.fetch_add(1); }));
+  }
+  EXPECT_EQ(counter.load(), 100);
+}
@@ -124,6 +124,29 @@ TEST(RelocoVectorComplexTest, NonRelocatableTypeShifting) {
   EXPECT_EQ(v[2].data, "third");
 }
 
+TEST(RelocoVectorComplexTest, EraseRangeAndSwap) {
+  reloco::vector<HeavyType> v;
+  for (const char *s : {"a", "b", "c", "d", "e"})
+    std::ignore = v.try_emplace_back(std::string(s));
+
+  ASSERT_TRUE(v.try_erase(1, 3));
+  ASSERT_EQ(v.size(), 2);
+  EXPECT_EQ(v[0].data, "a");
+  EXPECT_EQ(v[1].data, "e");
+
+  EXPECT_EQ(v.try_erase(1, 2).error(), reloco::error::out_of_range);
+  EXPECT_TRUE(v.try_erase(2, 0));
+  ASSERT_TRUE(v.try_erase(0, 2));
+  EXPECT_TRUE(v.empty());
+
+  reloco::vector<HeavyType> other;
+  std::ignore = other.try_emplace_back(std::string("x"));
+  v.swap(other);
+  ASSERT_EQ(v.size(), 1);
+  EXPECT_EQ(v[0].data, "x");
+  EXPECT_TRUE(other.empty());
+}
+
 TEST(RelocoVectorTest, TriggersReallocation) {
   reloco::vector<int> vec;
 
@@ -194,6 +217,55 @@ TEST(RelocoVectorTest, CloneEmptyVector) {
   EXPECT_EQ(clone_res->capacity(), 0);
 }
 
+TEST(RelocoVectorTest, AppendCopiesRange) {
+  reloco::vector<int> vec;
+  ASSERT_TRUE(vec.try_push_back(1));
+  const int more[] = {2, 3, 4};
+  ASSERT_TRUE(vec.try_append(reloco::span<const int>(more, 3)));
+  ASSERT_EQ(vec.size(), 4);
+  EXPECT_EQ(vec[3], 4);
+  EXPECT_TRUE(vec.try_append(reloco::span<const int>()));
+  EXPECT_EQ(vec.size(), 4);
+}
+
+TEST(RelocoVectorTest, AppendOwnElementsAcrossGrowth) {
+  // Not relocatable, so growing always moves into a new block, and the
+  // destructor scrubs what the old block held
+  struct scrubbed {
+    int value;
+    explicit scrubbed(int v) noexcept : value(v) {}
+    scrubbed(const scrubbed &) noexcept = default;
+    scrubbed(scrubbed &&other) noexcept : value(other.value) {}
+    ~scrubbed() { value = -1; }
+  };
+
+  reloco::vector<scrubbed> vec;
+  for (int i = 0; i < 8; ++i)
+    ASSERT_TRUE(vec.try_emplace_back(i));
+  ASSERT_EQ(vec.capacity(), 8);
+
+  ASSERT_TRUE(
+      vec.try_append(reloco::span<const scrubbed>(vec.begin() + 2, 6)));
+  ASSERT_EQ(vec.size(), 14);
+  for (int i = 0; i < 6; ++i)
+    EXPECT_EQ(vec[8 + i].value, i + 2);
+}
+
+TEST(RelocoVectorTest, AppendClonesElements) {
+  reloco::vector<MockClonable> source;
+  ASSERT_TRUE(source.try_push_back({1, false}));
+  ASSERT_TRUE(source.try_push_back({2, true}));
+
+  reloco::vector<MockClonable> vec;
+  auto res = vec.try_append(
+      reloco::span<const MockClonable>(source.begin(), source.size()));
+  ASSERT_FALSE(res);
+  EXPECT_EQ(res.error(), reloco::error::allocation_failed);
+  // The copy made before the failing one stays
+  ASSERT_EQ(vec.size(), 1);
+  EXPECT_EQ(vec[0].value, 1);
+}
+
 TEST(RelocoVectorEmplace, HandlesTryCreate) {
   struct FallibleWidget {
     int id;